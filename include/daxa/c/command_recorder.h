@@ -24,10 +24,52 @@ typedef struct
 {
     daxa_QueueType queue_type;
     daxa_SmallString name;
+    daxa_Bool8 reusable;
 } daxa_CommandRecorderInfo;
 
 static daxa_CommandRecorderInfo const DAXA_DEFAULT_COMMAND_RECORDER_INFO = DAXA_ZERO_INIT;
 
+// Describes the render pass a secondary command recorder records into.
+// Completed secondary commands are executed by a primary recorder, in a render pass begun with secondary_command_lists set.
+// Dynamic state like viewport and scissor is not inherited, it must be set in each secondary recorder.
+typedef struct
+{
+    daxa_FixedList(VkFormat, 8) color_attachment_formats;
+    daxa_Optional(VkFormat) depth_attachment_format;
+    daxa_Optional(VkFormat) stencil_attachment_format;
+    VkSampleCountFlagBits rasterization_samples;
+    daxa_SmallString name;
+    // Reusable secondary command lists can be executed many times, also by reusable primary command lists.
+    daxa_Bool8 reusable;
+} daxa_SecondaryCommandRecorderInfo;
+
+static daxa_SecondaryCommandRecorderInfo const DAXA_DEFAULT_SECONDARY_COMMAND_RECORDER_INFO = {
+    .color_attachment_formats = DAXA_ZERO_INIT,
+    .depth_attachment_format = DAXA_ZERO_INIT,
+    .stencil_attachment_format = DAXA_ZERO_INIT,
+    .rasterization_samples = VK_SAMPLE_COUNT_1_BIT,
+    .name = DAXA_ZERO_INIT,
+    .reusable = 0,
+};
+
+// Counts state changes that were skipped, because the same state was already set in the command recorder.
+// Also counts how the batched pipeline barriers were recorded.
+typedef struct
+{
+    uint64_t elided_pipeline_binds;
+    uint64_t elided_descriptor_set_binds;
+    uint64_t elided_push_constants;
+    uint64_t elided_viewports;
+    uint64_t elided_scissors;
+    uint64_t elided_depth_biases;
+    // Number of vkCmdPipelineBarrier2 calls that recorded the batched barriers.
+    uint64_t barrier_flushes;
+    uint64_t flushed_memory_barriers;
+    uint64_t flushed_image_barriers;
+    // Image barriers merged into a pending barrier on the same subresource range.
+    uint64_t merged_image_barriers;
+} daxa_CommandRecorderStatistics;
+
 typedef struct
 {
     daxa_ImageId src_image;
@@ -173,6 +215,8 @@ typedef struct
     daxa_Optional(daxa_RenderAttachmentInfo) depth_attachment;
     daxa_Optional(daxa_RenderAttachmentInfo) stencil_attachment;
     VkRect2D render_area;
+    // The render pass contents are recorded in secondary command lists, see daxa_cmd_execute_commands.
+    daxa_Bool8 secondary_command_lists;
 } daxa_RenderPassBeginInfo;
 
 static daxa_RenderPassBeginInfo const DAXA_DEFAULT_RENDERPASS_BEGIN_INFO = DAXA_ZERO_INIT;
@@ -263,6 +307,7 @@ static daxa_DrawMeshTasksIndirectCountInfo const DAXA_DRAW_MESH_TASKS_INDIRECT_C
     .stride = 12,
 };
 
+// Has the memory layout of VkDrawIndirectCommand, arrays of draw infos can be copied into indirect buffers as is.
 typedef struct
 {
     uint32_t vertex_count;
@@ -278,6 +323,7 @@ static daxa_DrawInfo const DAXA_DEFAULT_DRAW_INFO = {
     .first_instance = 0,
 };
 
+// Has the memory layout of VkDrawIndexedIndirectCommand, arrays of draw infos can be copied into indirect buffers as is.
 typedef struct
 {
     uint32_t index_count;
@@ -300,6 +346,7 @@ typedef struct
     daxa_BufferId indirect_buffer;
     size_t indirect_buffer_offset;
     uint32_t draw_count;
+    // A stride of 0 means tightly packed draw commands.
     uint32_t draw_command_stride;
     daxa_Bool8 is_indexed;
 } daxa_DrawIndirectInfo;
@@ -319,6 +366,7 @@ typedef struct
     daxa_BufferId count_buffer;
     size_t count_buffer_offset;
     uint32_t max_draw_count;
+    // A stride of 0 means tightly packed draw commands.
     uint32_t draw_command_stride;
     daxa_Bool8 is_indexed;
 } daxa_DrawIndirectCountInfo;
@@ -424,12 +472,13 @@ DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_clear_image(daxa_CommandRecorder cmd_enc, daxa_ImageClearInfo const * info);
 
 /// @brief  Successive pipeline barrier calls are combined.
-///         As soon as a non-pipeline barrier command is recorded, the currently recorded barriers are flushed with a vkCmdPipelineBarrier2 call.
+///         As soon as a command that accesses memory is recorded, the currently recorded barriers are flushed with a vkCmdPipelineBarrier2 call.
 /// @param info parameters.
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_pipeline_barrier(daxa_CommandRecorder cmd_enc, daxa_BarrierInfo const * info);
 /// @brief  Successive pipeline barrier calls are combined.
-///         As soon as a non-pipeline barrier command is recorded, the currently recorded barriers are flushed with a vkCmdPipelineBarrier2 call.
+///         As soon as a command that accesses memory is recorded, the currently recorded barriers are flushed with a vkCmdPipelineBarrier2 call.
+///         Successive image barriers on the same image and subresource range are merged, partially overlapping ones flush the pending barriers first.
 /// @param info parameters.
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_pipeline_image_barrier(daxa_CommandRecorder cmd_enc, daxa_ImageBarrierInfo const * info);
@@ -505,6 +554,13 @@ DAXA_EXPORT void
 daxa_cmd_draw(daxa_CommandRecorder cmd_enc, daxa_DrawInfo const * info);
 DAXA_EXPORT void
 daxa_cmd_draw_indexed(daxa_CommandRecorder cmd_enc, daxa_DrawIndexedInfo const * info);
+// Records all draws with a single call when VK_EXT_multi_draw is supported, see DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW.
+// Consecutive draws with equal instance_count and first_instance are merged into one multi draw.
+// Without the extension, the draws are recorded one by one.
+DAXA_EXPORT void
+daxa_cmd_draw_many(daxa_CommandRecorder cmd_enc, daxa_DrawInfo const * infos, uint32_t info_count);
+DAXA_EXPORT void
+daxa_cmd_draw_indexed_many(daxa_CommandRecorder cmd_enc, daxa_DrawIndexedInfo const * infos, uint32_t info_count);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_draw_indirect(daxa_CommandRecorder cmd_enc, daxa_DrawIndirectInfo const * info);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
@@ -529,13 +585,24 @@ daxa_cmd_end_label(daxa_CommandRecorder cmd_enc);
 DAXA_EXPORT void
 daxa_cmd_reset_assumed_state(daxa_CommandRecorder cmd_enc);
 
-// Is called by all other commands. Flushes internal pipeline barrier list to actual vulkan call.
+// Executes completed secondary command lists within the current render pass.
+// The render pass must be begun with secondary_command_lists set.
+// Secondary command lists that are not reusable can only be executed once. They are recycled together with the commands of this recorder.
+// Reusable recorders can only execute reusable secondary command lists.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_cmd_execute_commands(daxa_CommandRecorder cmd_enc, daxa_ExecutableCommandList const * commands, uint64_t command_count);
+
+// Is called by all commands that access memory. Flushes internal pipeline barrier list to actual vulkan call.
 DAXA_EXPORT void
 daxa_cmd_flush_barriers(daxa_CommandRecorder cmd_enc);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_cmd_complete_current_commands(daxa_CommandRecorder cmd_enc, daxa_ExecutableCommandList * out_executable_cmds);
 DAXA_EXPORT daxa_CommandRecorderInfo const *
 daxa_cmd_info(daxa_CommandRecorder cmd_enc);
+// Statistics stay valid after completing the commands.
+DAXA_EXPORT daxa_CommandRecorderStatistics const *
+daxa_cmd_statistics(daxa_CommandRecorder cmd_enc);
+// Flushes pending pipeline barriers, so that raw vulkan commands can be recorded into the returned command buffer.
 DAXA_EXPORT VkCommandBuffer
 daxa_cmd_get_vk_command_buffer(daxa_CommandRecorder cmd_enc);
 DAXA_EXPORT VkCommandPool
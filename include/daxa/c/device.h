@@ -282,6 +282,7 @@ typedef enum
     DAXA_IMPLICIT_FEATURE_FLAG_SHADER_CLOCK = 0x1 << 14,
     DAXA_IMPLICIT_FEATURE_FLAG_HOST_IMAGE_COPY = 0x1 << 15,
     DAXA_IMPLICIT_FEATURE_FLAG_LINE_RASTERIZATION = 0x1 << 16,
+    DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW = 0x1 << 17,
 } daxa_DeviceImplicitFeatureFlagBits;
 
 typedef daxa_DeviceImplicitFeatureFlagBits daxa_ImplicitFeatureFlags;
@@ -379,6 +380,24 @@ typedef struct
 
 static daxa_PresentInfo const DAXA_DEFAULT_PRESENT_INFO = DAXA_ZERO_INIT;
 
+typedef struct
+{
+    // Maximum number of zombies destroyed by one call. Zero means unlimited.
+    uint64_t max_objects;
+    // Maximum time in microseconds spent destroying zombies in one call. Zero means unlimited.
+    uint64_t max_time_us;
+} daxa_GarbageCollectionInfo;
+
+static daxa_GarbageCollectionInfo const DAXA_DEFAULT_GARBAGE_COLLECTION_INFO = DAXA_ZERO_INIT;
+
+typedef struct
+{
+    // Number of zombies destroyed by the call.
+    uint64_t collected_objects;
+    // False when zombies that were ready to be destroyed remain because the budget was spent.
+    daxa_Bool8 all_collected;
+} daxa_GarbageCollectionResult;
+
 typedef struct
 {
     daxa_Queue queue;
@@ -574,6 +593,11 @@ DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_buffer(daxa_Device device, daxa_BufferInfo const * info, daxa_BufferId * out_id);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_image(daxa_Device device, daxa_ImageInfo const * info, daxa_ImageId * out_id);
+// Creates count resources with a single descriptor set update. Either all or none of the resources are created.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_buffers(daxa_Device device, daxa_BufferInfo const * infos, daxa_u32 count, daxa_BufferId * out_ids);
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_images(daxa_Device device, daxa_ImageInfo const * infos, daxa_u32 count, daxa_ImageId * out_ids);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_buffer_from_memory_block(daxa_Device device, daxa_MemoryBlockBufferInfo const * info, daxa_BufferId * out_id);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
@@ -612,6 +636,11 @@ DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_destroy_image(daxa_Device device, daxa_ImageId image);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_destroy_image_view(daxa_Device device, daxa_ImageViewId image_view);
+// Destroys count resources, taking the zombie lock once. Invalid ids are skipped and reported after all valid ids are destroyed.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_destroy_buffers(daxa_Device device, daxa_BufferId const * buffers, daxa_u32 count);
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_destroy_images(daxa_Device device, daxa_ImageId const * images, daxa_u32 count);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_destroy_sampler(daxa_Device device, daxa_SamplerId sampler);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
@@ -682,6 +711,9 @@ DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_swapchain(daxa_Device device, daxa_SwapchainInfo const * info, daxa_Swapchain * out_swapchain);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_command_recorder(daxa_Device device, daxa_CommandRecorderInfo const * info, daxa_CommandRecorder * out_command_list);
+// Secondary command recorders can record render commands on any thread, for a render pass recorded in a primary recorder.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_create_secondary_command_recorder(daxa_Device device, daxa_SecondaryCommandRecorderInfo const * info, daxa_CommandRecorder * out_command_list);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_create_binary_semaphore(daxa_Device device, daxa_BinarySemaphoreInfo const * info, daxa_BinarySemaphore * out_binary_semaphore);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
@@ -727,6 +759,9 @@ DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_present_frame(daxa_Device device, daxa_PresentInfo const * info);
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_collect_garbage(daxa_Device device);
+// Stops destroying zombies once the budget is spent. out_result->all_collected is set to false when ready zombies remain.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_collect_garbage_budgeted(daxa_Device device, daxa_GarbageCollectionInfo const * info, daxa_GarbageCollectionResult * out_result);
 
 DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
 daxa_dvc_report_supported_present_modes(daxa_Device device, daxa_NativeWindowInfo native_window, uint32_t * out_present_mode_count, VkPresentModeKHR * out_present_modes);
@@ -738,6 +773,16 @@ daxa_dvc_choose_swapchain_surface_format(
     daxa_ChooseSwapchainSurfaceFormatInfo const * info,
     VkSurfaceFormatKHR * out_format);
 
+// Pipeline cache data is prefixed with a daxa header recording vendor id, device id, driver version and the pipeline cache uuid.
+// Follows the usual two call idiom: when out_data is null, out_size receives the required size.
+// When out_data is not null, *out_size must hold the capacity of out_data, returns VK_INCOMPLETE if it is too small.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_get_pipeline_cache_data(daxa_Device device, size_t * out_size, void * out_data);
+// Merges previously saved pipeline cache data into the device pipeline cache.
+// Returns DAXA_RESULT_ERROR_INCOMPATIBLE_PIPELINE_CACHE_DATA when the header does not match the device or driver, the device cache is left untouched.
+DAXA_EXPORT DAXA_NO_DISCARD daxa_Result
+daxa_dvc_load_pipeline_cache(daxa_Device device, void const * data, size_t size);
+
 DAXA_EXPORT daxa_DeviceInfo2 const *
 daxa_dvc_info(daxa_Device device);
 DAXA_EXPORT daxa_DeviceProperties const *
@@ -136,6 +136,12 @@ typedef enum
     DAXA_RESULT_ERROR_WAYLAND_FAILED_TO_CREATE_SURFACE = (1 << 30) + 82,
     DAXA_RESULT_ERROR_QUEUE_DOES_NOT_SUPPORT_SURFACE = (1 << 30) + 83,
     DAXA_RESULT_ERROR_INVALID_POINTER_PARAMETER = (1 << 30) + 84,
+    DAXA_RESULT_ERROR_SECONDARY_CMD_LIST_SUBMITTED = (1 << 30) + 85,
+    DAXA_RESULT_ERROR_CMD_LIST_NOT_EXECUTABLE_AS_SECONDARY = (1 << 30) + 86,
+    DAXA_RESULT_ERROR_RENDERPASS_DOES_NOT_ALLOW_SECONDARY_CMD_LISTS = (1 << 30) + 87,
+    DAXA_RESULT_ERROR_INVALID_CMD_ON_SECONDARY_CMD_LIST = (1 << 30) + 88,
+    DAXA_RESULT_ERROR_INCOMPATIBLE_PIPELINE_CACHE_DATA = (1 << 30) + 89,
+    DAXA_RESULT_ERROR_SECONDARY_CMD_LIST_NOT_REUSABLE = (1 << 30) + 90,
     DAXA_RESULT_MAX_ENUM = 0x7FFFFFFF,
 } daxa_Result;
 
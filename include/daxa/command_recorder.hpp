@@ -21,6 +21,41 @@ namespace daxa
     {
         QueueType queue_type = {};
         SmallString name = {};
+        /// @brief  Allows the completed commands to be submitted multiple times, even while a previous submission is still pending.
+        ///         Commands that are submitted only once should not set this, as drivers may optimize one time submit commands better.
+        bool reusable = {};
+    };
+
+    /// @brief  Describes the render pass a secondary command recorder records into.
+    ///         The formats and sample count must match the render pass the secondary commands are executed in.
+    ///         Dynamic state like viewport and scissor is not inherited, it must be set in each secondary recorder.
+    struct SecondaryCommandRecorderInfo
+    {
+        FixedList<Format, 8> color_attachment_formats = {};
+        Optional<Format> depth_attachment_format = {};
+        Optional<Format> stencil_attachment_format = {};
+        RasterizationSamples rasterization_samples = RasterizationSamples::E1;
+        SmallString name = {};
+        /// @brief  Reusable secondary command lists can be executed many times, also by reusable primary command lists.
+        bool reusable = {};
+    };
+
+    /// @brief  Counts state changes that were skipped, because the same state was already set in the command recorder.
+    ///         Also counts how the batched pipeline barriers were recorded.
+    struct CommandRecorderStatistics
+    {
+        u64 elided_pipeline_binds = {};
+        u64 elided_descriptor_set_binds = {};
+        u64 elided_push_constants = {};
+        u64 elided_viewports = {};
+        u64 elided_scissors = {};
+        u64 elided_depth_biases = {};
+        /// @brief  Number of vkCmdPipelineBarrier2 calls that recorded the batched barriers.
+        u64 barrier_flushes = {};
+        u64 flushed_memory_barriers = {};
+        u64 flushed_image_barriers = {};
+        /// @brief  Image barriers merged into a pending barrier on the same subresource range.
+        u64 merged_image_barriers = {};
     };
 
     struct ImageBlitInfo
@@ -119,6 +154,8 @@ namespace daxa
         Optional<RenderAttachmentInfo> depth_attachment = {};
         Optional<RenderAttachmentInfo> stencil_attachment = {};
         Rect2D render_area = {};
+        /// @brief  The render pass contents are recorded in secondary command lists, see RenderCommandRecorder::execute_commands.
+        bool secondary_command_lists = {};
     };
 
     struct TraceRaysInfo
@@ -181,6 +218,8 @@ namespace daxa
         u32 stride = 12;
     };
 
+    /// @brief  Has the memory layout of VkDrawIndirectCommand.
+    ///         Arrays of DrawInfo can be copied into indirect buffers as is and drawn with draw_indirect.
     struct DrawInfo
     {
         u32 vertex_count = {};
@@ -189,6 +228,8 @@ namespace daxa
         u32 first_instance = {};
     };
 
+    /// @brief  Has the memory layout of VkDrawIndexedIndirectCommand.
+    ///         Arrays of DrawIndexedInfo can be copied into indirect buffers as is and drawn with draw_indirect.
     struct DrawIndexedInfo
     {
         u32 index_count = {};
@@ -203,6 +244,7 @@ namespace daxa
         BufferId draw_command_buffer = {};
         usize indirect_buffer_offset = {};
         u32 draw_count = 1;
+        /// @brief A stride of 0 means tightly packed draw commands.
         u32 draw_command_stride = {};
         bool is_indexed = {};
     };
@@ -214,6 +256,7 @@ namespace daxa
         BufferId count_buffer = {};
         usize count_buffer_offset = {};
         u32 max_draw_count = static_cast<u32>(std::numeric_limits<u16>::max());
+        /// @brief A stride of 0 means tightly packed draw commands.
         u32 draw_command_stride = {};
         bool is_indexed = {};
     };
@@ -316,11 +359,27 @@ namespace daxa
 
         void draw(DrawInfo const & info);
         void draw_indexed(DrawIndexedInfo const & info);
+        /// @brief  Records all draws with a single call when ImplicitFeatureFlagBits::MULTI_DRAW is supported.
+        ///         Consecutive draws with equal instance_count and first_instance are merged into one multi draw.
+        ///         Without the feature, the draws are recorded one by one.
+        void draw_many(daxa::Span<DrawInfo const> const & infos);
+        void draw_indexed_many(daxa::Span<DrawIndexedInfo const> const & infos);
         void draw_indirect(DrawIndirectInfo const & info);
         void draw_indirect_count(DrawIndirectCountInfo const & info);
         void draw_mesh_tasks(DrawMeshTasksInfo const & info);
         void draw_mesh_tasks_indirect(DrawMeshTasksIndirectInfo const & info);
         void draw_mesh_tasks_indirect_count(DrawMeshTasksIndirectCountInfo const & info);
+
+        /// @brief  Executes completed secondary command lists within the current render pass.
+        ///         The render pass must be begun with secondary_command_lists set.
+        ///         Secondary command lists that are not reusable can only be executed once. They are recycled together with the commands of this recorder.
+        ///         Reusable recorders can only execute reusable secondary command lists.
+        /// @param commands secondary command lists, completed from recorders created with Device::create_secondary_command_recorder.
+        void execute_commands(daxa::Span<ExecutableCommandList const> const & commands);
+
+        /// @brief  Only valid for secondary command recorders.
+        ///         The returned command list can not be submitted, it must be executed by a primary recorder.
+        [[nodiscard]] auto complete_current_commands() -> ExecutableCommandList;
     };
 
     /**
@@ -365,11 +424,14 @@ namespace daxa
         void clear_image(ImageClearInfo const & info);
 
         /// @brief  Successive pipeline barrier calls are combined.
-        ///         As soon as a non-pipeline barrier command is recorded, the currently recorded barriers are flushed with a vkCmdPipelineBarrier2 call.
+        ///         As soon as a command that accesses memory is recorded, the currently recorded barriers are flushed with a vkCmdPipelineBarrier2 call.
+        ///         State changes like setting pipelines, push constants, viewports or labels do not flush barriers.
         /// @param info parameters.
         void pipeline_barrier(BarrierInfo const & info);
         /// @brief  Successive pipeline barrier calls are combined.
-        ///         As soon as a non-pipeline barrier command is recorded, the currently recorded barriers are flushed with a vkCmdPipelineBarrier2 call.
+        ///         As soon as a command that accesses memory is recorded, the currently recorded barriers are flushed with a vkCmdPipelineBarrier2 call.
+        ///         Successive image barriers on the same image and subresource range are merged into a single barrier.
+        ///         A barrier that partially overlaps a pending one flushes the pending barriers first.
         /// @param info parameters.
         void pipeline_image_barrier(ImageBarrierInfo const & info);
         void signal_event(EventSignalInfo const & info);
@@ -410,6 +472,10 @@ namespace daxa
         /// * reference MUST NOT be read after the device is destroyed.
         /// @return reference to info of object.
         [[nodiscard]] auto info() const -> CommandRecorderInfo const &;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the command recorder is destroyed.
+        /// @return reference to the redundant state change statistics of the recorder.
+        [[nodiscard]] auto statistics() const -> CommandRecorderStatistics const &;
 
 
         /// ============= Compute Queue Legal Commands ============= ///
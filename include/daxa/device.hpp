@@ -287,6 +287,7 @@ namespace daxa
         static inline constexpr ImplicitFeatureFlags SHADER_CLOCK = {0x1 << 14};
         static inline constexpr ImplicitFeatureFlags HOST_IMAGE_COPY = {0x1 << 15};
         static inline constexpr ImplicitFeatureFlags LINE_RASTERIZATION = {0x1 << 16};
+        static inline constexpr ImplicitFeatureFlags MULTI_DRAW = {0x1 << 17};
     };
 
     struct DeviceProperties
@@ -407,6 +408,22 @@ namespace daxa
         Queue queue = QUEUE_MAIN;
     };
 
+    struct GarbageCollectionInfo
+    {
+        /// @brief Maximum number of zombies destroyed by one call. Zero means unlimited.
+        u64 max_objects = {};
+        /// @brief Maximum time in microseconds spent destroying zombies in one call. Zero means unlimited.
+        u64 max_time_us = {};
+    };
+
+    struct GarbageCollectionResult
+    {
+        /// @brief Number of zombies destroyed by the call.
+        u64 collected_objects = {};
+        /// @brief False when zombies that were ready to be destroyed remain because the budget was spent.
+        bool all_collected = {};
+    };
+
     struct WaitOnSubmitInfo
     {
         Queue queue = {};
@@ -571,6 +588,14 @@ namespace daxa
 
         [[nodiscard]] auto create_buffer(BufferInfo const & info) -> BufferId;
         [[nodiscard]] auto create_image(ImageInfo const & info) -> ImageId;
+        /// @brief  Creates all buffers with a single descriptor set update. Either all or none of the buffers are created.
+        /// @param infos of the buffers to create.
+        /// @param out_ids receives the ids in the order of the infos. Must be at least as large as infos.
+        void create_buffers(std::span<BufferInfo const> infos, std::span<BufferId> out_ids);
+        /// @brief  Creates all images with a single descriptor set update. Either all or none of the images are created.
+        /// @param infos of the images to create.
+        /// @param out_ids receives the ids in the order of the infos. Must be at least as large as infos.
+        void create_images(std::span<ImageInfo const> infos, std::span<ImageId> out_ids);
         [[nodiscard]] auto create_buffer_from_memory_block(MemoryBlockBufferInfo const & info) -> BufferId;
         [[nodiscard]] auto create_tlas_from_memory_block(MemoryBlockTlasInfo const & info) -> TlasId;
         [[nodiscard]] auto create_image_from_memory_block(MemoryBlockImageInfo const & info) -> ImageId;
@@ -607,6 +632,10 @@ namespace daxa
         void destroy_buffer(BufferId buffer);
         void destroy_image(ImageId image);
         void destroy_image_view(ImageViewId image_view);
+        /// @brief  Destroys all buffers, taking the zombie lock once.
+        void destroy_buffers(std::span<BufferId const> buffers);
+        /// @brief  Destroys all images, taking the zombie lock once.
+        void destroy_images(std::span<ImageId const> images);
         void destroy_sampler(SamplerId sampler);
         void destroy_tlas(TlasId tlas);
         void destroy_blas(BlasId blas);
@@ -686,6 +715,10 @@ namespace daxa
 
         [[nodiscard]] auto create_swapchain(SwapchainInfo const & info) -> Swapchain;
         [[nodiscard]] auto create_command_recorder(CommandRecorderInfo const & info) -> CommandRecorder;
+        /// @brief  Secondary command recorders record render commands for a render pass of a primary recorder.
+        ///         Many secondary recorders can record in parallel on different threads.
+        ///         Their completed commands are executed with RenderCommandRecorder::execute_commands.
+        [[nodiscard]] auto create_secondary_command_recorder(SecondaryCommandRecorderInfo const & info) -> RenderCommandRecorder;
         [[nodiscard]] auto create_binary_semaphore(BinarySemaphoreInfo const & info) -> BinarySemaphore;
         [[nodiscard]] auto create_timeline_semaphore(TimelineSemaphoreInfo const & info) -> TimelineSemaphore;
         [[nodiscard]] auto create_event(EventInfo const & info) -> Event;
@@ -724,6 +757,11 @@ namespace daxa
         ///         When calling destroy, or removing all references to an object, it is zombified not really destroyed.
         ///         A zombie lives until the gpu catches up to the point of zombification.
         void collect_garbage();
+        /// @brief  Destroys zombies that are ready to be destroyed until the budget is spent.
+        ///         Spreads the destruction cost of large unloads over multiple frames.
+        ///         Zombies are destroyed oldest first, remaining zombies are destroyed by later calls.
+        /// @return number of destroyed zombies and whether all zombies that were ready to be destroyed got destroyed.
+        auto collect_garbage(GarbageCollectionInfo const & info) -> GarbageCollectionResult;
 
         /// THREADSAFETY:
         /// * reference MUST NOT be read after the device is destroyed.
@@ -739,6 +777,18 @@ namespace daxa
         // Set color space to MAX_ENUM to be ignored in selection.
         [[nodiscard]] auto choose_swapchain_surface_format(ChooseSwapchainSurfaceFormatInfo const & info) const -> SurfaceFormat;
 
+        /// @brief  Every pipeline daxa creates goes through a device wide VkPipelineCache.
+        ///         Saving its contents and loading them on the next run lets the driver skip compiling pipelines it has already seen.
+        /// THREADSAFETY:
+        /// * is threadsafe.
+        /// @return pipeline cache contents, prefixed with a header identifying the device and driver version.
+        [[nodiscard]] auto pipeline_cache_data() const -> std::vector<std::byte>;
+        /// @brief  Merges data previously returned by pipeline_cache_data into the device pipeline cache.
+        /// THREADSAFETY:
+        /// * is threadsafe.
+        /// @return false when the data was written by a different device or driver version. The data is ignored in that case.
+        auto load_pipeline_cache(Span<std::byte const> const & data) -> bool;
+
       protected:
         template <typename T, typename H_T>
         friend struct ManagedPtr;
@@ -8,6 +8,12 @@
 #include <daxa/device.hpp>
 
 #include <deque>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <memory>
+#include <vector>
 
 namespace daxa
 {
@@ -16,12 +22,32 @@ namespace daxa
         Device device = {};
         u32 capacity = 1 << 25;
         bool prefer_device_memory = true;
+        /// @brief  When the ring is full, allocations spill into up to this many extra buffer blocks instead of failing.
+        ///         0 disables spilling.
+        u32 max_spill_blocks = 0;
+        /// @brief Allocations larger than the spill block size get a block of their own size.
+        u32 spill_block_size = 1 << 22;
+        /// @brief Unused spill blocks are destroyed after this many calls to reuse_memory_after_pending_submits without spilling.
+        u32 spill_release_frames = 8;
         std::string name = {};
     };
 
     using TransferMemoryPoolInfo = RingBufferInfo;
 
-    /// @brief Ring buffer based transfer memory allocator for easy and efficient cpu gpu communication.
+    struct RingBufferStatistics
+    {
+        /// @brief Most bytes in use at once, including spill blocks and padding.
+        u64 high_water_mark = {};
+        /// @brief Number of allocations served from spill blocks.
+        u64 spill_count = {};
+        /// @brief Bytes lost to alignment and to skipped tail space when the ring wraps around.
+        u64 wasted_padding = {};
+        u32 spill_block_count = {};
+    };
+
+    /// @brief  Ring buffer based transfer memory allocator for easy and efficient cpu gpu communication.
+    ///         With spilling enabled, allocations that do not fit the ring are placed in extra buffer blocks, see RingBufferInfo::max_spill_blocks.
+    ///         Always use Allocation::buffer instead of buffer() when spilling is enabled.
     struct RingBuffer
     {
         DAXA_EXPORT_CXX RingBuffer(RingBufferInfo a_info);
@@ -36,6 +62,8 @@ namespace daxa
             u32 buffer_offset = {};
             usize size = {};
             u64 submit_index = {};
+            /// @brief Either the ring buffer or a spill block. buffer_offset is relative to this buffer.
+            daxa::BufferId buffer = {};
         };
         /// @return returns an Allocation if successful, otherwise returns std::nullopt.
         DAXA_EXPORT_CXX auto allocate(u32 size, u32 alignment_requirement = 16 /* 16 is a save default for most gpu data*/) -> std::optional<Allocation>;
@@ -52,12 +80,20 @@ namespace daxa
             }
             return std::nullopt;
         }
+        /// @brief  Writes the draw commands tightly packed into a new allocation.
+        ///         DrawInfo and DrawIndexedInfo have the layout of the vulkan indirect commands, so they are copied as is.
+        /// @return returns a DrawIndirectInfo drawing all commands with a single draw_indirect call if successful, otherwise returns std::nullopt.
+        DAXA_EXPORT_CXX auto allocate_draw_commands(daxa::Span<DrawInfo const> const & draws) -> std::optional<DrawIndirectInfo>;
+        DAXA_EXPORT_CXX auto allocate_draw_commands(daxa::Span<DrawIndexedInfo const> const & draws) -> std::optional<DrawIndirectInfo>;
         
         DAXA_EXPORT_CXX auto buffer() const -> daxa::BufferId;
         /// THREADSAFETY:
         /// * reference MUST NOT be read after the object is destroyed.
         /// @return reference to info of object.
         DAXA_EXPORT_CXX auto info() const -> RingBufferInfo const &;
+        /// @return number of successful allocations made over the lifetime of the ring buffer.
+        DAXA_EXPORT_CXX auto allocation_count() const -> u64;
+        DAXA_EXPORT_CXX auto statistics() const -> RingBufferStatistics;
 
         /// @brief Marks ALL allocations made prior to calling this function as reclaimable.
         ///        Memory will be reclaimed ONLY AFTER all currently pending submits have completed execution on the GPU.
@@ -66,14 +102,27 @@ namespace daxa
 
       private:
         DAXA_EXPORT_CXX auto allocate_internal(u32 size, u32 alignment_requirement, bool try_again_on_fail) -> std::optional<Allocation>;
+        DAXA_EXPORT_CXX auto allocate_spill(u32 size, u32 alignment_requirement) -> std::optional<Allocation>;
         // Reclaim expired memory allocations.
         DAXA_EXPORT_CXX void reclaim_memory();
+        DAXA_EXPORT_CXX void release_spill_blocks();
         struct TrackedAllocation
         {
             usize submit_index = {};
             u32 offset = {};
             u32 size = {};
         };
+        struct SpillBlock
+        {
+            BufferId buffer = {};
+            daxa::DeviceAddress device_address = {};
+            void * host_address = {};
+            u32 size = {};
+            u32 head = {};
+            // Set when the block is retired in reuse_memory_after_pending_submits, the block is reset once the submit completed.
+            bool retired = {};
+            u64 retire_submit_index = {};
+        };
 
         // used to mark allocations and when we can free them.
         // We can free all allocations before this index.
@@ -81,12 +130,325 @@ namespace daxa
 
         RingBufferInfo m_info = {};
         std::deque<TrackedAllocation> live_allocations = {};
+        // Number of allocations at the front of live_allocations that were retired by reuse_memory_after_pending_submits.
+        usize retired_allocation_count = {};
         BufferId m_buffer = {};
         daxa::DeviceAddress buffer_device_address = {};
         void * buffer_host_address = {};
         u32 claimed_start = {};
         u32 claimed_size = {};
+        u64 m_allocation_count = {};
+        std::vector<SpillBlock> spill_blocks = {};
+        u64 spill_bytes_in_use = {};
+        bool spilled_since_reuse = {};
+        u32 quiet_frames = {};
+        RingBufferStatistics m_statistics = {};
     };
     
     using TransferMemoryPool = RingBuffer;
+
+    struct StagingAllocatorInfo
+    {
+        Device device = {};
+        /// @brief Maximum size of a single allocation.
+        u32 block_size = 1 << 20;
+        u32 block_count = 32;
+        bool prefer_device_memory = true;
+        std::string name = {};
+    };
+
+    /// @brief  Thread safe transfer memory allocator for uploading from many threads.
+    ///         The backing buffer is split into fixed size blocks. Threads are spread over shards, each shard bump allocates lock free inside its current block.
+    ///         Only handing out a new block to a shard takes a lock.
+    ///         Blocks are reclaimed by submit index, like the allocations of a RingBuffer.
+    struct StagingAllocator
+    {
+        DAXA_EXPORT_CXX StagingAllocator(StagingAllocatorInfo a_info);
+        StagingAllocator(StagingAllocator const &) = delete;
+        StagingAllocator & operator=(StagingAllocator const &) = delete;
+        DAXA_EXPORT_CXX ~StagingAllocator();
+
+        struct Allocation
+        {
+            daxa::DeviceAddress device_address = {};
+            void * host_address = {};
+            u32 buffer_offset = {};
+            usize size = {};
+        };
+        /// THREADSAFETY:
+        /// * can be called from any number of threads concurrently.
+        /// @return returns an Allocation if successful, otherwise returns std::nullopt.
+        DAXA_EXPORT_CXX auto allocate(u32 size, u32 alignment_requirement = 16) -> std::optional<Allocation>;
+        /// @brief  Allocates a section of a buffer with the size of T, writes the given T to the allocation.
+        /// @return returns an Allocation if successful, otherwise returns std::nullopt.
+        template <typename T>
+        auto allocate_fill(T const & value, u32 alignment_requirement = alignof(T)) -> std::optional<Allocation>
+        {
+            auto allocation_o = allocate(sizeof(T), alignment_requirement);
+            if (allocation_o.has_value())
+            {
+                *reinterpret_cast<T *>(allocation_o->host_address) = value;
+                return allocation_o.value();
+            }
+            return std::nullopt;
+        }
+
+        DAXA_EXPORT_CXX auto buffer() const -> daxa::BufferId;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> StagingAllocatorInfo const &;
+        /// @return number of successful allocations made over the lifetime of the allocator.
+        DAXA_EXPORT_CXX auto allocation_count() const -> u64;
+
+        /// @brief  Marks ALL allocations made prior to calling this function as reclaimable.
+        ///         Memory will be reclaimed ONLY AFTER all currently pending submits have completed execution on the GPU.
+        ///         Easiest way to use this is to call it at the end of a frame, so that all allocations made during the frame can be reclaimed.
+        /// THREADSAFETY:
+        /// * MUST NOT be called concurrently with allocate.
+        DAXA_EXPORT_CXX void reuse_memory_after_pending_submits();
+        /// @brief  reuse_memory_after_pending_submits split in two, so that other threads can keep allocating while the allocations are submitted.
+        ///         close_blocks ends all allocations made prior to calling it and returns the blocks holding them.
+        ///         retire_blocks marks these blocks as reclaimable after all then pending submits completed, call it after submitting.
+        /// THREADSAFETY:
+        /// * close_blocks MUST NOT be called concurrently with allocate.
+        /// * retire_blocks can be called concurrently with allocate.
+        DAXA_EXPORT_CXX auto close_blocks() -> std::vector<u32>;
+        DAXA_EXPORT_CXX void retire_blocks(std::vector<u32> const & blocks);
+
+      private:
+        static constexpr u32 SHARD_COUNT = 16;
+        static constexpr u32 NO_BLOCK = ~0u;
+
+        struct alignas(64) Shard
+        {
+            std::mutex mtx = {};
+            std::atomic<u32> block = NO_BLOCK;
+        };
+
+        struct RetiredBlock
+        {
+            u64 submit_index = {};
+            u32 block = {};
+        };
+
+        // Returns NO_BLOCK when all blocks are in use, even after reclaiming.
+        DAXA_EXPORT_CXX auto acquire_block() -> u32;
+        // Reclaim blocks whose submits have completed.
+        DAXA_EXPORT_CXX void reclaim_blocks();
+
+        StagingAllocatorInfo m_info = {};
+        BufferId m_buffer = {};
+        daxa::DeviceAddress buffer_device_address = {};
+        void * buffer_host_address = {};
+        std::unique_ptr<std::atomic<u32>[]> block_heads = {};
+        std::array<Shard, SHARD_COUNT> shards = {};
+        std::atomic<u64> m_allocation_count = {};
+        // Guards the block lists below.
+        std::mutex block_mtx = {};
+        std::vector<u32> free_blocks = {};
+        // Blocks filled up since the last reuse_memory_after_pending_submits.
+        std::vector<u32> filled_blocks = {};
+        std::deque<RetiredBlock> retired_blocks = {};
+    };
+
+    struct UploadQueueInfo
+    {
+        Device device = {};
+        /// @brief  Uploads are submitted to this queue.
+        ///         A transfer queue keeps uploads off the main queue on devices that have one.
+        Queue queue = QUEUE_MAIN;
+        /// @brief Image uploads can not be larger than a staging block, buffer uploads are split.
+        u32 staging_block_size = 1 << 22;
+        u32 staging_block_count = 16;
+        std::string name = {};
+    };
+
+    struct BufferUploadInfo
+    {
+        void const * data = {};
+        usize size = {};
+        BufferId dst_buffer = {};
+        usize dst_offset = {};
+    };
+
+    /// @brief The image must be in the general layout when the uploads are executed.
+    struct ImageUploadInfo
+    {
+        void const * data = {};
+        /// @brief Must be the size of the tightly packed region, image_extent in texel blocks times layer count times texel block size.
+        usize size = {};
+        ImageId dst_image = {};
+        ImageArraySlice image_slice = {};
+        Offset3D image_offset = {};
+        Extent3D image_extent = {};
+    };
+
+    struct UploadQueueStatistics
+    {
+        u64 upload_count = {};
+        /// @brief Number of recorded copy commands, adjacent buffer uploads are coalesced into one copy.
+        u64 copy_command_count = {};
+        u64 flush_count = {};
+    };
+
+    /// @brief  Batches host to gpu uploads from any number of threads.
+    ///         Data is written into a StagingAllocator when it is queued.
+    ///         flush records all queued uploads into one command list, coalescing buffer uploads that are adjacent in both staging and destination memory.
+    ///         Overlapping uploads are applied in the order they were queued.
+    struct UploadQueue
+    {
+        DAXA_EXPORT_CXX UploadQueue(UploadQueueInfo a_info);
+        UploadQueue(UploadQueue const &) = delete;
+        UploadQueue & operator=(UploadQueue const &) = delete;
+        DAXA_EXPORT_CXX ~UploadQueue();
+
+        /// THREADSAFETY:
+        /// * can be called from any number of threads concurrently, also while another thread flushes.
+        /// @return false when the staging memory ran out, flush and wait for the uploads to complete before retrying.
+        ///         A failed upload queues nothing, also when it was split and some of its pieces were already staged.
+        DAXA_EXPORT_CXX auto upload(BufferUploadInfo const & info) -> bool;
+        DAXA_EXPORT_CXX auto upload(ImageUploadInfo const & info) -> bool;
+
+        /// @brief  Records and submits all queued uploads.
+        /// @return timeline value of timeline_semaphore() that is signaled once the uploads completed.
+        ///         When nothing was queued, the value of the previous flush is returned.
+        DAXA_EXPORT_CXX auto flush() -> u64;
+
+        DAXA_EXPORT_CXX auto timeline_semaphore() const -> TimelineSemaphore const &;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> UploadQueueInfo const &;
+        DAXA_EXPORT_CXX auto statistics() const -> UploadQueueStatistics;
+
+      private:
+        struct PendingBufferCopy
+        {
+            // Order in which the upload was queued, later uploads win where they overlap.
+            u64 sequence = {};
+            usize src_offset = {};
+            BufferId dst_buffer = {};
+            usize dst_offset = {};
+            usize size = {};
+        };
+
+        struct PendingImageCopy
+        {
+            usize src_offset = {};
+            ImageId dst_image = {};
+            ImageArraySlice image_slice = {};
+            Offset3D image_offset = {};
+            Extent3D image_extent = {};
+        };
+
+        UploadQueueInfo m_info = {};
+        StagingAllocator staging;
+        TimelineSemaphore timeline = {};
+        u64 timeline_value = {};
+        // Uploads hold it shared, flush holds it exclusively while it takes the queued copies and closes their staging blocks.
+        std::shared_mutex flush_mtx = {};
+        // Serializes flushes, held while recording and submitting.
+        std::mutex submit_mtx = {};
+        // Guards the pending copies and statistics.
+        mutable std::mutex pending_mtx = {};
+        std::vector<PendingBufferCopy> pending_buffer_copies = {};
+        std::vector<PendingImageCopy> pending_image_copies = {};
+        u64 upload_sequence = {};
+        UploadQueueStatistics m_statistics = {};
+    };
+
+    struct TextureStreamerInfo
+    {
+        Device device = {};
+        /// @brief Staged uploads are submitted to this queue.
+        Queue queue = QUEUE_MAIN;
+        /// @brief Staging memory for devices or images without host image copy support.
+        u32 staging_capacity = 1 << 26;
+        /// @brief Textures larger than the staging ring spill into extra blocks, see RingBufferInfo::max_spill_blocks.
+        u32 max_staging_spill_blocks = 4;
+        /// @brief When false, all uploads take the staging path. Useful to compare both paths.
+        bool prefer_host_image_copy = true;
+        std::string name = {};
+    };
+
+    /// @brief  Texel data of one mip level, containing all uploaded array layers tightly packed.
+    ///         size must match the mip extent in texel blocks times the layer count times the texel block size.
+    struct TextureMipData
+    {
+        std::byte const * data = {};
+        usize size = {};
+    };
+
+    struct TextureUploadInfo
+    {
+        ImageId image = {};
+        u32 base_mip_level = {};
+        u32 base_array_layer = {};
+        u32 layer_count = 1;
+        /// @brief mips[i] is uploaded to mip level base_mip_level + i.
+        daxa::Span<TextureMipData const> mips = {};
+        /// @brief  Transitions the image from undefined to the general layout before uploading, discarding its previous contents.
+        ///         Otherwise the image must already be in the general layout.
+        bool initialize_layout = {};
+    };
+
+    struct TextureStreamerStatistics
+    {
+        u64 host_copy_uploads = {};
+        u64 host_copy_bytes = {};
+        u64 staged_uploads = {};
+        u64 staged_bytes = {};
+    };
+
+    /// @brief  Uploads textures with all their mips and array layers in one call.
+    ///         Images created with ImageUsageFlagBits::HOST_TRANSFER are written directly from the host with host image copy, when the device supports it.
+    ///         Host copied uploads are complete when upload returns, no gpu work or staging memory is needed.
+    ///         All other uploads are staged through a RingBuffer and recorded in the next flush.
+    struct TextureStreamer
+    {
+        DAXA_EXPORT_CXX TextureStreamer(TextureStreamerInfo a_info);
+        TextureStreamer(TextureStreamer const &) = delete;
+        TextureStreamer & operator=(TextureStreamer const &) = delete;
+        DAXA_EXPORT_CXX ~TextureStreamer();
+
+        /// THREADSAFETY:
+        /// * can be called from any number of threads concurrently. Host copies run in parallel, staging is serialized.
+        /// @return false when the image is invalid, a mip has the wrong size or the staging memory ran out. A failed upload stages none of its mips.
+        DAXA_EXPORT_CXX auto upload(TextureUploadInfo const & info) -> bool;
+        /// @return true when uploads to this image take the host image copy path.
+        DAXA_EXPORT_CXX auto uses_host_image_copy(ImageId image) const -> bool;
+
+        /// @brief  Records and submits all staged uploads.
+        /// @return timeline value of timeline_semaphore() that is signaled once the staged uploads completed.
+        ///         When nothing was staged, the value of the previous flush is returned.
+        DAXA_EXPORT_CXX auto flush() -> u64;
+
+        DAXA_EXPORT_CXX auto timeline_semaphore() const -> TimelineSemaphore const &;
+        /// THREADSAFETY:
+        /// * reference MUST NOT be read after the object is destroyed.
+        /// @return reference to info of object.
+        DAXA_EXPORT_CXX auto info() const -> TextureStreamerInfo const &;
+        DAXA_EXPORT_CXX auto statistics() const -> TextureStreamerStatistics;
+
+      private:
+        struct StagedMipCopy
+        {
+            BufferId src_buffer = {};
+            u32 src_offset = {};
+            ImageId image = {};
+            ImageArraySlice image_slice = {};
+            Extent3D image_extent = {};
+        };
+
+        TextureStreamerInfo m_info = {};
+        RingBuffer staging;
+        TimelineSemaphore timeline = {};
+        u64 timeline_value = {};
+        // Guards staging, the staged copies and statistics.
+        mutable std::mutex mtx = {};
+        std::vector<ImageId> staged_layout_initializations = {};
+        std::vector<StagedMipCopy> staged_copies = {};
+        TextureStreamerStatistics m_statistics = {};
+    };
 } // namespace daxa
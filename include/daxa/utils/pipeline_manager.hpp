@@ -104,6 +104,9 @@ namespace daxa
         std::optional<std::filesystem::path> write_out_preprocessed_code = {};
         std::optional<std::filesystem::path> write_out_spirv = {};
         std::optional<std::filesystem::path> spirv_cache_folder = {};
+        // When set, the device pipeline cache is loaded from this file on creation and written back on destruction.
+        // Files written by a different gpu or driver version are ignored and overwritten.
+        std::optional<std::filesystem::path> pipeline_cache_file = {};
         bool register_null_pipelines_when_first_compile_fails = false;
         std::function<void(std::string &, std::filesystem::path const & path)> custom_preprocessor = {};
         std::optional<std::string> default_entry_point = {};
@@ -154,6 +157,16 @@ namespace daxa
         std::vector<Result<std::shared_ptr<RayTracingPipeline>>> ray_tracing = {};
     };
 
+    // Where the spirv of every shader stage requested since the pipeline manager was created came from.
+    struct PipelineManagerStageCacheStats
+    {
+        // Reused from an identical stage (same source, compile options and unchanged includes) compiled earlier in this run.
+        u32 memory_hits = {};
+        // Loaded from the spirv_cache_folder.
+        u32 disk_hits = {};
+        u32 compiles = {};
+    };
+
     struct PipelineReloadSuccess
     {
     };
@@ -184,12 +197,23 @@ namespace daxa
             PipelineManagerParallelInfo parallel_info) -> PipelineCompileBatch;
         // Like reload_all() but compiles changed pipelines in parallel using the supplied executor.
         auto reload_all_parallel(PipelineManagerParallelInfo parallel_info) -> PipelineReloadResult;
+        // Non-blocking reload_all(), meant to be called once per frame from the thread using the pipelines.
+        // Changed pipelines are recompiled on a background thread (fanned out over the executor when one is given),
+        // while the current pipelines stay valid and in use. A later poll_reloads call swaps all finished pipelines in at once,
+        // so pipelines only ever change during poll_reloads. The executor must stay valid until the reload finished.
+        // All other calls wait for a running background reload first; reload_all and reload_all_parallel also apply its results.
+        auto poll_reloads(PipelineManagerParallelInfo parallel_info = {}) -> PipelineReloadResult;
+        auto reload_in_progress() const -> bool;
         void remove_ray_tracing_pipeline(std::shared_ptr<RayTracingPipeline> const & pipeline);
         void remove_compute_pipeline(std::shared_ptr<ComputePipeline> const & pipeline);
         void remove_raster_pipeline(std::shared_ptr<RasterPipeline> const & pipeline);
         void add_virtual_file(VirtualFileInfo const & info);
         auto reload_all() -> PipelineReloadResult;
         auto all_pipelines_valid() const -> bool;
+        // Writes the device pipeline cache to info.pipeline_cache_file immediately, does nothing if no file is set.
+        // Useful to persist the cache right after startup compilation instead of waiting for destruction.
+        void save_pipeline_cache() const;
+        auto stage_cache_stats() const -> PipelineManagerStageCacheStats;
 
       protected:
         template <typename T, typename H_T>
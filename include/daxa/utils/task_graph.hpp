@@ -39,6 +39,30 @@ namespace daxa
 
     [[nodiscard]] DAXA_EXPORT_CXX auto to_string(TaskResourceLifetimeType lifetime_type) -> std::string_view;
 
+    enum struct TaskResourceAliasingStrategy
+    {
+        /// @brief  Places resources sorted by lifetime length at the lowest offset that does not collide.
+        FIRST_FIT,
+        /// @brief  Places resources sorted by size into the smallest hole between lifetime colliding resources.
+        ///         Typically leaves fewer unused holes and produces a smaller resource memory block.
+        BEST_FIT,
+        MAX_ENUM,
+    };
+
+    [[nodiscard]] DAXA_EXPORT_CXX auto to_string(TaskResourceAliasingStrategy strategy) -> std::string_view;
+
+    struct TaskResourceMemoryReport
+    {
+        bool aliasing_enabled = {};
+        TaskResourceAliasingStrategy aliasing_strategy = {};
+        /// @brief  Size of the resource memory block the graph allocated.
+        u64 resource_memory_block_size = {};
+        /// @brief  Size the resource memory block would have without any aliasing.
+        u64 non_aliased_size = {};
+        /// @brief  Size the resource memory block would have with each aliasing strategy. Index with TaskResourceAliasingStrategy.
+        std::array<u64, static_cast<u32>(TaskResourceAliasingStrategy::MAX_ENUM)> aliasing_strategy_sizes = {};
+    };
+
     struct TaskBufferInfo
     {
         u64 size = {};
@@ -60,6 +84,27 @@ namespace daxa
         std::string_view name = {};
     };
 
+    // Generic parallel executor interface for command recording.
+    // daxa does not depend on any specific thread pool implementation.
+    // user_data: arbitrary pointer forwarded to blocking_parallel_for (e.g. a ThreadPool*).
+    // blocking_parallel_for: must call task_fn(task_user_data, i, thread_index) for every i in [0, count),
+    //   optionally from multiple threads, and MUST block until all invocations complete.
+    //   thread_index identifies which worker executed the task (implementation-defined, e.g. 0..N-1).
+    struct TaskGraphParallelRecordInfo
+    {
+        void * user_data = {};
+        void (*blocking_parallel_for)(
+            void * user_data,
+            u32 count,
+            void * task_user_data,
+            void (*task_fn)(void * task_user_data, u32 task_index, u32 thread_index)) = {};
+        // Every thread_index passed to task_fn must be smaller than this.
+        // Tasks passed a larger thread_index are recorded on the calling thread instead, after blocking_parallel_for returned.
+        // Each worker gets its own staging memory pool of TaskGraphInfo::staging_memory_pool_size bytes,
+        // so the graph allocates (worker_thread_count + 1) * staging_memory_pool_size bytes of staging memory in total.
+        u32 worker_thread_count = 0;
+    };
+
     struct TaskGraphInfo
     {
         Device device = {};
@@ -74,6 +119,8 @@ namespace daxa
         bool optimize_transient_lifetimes = true;
         /// @brief  Allows task graph to alias transient resources memory (ofc only when that wont break the program)
         bool alias_transients = {};
+        /// @brief  Strategy used to place resources within the resource memory block when alias_transients is enabled.
+        TaskResourceAliasingStrategy aliasing_strategy = TaskResourceAliasingStrategy::FIRST_FIT;
         /// @brief  Task graph will put performance markers that are used by profilers like nsight around each tasks execution by default.
         bool enable_command_labels = true;
         std::array<f32, 4> task_graph_label_color = {0.463f, 0.333f, 0.671f, 1.0f};
@@ -82,6 +129,16 @@ namespace daxa
         /// @brief  AMD gpus of the generations RDNA3 and RDNA4 have hardware bugs that make image barriers still useful for cache flushes.
         ///         This boolean makes task graph insert image barriers for image sync instead of global barriers to help the drivers out.
         bool amd_rdna3_4_image_barrier_fix = true;
+        /// @brief  Access groups on the same queue that are separated by one or more batches are synchronized with split barriers (events).
+        ///         The signal is recorded right after the last batch of the earlier access and the wait right before the first batch of the later access.
+        ///         This lets the gpu overlap the batches in between with the dependency. Transfer queues do not support events and always use pipeline barriers.
+        bool use_split_barriers = true;
+        /// @brief  Each queue within a submit only waits on the earlier submits and queues it depends on through resource accesses or memory aliasing.
+        ///         This lets independent async compute work overlap with other queues across submits.
+        ///         Queues accessing graph owned resources also wait on the queues of the previous execution, as these resources persist or alias across executions.
+        ///         Dependencies that are invisible to the graph, for example untracked resources, are NOT synchronized.
+        ///         When disabled, every submit waits on all queues used in the previous submit.
+        bool fine_grained_queue_sync = false;
         /// @brief  Sets the size of the linear allocator of device local, host visible memory used by the linear staging allocator.
         ///         This memory is used internally as well as by tasks via the TaskInterface::get_allocator().
         ///         Setting the size to 0, disables a few task list features but also eliminates the memory allocation.
@@ -93,6 +150,21 @@ namespace daxa
         // Useful for reflection/ debugging.
         std::function<void(TaskInterface)> pre_task_callback = {};
         std::function<void(TaskInterface)> post_task_callback = {};
+        /// @brief  Opt-in multi threaded command recording.
+        ///         When blocking_parallel_for is set, each batch of each queue within a submit is recorded into its own command list concurrently.
+        ///         The command lists are still submitted in the same fixed order as with serial recording.
+        ///         All task callbacks, pre_task_callback and post_task_callback must be safe to call concurrently.
+        ///         Each worker thread gets its own TaskInterface::allocator, each of them staging_memory_pool_size large.
+        ///         Recording falls back to serial recording while a debug ui has active resource viewers.
+        TaskGraphParallelRecordInfo parallel_recording = {};
+        /// @brief  Opt-in reuse of recorded command lists between executions.
+        ///         Each submit is fingerprinted by the ids of the external and double buffered resources it accesses,
+        ///         its image initializations and clears and ExecutionInfo::recording_fingerprint.
+        ///         When the fingerprint of a submit matches a previous recording, the cached command lists are submitted again and the task callbacks are NOT called.
+        ///         Task callbacks must only depend on their attachments and on inputs covered by ExecutionInfo::recording_fingerprint.
+        ///         Submits that use the TaskInterface::allocator or are recorded while a debug ui has active resource viewers are never cached.
+        ///         Cached command lists are reusable, secondary command lists executed by task callbacks must be created with SecondaryCommandRecorderInfo::reusable.
+        bool enable_recording_cache = {};
         Queue default_queue = QUEUE_MAIN;
         std::string_view name = {};
     };
@@ -124,6 +196,10 @@ namespace daxa
         TaskGraphDebugUi * debug_ui = {};
         std::span<bool> permutation_condition_values = {};
         bool record_debug_string = {};
+        /// @brief  Only used with TaskGraphInfo::enable_recording_cache.
+        ///         Hash of all inputs to task callbacks that are invisible to the task graph, for example push constant values or captured pointers.
+        ///         Changing the value forces all submits to be re-recorded.
+        u64 recording_fingerprint = {};
     };
 
     /*
@@ -966,6 +1042,7 @@ namespace daxa
         DAXA_EXPORT_CXX void present(TaskPresentInfo const & info);
 
         // TODO: make move only. Return ExecutableTaskGraph.
+        // Calling complete on an already completed graph is only allowed after resizing resources.
         DAXA_EXPORT_CXX void complete(TaskCompleteInfo const & info);
 
         DAXA_EXPORT_CXX void execute(ExecutionInfo const & info);
@@ -975,7 +1052,17 @@ namespace daxa
         DAXA_EXPORT_CXX void request_persistent_buffer_clear(TaskBufferView const & task_buffer);
         DAXA_EXPORT_CXX void request_persistent_image_clear(TaskImageView const & task_image);
 
+        // Graph owned resources can be resized after the graph was completed, for example on a resolution change.
+        // Resizes are applied with the next call to complete(), which then only re-runs the resource allocation and creation.
+        // The resource memory block is kept when the new allocations still fit into it.
+        // Persistent resources that are moved without being resized keep their contents, they are copied over in the next execution.
+        // Only resized persistent resources lose their contents and are cleared before the next execution.
+        DAXA_EXPORT_CXX void resize_task_buffer(TaskBufferView const & task_buffer, u64 size);
+        DAXA_EXPORT_CXX void resize_task_image(TaskImageView const & task_image, Extent3D const & size);
+
         DAXA_EXPORT_CXX auto get_resource_memory_block_size() -> usize;
+        // Reports the resource memory block size and the sizes every aliasing strategy would produce for this graph.
+        DAXA_EXPORT_CXX auto get_resource_memory_report() -> TaskResourceMemoryReport;
 
       protected:
         template <typename T, typename H_T>
@@ -34,6 +34,7 @@ DAXA_ASSERT_INFO_SAME_SIZE(BufferTlasInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(ChooseSwapchainSurfaceFormatInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(CommandLabelInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(CommandRecorderInfo);
+DAXA_ASSERT_INFO_SAME_SIZE(CommandRecorderStatistics);
 DAXA_ASSERT_INFO_SAME_SIZE(CommandSubmitInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(ComputePipelineInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(ConservativeRasterInfo);
@@ -51,6 +52,7 @@ DAXA_ASSERT_INFO_SAME_SIZE(DrawMeshTasksInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(EventInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(EventSignalInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(EventWaitInfo);
+DAXA_ASSERT_INFO_SAME_SIZE(GarbageCollectionInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(HostImageLayoutOperationInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(ImageBarrierInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(ImageBlitInfo);
@@ -78,6 +80,7 @@ DAXA_ASSERT_INFO_SAME_SIZE(RenderPassBeginInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(ResetEventInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(ResetTimestampsInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(SamplerInfo);
+DAXA_ASSERT_INFO_SAME_SIZE(SecondaryCommandRecorderInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(SetIndexBufferInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(ShaderInfo);
 DAXA_ASSERT_INFO_SAME_SIZE(SwapchainInfo);
@@ -227,6 +230,12 @@ auto daxa_result_to_string(daxa_Result result) -> std::string_view
     case DAXA_RESULT_ERROR_WAYLAND_FAILED_TO_CREATE_SURFACE: return "DAXA_RESULT_ERROR_WAYLAND_FAILED_TO_CREATE_SURFACE";
     case DAXA_RESULT_ERROR_QUEUE_DOES_NOT_SUPPORT_SURFACE: return "DAXA_RESULT_ERROR_QUEUE_DOES_NOT_SUPPORT_SURFACE";
     case DAXA_RESULT_ERROR_INVALID_POINTER_PARAMETER: return "DAXA_RESULT_ERROR_INVALID_POINTER_PARAMETER";
+    case DAXA_RESULT_ERROR_SECONDARY_CMD_LIST_SUBMITTED: return "DAXA_RESULT_ERROR_SECONDARY_CMD_LIST_SUBMITTED";
+    case DAXA_RESULT_ERROR_CMD_LIST_NOT_EXECUTABLE_AS_SECONDARY: return "DAXA_RESULT_ERROR_CMD_LIST_NOT_EXECUTABLE_AS_SECONDARY";
+    case DAXA_RESULT_ERROR_RENDERPASS_DOES_NOT_ALLOW_SECONDARY_CMD_LISTS: return "DAXA_RESULT_ERROR_RENDERPASS_DOES_NOT_ALLOW_SECONDARY_CMD_LISTS";
+    case DAXA_RESULT_ERROR_INVALID_CMD_ON_SECONDARY_CMD_LIST: return "DAXA_RESULT_ERROR_INVALID_CMD_ON_SECONDARY_CMD_LIST";
+    case DAXA_RESULT_ERROR_INCOMPATIBLE_PIPELINE_CACHE_DATA: return "DAXA_RESULT_ERROR_INCOMPATIBLE_PIPELINE_CACHE_DATA";
+    case DAXA_RESULT_ERROR_SECONDARY_CMD_LIST_NOT_REUSABLE: return "DAXA_RESULT_ERROR_SECONDARY_CMD_LIST_NOT_REUSABLE";
     case DAXA_RESULT_MAX_ENUM: return "UNKNOWN";
     default: return "UNKNOWN";
     }
@@ -449,6 +458,50 @@ namespace daxa
         return {};                                                    \
     }
 
+    void Device::create_buffers(std::span<BufferInfo const> infos, std::span<BufferId> out_ids)
+    {
+        DAXA_DBG_ASSERT_TRUE_M(out_ids.size() >= infos.size(), "out_ids must be at least as large as infos");
+        check_result(
+            daxa_dvc_create_buffers(
+                r_cast<daxa_Device>(this->object),
+                r_cast<daxa_BufferInfo const *>(infos.data()),
+                static_cast<u32>(infos.size()),
+                r_cast<daxa_BufferId *>(out_ids.data())),
+            "failed to create buffers");
+    }
+
+    void Device::create_images(std::span<ImageInfo const> infos, std::span<ImageId> out_ids)
+    {
+        DAXA_DBG_ASSERT_TRUE_M(out_ids.size() >= infos.size(), "out_ids must be at least as large as infos");
+        check_result(
+            daxa_dvc_create_images(
+                r_cast<daxa_Device>(this->object),
+                r_cast<daxa_ImageInfo const *>(infos.data()),
+                static_cast<u32>(infos.size()),
+                r_cast<daxa_ImageId *>(out_ids.data())),
+            "failed to create images");
+    }
+
+    void Device::destroy_buffers(std::span<BufferId const> buffers)
+    {
+        check_result(
+            daxa_dvc_destroy_buffers(
+                r_cast<daxa_Device>(this->object),
+                r_cast<daxa_BufferId const *>(buffers.data()),
+                static_cast<u32>(buffers.size())),
+            "invalid resource id");
+    }
+
+    void Device::destroy_images(std::span<ImageId const> images)
+    {
+        check_result(
+            daxa_dvc_destroy_images(
+                r_cast<daxa_Device>(this->object),
+                r_cast<daxa_ImageId const *>(images.data()),
+                static_cast<u32>(images.size())),
+            "invalid resource id");
+    }
+
     auto Device::create_buffer_from_memory_block(MemoryBlockBufferInfo const & info) -> BufferId
     {
         BufferId id = {};
@@ -621,6 +674,17 @@ namespace daxa
         return ret;
     }
 
+    auto Device::create_secondary_command_recorder(SecondaryCommandRecorderInfo const & info) -> RenderCommandRecorder
+    {
+        RenderCommandRecorder ret = {};
+        check_result(daxa_dvc_create_secondary_command_recorder(
+                         r_cast<daxa_Device>(this->object),
+                         r_cast<daxa_SecondaryCommandRecorderInfo const *>(&info),
+                         r_cast<daxa_CommandRecorder *>(&ret)),
+                     "failed to create secondary command recorder");
+        return ret;
+    }
+
     using daxa_RayTracingPipelineLibraryInfo = daxa_RayTracingPipelineInfo;
     using RayTracingPipelineLibraryInfo = RayTracingPipelineInfo;
 
@@ -737,11 +801,50 @@ namespace daxa
             "failed to collect garbage");
     }
 
+    auto Device::collect_garbage(GarbageCollectionInfo const & info) -> GarbageCollectionResult
+    {
+        daxa_GarbageCollectionResult result = {};
+        check_result(
+            daxa_dvc_collect_garbage_budgeted(
+                r_cast<daxa_Device>(this->object),
+                r_cast<daxa_GarbageCollectionInfo const *>(&info),
+                &result),
+            "failed to collect garbage");
+        return GarbageCollectionResult{
+            .collected_objects = result.collected_objects,
+            .all_collected = result.all_collected != 0,
+        };
+    }
+
     auto Device::properties() const -> DeviceProperties const &
     {
         return *r_cast<DeviceProperties const *>(daxa_dvc_properties(rc_cast<daxa_Device>(object)));
     }
 
+    auto Device::pipeline_cache_data() const -> std::vector<std::byte>
+    {
+        std::vector<std::byte> data = {};
+        // The cache can grow between the size query and the copy when pipelines are created concurrently.
+        daxa_Result result = DAXA_RESULT_INCOMPLETE;
+        while (result == DAXA_RESULT_INCOMPLETE)
+        {
+            usize size = {};
+            check_result(daxa_dvc_get_pipeline_cache_data(rc_cast<daxa_Device>(object), &size, nullptr), "failed to query pipeline cache data size");
+            data.resize(size);
+            result = daxa_dvc_get_pipeline_cache_data(rc_cast<daxa_Device>(object), &size, data.data());
+            check_result(result, "failed to get pipeline cache data", std::array{DAXA_RESULT_SUCCESS, DAXA_RESULT_INCOMPLETE});
+            data.resize(size);
+        }
+        return data;
+    }
+
+    auto Device::load_pipeline_cache(Span<std::byte const> const & data) -> bool
+    {
+        auto result = daxa_dvc_load_pipeline_cache(r_cast<daxa_Device>(object), data.data(), data.size());
+        check_result(result, "failed to load pipeline cache", std::array{DAXA_RESULT_SUCCESS, DAXA_RESULT_ERROR_INCOMPATIBLE_PIPELINE_CACHE_DATA});
+        return result == DAXA_RESULT_SUCCESS;
+    }
+
     auto Device::get_supported_present_modes(NativeWindowInfo native_window_info) const -> std::vector<PresentMode>
     {
         auto const c_native_window_info = std::bit_cast<daxa_NativeWindowInfo>(native_window_info);
@@ -1218,6 +1321,23 @@ namespace daxa
         return ret;
     }
 
+    void RenderCommandRecorder::execute_commands(daxa::Span<ExecutableCommandList const> const & commands)
+    {
+        auto result = daxa_cmd_execute_commands(
+            this->internal,
+            r_cast<daxa_ExecutableCommandList const *>(commands.data()),
+            commands.size());
+        check_result(result, "failed in execute_commands");
+    }
+
+    auto RenderCommandRecorder::complete_current_commands() -> ExecutableCommandList
+    {
+        ExecutableCommandList ret = {};
+        auto result = daxa_cmd_complete_current_commands(this->internal, r_cast<daxa_ExecutableCommandList *>(&ret));
+        check_result(result, "failed to complete current commands");
+        return ret;
+    }
+
     void RenderCommandRecorder::set_viewport(ViewportInfo const & info)
     {
         daxa_cmd_set_viewport(
@@ -1242,6 +1362,23 @@ namespace daxa
     DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER_CHECK_RESULT(set_index_buffer, SetIndexBufferInfo)
     DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER(draw, DrawInfo)
     DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER(draw_indexed, DrawIndexedInfo)
+
+    void RenderCommandRecorder::draw_many(daxa::Span<DrawInfo const> const & infos)
+    {
+        daxa_cmd_draw_many(
+            this->internal,
+            r_cast<daxa_DrawInfo const *>(infos.data()),
+            static_cast<u32>(infos.size()));
+    }
+
+    void RenderCommandRecorder::draw_indexed_many(daxa::Span<DrawIndexedInfo const> const & infos)
+    {
+        daxa_cmd_draw_indexed_many(
+            this->internal,
+            r_cast<daxa_DrawIndexedInfo const *>(infos.data()),
+            static_cast<u32>(infos.size()));
+    }
+
     DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER_CHECK_RESULT(draw_indirect, DrawIndirectInfo)
     DAXA_DECL_RENDER_COMMAND_LIST_WRAPPER_CHECK_RESULT(draw_indirect_count, DrawIndirectCountInfo)
 
@@ -1400,6 +1537,11 @@ namespace daxa
         return *r_cast<CommandRecorderInfo const *>(daxa_cmd_info(*rc_cast<daxa_CommandRecorder *>(this)));
     }
 
+    auto CommandRecorder::statistics() const -> CommandRecorderStatistics const &
+    {
+        return *r_cast<CommandRecorderStatistics const *>(daxa_cmd_statistics(*rc_cast<daxa_CommandRecorder *>(this)));
+    }
+
     CommandRecorder::~CommandRecorder()
     {
         if (this->internal != nullptr)
@@ -17,6 +17,10 @@
         return DAXA_RESULT_ERROR_CMD_LIST_ALREADY_COMPLETED; \
     }
 
+// Render passes begun with secondary_command_lists only allow executing secondary command lists in the primary recorder.
+#define DAXA_DBG_ASSERT_NOT_SECONDARY_CONTENTS(self) \
+    DAXA_DBG_ASSERT_TRUE_M(!self->secondary_command_list_renderpass, "draws in a render pass begun with secondary_command_lists must be recorded in secondary command recorders")
+
 // DO NOT VALIDATE RENDER PASS COMMANDS
 // VALIDATING THE START OF A RENDERPASS SHOULD ALWAYS BE ENOUGH!
 auto validate_queue_type(daxa_QueueType recorder_qf, daxa_QueueType command_qf) -> daxa_Result
@@ -49,6 +53,14 @@ auto get_vk_image_memory_barrier(daxa_ImageBarrierInfo const & image_barrier, da
     };
 }
 
+auto subresource_ranges_overlap(VkImageSubresourceRange const & a, VkImageSubresourceRange const & b) -> bool
+{
+    bool const aspects_overlap = (a.aspectMask & b.aspectMask) != 0;
+    bool const mips_overlap = a.baseMipLevel < b.baseMipLevel + b.levelCount && b.baseMipLevel < a.baseMipLevel + a.levelCount;
+    bool const layers_overlap = a.baseArrayLayer < b.baseArrayLayer + b.layerCount && b.baseArrayLayer < a.baseArrayLayer + a.layerCount;
+    return aspects_overlap && mips_overlap && layers_overlap;
+}
+
 auto get_vk_memory_barrier(daxa_BarrierInfo const & memory_barrier) -> VkMemoryBarrier2
 {
     return VkMemoryBarrier2{
@@ -155,27 +167,45 @@ void remember_ids(daxa_CommandRecorder self, T id)
 {
     if constexpr (std::is_same_v<daxa_BufferId, T>)
     {
-        self->command_arena->used_buffers.push_back(std::bit_cast<BufferId>(id));
+        if (self->command_arena->try_remember_id(0, std::bit_cast<GPUResourceId>(id)))
+        {
+            self->command_arena->used_buffers.push_back(std::bit_cast<BufferId>(id));
+        }
     }
     if constexpr (std::is_same_v<daxa_ImageId, T>)
     {
-        self->command_arena->used_images.push_back(std::bit_cast<ImageId>(id));
+        if (self->command_arena->try_remember_id(1, std::bit_cast<GPUResourceId>(id)))
+        {
+            self->command_arena->used_images.push_back(std::bit_cast<ImageId>(id));
+        }
     }
     if constexpr (std::is_same_v<daxa_ImageViewId, T>)
     {
-        self->command_arena->used_image_views.push_back(std::bit_cast<ImageViewId>(id));
+        if (self->command_arena->try_remember_id(2, std::bit_cast<GPUResourceId>(id)))
+        {
+            self->command_arena->used_image_views.push_back(std::bit_cast<ImageViewId>(id));
+        }
     }
     if constexpr (std::is_same_v<daxa_SamplerId, T>)
     {
-        self->command_arena->used_samplers.push_back(std::bit_cast<SamplerId>(id));
+        if (self->command_arena->try_remember_id(3, std::bit_cast<GPUResourceId>(id)))
+        {
+            self->command_arena->used_samplers.push_back(std::bit_cast<SamplerId>(id));
+        }
     }
     if constexpr (std::is_same_v<daxa_TlasId, T>)
     {
-        self->command_arena->used_tlass.push_back(std::bit_cast<TlasId>(id));
+        if (self->command_arena->try_remember_id(4, std::bit_cast<GPUResourceId>(id)))
+        {
+            self->command_arena->used_tlass.push_back(std::bit_cast<TlasId>(id));
+        }
     }
     if constexpr (std::is_same_v<daxa_BlasId, T>)
     {
-        self->command_arena->used_blass.push_back(std::bit_cast<BlasId>(id));
+        if (self->command_arena->try_remember_id(5, std::bit_cast<GPUResourceId>(id)))
+        {
+            self->command_arena->used_blass.push_back(std::bit_cast<BlasId>(id));
+        }
     }
 }
 
@@ -229,6 +259,34 @@ void remember_ids(daxa_CommandRecorder self, Args... args)
     _DAXA_CHECK_IDS(__VA_ARGS__)         \
     _DAXA_REMEMBER_IDS(__VA_ARGS__)
 
+// Binds the pipeline and the descriptor set of the gpu shader resource table, skipping everything that is already bound.
+void bind_pipeline(daxa_CommandRecorder self, u32 bind_point_index, VkPipelineBindPoint vk_bind_point, VkPipeline vk_pipeline, VkPipelineLayout vk_pipeline_layout)
+{
+    // Pushed constants are only kept when binding pipelines with the same layout.
+    if (self->push_constant_layout != vk_pipeline_layout)
+    {
+        self->push_constant_layout = {};
+    }
+    if (self->bound_descriptor_set_layouts[bind_point_index] != vk_pipeline_layout)
+    {
+        vkCmdBindDescriptorSets(self->command_arena->vk_command_buffer, vk_bind_point, vk_pipeline_layout, 0, 1, &self->device->gpu_sro_table.vk_descriptor_set, 0, nullptr);
+        self->bound_descriptor_set_layouts[bind_point_index] = vk_pipeline_layout;
+    }
+    else
+    {
+        self->statistics.elided_descriptor_set_binds += 1;
+    }
+    if (self->bound_pipelines[bind_point_index] != vk_pipeline)
+    {
+        vkCmdBindPipeline(self->command_arena->vk_command_buffer, vk_bind_point, vk_pipeline);
+        self->bound_pipelines[bind_point_index] = vk_pipeline;
+    }
+    else
+    {
+        self->statistics.elided_pipeline_binds += 1;
+    }
+}
+
 /// --- End Helpers ---
 
 /// --- Begin API Functions ---
@@ -240,7 +298,6 @@ auto daxa_cmd_set_rasterization_samples(daxa_CommandRecorder self, VkSampleCount
     {
         _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_EXTENSION_NOT_PRESENT, DAXA_RESULT_ERROR_EXTENSION_NOT_PRESENT);
     }
-    daxa_cmd_flush_barriers(self);
     self->device->vkCmdSetRasterizationSamplesEXT(self->command_arena->vk_command_buffer, samples);
     return DAXA_RESULT_SUCCESS;
 }
@@ -505,32 +562,46 @@ auto daxa_cmd_clear_image(daxa_CommandRecorder self, daxa_ImageClearInfo const *
 auto daxa_cmd_pipeline_barrier(daxa_CommandRecorder self, daxa_BarrierInfo const * info) -> daxa_Result
 {
     DAXA_CHECK_UNCOMPLETED(self)
-    if (self->memory_barrier_batch_count == COMMAND_RECORDER_BARRIER_MAX_BATCH_SIZE)
-    {
-        daxa_cmd_flush_barriers(self);
-    }
-    self->memory_barrier_batch.at(self->memory_barrier_batch_count++) = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
-        .pNext = nullptr,
-        .srcStageMask = info->src_access.stages,
-        .srcAccessMask = info->src_access.access_type,
-        .dstStageMask = info->dst_access.stages,
-        .dstAccessMask = info->dst_access.access_type,
-    };
+    self->memory_barrier_batch.push_back(get_vk_memory_barrier(*info));
     return DAXA_RESULT_SUCCESS;
 }
 
 auto daxa_cmd_pipeline_image_barrier(daxa_CommandRecorder self, daxa_ImageBarrierInfo const * info) -> daxa_Result
 {
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->image)
-    if (self->image_barrier_batch_count == COMMAND_RECORDER_BARRIER_MAX_BATCH_SIZE)
+    auto const & img_slot = self->device->slot(info->image);
+    VkImageMemoryBarrier2 const vk_barrier = get_vk_image_memory_barrier(*info, img_slot.view_slot.info.slice, img_slot.vk_image, img_slot.aspect_flags);
+    // Barriers within one vkCmdPipelineBarrier2 are unordered.
+    // A second barrier on the same subresource is merged into the pending one, instead of both transitioning the layout.
+    // A barrier that only partially overlaps a pending one can not be merged, so the pending barriers are flushed first to keep them ordered.
+    for (auto & pending : self->image_barrier_batch)
     {
-        daxa_cmd_flush_barriers(self);
+        if (pending.image != vk_barrier.image || !subresource_ranges_overlap(pending.subresourceRange, vk_barrier.subresourceRange))
+        {
+            continue;
+        }
+        if (std::memcmp(&pending.subresourceRange, &vk_barrier.subresourceRange, sizeof(VkImageSubresourceRange)) != 0)
+        {
+            daxa_cmd_flush_barriers(self);
+            break;
+        }
+        pending.srcStageMask |= vk_barrier.srcStageMask;
+        pending.srcAccessMask |= vk_barrier.srcAccessMask;
+        pending.dstStageMask |= vk_barrier.dstStageMask;
+        pending.dstAccessMask |= vk_barrier.dstAccessMask;
+        // Discarding the contents in the second barrier also discards them for the merged barrier.
+        if (vk_barrier.oldLayout == VK_IMAGE_LAYOUT_UNDEFINED)
+        {
+            pending.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        }
+        pending.newLayout = vk_barrier.newLayout;
+        self->statistics.merged_image_barriers += 1;
+        return DAXA_RESULT_SUCCESS;
     }
-    auto const & img_slot = self->device->slot(info->image);
-    self->image_barrier_batch.at(self->image_barrier_batch_count++) = get_vk_image_memory_barrier(*info, img_slot.view_slot.info.slice, img_slot.vk_image, img_slot.aspect_flags);
+    self->image_barrier_batch.push_back(vk_barrier);
     return DAXA_RESULT_SUCCESS;
 }
+
 struct SplitBarrierDependencyInfoBuffer
 {
     std::vector<VkImageMemoryBarrier2> vk_image_memory_barriers = {};
@@ -636,7 +707,6 @@ auto daxa_cmd_push_constant(daxa_CommandRecorder self, daxa_PushConstantInfo con
     daxa_Result result = DAXA_RESULT_SUCCESS;
     result = validate_queue_type(self->info.queue_type, DAXA_QUEUE_TYPE_COMPUTE);
     _DAXA_RETURN_IF_ERROR(result, result);
-    daxa_cmd_flush_barriers(self);
     if (daxa::holds_alternative<daxa_ImplCommandRecorder::NoPipeline>(self->current_pipeline))
     {
         _DAXA_RETURN_IF_ERROR(DAXA_RESULT_NO_PIPELINE_SET, DAXA_RESULT_NO_PIPELINE_SET);
@@ -664,9 +734,19 @@ auto daxa_cmd_push_constant(daxa_CommandRecorder self, daxa_PushConstantInfo con
     }
     // Always write the whole range, fill with 0xFF to the size of the push constant.
     // This makes validation and renderdoc happy as well as help debug uninitialized push constant data
-    std::array<std::byte, DAXA_MAX_PUSH_CONSTANT_BYTE_SIZE> const_data = {std::byte{0xFF}};
+    std::array<std::byte, DAXA_MAX_PUSH_CONSTANT_BYTE_SIZE> const_data;
+    std::memset(const_data.data(), 0xFF, current_pipeline_push_constant_size);
     std::memcpy(const_data.data(), info->data, info->size);
-    vkCmdPushConstants(self->command_arena->vk_command_buffer, vk_pipeline_layout, VK_SHADER_STAGE_ALL, 0, current_pipeline_push_constant_size, const_data.data());
+    // Skip the write when the whole range already holds the same bytes for this layout.
+    bool const same_layout = self->push_constant_layout == vk_pipeline_layout;
+    if (same_layout && std::memcmp(self->push_constant_data.data(), const_data.data(), current_pipeline_push_constant_size) == 0)
+    {
+        self->statistics.elided_push_constants += 1;
+        return DAXA_RESULT_SUCCESS;
+    }
+    std::memcpy(self->push_constant_data.data(), const_data.data(), current_pipeline_push_constant_size);
+    self->push_constant_layout = vk_pipeline_layout;
+    vkCmdPushConstants(self->command_arena->vk_command_buffer, vk_pipeline_layout, VK_SHADER_STAGE_ALL, 0, current_pipeline_push_constant_size, self->push_constant_data.data());
     return DAXA_RESULT_SUCCESS;
 }
 
@@ -676,15 +756,8 @@ auto daxa_cmd_set_ray_tracing_pipeline(daxa_CommandRecorder self, daxa_RayTracin
     daxa_Result result = DAXA_RESULT_SUCCESS;
     result = validate_queue_type(self->info.queue_type, DAXA_QUEUE_TYPE_COMPUTE);
     _DAXA_RETURN_IF_ERROR(result, result);
-    daxa_cmd_flush_barriers(self);
-    bool const prev_pipeline_rt = self->current_pipeline.index() == decltype(self->current_pipeline)::index_of<daxa_RayTracingPipeline>;
-    bool const same_type_same_layout_as_prev_pipe = prev_pipeline_rt && daxa::get<daxa_RayTracingPipeline>(self->current_pipeline)->vk_pipeline_layout == pipeline->vk_pipeline_layout;
-    if (!same_type_same_layout_as_prev_pipe)
-    {
-        vkCmdBindDescriptorSets(self->command_arena->vk_command_buffer, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, pipeline->vk_pipeline_layout, 0, 1, &self->device->gpu_sro_table.vk_descriptor_set, 0, nullptr);
-    }
     self->current_pipeline = pipeline;
-    vkCmdBindPipeline(self->command_arena->vk_command_buffer, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, pipeline->vk_pipeline);
+    bind_pipeline(self, COMMAND_RECORDER_BIND_POINT_RAY_TRACING, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, pipeline->vk_pipeline, pipeline->vk_pipeline_layout);
     return DAXA_RESULT_SUCCESS;
 }
 
@@ -694,15 +767,8 @@ auto daxa_cmd_set_compute_pipeline(daxa_CommandRecorder self, daxa_ComputePipeli
     daxa_Result result = DAXA_RESULT_SUCCESS;
     result = validate_queue_type(self->info.queue_type, DAXA_QUEUE_TYPE_COMPUTE);
     _DAXA_RETURN_IF_ERROR(result, result);
-    daxa_cmd_flush_barriers(self);
-    bool const prev_pipeline_compute = self->current_pipeline.index() == decltype(self->current_pipeline)::index_of<daxa_ComputePipeline>;
-    bool const same_type_same_layout_as_prev_pipe = prev_pipeline_compute && daxa::get<daxa_ComputePipeline>(self->current_pipeline)->vk_pipeline_layout == pipeline->vk_pipeline_layout;
-    if (!same_type_same_layout_as_prev_pipe)
-    {
-        vkCmdBindDescriptorSets(self->command_arena->vk_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->vk_pipeline_layout, 0, 1, &self->device->gpu_sro_table.vk_descriptor_set, 0, nullptr);
-    }
     self->current_pipeline = pipeline;
-    vkCmdBindPipeline(self->command_arena->vk_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->vk_pipeline);
+    bind_pipeline(self, COMMAND_RECORDER_BIND_POINT_COMPUTE, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline->vk_pipeline, pipeline->vk_pipeline_layout);
     return DAXA_RESULT_SUCCESS;
 }
 
@@ -712,15 +778,8 @@ auto daxa_cmd_set_raster_pipeline(daxa_CommandRecorder self, daxa_RasterPipeline
     daxa_Result result = DAXA_RESULT_SUCCESS;
     result = validate_queue_type(self->info.queue_type, DAXA_QUEUE_TYPE_MAIN);
     _DAXA_RETURN_IF_ERROR(result, result);
-    daxa_cmd_flush_barriers(self);
-    bool const prev_pipeline_raster = self->current_pipeline.index() == decltype(self->current_pipeline)::index_of<daxa_RasterPipeline>;
-    bool const same_type_same_layout_as_prev_pipe = prev_pipeline_raster && daxa::get<daxa_RasterPipeline>(self->current_pipeline)->vk_pipeline_layout == pipeline->vk_pipeline_layout;
-    if (!same_type_same_layout_as_prev_pipe)
-    {
-        vkCmdBindDescriptorSets(self->command_arena->vk_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->vk_pipeline_layout, 0, 1, &self->device->gpu_sro_table.vk_descriptor_set, 0, nullptr);
-    }
     self->current_pipeline = pipeline;
-    vkCmdBindPipeline(self->command_arena->vk_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->vk_pipeline);
+    bind_pipeline(self, COMMAND_RECORDER_BIND_POINT_GRAPHICS, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->vk_pipeline, pipeline->vk_pipeline_layout);
     return DAXA_RESULT_SUCCESS;
 }
 
@@ -735,6 +794,7 @@ auto daxa_cmd_trace_rays(daxa_CommandRecorder self, daxa_TraceRaysInfo const * i
     {
         _DAXA_RETURN_IF_ERROR(DAXA_RESULT_NO_RAYTRACING_PIPELINE_SET, DAXA_RESULT_NO_RAYTRACING_PIPELINE_SET);
     }
+    daxa_cmd_flush_barriers(self);
     auto const & binding_table = info->shader_binding_table;
     auto raygen_handle = binding_table.raygen_region;
     raygen_handle.deviceAddress += binding_table.raygen_region.stride * info->raygen_handle_offset;
@@ -765,6 +825,7 @@ auto daxa_cmd_trace_rays_indirect(daxa_CommandRecorder self, daxa_TraceRaysIndir
     {
         _DAXA_RETURN_IF_ERROR(DAXA_RESULT_NO_RAYTRACING_PIPELINE_SET, DAXA_RESULT_NO_RAYTRACING_PIPELINE_SET);
     }
+    daxa_cmd_flush_barriers(self);
     auto const & binding_table = info->shader_binding_table;
     auto raygen_handle = binding_table.raygen_region;
     raygen_handle.deviceAddress += binding_table.raygen_region.stride * info->raygen_handle_offset;
@@ -795,6 +856,7 @@ auto daxa_cmd_dispatch(daxa_CommandRecorder self, daxa_DispatchInfo const * info
     {
         _DAXA_RETURN_IF_ERROR(DAXA_RESULT_NO_COMPUTE_PIPELINE_SET, DAXA_RESULT_NO_COMPUTE_PIPELINE_SET);
     }
+    daxa_cmd_flush_barriers(self);
     vkCmdDispatch(self->command_arena->vk_command_buffer, info->x, info->y, info->z);
     return DAXA_RESULT_SUCCESS;
 }
@@ -810,6 +872,7 @@ auto daxa_cmd_dispatch_indirect(daxa_CommandRecorder self, daxa_DispatchIndirect
     {
         _DAXA_RETURN_IF_ERROR(DAXA_RESULT_NO_COMPUTE_PIPELINE_SET, DAXA_RESULT_NO_COMPUTE_PIPELINE_SET);
     }
+    daxa_cmd_flush_barriers(self);
     vkCmdDispatchIndirect(self->command_arena->vk_command_buffer, self->device->hot_slot(info->indirect_buffer).vk_buffer, info->offset);
     return DAXA_RESULT_SUCCESS;
 }
@@ -852,6 +915,11 @@ auto daxa_cmd_begin_renderpass(daxa_CommandRecorder self, daxa_RenderPassBeginIn
     daxa_Result result = DAXA_RESULT_SUCCESS;
     result = validate_queue_type(self->info.queue_type, DAXA_QUEUE_TYPE_MAIN);
     _DAXA_RETURN_IF_ERROR(result, result);
+    if (self->secondary)
+    {
+        // Secondary recorders are always within the render pass of their primary recorder.
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_INVALID_CMD_ON_SECONDARY_CMD_LIST, DAXA_RESULT_ERROR_INVALID_CMD_ON_SECONDARY_CMD_LIST);
+    }
     daxa_cmd_flush_barriers(self);
 
     auto fill_rendering_attachment_info = [&](daxa_RenderAttachmentInfo const & in, VkRenderingAttachmentInfo & out)
@@ -917,24 +985,21 @@ auto daxa_cmd_begin_renderpass(daxa_CommandRecorder self, daxa_RenderPassBeginIn
     };
     for (usize i = 0; i < info->color_attachments.size; ++i)
     {
-        self->command_arena->used_image_views.push_back(std::bit_cast<ImageViewId>(info->color_attachments.data[i].image_view));
-        self->command_arena->used_images.push_back(std::bit_cast<ImageId>(self->device->slot(info->color_attachments.data[i].image_view).info.image));
+        remember_ids(self, info->color_attachments.data[i].image_view, self->device->slot(info->color_attachments.data[i].image_view).info.image);
     }
     if (info->depth_attachment.has_value != 0)
     {
-        self->command_arena->used_image_views.push_back(std::bit_cast<ImageViewId>(info->depth_attachment.value.image_view));
-        self->command_arena->used_images.push_back(std::bit_cast<ImageId>(self->device->slot(info->depth_attachment.value.image_view).info.image));
+        remember_ids(self, info->depth_attachment.value.image_view, self->device->slot(info->depth_attachment.value.image_view).info.image);
     }
     if (info->stencil_attachment.has_value != 0)
     {
-        self->command_arena->used_image_views.push_back(std::bit_cast<ImageViewId>(info->stencil_attachment.value.image_view));
-        self->command_arena->used_images.push_back(std::bit_cast<ImageId>(self->device->slot(info->stencil_attachment.value.image_view).info.image));
+        remember_ids(self, info->stencil_attachment.value.image_view, self->device->slot(info->stencil_attachment.value.image_view).info.image);
     }
 
     VkRenderingInfo const vk_rendering_info{
         .sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
         .pNext = nullptr,
-        .flags = {},
+        .flags = info->secondary_command_lists != 0 ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : VkRenderingFlags{},
         .renderArea = info->render_area,
         .layerCount = 1,
         .viewMask = {},
@@ -943,7 +1008,6 @@ auto daxa_cmd_begin_renderpass(daxa_CommandRecorder self, daxa_RenderPassBeginIn
         .pDepthAttachment = info->depth_attachment.has_value != 0 ? &depth_attachment_info : nullptr,
         .pStencilAttachment = info->stencil_attachment.has_value != 0 ? &stencil_attachment_info : nullptr,
     };
-    vkCmdSetScissor(self->command_arena->vk_command_buffer, 0, 1, reinterpret_cast<VkRect2D const *>(&info->render_area));
     VkViewport const vk_viewport = {
         .x = static_cast<f32>(info->render_area.offset.x),
         .y = static_cast<f32>(info->render_area.offset.y),
@@ -952,13 +1016,15 @@ auto daxa_cmd_begin_renderpass(daxa_CommandRecorder self, daxa_RenderPassBeginIn
         .minDepth = 0.0f,
         .maxDepth = 1.0f,
     };
-    vkCmdSetViewport(self->command_arena->vk_command_buffer, 0, 1, &vk_viewport);
+    daxa_cmd_set_scissor(self, reinterpret_cast<VkRect2D const *>(&info->render_area));
+    daxa_cmd_set_viewport(self, &vk_viewport);
     vkCmdBeginRendering(self->command_arena->vk_command_buffer, &vk_rendering_info);
-    if (self->device->vkCmdSetRasterizationSamplesEXT != nullptr)
+    if (self->device->vkCmdSetRasterizationSamplesEXT != nullptr && info->secondary_command_lists == 0)
     {
         self->device->vkCmdSetRasterizationSamplesEXT(self->command_arena->vk_command_buffer, VK_SAMPLE_COUNT_1_BIT);
     }
     self->in_renderpass = true;
+    self->secondary_command_list_renderpass = info->secondary_command_lists != 0;
     return DAXA_RESULT_SUCCESS;
 }
 
@@ -967,24 +1033,43 @@ void daxa_cmd_end_renderpass(daxa_CommandRecorder self)
     daxa_cmd_flush_barriers(self);
     vkCmdEndRendering(self->command_arena->vk_command_buffer);
     self->in_renderpass = false;
+    self->secondary_command_list_renderpass = false;
 }
 
 void daxa_cmd_set_viewport(daxa_CommandRecorder self, VkViewport const * info)
 {
-    daxa_cmd_flush_barriers(self);
+    if (self->viewport_set && std::memcmp(&self->viewport, info, sizeof(VkViewport)) == 0)
+    {
+        self->statistics.elided_viewports += 1;
+        return;
+    }
     vkCmdSetViewport(self->command_arena->vk_command_buffer, 0, 1, info);
+    self->viewport = *info;
+    self->viewport_set = true;
 }
 
 void daxa_cmd_set_scissor(daxa_CommandRecorder self, VkRect2D const * info)
 {
-    daxa_cmd_flush_barriers(self);
+    if (self->scissor_set && std::memcmp(&self->scissor, info, sizeof(VkRect2D)) == 0)
+    {
+        self->statistics.elided_scissors += 1;
+        return;
+    }
     vkCmdSetScissor(self->command_arena->vk_command_buffer, 0, 1, info);
+    self->scissor = *info;
+    self->scissor_set = true;
 }
 
 void daxa_cmd_set_depth_bias(daxa_CommandRecorder self, daxa_DepthBiasInfo const * info)
 {
-    daxa_cmd_flush_barriers(self);
+    if (self->depth_bias_set && std::memcmp(&self->depth_bias, info, sizeof(daxa_DepthBiasInfo)) == 0)
+    {
+        self->statistics.elided_depth_biases += 1;
+        return;
+    }
     vkCmdSetDepthBias(self->command_arena->vk_command_buffer, info->constant_factor, info->clamp, info->slope_factor);
+    self->depth_bias = *info;
+    self->depth_bias_set = true;
 }
 
 auto daxa_cmd_set_index_buffer(daxa_CommandRecorder self, daxa_SetIndexBufferInfo const * info) -> daxa_Result
@@ -997,18 +1082,107 @@ auto daxa_cmd_set_index_buffer(daxa_CommandRecorder self, daxa_SetIndexBufferInf
 
 void daxa_cmd_draw(daxa_CommandRecorder self, daxa_DrawInfo const * info)
 {
+    DAXA_DBG_ASSERT_NOT_SECONDARY_CONTENTS(self);
+    daxa_cmd_flush_barriers(self);
     vkCmdDraw(self->command_arena->vk_command_buffer, info->vertex_count, info->instance_count, info->first_vertex, info->first_instance);
 }
 
 void daxa_cmd_draw_indexed(daxa_CommandRecorder self, daxa_DrawIndexedInfo const * info)
 {
+    DAXA_DBG_ASSERT_NOT_SECONDARY_CONTENTS(self);
+    daxa_cmd_flush_barriers(self);
     vkCmdDrawIndexed(self->command_arena->vk_command_buffer, info->index_count, info->instance_count, info->first_index, info->vertex_offset, info->first_instance);
 }
 
+// Draw infos are translated to VkMultiDraw(Indexed)InfoEXT in stack chunks of this size.
+// It is well below the minimum maxMultiDrawCount of 1024 guaranteed by VK_EXT_multi_draw.
+static constexpr u32 MULTI_DRAW_CHUNK_SIZE = 64;
+
+void daxa_cmd_draw_many(daxa_CommandRecorder self, daxa_DrawInfo const * infos, u32 info_count)
+{
+    DAXA_DBG_ASSERT_NOT_SECONDARY_CONTENTS(self);
+    daxa_cmd_flush_barriers(self);
+    VkCommandBuffer const vk_cmd = self->command_arena->vk_command_buffer;
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW) == 0)
+    {
+        for (u32 i = 0; i < info_count; ++i)
+        {
+            vkCmdDraw(vk_cmd, infos[i].vertex_count, infos[i].instance_count, infos[i].first_vertex, infos[i].first_instance);
+        }
+        return;
+    }
+    // Instance count and first instance are shared by all draws of one multi draw.
+    std::array<VkMultiDrawInfoEXT, MULTI_DRAW_CHUNK_SIZE> chunk = {};
+    u32 i = 0;
+    while (i < info_count)
+    {
+        u32 const instance_count = infos[i].instance_count;
+        u32 const first_instance = infos[i].first_instance;
+        u32 chunk_size = 0;
+        while (i < info_count && chunk_size < MULTI_DRAW_CHUNK_SIZE && infos[i].instance_count == instance_count && infos[i].first_instance == first_instance)
+        {
+            chunk[chunk_size++] = VkMultiDrawInfoEXT{
+                .firstVertex = infos[i].first_vertex,
+                .vertexCount = infos[i].vertex_count,
+            };
+            ++i;
+        }
+        self->device->vkCmdDrawMultiEXT(vk_cmd, chunk_size, chunk.data(), instance_count, first_instance, sizeof(VkMultiDrawInfoEXT));
+    }
+}
+
+void daxa_cmd_draw_indexed_many(daxa_CommandRecorder self, daxa_DrawIndexedInfo const * infos, u32 info_count)
+{
+    DAXA_DBG_ASSERT_NOT_SECONDARY_CONTENTS(self);
+    daxa_cmd_flush_barriers(self);
+    VkCommandBuffer const vk_cmd = self->command_arena->vk_command_buffer;
+    if ((self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW) == 0)
+    {
+        for (u32 i = 0; i < info_count; ++i)
+        {
+            vkCmdDrawIndexed(vk_cmd, infos[i].index_count, infos[i].instance_count, infos[i].first_index, infos[i].vertex_offset, infos[i].first_instance);
+        }
+        return;
+    }
+    std::array<VkMultiDrawIndexedInfoEXT, MULTI_DRAW_CHUNK_SIZE> chunk = {};
+    u32 i = 0;
+    while (i < info_count)
+    {
+        u32 const instance_count = infos[i].instance_count;
+        u32 const first_instance = infos[i].first_instance;
+        u32 chunk_size = 0;
+        while (i < info_count && chunk_size < MULTI_DRAW_CHUNK_SIZE && infos[i].instance_count == instance_count && infos[i].first_instance == first_instance)
+        {
+            chunk[chunk_size++] = VkMultiDrawIndexedInfoEXT{
+                .firstIndex = infos[i].first_index,
+                .indexCount = infos[i].index_count,
+                .vertexOffset = infos[i].vertex_offset,
+            };
+            ++i;
+        }
+        self->device->vkCmdDrawMultiIndexedEXT(vk_cmd, chunk_size, chunk.data(), instance_count, first_instance, sizeof(VkMultiDrawIndexedInfoEXT), nullptr);
+    }
+}
+
+// Draw infos are used as tightly packed indirect commands, so they must keep the vulkan layout.
+static_assert(sizeof(daxa_DrawInfo) == sizeof(VkDrawIndirectCommand));
+static_assert(sizeof(daxa_DrawIndexedInfo) == sizeof(VkDrawIndexedIndirectCommand));
+
+static auto draw_command_stride(u32 stride, daxa_Bool8 is_indexed) -> u32
+{
+    if (stride != 0)
+    {
+        return stride;
+    }
+    return is_indexed != 0 ? static_cast<u32>(sizeof(VkDrawIndexedIndirectCommand)) : static_cast<u32>(sizeof(VkDrawIndirectCommand));
+}
+
 auto daxa_cmd_draw_indirect(daxa_CommandRecorder self, daxa_DrawIndirectInfo const * info) -> daxa_Result
 {
     DAXA_CHECK_UNCOMPLETED(self)
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->indirect_buffer)
+    DAXA_DBG_ASSERT_NOT_SECONDARY_CONTENTS(self);
+    daxa_cmd_flush_barriers(self);
     if (info->is_indexed != 0)
     {
         vkCmdDrawIndexedIndirect(
@@ -1016,7 +1190,7 @@ auto daxa_cmd_draw_indirect(daxa_CommandRecorder self, daxa_DrawIndirectInfo con
             self->device->hot_slot(info->indirect_buffer).vk_buffer,
             info->indirect_buffer_offset,
             info->draw_count,
-            info->draw_command_stride);
+            draw_command_stride(info->draw_command_stride, info->is_indexed));
     }
     else
     {
@@ -1025,7 +1199,7 @@ auto daxa_cmd_draw_indirect(daxa_CommandRecorder self, daxa_DrawIndirectInfo con
             self->device->hot_slot(info->indirect_buffer).vk_buffer,
             info->indirect_buffer_offset,
             info->draw_count,
-            info->draw_command_stride);
+            draw_command_stride(info->draw_command_stride, info->is_indexed));
     }
     return DAXA_RESULT_SUCCESS;
 }
@@ -1034,6 +1208,8 @@ auto daxa_cmd_draw_indirect_count(daxa_CommandRecorder self, daxa_DrawIndirectCo
 {
     DAXA_CHECK_UNCOMPLETED(self)
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->indirect_buffer, info->count_buffer)
+    DAXA_DBG_ASSERT_NOT_SECONDARY_CONTENTS(self);
+    daxa_cmd_flush_barriers(self);
     if (info->is_indexed != 0)
     {
         vkCmdDrawIndexedIndirectCount(
@@ -1043,7 +1219,7 @@ auto daxa_cmd_draw_indirect_count(daxa_CommandRecorder self, daxa_DrawIndirectCo
             self->device->hot_slot(info->count_buffer).vk_buffer,
             info->count_buffer_offset,
             info->max_draw_count,
-            info->draw_command_stride);
+            draw_command_stride(info->draw_command_stride, info->is_indexed));
     }
     else
     {
@@ -1054,13 +1230,15 @@ auto daxa_cmd_draw_indirect_count(daxa_CommandRecorder self, daxa_DrawIndirectCo
             self->device->hot_slot(info->count_buffer).vk_buffer,
             info->count_buffer_offset,
             info->max_draw_count,
-            info->draw_command_stride);
+            draw_command_stride(info->draw_command_stride, info->is_indexed));
     }
     return DAXA_RESULT_SUCCESS;
 }
 
 void daxa_cmd_draw_mesh_tasks(daxa_CommandRecorder self, daxa_DrawMeshTasksInfo const * info)
 {
+    DAXA_DBG_ASSERT_NOT_SECONDARY_CONTENTS(self);
+    daxa_cmd_flush_barriers(self);
     if (self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MESH_SHADER)
     {
         self->device->vkCmdDrawMeshTasksEXT(self->command_arena->vk_command_buffer, info->x, info->y, info->z);
@@ -1071,6 +1249,8 @@ auto daxa_cmd_draw_mesh_tasks_indirect(daxa_CommandRecorder self, daxa_DrawMeshT
 {
     DAXA_CHECK_UNCOMPLETED(self)
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->indirect_buffer)
+    DAXA_DBG_ASSERT_NOT_SECONDARY_CONTENTS(self);
+    daxa_cmd_flush_barriers(self);
     if (self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MESH_SHADER)
     {
         self->device->vkCmdDrawMeshTasksIndirectEXT(
@@ -1089,6 +1269,8 @@ auto daxa_cmd_draw_mesh_tasks_indirect_count(
 {
     DAXA_CHECK_UNCOMPLETED(self)
     DAXA_CHECK_AND_REMEMBER_IDS(self, info->indirect_buffer, info->count_buffer)
+    DAXA_DBG_ASSERT_NOT_SECONDARY_CONTENTS(self);
+    daxa_cmd_flush_barriers(self);
     if (self->device->properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MESH_SHADER)
     {
         self->device->vkCmdDrawMeshTasksIndirectCountEXT(
@@ -1105,6 +1287,7 @@ auto daxa_cmd_draw_mesh_tasks_indirect_count(
 
 void daxa_cmd_write_timestamp(daxa_CommandRecorder self, daxa_WriteTimestampInfo const * info)
 {
+    // The timestamp must be ordered after pending barriers, otherwise it would measure before them.
     daxa_cmd_flush_barriers(self);
     vkCmdWriteTimestamp2(
         self->command_arena->vk_command_buffer,
@@ -1115,7 +1298,6 @@ void daxa_cmd_write_timestamp(daxa_CommandRecorder self, daxa_WriteTimestampInfo
 
 void daxa_cmd_reset_timestamps(daxa_CommandRecorder self, daxa_ResetTimestampsInfo const * info)
 {
-    daxa_cmd_flush_barriers(self);
     vkCmdResetQueryPool(
         self->command_arena->vk_command_buffer,
         (**info->query_pool).vk_timeline_query_pool,
@@ -1125,7 +1307,6 @@ void daxa_cmd_reset_timestamps(daxa_CommandRecorder self, daxa_ResetTimestampsIn
 
 void daxa_cmd_begin_label(daxa_CommandRecorder self, daxa_CommandLabelInfo const * info)
 {
-    daxa_cmd_flush_barriers(self);
     VkDebugUtilsLabelEXT const vk_debug_label_info{
         .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
         .pNext = {},
@@ -1145,7 +1326,6 @@ void daxa_cmd_begin_label(daxa_CommandRecorder self, daxa_CommandLabelInfo const
 
 void daxa_cmd_end_label(daxa_CommandRecorder self)
 {
-    daxa_cmd_flush_barriers(self);
     if ((self->device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE)
     {
         self->device->vkCmdEndDebugUtilsLabelEXT(self->command_arena->vk_command_buffer);
@@ -1155,28 +1335,116 @@ void daxa_cmd_end_label(daxa_CommandRecorder self)
 void daxa_cmd_reset_assumed_state(daxa_CommandRecorder self)
 {
     self->current_pipeline = daxa_ImplCommandRecorder::NoPipeline{};
+    self->bound_pipelines = {};
+    self->bound_descriptor_set_layouts = {};
+    self->push_constant_layout = {};
+    self->viewport_set = false;
+    self->scissor_set = false;
+    self->depth_bias_set = false;
+}
+
+auto daxa_cmd_execute_commands(daxa_CommandRecorder self, daxa_ExecutableCommandList const * commands, uint64_t command_count) -> daxa_Result
+{
+    DAXA_CHECK_UNCOMPLETED(self)
+    if (self->secondary)
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_INVALID_CMD_ON_SECONDARY_CMD_LIST, DAXA_RESULT_ERROR_INVALID_CMD_ON_SECONDARY_CMD_LIST);
+    }
+    if (!self->in_renderpass || !self->secondary_command_list_renderpass)
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_RENDERPASS_DOES_NOT_ALLOW_SECONDARY_CMD_LISTS, DAXA_RESULT_ERROR_RENDERPASS_DOES_NOT_ALLOW_SECONDARY_CMD_LISTS);
+    }
+    for (daxa_ExecutableCommandList secondary : std::span{commands, command_count})
+    {
+        // Secondary command lists that are not reusable can only be executed once, their arena is handed over to the executing recorder.
+        if (secondary->command_arena == nullptr || secondary->command_arena->vk_level != VK_COMMAND_BUFFER_LEVEL_SECONDARY)
+        {
+            _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_CMD_LIST_NOT_EXECUTABLE_AS_SECONDARY, DAXA_RESULT_ERROR_CMD_LIST_NOT_EXECUTABLE_AS_SECONDARY);
+        }
+        // Reusable command lists are submitted many times, so every secondary command list they execute must allow that too.
+        if (self->info.reusable != 0 && secondary->info.reusable == 0)
+        {
+            _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_SECONDARY_CMD_LIST_NOT_REUSABLE, DAXA_RESULT_ERROR_SECONDARY_CMD_LIST_NOT_REUSABLE);
+        }
+    }
+    ImplTransientCommandArena & arena = *self->command_arena;
+    std::vector<VkCommandBuffer> & vk_command_buffers = arena.execute_commands_scratch;
+    vk_command_buffers.clear();
+    for (u64 i = 0; i < command_count; ++i)
+    {
+        daxa_ExecutableCommandList secondary = commands[i];
+        vk_command_buffers.push_back(secondary->command_arena->vk_command_buffer);
+        // The primary takes over the id tracking and deferred destructions of the secondary, so submits only need to look at the primary.
+        ImplTransientCommandArena & secondary_arena = *secondary->command_arena;
+        for (BufferId id : secondary_arena.used_buffers)
+        {
+            remember_ids(self, std::bit_cast<daxa_BufferId>(id));
+        }
+        for (ImageId id : secondary_arena.used_images)
+        {
+            remember_ids(self, std::bit_cast<daxa_ImageId>(id));
+        }
+        for (ImageViewId id : secondary_arena.used_image_views)
+        {
+            remember_ids(self, std::bit_cast<daxa_ImageViewId>(id));
+        }
+        for (SamplerId id : secondary_arena.used_samplers)
+        {
+            remember_ids(self, std::bit_cast<daxa_SamplerId>(id));
+        }
+        for (TlasId id : secondary_arena.used_tlass)
+        {
+            remember_ids(self, std::bit_cast<daxa_TlasId>(id));
+        }
+        for (BlasId id : secondary_arena.used_blass)
+        {
+            remember_ids(self, std::bit_cast<daxa_BlasId>(id));
+        }
+        for (auto const & deferred_destruction : secondary_arena.deferred_destructions)
+        {
+            arena.deferred_destructions.push_back(deferred_destruction);
+        }
+        secondary_arena.deferred_destructions.clear();
+        arena.executed_secondaries.push_back(secondary->command_arena);
+        if (secondary->info.reusable != 0)
+        {
+            // Reusable secondary command lists keep their arena, this arena references it until it is retired.
+            secondary_arena.owner_count.fetch_add(1, std::memory_order::relaxed);
+        }
+        else
+        {
+            secondary->command_arena = {};
+        }
+    }
+    vkCmdExecuteCommands(arena.vk_command_buffer, static_cast<u32>(vk_command_buffers.size()), vk_command_buffers.data());
+    // Executing secondary command buffers leaves the command buffer state undefined.
+    daxa_cmd_reset_assumed_state(self);
+    return DAXA_RESULT_SUCCESS;
 }
 
 void daxa_cmd_flush_barriers(daxa_CommandRecorder self)
 {
-    if (self->memory_barrier_batch_count > 0 || self->image_barrier_batch_count > 0)
+    if (!self->memory_barrier_batch.empty() || !self->image_barrier_batch.empty())
     {
         VkDependencyInfo const vk_dependency_info{
             .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
             .pNext = nullptr,
             .dependencyFlags = {},
-            .memoryBarrierCount = static_cast<u32>(self->memory_barrier_batch_count),
+            .memoryBarrierCount = static_cast<u32>(self->memory_barrier_batch.size()),
             .pMemoryBarriers = self->memory_barrier_batch.data(),
             .bufferMemoryBarrierCount = 0,
             .pBufferMemoryBarriers = nullptr,
-            .imageMemoryBarrierCount = static_cast<u32>(self->image_barrier_batch_count),
+            .imageMemoryBarrierCount = static_cast<u32>(self->image_barrier_batch.size()),
             .pImageMemoryBarriers = self->image_barrier_batch.data(),
         };
 
         vkCmdPipelineBarrier2(self->command_arena->vk_command_buffer, &vk_dependency_info);
+        self->statistics.barrier_flushes += 1;
+        self->statistics.flushed_memory_barriers += self->memory_barrier_batch.size();
+        self->statistics.flushed_image_barriers += self->image_barrier_batch.size();
 
-        self->memory_barrier_batch_count = 0;
-        self->image_barrier_batch_count = 0;
+        self->memory_barrier_batch.clear();
+        self->image_barrier_batch.clear();
     }
 }
 
@@ -1195,7 +1463,7 @@ auto daxa_cmd_complete_current_commands(
         .info = self->info,
         .command_arena = self->command_arena,
     };
-    self->current_pipeline = daxa_ImplCommandRecorder::NoPipeline{};
+    daxa_cmd_reset_assumed_state(self);
     self->command_arena = {};
 
     return DAXA_RESULT_SUCCESS;
@@ -1206,8 +1474,15 @@ auto daxa_cmd_info(daxa_CommandRecorder self) -> daxa_CommandRecorderInfo const
     return &self->info;
 }
 
+auto daxa_cmd_statistics(daxa_CommandRecorder self) -> daxa_CommandRecorderStatistics const *
+{
+    return &self->statistics;
+}
+
 auto daxa_cmd_get_vk_command_buffer(daxa_CommandRecorder self) -> VkCommandBuffer
 {
+    // Raw vulkan commands recorded into the command buffer must see all pending barriers.
+    daxa_cmd_flush_barriers(self);
     return self->command_arena->vk_command_buffer;
 }
 
@@ -1225,10 +1500,10 @@ void daxa_destroy_command_recorder(daxa_CommandRecorder self)
         self->device->instance);
 }
 
-auto daxa_dvc_create_command_recorder(daxa_Device device, daxa_CommandRecorderInfo const * info, daxa_CommandRecorder * out_cmd_list) -> daxa_Result
+auto create_command_recorder_helper(daxa_Device device, daxa_CommandRecorderInfo const * info, VkCommandBufferLevel vk_level, VkCommandBufferInheritanceInfo const * vk_inheritance_info, daxa_CommandRecorder * out_cmd_list) -> daxa_Result
 {
     ImplTransientCommandArena *cmd_arena = {};
-    daxa_Result result = device->commands.get_arena(device->vk_device, info->queue_type, device->queue_families[info->queue_type].vk_queue_type_index, cmd_arena);
+    daxa_Result result = device->commands.get_arena(device->vk_device, info->queue_type, device->queue_families[info->queue_type].vk_queue_type_index, vk_level, cmd_arena);
     _DAXA_RETURN_IF_ERROR(result, result);
     defer {
         if (result != DAXA_RESULT_SUCCESS)
@@ -1240,8 +1515,9 @@ auto daxa_dvc_create_command_recorder(daxa_Device device, daxa_CommandRecorderIn
     VkCommandBufferBeginInfo const vk_command_buffer_begin_info{
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
         .pNext = nullptr,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-        .pInheritanceInfo = {},
+        .flags = static_cast<VkCommandBufferUsageFlags>(info->reusable ? VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT : VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT) |
+                 static_cast<VkCommandBufferUsageFlags>(vk_level == VK_COMMAND_BUFFER_LEVEL_SECONDARY ? VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT : 0),
+        .pInheritanceInfo = vk_inheritance_info,
     };
     result = static_cast<daxa_Result>(vkBeginCommandBuffer(cmd_arena->vk_command_buffer, &vk_command_buffer_begin_info));
     _DAXA_RETURN_IF_ERROR(result, result);
@@ -1250,6 +1526,8 @@ auto daxa_dvc_create_command_recorder(daxa_Device device, daxa_CommandRecorderIn
     ret.device = device;
     ret.info = *info;
     ret.command_arena = cmd_arena;
+    ret.secondary = vk_level == VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    ret.in_renderpass = ret.secondary;
 
     if ((ret.device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE && ret.info.name.size != 0)
     {
@@ -1272,6 +1550,49 @@ auto daxa_dvc_create_command_recorder(daxa_Device device, daxa_CommandRecorderIn
     return DAXA_RESULT_SUCCESS;
 }
 
+auto daxa_dvc_create_command_recorder(daxa_Device device, daxa_CommandRecorderInfo const * info, daxa_CommandRecorder * out_cmd_list) -> daxa_Result
+{
+    return create_command_recorder_helper(device, info, VK_COMMAND_BUFFER_LEVEL_PRIMARY, nullptr, out_cmd_list);
+}
+
+auto daxa_dvc_create_secondary_command_recorder(daxa_Device device, daxa_SecondaryCommandRecorderInfo const * info, daxa_CommandRecorder * out_cmd_list) -> daxa_Result
+{
+    VkCommandBufferInheritanceRenderingInfo const vk_inheritance_rendering_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+        .pNext = nullptr,
+        .flags = {},
+        .viewMask = {},
+        .colorAttachmentCount = info->color_attachment_formats.size,
+        .pColorAttachmentFormats = info->color_attachment_formats.data,
+        .depthAttachmentFormat = info->depth_attachment_format.has_value != 0 ? info->depth_attachment_format.value : VK_FORMAT_UNDEFINED,
+        .stencilAttachmentFormat = info->stencil_attachment_format.has_value != 0 ? info->stencil_attachment_format.value : VK_FORMAT_UNDEFINED,
+        .rasterizationSamples = info->rasterization_samples,
+    };
+    VkCommandBufferInheritanceInfo const vk_inheritance_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = &vk_inheritance_rendering_info,
+        .renderPass = VK_NULL_HANDLE,
+        .subpass = 0,
+        .framebuffer = VK_NULL_HANDLE,
+        .occlusionQueryEnable = VK_FALSE,
+        .queryFlags = {},
+        .pipelineStatistics = {},
+    };
+    daxa_CommandRecorderInfo const recorder_info{
+        .queue_type = DAXA_QUEUE_TYPE_MAIN,
+        .name = info->name,
+        .reusable = info->reusable,
+    };
+    daxa_Result result = create_command_recorder_helper(device, &recorder_info, VK_COMMAND_BUFFER_LEVEL_SECONDARY, &vk_inheritance_info, out_cmd_list);
+    _DAXA_RETURN_IF_ERROR(result, result);
+    // Dynamic state is not inherited from the primary command buffer.
+    if (device->vkCmdSetRasterizationSamplesEXT != nullptr)
+    {
+        device->vkCmdSetRasterizationSamplesEXT((**out_cmd_list).command_arena->vk_command_buffer, info->rasterization_samples);
+    }
+    return result;
+}
+
 auto daxa_executable_commands_inc_refcnt(daxa_ExecutableCommandList self) -> u64
 {
     return self->inc_refcnt();
@@ -1294,8 +1615,9 @@ void daxa_ImplCommandRecorder::zero_ref_callback(ImplHandle const * handle)
     u64 const submit_timeline = self->device->global_submit_timeline.load(std::memory_order::relaxed);
     if (self->command_arena)
     {
-        std::unique_lock const lock{self->device->zombies_mtx};
-        self->device->command_zombies.emplace_front(
+        auto & shard = self->device->zombie_shards[zombie_shard_index()];
+        std::unique_lock const lock{shard.mtx};
+        shard.command_zombies.emplace_back(
             submit_timeline,
             self->command_arena);
     }
@@ -1309,9 +1631,13 @@ void daxa_ImplExecutableCommandList::zero_ref_callback(ImplHandle const * handle
 {
     auto * self = rc_cast<daxa_ExecutableCommandList>(handle);
     u64 const submit_timeline = self->device->global_submit_timeline.load(std::memory_order::relaxed);
+    // Executed secondary command lists handed their arena over to the executing recorder.
+    // Arenas of reusable secondary command lists are retired by the last arena executing them, if that outlives this list.
+    if (self->command_arena != nullptr && self->command_arena->owner_count.fetch_sub(1, std::memory_order::acq_rel) == 1)
     {
-        std::unique_lock const lock{self->device->zombies_mtx};
-        self->device->command_zombies.emplace_front(
+        auto & shard = self->device->zombie_shards[zombie_shard_index()];
+        std::unique_lock const lock{shard.mtx};
+        shard.command_zombies.emplace_back(
             submit_timeline,
             self->command_arena);
     }
@@ -5,12 +5,23 @@
 #include <daxa/c/command_recorder.h>
 #include <daxa/command_recorder.hpp>
 #include <mutex>
+#include <atomic>
 
 using namespace daxa;
 
 struct ImplDevice;
 
-static inline constexpr usize DAXA_MAX_COMMAND_POOLS = 128u;
+// Free command arenas are kept in several shards, each with its own lock.
+// Threads are assigned to shards round robin. Retired arenas return to the shard of the thread that last acquired them.
+// This acts as a per thread cache of arenas, without tying the lifetime of arenas to threads.
+static inline constexpr u32 COMMAND_ARENA_SHARD_COUNT = 16u;
+
+inline auto command_arena_shard_index() -> u32
+{
+    static std::atomic_uint32_t next_command_arena_shard = {};
+    thread_local u32 const shard_index = next_command_arena_shard.fetch_add(1, std::memory_order_relaxed) % COMMAND_ARENA_SHARD_COUNT;
+    return shard_index;
+}
 
 static inline constexpr u8 DEFERRED_DESTRUCTION_BUFFER_INDEX = 0u;
 static inline constexpr u8 DEFERRED_DESTRUCTION_IMAGE_INDEX = 1u;
@@ -18,32 +29,86 @@ static inline constexpr u8 DEFERRED_DESTRUCTION_IMAGE_VIEW_INDEX = 2u;
 static inline constexpr u8 DEFERRED_DESTRUCTION_SAMPLER_INDEX = 3u;
 static inline constexpr u8 DEFERRED_DESTRUCTION_TIMELINE_QUERY_POOL_INDEX = 4u;
 
-static inline constexpr usize COMMAND_RECORDER_BARRIER_MAX_BATCH_SIZE = 16u;
+static inline constexpr usize REMEMBERED_ID_CACHE_SIZE = 64u;
+static inline constexpr u32 REMEMBERED_ID_TYPE_COUNT = 6u;
+
 static inline constexpr usize COMMAND_LIST_COLOR_ATTACHMENT_MAX = 8u;
 
+static inline constexpr u32 COMMAND_RECORDER_BIND_POINT_GRAPHICS = 0u;
+static inline constexpr u32 COMMAND_RECORDER_BIND_POINT_COMPUTE = 1u;
+static inline constexpr u32 COMMAND_RECORDER_BIND_POINT_RAY_TRACING = 2u;
+static inline constexpr u32 COMMAND_RECORDER_BIND_POINT_COUNT = 3u;
+
 struct ImplTransientCommandArena
 {
     VkCommandPool vk_command_pool = {};
     VkCommandBuffer vk_command_buffer = {};
     daxa_QueueType queue_type = {};
     u32 vk_queue_type_index = {};
-    
-    /// TODO: Replace these with arena dynamic arrays
-    /// TODO: Add Automatically growing memory arena (when writing this i like the idea of having a per device pool of slabs (maybe 1-128kib) that the arenas can source their memory from)
-    std::vector<std::pair<GPUResourceId, u8>> deferred_destructions = {};
-    std::vector<BufferId> used_buffers = {};
-    std::vector<ImageId> used_images = {};
-    std::vector<ImageViewId> used_image_views = {};
-    std::vector<SamplerId> used_samplers = {};
-    std::vector<TlasId> used_tlass = {};
-    std::vector<BlasId> used_blass = {};
+    u32 shard_index = {};
+    VkCommandBufferLevel vk_level = {};
+
+    // Backed by the slab pool of the device, recording does not allocate after warm up.
+    SlabArray<std::pair<GPUResourceId, u8>> deferred_destructions = {};
+    SlabArray<BufferId> used_buffers = {};
+    SlabArray<ImageId> used_images = {};
+    SlabArray<ImageViewId> used_image_views = {};
+    SlabArray<SamplerId> used_samplers = {};
+    SlabArray<TlasId> used_tlass = {};
+    SlabArray<BlasId> used_blass = {};
+    // Arenas of secondary command lists executed by this arena. This arena owns a reference to each of them and releases it when retired.
+    SlabArray<ImplTransientCommandArena *> executed_secondaries = {};
+    // References of the executable command list and the arenas executing it. The arena is retired when the last reference is released.
+    std::atomic<u32> owner_count = {};
+    // Scratch space for daxa_cmd_execute_commands, keeps its capacity between recordings.
+    std::vector<VkCommandBuffer> execute_commands_scratch = {};
+
+    // Direct mapped cache of the last remembered id per slot, one table per id type.
+    // Skips remembering the same id many times when it is used over and over in a recording.
+    std::array<std::array<u64, REMEMBERED_ID_CACHE_SIZE>, REMEMBERED_ID_TYPE_COUNT> remembered_id_cache = {};
+
+    void set_slab_pool(SlabPool * pool)
+    {
+        deferred_destructions.pool = pool;
+        used_buffers.pool = pool;
+        used_images.pool = pool;
+        used_image_views.pool = pool;
+        used_samplers.pool = pool;
+        used_tlass.pool = pool;
+        used_blass.pool = pool;
+        executed_secondaries.pool = pool;
+    }
+
+    // Returns true when the id was not remembered yet.
+    auto try_remember_id(u32 type_index, GPUResourceId id) -> bool
+    {
+        u64 & cached = remembered_id_cache[type_index][id.index % REMEMBERED_ID_CACHE_SIZE];
+        u64 const id_value = std::bit_cast<u64>(id);
+        if (cached == id_value)
+        {
+            return false;
+        }
+        cached = id_value;
+        return true;
+    }
 };
 
 struct ImplTransientCommandArenas
 {
-    std::pair<std::array<ImplTransientCommandArena, DAXA_MAX_COMMAND_POOLS>, u32> transient_command_arenas = {};
-    std::array<std::deque<u32>, DAXA_QUEUE_TYPE_MAX_ENUM> available_arenas = {};
-    std::mutex mtx = {};
+    struct Shard
+    {
+        std::mutex mtx = {};
+        // Indexed by VkCommandBufferLevel and queue type.
+        std::array<std::array<std::vector<ImplTransientCommandArena *>, DAXA_QUEUE_TYPE_MAX_ENUM>, 2> available_arenas = {};
+    };
+
+    // Shared by all arenas, must outlive them.
+    SlabPool slab_pool = {};
+    // Address stable and growing, arenas are never moved or removed until cleanup.
+    std::deque<ImplTransientCommandArena> transient_command_arenas = {};
+    // Only taken when a new arena is created.
+    std::mutex table_mtx = {};
+    std::array<Shard, COMMAND_ARENA_SHARD_COUNT> shards = {};
 
     void initialize() 
     {
@@ -52,88 +117,103 @@ struct ImplTransientCommandArenas
 
     void cleanup(VkDevice vk_device)
     {
-        for (u32 i = 0; i < transient_command_arenas.second; ++i)
+        for (auto & transient_command_arena : transient_command_arenas)
         {
-            vkDestroyCommandPool(vk_device, transient_command_arenas.first[i].vk_command_pool, nullptr);
+            vkDestroyCommandPool(vk_device, transient_command_arena.vk_command_pool, nullptr);
         }
     }
 
-    auto get_arena(VkDevice vk_device, daxa_QueueType queue_type, u32 queue_type_index, ImplTransientCommandArena*& out, std::unique_lock<std::mutex>* lock = {}) -> daxa_Result
+    auto try_pop_available_arena(u32 shard_index, VkCommandBufferLevel vk_level, daxa_QueueType queue_type, bool wait_for_lock) -> ImplTransientCommandArena *
     {
-        std::unique_lock<std::mutex> local_lock = lock == nullptr ? std::unique_lock(mtx) : std::unique_lock<std::mutex>{};
+        Shard & shard = shards[shard_index];
+        std::unique_lock<std::mutex> lock = wait_for_lock ? std::unique_lock(shard.mtx) : std::unique_lock(shard.mtx, std::try_to_lock);
+        auto & available_arenas = shard.available_arenas[vk_level][queue_type];
+        if (!lock.owns_lock() || available_arenas.empty())
+        {
+            return nullptr;
+        }
+        ImplTransientCommandArena * arena = available_arenas.back();
+        available_arenas.pop_back();
+        return arena;
+    }
 
+    auto get_arena(VkDevice vk_device, daxa_QueueType queue_type, u32 queue_type_index, VkCommandBufferLevel vk_level, ImplTransientCommandArena*& out) -> daxa_Result
+    {
         out = {};
         daxa_Result result = DAXA_RESULT_SUCCESS;
-        std::deque<u32>& available_command_pools = available_arenas[queue_type];
+        u32 const shard_index = command_arena_shard_index();
+
+        // Fast path, reuse an arena retired into the shard of this thread.
+        out = try_pop_available_arena(shard_index, vk_level, queue_type, true);
 
-        if (available_command_pools.size() == 0)
+        // Steal an arena from other shards before creating a new one. Skips contended shards.
+        for (u32 i = 1; i < COMMAND_ARENA_SHARD_COUNT && out == nullptr; ++i)
         {
-            // Get new Pool in array
-            if (transient_command_arenas.second >= DAXA_MAX_COMMAND_POOLS)
+            out = try_pop_available_arena((shard_index + i) % COMMAND_ARENA_SHARD_COUNT, vk_level, queue_type, false);
+        }
+
+        if (out != nullptr)
+        {
+            out->shard_index = shard_index;
+            out->owner_count.store(1, std::memory_order::relaxed);
+            return result;
+        }
+
+        // Create a new arena.
+        std::unique_lock<std::mutex> table_lock{table_mtx};
+        ImplTransientCommandArena & transient_cmd_arena = transient_command_arenas.emplace_back();
+        defer
+        {
+            if (result != DAXA_RESULT_SUCCESS)
             {
-                result = DAXA_RESULT_ERROR_EXCEEDED_MAX_COMMAND_POOLS;
+                transient_command_arenas.pop_back();
             }
-            _DAXA_RETURN_IF_ERROR(result, result);
-            u32 const command_arena_index = transient_command_arenas.second++;
-            ImplTransientCommandArena& transient_cmd_arena = transient_command_arenas.first[command_arena_index];
-            defer
-            {
-                if (result != DAXA_RESULT_SUCCESS)
-                {
-                    --transient_command_arenas.second;
-                }
-            };
-
-            // Create Command Pool
-            VkCommandPoolCreateInfo const vk_command_pool_create_info{
-                .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-                .pNext = nullptr,
-                .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
-                .queueFamilyIndex = queue_type_index,
-            };
-            result = static_cast<daxa_Result>(vkCreateCommandPool(vk_device, &vk_command_pool_create_info, nullptr, &transient_cmd_arena.vk_command_pool));
-            _DAXA_RETURN_IF_ERROR(result, result);
-            defer
+        };
+
+        // Create Command Pool
+        VkCommandPoolCreateInfo const vk_command_pool_create_info{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+            .queueFamilyIndex = queue_type_index,
+        };
+        result = static_cast<daxa_Result>(vkCreateCommandPool(vk_device, &vk_command_pool_create_info, nullptr, &transient_cmd_arena.vk_command_pool));
+        _DAXA_RETURN_IF_ERROR(result, result);
+        defer
+        {
+            if (result != DAXA_RESULT_SUCCESS)
             {
-                if (result != DAXA_RESULT_SUCCESS)
-                {
-                    vkDestroyCommandPool(vk_device, transient_cmd_arena.vk_command_pool, nullptr);
-                }
-            };                
-
-            // Create Command Buffer
-            VkCommandBufferAllocateInfo const vk_command_buffer_allocate_info{
-                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-                .pNext = nullptr,
-                .commandPool = transient_cmd_arena.vk_command_pool,
-                .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-                .commandBufferCount = 1u,
-            };
-            result = static_cast<daxa_Result>(vkAllocateCommandBuffers(vk_device, &vk_command_buffer_allocate_info, &transient_cmd_arena.vk_command_buffer));
-            _DAXA_RETURN_IF_ERROR(result, result);
-
-            transient_cmd_arena.queue_type = queue_type;
-            transient_cmd_arena.vk_queue_type_index = queue_type_index;
-
-            // Append pool to available list
-            available_command_pools.push_back(command_arena_index);
-        }
+                vkDestroyCommandPool(vk_device, transient_cmd_arena.vk_command_pool, nullptr);
+            }
+        };                
+
+        // Create Command Buffer
+        VkCommandBufferAllocateInfo const vk_command_buffer_allocate_info{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .pNext = nullptr,
+            .commandPool = transient_cmd_arena.vk_command_pool,
+            .level = vk_level,
+            .commandBufferCount = 1u,
+        };
+        result = static_cast<daxa_Result>(vkAllocateCommandBuffers(vk_device, &vk_command_buffer_allocate_info, &transient_cmd_arena.vk_command_buffer));
+        _DAXA_RETURN_IF_ERROR(result, result);
 
-        // Determine command pool and buffer index and fill the out variable
-        u32 const command_arena_index = available_command_pools.back();
-        available_command_pools.pop_back();
-        out = &transient_command_arenas.first[command_arena_index];
+        transient_cmd_arena.queue_type = queue_type;
+        transient_cmd_arena.vk_queue_type_index = queue_type_index;
+        transient_cmd_arena.shard_index = shard_index;
+        transient_cmd_arena.vk_level = vk_level;
+        transient_cmd_arena.owner_count.store(1, std::memory_order::relaxed);
+        transient_cmd_arena.set_slab_pool(&slab_pool);
 
+        out = &transient_cmd_arena;
         return result;
     }
 
-    auto retire_arena(VkDevice vk_device, ImplTransientCommandArena * cmd_arena, std::unique_lock<std::mutex>* lock = {}) -> daxa_Result
+    auto retire_arena(VkDevice vk_device, ImplTransientCommandArena * cmd_arena) -> daxa_Result
     {
-        std::unique_lock<std::mutex> local_lock = lock == nullptr ? std::unique_lock(mtx) : std::unique_lock<std::mutex>{};
         daxa_Result result = DAXA_RESULT_SUCCESS;
 
-        u32 const cmd_arena_index = (cmd_arena - transient_command_arenas.first.data());
-
+        // The retired arena is exclusively owned here, the reset does not need a lock.
         result = static_cast<daxa_Result>(vkResetCommandPool(vk_device, cmd_arena->vk_command_pool, {}));
         _DAXA_RETURN_IF_ERROR(result, result);
 
@@ -144,8 +224,21 @@ struct ImplTransientCommandArenas
         cmd_arena->used_tlass.clear();
         cmd_arena->used_blass.clear();
         cmd_arena->deferred_destructions.clear();
+        for (ImplTransientCommandArena * secondary_arena : cmd_arena->executed_secondaries)
+        {
+            // Reusable secondary arenas stay alive while their executable command list or other executing arenas still reference them.
+            if (secondary_arena->owner_count.fetch_sub(1, std::memory_order::acq_rel) == 1)
+            {
+                result = retire_arena(vk_device, secondary_arena);
+                _DAXA_RETURN_IF_ERROR(result, result);
+            }
+        }
+        cmd_arena->executed_secondaries.clear();
+        cmd_arena->remembered_id_cache = {};
 
-        available_arenas[cmd_arena->queue_type].push_front(cmd_arena_index);
+        Shard & shard = shards[cmd_arena->shard_index];
+        std::unique_lock<std::mutex> lock{shard.mtx};
+        shard.available_arenas[cmd_arena->vk_level][cmd_arena->queue_type].push_back(cmd_arena);
 
         return result;
     }
@@ -159,16 +252,35 @@ struct daxa_ImplCommandRecorder final : ImplHandle
 {
     daxa_Device device = {};
     bool in_renderpass = {};
+    // Secondary recorders record into a render pass begun by the primary recorder that executes them.
+    bool secondary = {};
+    // The current render pass only allows executing secondary command lists.
+    bool secondary_command_list_renderpass = {};
     daxa_CommandRecorderInfo info = {};
-    std::array<VkMemoryBarrier2, COMMAND_RECORDER_BARRIER_MAX_BATCH_SIZE> memory_barrier_batch = {};
-    std::array<VkImageMemoryBarrier2, COMMAND_RECORDER_BARRIER_MAX_BATCH_SIZE> image_barrier_batch = {};
-    usize image_barrier_batch_count = {};
-    usize memory_barrier_batch_count = {};
+    // Pending barriers, flushed only before commands that access memory.
+    // The batches grow as needed and keep their capacity, so they stop allocating after warm up.
+    std::vector<VkMemoryBarrier2> memory_barrier_batch = {};
+    std::vector<VkImageMemoryBarrier2> image_barrier_batch = {};
     struct NoPipeline
     {
     };
     Variant<NoPipeline, daxa_ComputePipeline, daxa_RasterPipeline, daxa_RayTracingPipeline> current_pipeline = NoPipeline{};
 
+    // Assumed state of the vulkan command buffer, used to skip redundant state changes.
+    // Pipelines and descriptor set bindings are tracked per bind point.
+    std::array<VkPipeline, COMMAND_RECORDER_BIND_POINT_COUNT> bound_pipelines = {};
+    std::array<VkPipelineLayout, COMMAND_RECORDER_BIND_POINT_COUNT> bound_descriptor_set_layouts = {};
+    // Layout the push constant range was last fully written with, push_constant_data mirrors the written range.
+    VkPipelineLayout push_constant_layout = {};
+    std::array<std::byte, DAXA_MAX_PUSH_CONSTANT_BYTE_SIZE> push_constant_data = {};
+    bool viewport_set = {};
+    VkViewport viewport = {};
+    bool scissor_set = {};
+    VkRect2D scissor = {};
+    bool depth_bias_set = {};
+    daxa_DepthBiasInfo depth_bias = {};
+    daxa_CommandRecorderStatistics statistics = {};
+
     ImplTransientCommandArena* command_arena = {};
 
     static void zero_ref_callback(ImplHandle const * handle);
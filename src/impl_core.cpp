@@ -41,6 +41,302 @@ auto infer_aspect_from_format(Format format) -> VkImageAspectFlags
     return VK_IMAGE_ASPECT_COLOR_BIT;
 }
 
+auto texel_block_size(Format format) -> u32
+{
+    // Depth stencil formats return the size of the depth aspect.
+    // Multi planar formats return 4, the size of their largest plane texel.
+    switch (format)
+    {
+    case Format::R4G4_UNORM_PACK8:
+    case Format::R8_UNORM:
+    case Format::R8_SNORM:
+    case Format::R8_USCALED:
+    case Format::R8_SSCALED:
+    case Format::R8_UINT:
+    case Format::R8_SINT:
+    case Format::R8_SRGB:
+    case Format::S8_UINT:
+        return 1;
+    case Format::R4G4B4A4_UNORM_PACK16:
+    case Format::B4G4R4A4_UNORM_PACK16:
+    case Format::R5G6B5_UNORM_PACK16:
+    case Format::B5G6R5_UNORM_PACK16:
+    case Format::R5G5B5A1_UNORM_PACK16:
+    case Format::B5G5R5A1_UNORM_PACK16:
+    case Format::A1R5G5B5_UNORM_PACK16:
+    case Format::R8G8_UNORM:
+    case Format::R8G8_SNORM:
+    case Format::R8G8_USCALED:
+    case Format::R8G8_SSCALED:
+    case Format::R8G8_UINT:
+    case Format::R8G8_SINT:
+    case Format::R8G8_SRGB:
+    case Format::R16_UNORM:
+    case Format::R16_SNORM:
+    case Format::R16_USCALED:
+    case Format::R16_SSCALED:
+    case Format::R16_UINT:
+    case Format::R16_SINT:
+    case Format::R16_SFLOAT:
+    case Format::D16_UNORM:
+    case Format::D16_UNORM_S8_UINT:
+    case Format::R10X6_UNORM_PACK16:
+    case Format::R12X4_UNORM_PACK16:
+    case Format::A4R4G4B4_UNORM_PACK16:
+    case Format::A4B4G4R4_UNORM_PACK16:
+        return 2;
+    case Format::R8G8B8_UNORM:
+    case Format::R8G8B8_SNORM:
+    case Format::R8G8B8_USCALED:
+    case Format::R8G8B8_SSCALED:
+    case Format::R8G8B8_UINT:
+    case Format::R8G8B8_SINT:
+    case Format::R8G8B8_SRGB:
+    case Format::B8G8R8_UNORM:
+    case Format::B8G8R8_SNORM:
+    case Format::B8G8R8_USCALED:
+    case Format::B8G8R8_SSCALED:
+    case Format::B8G8R8_UINT:
+    case Format::B8G8R8_SINT:
+    case Format::B8G8R8_SRGB:
+        return 3;
+    case Format::R16G16B16_UNORM:
+    case Format::R16G16B16_SNORM:
+    case Format::R16G16B16_USCALED:
+    case Format::R16G16B16_SSCALED:
+    case Format::R16G16B16_UINT:
+    case Format::R16G16B16_SINT:
+    case Format::R16G16B16_SFLOAT:
+        return 6;
+    case Format::R16G16B16A16_UNORM:
+    case Format::R16G16B16A16_SNORM:
+    case Format::R16G16B16A16_USCALED:
+    case Format::R16G16B16A16_SSCALED:
+    case Format::R16G16B16A16_UINT:
+    case Format::R16G16B16A16_SINT:
+    case Format::R16G16B16A16_SFLOAT:
+    case Format::R32G32_UINT:
+    case Format::R32G32_SINT:
+    case Format::R32G32_SFLOAT:
+    case Format::R64_UINT:
+    case Format::R64_SINT:
+    case Format::R64_SFLOAT:
+    case Format::BC1_RGB_UNORM_BLOCK:
+    case Format::BC1_RGB_SRGB_BLOCK:
+    case Format::BC1_RGBA_UNORM_BLOCK:
+    case Format::BC1_RGBA_SRGB_BLOCK:
+    case Format::BC4_UNORM_BLOCK:
+    case Format::BC4_SNORM_BLOCK:
+    case Format::ETC2_R8G8B8_UNORM_BLOCK:
+    case Format::ETC2_R8G8B8_SRGB_BLOCK:
+    case Format::ETC2_R8G8B8A1_UNORM_BLOCK:
+    case Format::ETC2_R8G8B8A1_SRGB_BLOCK:
+    case Format::EAC_R11_UNORM_BLOCK:
+    case Format::EAC_R11_SNORM_BLOCK:
+    case Format::R10X6G10X6B10X6A10X6_UNORM_4PACK16:
+    case Format::G10X6B10X6G10X6R10X6_422_UNORM_4PACK16:
+    case Format::B10X6G10X6R10X6G10X6_422_UNORM_4PACK16:
+    case Format::R12X4G12X4B12X4A12X4_UNORM_4PACK16:
+    case Format::G12X4B12X4G12X4R12X4_422_UNORM_4PACK16:
+    case Format::B12X4G12X4R12X4G12X4_422_UNORM_4PACK16:
+    case Format::G16B16G16R16_422_UNORM:
+    case Format::B16G16R16G16_422_UNORM:
+    case Format::PVRTC1_2BPP_UNORM_BLOCK_IMG:
+    case Format::PVRTC1_4BPP_UNORM_BLOCK_IMG:
+    case Format::PVRTC2_2BPP_UNORM_BLOCK_IMG:
+    case Format::PVRTC2_4BPP_UNORM_BLOCK_IMG:
+    case Format::PVRTC1_2BPP_SRGB_BLOCK_IMG:
+    case Format::PVRTC1_4BPP_SRGB_BLOCK_IMG:
+    case Format::PVRTC2_2BPP_SRGB_BLOCK_IMG:
+    case Format::PVRTC2_4BPP_SRGB_BLOCK_IMG:
+        return 8;
+    case Format::R32G32B32_UINT:
+    case Format::R32G32B32_SINT:
+    case Format::R32G32B32_SFLOAT:
+        return 12;
+    case Format::R32G32B32A32_UINT:
+    case Format::R32G32B32A32_SINT:
+    case Format::R32G32B32A32_SFLOAT:
+    case Format::R64G64_UINT:
+    case Format::R64G64_SINT:
+    case Format::R64G64_SFLOAT:
+    case Format::BC2_UNORM_BLOCK:
+    case Format::BC2_SRGB_BLOCK:
+    case Format::BC3_UNORM_BLOCK:
+    case Format::BC3_SRGB_BLOCK:
+    case Format::BC5_UNORM_BLOCK:
+    case Format::BC5_SNORM_BLOCK:
+    case Format::BC6H_UFLOAT_BLOCK:
+    case Format::BC6H_SFLOAT_BLOCK:
+    case Format::BC7_UNORM_BLOCK:
+    case Format::BC7_SRGB_BLOCK:
+    case Format::ETC2_R8G8B8A8_UNORM_BLOCK:
+    case Format::ETC2_R8G8B8A8_SRGB_BLOCK:
+    case Format::EAC_R11G11_UNORM_BLOCK:
+    case Format::EAC_R11G11_SNORM_BLOCK:
+    case Format::ASTC_4x4_UNORM_BLOCK:
+    case Format::ASTC_4x4_SRGB_BLOCK:
+    case Format::ASTC_5x4_UNORM_BLOCK:
+    case Format::ASTC_5x4_SRGB_BLOCK:
+    case Format::ASTC_5x5_UNORM_BLOCK:
+    case Format::ASTC_5x5_SRGB_BLOCK:
+    case Format::ASTC_6x5_UNORM_BLOCK:
+    case Format::ASTC_6x5_SRGB_BLOCK:
+    case Format::ASTC_6x6_UNORM_BLOCK:
+    case Format::ASTC_6x6_SRGB_BLOCK:
+    case Format::ASTC_8x5_UNORM_BLOCK:
+    case Format::ASTC_8x5_SRGB_BLOCK:
+    case Format::ASTC_8x6_UNORM_BLOCK:
+    case Format::ASTC_8x6_SRGB_BLOCK:
+    case Format::ASTC_8x8_UNORM_BLOCK:
+    case Format::ASTC_8x8_SRGB_BLOCK:
+    case Format::ASTC_10x5_UNORM_BLOCK:
+    case Format::ASTC_10x5_SRGB_BLOCK:
+    case Format::ASTC_10x6_UNORM_BLOCK:
+    case Format::ASTC_10x6_SRGB_BLOCK:
+    case Format::ASTC_10x8_UNORM_BLOCK:
+    case Format::ASTC_10x8_SRGB_BLOCK:
+    case Format::ASTC_10x10_UNORM_BLOCK:
+    case Format::ASTC_10x10_SRGB_BLOCK:
+    case Format::ASTC_12x10_UNORM_BLOCK:
+    case Format::ASTC_12x10_SRGB_BLOCK:
+    case Format::ASTC_12x12_UNORM_BLOCK:
+    case Format::ASTC_12x12_SRGB_BLOCK:
+    case Format::ASTC_4x4_SFLOAT_BLOCK:
+    case Format::ASTC_5x4_SFLOAT_BLOCK:
+    case Format::ASTC_5x5_SFLOAT_BLOCK:
+    case Format::ASTC_6x5_SFLOAT_BLOCK:
+    case Format::ASTC_6x6_SFLOAT_BLOCK:
+    case Format::ASTC_8x5_SFLOAT_BLOCK:
+    case Format::ASTC_8x6_SFLOAT_BLOCK:
+    case Format::ASTC_8x8_SFLOAT_BLOCK:
+    case Format::ASTC_10x5_SFLOAT_BLOCK:
+    case Format::ASTC_10x6_SFLOAT_BLOCK:
+    case Format::ASTC_10x8_SFLOAT_BLOCK:
+    case Format::ASTC_10x10_SFLOAT_BLOCK:
+    case Format::ASTC_12x10_SFLOAT_BLOCK:
+    case Format::ASTC_12x12_SFLOAT_BLOCK:
+        return 16;
+    case Format::R64G64B64_UINT:
+    case Format::R64G64B64_SINT:
+    case Format::R64G64B64_SFLOAT:
+        return 24;
+    case Format::R64G64B64A64_UINT:
+    case Format::R64G64B64A64_SINT:
+    case Format::R64G64B64A64_SFLOAT:
+        return 32;
+    default: return 4;
+    }
+}
+
+auto texel_block_extent(Format format) -> Extent3D
+{
+    switch (format)
+    {
+    case Format::G8B8G8R8_422_UNORM:
+    case Format::B8G8R8G8_422_UNORM:
+    case Format::G10X6B10X6G10X6R10X6_422_UNORM_4PACK16:
+    case Format::B10X6G10X6R10X6G10X6_422_UNORM_4PACK16:
+    case Format::G12X4B12X4G12X4R12X4_422_UNORM_4PACK16:
+    case Format::B12X4G12X4R12X4G12X4_422_UNORM_4PACK16:
+    case Format::G16B16G16R16_422_UNORM:
+    case Format::B16G16R16G16_422_UNORM:
+        return {2, 1, 1};
+    case Format::BC1_RGB_UNORM_BLOCK:
+    case Format::BC1_RGB_SRGB_BLOCK:
+    case Format::BC1_RGBA_UNORM_BLOCK:
+    case Format::BC1_RGBA_SRGB_BLOCK:
+    case Format::BC2_UNORM_BLOCK:
+    case Format::BC2_SRGB_BLOCK:
+    case Format::BC3_UNORM_BLOCK:
+    case Format::BC3_SRGB_BLOCK:
+    case Format::BC4_UNORM_BLOCK:
+    case Format::BC4_SNORM_BLOCK:
+    case Format::BC5_UNORM_BLOCK:
+    case Format::BC5_SNORM_BLOCK:
+    case Format::BC6H_UFLOAT_BLOCK:
+    case Format::BC6H_SFLOAT_BLOCK:
+    case Format::BC7_UNORM_BLOCK:
+    case Format::BC7_SRGB_BLOCK:
+    case Format::ETC2_R8G8B8_UNORM_BLOCK:
+    case Format::ETC2_R8G8B8_SRGB_BLOCK:
+    case Format::ETC2_R8G8B8A1_UNORM_BLOCK:
+    case Format::ETC2_R8G8B8A1_SRGB_BLOCK:
+    case Format::ETC2_R8G8B8A8_UNORM_BLOCK:
+    case Format::ETC2_R8G8B8A8_SRGB_BLOCK:
+    case Format::EAC_R11_UNORM_BLOCK:
+    case Format::EAC_R11_SNORM_BLOCK:
+    case Format::EAC_R11G11_UNORM_BLOCK:
+    case Format::EAC_R11G11_SNORM_BLOCK:
+    case Format::ASTC_4x4_UNORM_BLOCK:
+    case Format::ASTC_4x4_SRGB_BLOCK:
+    case Format::ASTC_4x4_SFLOAT_BLOCK:
+    case Format::PVRTC1_4BPP_UNORM_BLOCK_IMG:
+    case Format::PVRTC2_4BPP_UNORM_BLOCK_IMG:
+    case Format::PVRTC1_4BPP_SRGB_BLOCK_IMG:
+    case Format::PVRTC2_4BPP_SRGB_BLOCK_IMG:
+        return {4, 4, 1};
+    case Format::ASTC_5x4_UNORM_BLOCK:
+    case Format::ASTC_5x4_SRGB_BLOCK:
+    case Format::ASTC_5x4_SFLOAT_BLOCK:
+        return {5, 4, 1};
+    case Format::ASTC_5x5_UNORM_BLOCK:
+    case Format::ASTC_5x5_SRGB_BLOCK:
+    case Format::ASTC_5x5_SFLOAT_BLOCK:
+        return {5, 5, 1};
+    case Format::ASTC_6x5_UNORM_BLOCK:
+    case Format::ASTC_6x5_SRGB_BLOCK:
+    case Format::ASTC_6x5_SFLOAT_BLOCK:
+        return {6, 5, 1};
+    case Format::ASTC_6x6_UNORM_BLOCK:
+    case Format::ASTC_6x6_SRGB_BLOCK:
+    case Format::ASTC_6x6_SFLOAT_BLOCK:
+        return {6, 6, 1};
+    case Format::PVRTC1_2BPP_UNORM_BLOCK_IMG:
+    case Format::PVRTC2_2BPP_UNORM_BLOCK_IMG:
+    case Format::PVRTC1_2BPP_SRGB_BLOCK_IMG:
+    case Format::PVRTC2_2BPP_SRGB_BLOCK_IMG:
+        return {8, 4, 1};
+    case Format::ASTC_8x5_UNORM_BLOCK:
+    case Format::ASTC_8x5_SRGB_BLOCK:
+    case Format::ASTC_8x5_SFLOAT_BLOCK:
+        return {8, 5, 1};
+    case Format::ASTC_8x6_UNORM_BLOCK:
+    case Format::ASTC_8x6_SRGB_BLOCK:
+    case Format::ASTC_8x6_SFLOAT_BLOCK:
+        return {8, 6, 1};
+    case Format::ASTC_8x8_UNORM_BLOCK:
+    case Format::ASTC_8x8_SRGB_BLOCK:
+    case Format::ASTC_8x8_SFLOAT_BLOCK:
+        return {8, 8, 1};
+    case Format::ASTC_10x5_UNORM_BLOCK:
+    case Format::ASTC_10x5_SRGB_BLOCK:
+    case Format::ASTC_10x5_SFLOAT_BLOCK:
+        return {10, 5, 1};
+    case Format::ASTC_10x6_UNORM_BLOCK:
+    case Format::ASTC_10x6_SRGB_BLOCK:
+    case Format::ASTC_10x6_SFLOAT_BLOCK:
+        return {10, 6, 1};
+    case Format::ASTC_10x8_UNORM_BLOCK:
+    case Format::ASTC_10x8_SRGB_BLOCK:
+    case Format::ASTC_10x8_SFLOAT_BLOCK:
+        return {10, 8, 1};
+    case Format::ASTC_10x10_UNORM_BLOCK:
+    case Format::ASTC_10x10_SRGB_BLOCK:
+    case Format::ASTC_10x10_SFLOAT_BLOCK:
+        return {10, 10, 1};
+    case Format::ASTC_12x10_UNORM_BLOCK:
+    case Format::ASTC_12x10_SRGB_BLOCK:
+    case Format::ASTC_12x10_SFLOAT_BLOCK:
+        return {12, 10, 1};
+    case Format::ASTC_12x12_UNORM_BLOCK:
+    case Format::ASTC_12x12_SRGB_BLOCK:
+    case Format::ASTC_12x12_SFLOAT_BLOCK:
+        return {12, 12, 1};
+    default: return {1, 1, 1};
+    }
+}
+
 auto make_subresource_range(ImageMipArraySlice const & slice, VkImageAspectFlags aspect) -> VkImageSubresourceRange
 {
     return VkImageSubresourceRange{
@@ -12,6 +12,8 @@
 #include <deque>
 #include <cstring>
 #include <memory>
+#include <new>
+#include <cstddef>
 
 #include <format>
 #if DAXA_VALIDATION
@@ -87,6 +89,10 @@ auto is_stencil_format(Format format) -> bool;
 
 auto infer_aspect_from_format(Format format) -> VkImageAspectFlags;
 
+auto texel_block_size(Format format) -> u32;
+
+auto texel_block_extent(Format format) -> Extent3D;
+
 auto make_subresource_range(ImageMipArraySlice const & slice, VkImageAspectFlags aspect) -> VkImageSubresourceRange;
 
 auto make_subresource_layers(ImageArraySlice const & slice, VkImageAspectFlags aspect) -> VkImageSubresourceLayers;
@@ -727,4 +733,200 @@ namespace daxa
             return ret;
         }
     };
+
+    // Threadsafe pool of memory slabs in power of two size classes, from 1kib up to 16kib.
+    // Slabs are recycled and only freed when the pool is destroyed, so after warm up growing a SlabArray never allocates.
+    struct SlabPool
+    {
+        static inline constexpr u32 MIN_SLAB_SIZE_LOG2 = 10u; // 1kib
+        static inline constexpr u32 SIZE_CLASS_COUNT = 5u;    // up to 16kib
+
+        static constexpr auto slab_size(u32 size_class) -> u64
+        {
+            return 1ull << (MIN_SLAB_SIZE_LOG2 + size_class);
+        }
+
+        struct SlabHeader
+        {
+            SlabHeader * next = {};
+            u32 size_class = {};
+        };
+
+        std::mutex mtx = {};
+        std::array<SlabHeader *, SIZE_CLASS_COUNT> free_slabs = {};
+        u64 allocated_slab_count = {};
+
+        SlabPool() = default;
+        SlabPool(SlabPool const &) = delete;
+        SlabPool & operator=(SlabPool const &) = delete;
+        ~SlabPool()
+        {
+            for (SlabHeader *& free_list : free_slabs)
+            {
+                while (free_list != nullptr)
+                {
+                    SlabHeader * next = free_list->next;
+                    ::operator delete[](reinterpret_cast<u8 *>(free_list), std::align_val_t(alignof(std::max_align_t)));
+                    free_list = next;
+                }
+            }
+        }
+
+        auto acquire(u32 size_class) -> SlabHeader *
+        {
+            std::unique_lock lock{mtx};
+            SlabHeader * slab = free_slabs[size_class];
+            if (slab != nullptr)
+            {
+                free_slabs[size_class] = slab->next;
+            }
+            else
+            {
+                slab = reinterpret_cast<SlabHeader *>(::operator new[](slab_size(size_class), std::align_val_t(alignof(std::max_align_t))));
+                slab->size_class = size_class;
+                allocated_slab_count += 1;
+            }
+            slab->next = nullptr;
+            return slab;
+        }
+
+        // Returns a linked chain of slabs with a single lock.
+        void release_chain(SlabHeader * first)
+        {
+            if (first == nullptr)
+            {
+                return;
+            }
+            std::unique_lock lock{mtx};
+            while (first != nullptr)
+            {
+                SlabHeader * next = first->next;
+                first->next = free_slabs[first->size_class];
+                free_slabs[first->size_class] = first;
+                first = next;
+            }
+        }
+    };
+
+    // Growable array of trivial elements, stored in a linked list of slabs from a SlabPool.
+    // Starts with the smallest slab and doubles the slab size with each new slab up to the largest size class,
+    // so rarely used arrays stay small while heavily used arrays need few slabs.
+    // Has no size limit. Clearing returns all slabs to the pool.
+    template <TrivialType T>
+    struct SlabArray
+    {
+        using SlabHeader = SlabPool::SlabHeader;
+        static inline constexpr u64 DATA_OFFSET = align_up(sizeof(SlabHeader), alignof(T));
+        static_assert((SlabPool::slab_size(0) - DATA_OFFSET) / sizeof(T) > 0, "ERROR: element type is larger than the smallest slab");
+
+        static constexpr auto slab_capacity(SlabHeader const * slab) -> u64
+        {
+            return (SlabPool::slab_size(slab->size_class) - DATA_OFFSET) / sizeof(T);
+        }
+
+        SlabPool * pool = {};
+        SlabHeader * first_slab = {};
+        SlabHeader * last_slab = {};
+        u64 last_slab_element_count = {};
+        u64 element_count = {};
+
+        SlabArray() = default;
+        SlabArray(SlabPool * a_pool) : pool{a_pool} {}
+        SlabArray(SlabArray const &) = delete;
+        SlabArray & operator=(SlabArray const &) = delete;
+        SlabArray(SlabArray && other) { *this = std::move(other); }
+        SlabArray & operator=(SlabArray && other)
+        {
+            this->clear();
+            this->pool = std::exchange(other.pool, {});
+            this->first_slab = std::exchange(other.first_slab, {});
+            this->last_slab = std::exchange(other.last_slab, {});
+            this->last_slab_element_count = std::exchange(other.last_slab_element_count, {});
+            this->element_count = std::exchange(other.element_count, {});
+            return *this;
+        }
+        ~SlabArray() { this->clear(); }
+
+        static auto slab_elements(SlabHeader * slab) -> T *
+        {
+            return reinterpret_cast<T *>(reinterpret_cast<u8 *>(slab) + DATA_OFFSET);
+        }
+
+        auto size() const -> usize { return static_cast<usize>(element_count); }
+        auto empty() const -> bool { return element_count == 0u; }
+
+        void push_back(T const & v)
+        {
+            if (last_slab == nullptr || last_slab_element_count == slab_capacity(last_slab))
+            {
+                u32 const size_class = last_slab != nullptr ? std::min(last_slab->size_class + 1u, SlabPool::SIZE_CLASS_COUNT - 1u) : 0u;
+                SlabHeader * slab = pool->acquire(size_class);
+                if (last_slab != nullptr)
+                {
+                    last_slab->next = slab;
+                }
+                else
+                {
+                    first_slab = slab;
+                }
+                last_slab = slab;
+                last_slab_element_count = 0;
+            }
+            new (&slab_elements(last_slab)[last_slab_element_count]) T(v);
+            ++last_slab_element_count;
+            ++element_count;
+        }
+
+        template <typename... Args>
+        void emplace_back(Args &&... args)
+        {
+            this->push_back(T{std::forward<Args>(args)...});
+        }
+
+        void clear()
+        {
+            if (pool != nullptr)
+            {
+                pool->release_chain(first_slab);
+            }
+            first_slab = {};
+            last_slab = {};
+            last_slab_element_count = {};
+            element_count = {};
+        }
+
+        struct Iterator
+        {
+            SlabHeader * slab = {};
+            u64 slab_index = {};
+            u64 index = {};
+
+            using difference_type = std::ptrdiff_t;
+            using value_type = T;
+
+            auto operator*() const -> T & { return slab_elements(slab)[slab_index]; }
+            auto operator->() const -> T * { return &slab_elements(slab)[slab_index]; }
+            auto operator++() -> Iterator &
+            {
+                ++index;
+                ++slab_index;
+                if (slab_index == slab_capacity(slab))
+                {
+                    slab = slab->next;
+                    slab_index = 0;
+                }
+                return *this;
+            }
+            auto operator++(int) -> Iterator
+            {
+                Iterator ret = *this;
+                ++(*this);
+                return ret;
+            }
+            auto operator==(Iterator const & other) const -> bool { return index == other.index; }
+        };
+
+        auto begin() const -> Iterator { return Iterator{first_slab, 0, 0}; }
+        auto end() const -> Iterator { return Iterator{nullptr, 0, element_count}; }
+    };
 }
\ No newline at end of file
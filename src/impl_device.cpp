@@ -3,6 +3,8 @@
 #include "impl_device.hpp"
 
 #include <unordered_map>
+#include <algorithm>
+#include <chrono>
 #include <utility>
 #include "daxa/core.hpp"
 #include "impl_features.hpp"
@@ -65,6 +67,38 @@ namespace
         }
         return result;
     }
+
+    // Prefixed to the vulkan pipeline cache data by daxa_dvc_get_pipeline_cache_data.
+    // Vulkan's own cache header does not record the driver version, and some drivers do not handle foreign or stale data gracefully.
+    // Validating this header before handing the data to the driver lets daxa reject caches from other gpus or driver versions up front.
+    struct PipelineCacheDataHeader
+    {
+        u32 magic = {};
+        u32 header_version = {};
+        u32 vendor_id = {};
+        u32 device_id = {};
+        u32 driver_version = {};
+        u32 vk_data_offset = {};
+        u64 vk_data_size = {};
+        std::array<char, VK_UUID_SIZE> pipeline_cache_uuid = {};
+    };
+    static constexpr u32 PIPELINE_CACHE_DATA_MAGIC = 0x43505844u; // "DXPC"
+    static constexpr u32 PIPELINE_CACHE_DATA_HEADER_VERSION = 1u;
+
+    auto make_pipeline_cache_data_header(daxa_DeviceProperties const & properties, u64 vk_data_size) -> PipelineCacheDataHeader
+    {
+        PipelineCacheDataHeader header = {
+            .magic = PIPELINE_CACHE_DATA_MAGIC,
+            .header_version = PIPELINE_CACHE_DATA_HEADER_VERSION,
+            .vendor_id = properties.vendor_id,
+            .device_id = properties.device_id,
+            .driver_version = properties.driver_version,
+            .vk_data_offset = static_cast<u32>(sizeof(PipelineCacheDataHeader)),
+            .vk_data_size = vk_data_size,
+        };
+        std::memcpy(header.pipeline_cache_uuid.data(), properties.pipeline_cache_uuid, VK_UUID_SIZE);
+        return header;
+    }
 } // namespace
 
 auto daxa_ImplDevice::ImplQueue::initialize(VkDevice a_vk_device) -> daxa_Result
@@ -130,7 +164,7 @@ auto daxa_ImplDevice::ImplQueue::get_oldest_pending_submit(VkDevice a_vk_device,
     return DAXA_RESULT_SUCCESS;
 }
 
-auto create_buffer_helper(daxa_Device self, daxa_BufferInfo const * info, daxa_BufferId * out_id, daxa_MemoryBlock opt_memory_block, usize opt_offset) -> daxa_Result
+auto create_buffer_helper(daxa_Device self, daxa_BufferInfo const * info, daxa_BufferId * out_id, daxa_MemoryBlock opt_memory_block, usize opt_offset, bool write_descriptor = true) -> daxa_Result
 {
     daxa_Result result = DAXA_RESULT_SUCCESS;
     // --- Begin Parameter Validation ---
@@ -276,6 +310,8 @@ auto create_buffer_helper(daxa_Device self, daxa_BufferInfo const * info, daxa_B
         self->vkSetDebugUtilsObjectNameEXT(self->vk_device, &buffer_name_info);
     }
 
+    // Batched creation writes all descriptors in a single update after all buffers are created.
+    if (write_descriptor)
     {
         // Does not need external sync given we use update after bind.
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkDescriptorBindingFlagBits.html
@@ -291,7 +327,7 @@ auto create_buffer_helper(daxa_Device self, daxa_BufferInfo const * info, daxa_B
     return result;
 }
 
-auto create_image_helper(daxa_Device self, daxa_ImageInfo const * info, daxa_ImageId * out_id, daxa_MemoryBlock opt_memory_block, usize opt_offset) -> daxa_Result
+auto create_image_helper(daxa_Device self, daxa_ImageInfo const * info, daxa_ImageId * out_id, daxa_MemoryBlock opt_memory_block, usize opt_offset, bool write_descriptor = true) -> daxa_Result
 {
     daxa_Result result = DAXA_RESULT_SUCCESS;
     /// --- Begin Validation ---
@@ -450,6 +486,8 @@ auto create_image_helper(daxa_Device self, daxa_ImageInfo const * info, daxa_Ima
         self->vkSetDebugUtilsObjectNameEXT(self->vk_device, &swapchain_image_view_name_info);
     }
 
+    // Batched creation writes all descriptors in a single update after all images are created.
+    if (write_descriptor)
     {
         // Does not need external sync given we use update after bind.
         // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VkDescriptorBindingFlagBits.html
@@ -938,6 +976,91 @@ auto daxa_dvc_create_image(daxa_Device self, daxa_ImageInfo const * info, daxa_I
     return create_image_helper(self, info, out_id, nullptr, 0);
 }
 
+auto daxa_dvc_create_buffers(daxa_Device self, daxa_BufferInfo const * infos, daxa_u32 count, daxa_BufferId * out_ids) -> daxa_Result
+{
+    daxa_Result result = DAXA_RESULT_SUCCESS;
+    u32 created_count = 0;
+    for (; created_count < count; ++created_count)
+    {
+        result = create_buffer_helper(self, &infos[created_count], &out_ids[created_count], nullptr, 0, false);
+        if (result != DAXA_RESULT_SUCCESS)
+        {
+            break;
+        }
+    }
+    // The batch either succeeds entirely or creates nothing.
+    if (result != DAXA_RESULT_SUCCESS)
+    {
+        [[maybe_unused]] auto const _ignore = daxa_dvc_destroy_buffers(self, out_ids, created_count);
+        std::fill_n(out_ids, count, daxa_BufferId{});
+    }
+    _DAXA_RETURN_IF_ERROR(result, result)
+
+    MemoryArena tmp_memory = MemoryArena{"daxa_dvc_create_buffers tmp memory", (sizeof(VkDescriptorBufferInfo) + sizeof(VkWriteDescriptorSet)) * count + 256u};
+    auto vk_descriptor_buffer_infos = tmp_memory.allocate_trivial_span<VkDescriptorBufferInfo>(count);
+    auto vk_write_descriptor_sets = tmp_memory.allocate_trivial_span<VkWriteDescriptorSet>(count);
+    for (u32 i = 0; i < count; ++i)
+    {
+        auto const id = std::bit_cast<BufferId>(out_ids[i]);
+        vk_descriptor_buffer_infos[i] = VkDescriptorBufferInfo{
+            .buffer = self->hot_slot(id).vk_buffer,
+            .offset = 0,
+            .range = static_cast<VkDeviceSize>(self->slot(id).info.size),
+        };
+        vk_write_descriptor_sets[i] = descriptor_set_buffer_write(self->gpu_sro_table.vk_descriptor_set, vk_descriptor_buffer_infos[i], static_cast<u32>(id.index));
+    }
+    // Does not need external sync given we use update after bind.
+    vkUpdateDescriptorSets(self->vk_device, count, vk_write_descriptor_sets.data(), 0, nullptr);
+    return result;
+}
+
+auto daxa_dvc_create_images(daxa_Device self, daxa_ImageInfo const * infos, daxa_u32 count, daxa_ImageId * out_ids) -> daxa_Result
+{
+    daxa_Result result = DAXA_RESULT_SUCCESS;
+    u32 created_count = 0;
+    for (; created_count < count; ++created_count)
+    {
+        result = create_image_helper(self, &infos[created_count], &out_ids[created_count], nullptr, 0, false);
+        if (result != DAXA_RESULT_SUCCESS)
+        {
+            break;
+        }
+    }
+    // The batch either succeeds entirely or creates nothing.
+    if (result != DAXA_RESULT_SUCCESS)
+    {
+        [[maybe_unused]] auto const _ignore = daxa_dvc_destroy_images(self, out_ids, created_count);
+        std::fill_n(out_ids, count, daxa_ImageId{});
+    }
+    _DAXA_RETURN_IF_ERROR(result, result)
+
+    // Each image has up to two descriptors, one storage and one sampled image descriptor.
+    MemoryArena tmp_memory = MemoryArena{"daxa_dvc_create_images tmp memory", (sizeof(VkDescriptorImageInfo) + sizeof(VkWriteDescriptorSet) * 2) * count + 256u};
+    auto vk_descriptor_image_infos = tmp_memory.allocate_trivial_span<VkDescriptorImageInfo>(count);
+    auto vk_write_descriptor_sets = tmp_memory.allocate_trivial_span<VkWriteDescriptorSet>(count * 2);
+    u32 vk_write_descriptor_set_count = 0;
+    for (u32 i = 0; i < count; ++i)
+    {
+        auto const id = std::bit_cast<ImageId>(out_ids[i]);
+        ImplImageSlot const & slot = self->slot(id);
+        auto const usage = std::bit_cast<ImageUsageFlags>(slot.info.usage);
+        vk_descriptor_image_infos[i] = VkDescriptorImageInfo{
+            .sampler = VK_NULL_HANDLE,
+            .imageView = slot.view_slot.vk_image_view,
+            .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+        };
+        vk_write_descriptor_set_count += descriptor_set_image_writes(
+            self->gpu_sro_table.vk_descriptor_set,
+            vk_descriptor_image_infos[i],
+            usage,
+            static_cast<u32>(id.index),
+            std::span<VkWriteDescriptorSet, 2>{vk_write_descriptor_sets.data() + vk_write_descriptor_set_count, 2});
+    }
+    // Does not need external sync given we use update after bind.
+    vkUpdateDescriptorSets(self->vk_device, vk_write_descriptor_set_count, vk_write_descriptor_sets.data(), 0, nullptr);
+    return result;
+}
+
 auto daxa_dvc_create_buffer_from_memory_block(daxa_Device self, daxa_MemoryBlockBufferInfo const * info, daxa_BufferId * out_id) -> daxa_Result
 {
     return create_buffer_helper(self, &info->buffer_info, out_id, *info->memory_block, info->offset);
@@ -1263,6 +1386,37 @@ auto template_hot_or_slot(auto & self, auto id)
             std::bit_cast<daxa::GPUResourceId>(id)));                                                                    \
     }
 
+template <typename T, typename ZombiesT>
+void zombiefy_batch(daxa_Device self, std::span<T const> ids, auto & slots, ZombiesT ZombieShard::* shard_zombies);
+
+#define _DAXA_DECL_BATCHED_GP_RES_DESTROY_FUNCTION(name, Name, NAME, SLOT_NAME, ZOMBIES)                                 \
+    auto daxa_dvc_destroy_##name##s(daxa_Device self, daxa_##Name##Id const * ids, daxa_u32 count) -> daxa_Result        \
+    {                                                                                                                    \
+        daxa_Result result = DAXA_RESULT_SUCCESS;                                                                        \
+        MemoryArena tmp_memory = MemoryArena{"daxa_dvc_destroy_" #name "s tmp memory", sizeof(Name##Id) * count + 256u}; \
+        auto zombie_ids = tmp_memory.allocate_trivial_span<Name##Id>(count);                                             \
+        u32 zombie_count = 0;                                                                                            \
+        for (u32 i = 0; i < count; ++i)                                                                                  \
+        {                                                                                                                \
+            auto ret = self->gpu_sro_table.SLOT_NAME.try_dec_refcnt(std::bit_cast<GPUResourceId>(ids[i]));               \
+            if (ret == TryDecRefcntResult::ERROR_INVALID_ID)                                                             \
+            {                                                                                                            \
+                result = DAXA_RESULT_INVALID_##NAME##_ID;                                                                \
+            }                                                                                                            \
+            if (ret == TryDecRefcntResult::SUCCESS_REFCOUNT_ZERO)                                                        \
+            {                                                                                                            \
+                zombie_ids[zombie_count++] = std::bit_cast<Name##Id>(ids[i]);                                            \
+            }                                                                                                            \
+        }                                                                                                                \
+        auto const zombies = std::span<Name##Id const>{zombie_ids.data(), zombie_count};                                 \
+        zombiefy_batch(self, zombies, self->gpu_sro_table.SLOT_NAME, &ZombieShard::ZOMBIES);                             \
+        _DAXA_RETURN_IF_ERROR(result, result);                                                                           \
+        return result;                                                                                                   \
+    }
+
+_DAXA_DECL_BATCHED_GP_RES_DESTROY_FUNCTION(buffer, Buffer, BUFFER, buffer_slots, buffer_zombies)
+_DAXA_DECL_BATCHED_GP_RES_DESTROY_FUNCTION(image, Image, IMAGE, image_slots, image_zombies)
+
 _DAXA_DECL_COMMON_GP_RES_FUNCTIONS(buffer, Buffer, BUFFER, buffer_slots, buffer, VkBuffer)
 _DAXA_DECL_COMMON_GP_RES_FUNCTIONS(image, Image, IMAGE, image_slots, image, VkImage)
 _DAXA_DECL_COMMON_GP_RES_FUNCTIONS(image_view, ImageView, IMAGE_VIEW, image_slots, image_view, VkImageView)
@@ -1515,6 +1669,10 @@ auto daxa_dvc_submit_commands(daxa_Device self, daxa_CommandSubmitInfo const * i
         {
             _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_CMD_LIST_SUBMIT_QUEUE_TYPE_MISMATCH, DAXA_RESULT_ERROR_CMD_LIST_SUBMIT_QUEUE_TYPE_MISMATCH);
         }
+        if (commands->command_arena == nullptr || commands->command_arena->vk_level == VK_COMMAND_BUFFER_LEVEL_SECONDARY)
+        {
+            _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_SECONDARY_CMD_LIST_SUBMITTED, DAXA_RESULT_ERROR_SECONDARY_CMD_LIST_SUBMITTED);
+        }
         for (BufferId id : commands->command_arena->used_buffers)
         {
             if (!daxa_dvc_is_buffer_valid(self, id))
@@ -1686,18 +1844,73 @@ auto daxa_dvc_present_frame(daxa_Device self, daxa_PresentInfo const * info) ->
 }
 
 auto daxa_dvc_collect_garbage(daxa_Device self) -> daxa_Result
+{
+    daxa_GarbageCollectionResult collection_result = {};
+    return daxa_dvc_collect_garbage_budgeted(self, &DAXA_DEFAULT_GARBAGE_COLLECTION_INFO, &collection_result);
+}
+
+auto daxa_dvc_collect_garbage_budgeted(daxa_Device self, daxa_GarbageCollectionInfo const * info, daxa_GarbageCollectionResult * out_result) -> daxa_Result
 {
     std::unique_lock lifetime_lock{self->gpu_sro_table.lifetime_lock};
     std::unique_lock lock{self->zombies_mtx};
-    std::unique_lock command_pools_lock{self->commands.mtx};
 
     u64 min_pending_device_timeline_value_of_all_queues = 0;
     auto result = daxa_dvc_oldest_pending_submit_index(self, &min_pending_device_timeline_value_of_all_queues);
     _DAXA_RETURN_IF_ERROR(result, result);
 
+    // Move all gpu resource and command zombies from the shards into the device zombie queues.
+    // The queues stay sorted by timeline value with the newest zombie in the front, no matter which shard a zombie came from.
+    // The cleanup below stops at the first zombie that is not ready yet, the sorting guarantees that no ready zombie is left behind it.
+    auto const newer_first = [](auto const & a, auto const & b)
+    {
+        return a.first > b.first;
+    };
+    auto merge_shard_zombies = [&](auto shard_zombies_member, auto & zombies)
+    {
+        usize const previous_size = zombies.size();
+        for (auto & shard : self->zombie_shards)
+        {
+            std::unique_lock const shard_lock{shard.mtx};
+            auto & shard_zombies = shard.*shard_zombies_member;
+            zombies.insert(zombies.begin(), shard_zombies.begin(), shard_zombies.end());
+            shard_zombies.clear();
+        }
+        // The queue was sorted before, only the new zombies need sorting before both ranges are merged.
+        auto const merged_end = zombies.begin() + static_cast<isize>(zombies.size() - previous_size);
+        std::sort(zombies.begin(), merged_end, newer_first);
+        std::inplace_merge(zombies.begin(), merged_end, zombies.end(), newer_first);
+    };
+    merge_shard_zombies(&ZombieShard::buffer_zombies, self->buffer_zombies);
+    merge_shard_zombies(&ZombieShard::image_zombies, self->image_zombies);
+    merge_shard_zombies(&ZombieShard::image_view_zombies, self->image_view_zombies);
+    merge_shard_zombies(&ZombieShard::sampler_zombies, self->sampler_zombies);
+    merge_shard_zombies(&ZombieShard::tlas_zombies, self->tlas_zombies);
+    merge_shard_zombies(&ZombieShard::blas_zombies, self->blas_zombies);
+    merge_shard_zombies(&ZombieShard::command_zombies, self->command_zombies);
+
+    u64 const max_objects = info->max_objects == 0 ? std::numeric_limits<u64>::max() : info->max_objects;
+    auto const start_time = std::chrono::steady_clock::now();
+    u64 collected_objects = 0;
+    bool budget_exhausted = false;
+    auto budget_left = [&]() -> bool
+    {
+        if (collected_objects >= max_objects)
+        {
+            return false;
+        }
+        if (info->max_time_us != 0)
+        {
+            auto const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+            return static_cast<u64>(elapsed.count()) < info->max_time_us;
+        }
+        return true;
+    };
+
+    // Once the budget is exhausted no further zombies of any kind are destroyed.
+    // This keeps the destruction order between zombie kinds intact, memory blocks are never freed before the buffers and images placed in them.
     auto check_and_cleanup_gpu_resources = [&](auto & zombies, auto const & cleanup_fn)
     {
-        while (!zombies.empty())
+        while (!zombies.empty() && !budget_exhausted)
         {
             auto & [timeline_value, object] = zombies.back();
 
@@ -1706,8 +1919,15 @@ auto daxa_dvc_collect_garbage(daxa_Device self) -> daxa_Result
                 break;
             }
 
+            if (!budget_left())
+            {
+                budget_exhausted = true;
+                break;
+            }
+
             cleanup_fn(object);
             zombies.pop_back();
+            ++collected_objects;
         }
     };
     check_and_cleanup_gpu_resources(
@@ -1782,8 +2002,10 @@ auto daxa_dvc_collect_garbage(daxa_Device self) -> daxa_Result
         {
             // Will error when pool reset failed. That is a unrecoverable error, we do not need to return it.
             // In the future it would still be nice to return this if we refactor the callback hell here.
-            [[maybe_unused]] auto result = self->commands.retire_arena(self->vk_device, cmd_arena, &command_pools_lock);
+            [[maybe_unused]] auto result = self->commands.retire_arena(self->vk_device, cmd_arena);
         });
+    out_result->collected_objects = collected_objects;
+    out_result->all_collected = static_cast<daxa_Bool8>(!budget_exhausted);
     return DAXA_RESULT_SUCCESS;
 }
 
@@ -1949,6 +2171,97 @@ auto daxa_dvc_choose_swapchain_surface_format(
     _DAXA_RETURN_IF_ERROR(DAXA_RESULT_NO_SUITABLE_FORMAT_FOUND, DAXA_RESULT_NO_SUITABLE_FORMAT_FOUND);
 }
 
+auto daxa_dvc_get_pipeline_cache_data(daxa_Device self, size_t * out_size, void * out_data) -> daxa_Result
+{
+    if (out_size == nullptr)
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_INVALID_POINTER_PARAMETER, DAXA_RESULT_ERROR_INVALID_POINTER_PARAMETER);
+    }
+
+    std::shared_lock lock{self->pipeline_cache_mtx};
+    if (out_data == nullptr)
+    {
+        size_t vk_data_size = 0;
+        auto result = static_cast<daxa_Result>(vkGetPipelineCacheData(self->vk_device, self->vk_pipeline_cache, &vk_data_size, nullptr));
+        _DAXA_RETURN_IF_ERROR(result, result)
+        *out_size = sizeof(PipelineCacheDataHeader) + vk_data_size;
+        return DAXA_RESULT_SUCCESS;
+    }
+
+    if (*out_size < sizeof(PipelineCacheDataHeader))
+    {
+        *out_size = 0;
+        return DAXA_RESULT_INCOMPLETE;
+    }
+    // The cache may have grown since the size query. Vulkan then writes as much as fits and reports VK_INCOMPLETE.
+    size_t vk_data_size = *out_size - sizeof(PipelineCacheDataHeader);
+    auto result = static_cast<daxa_Result>(vkGetPipelineCacheData(
+        self->vk_device,
+        self->vk_pipeline_cache,
+        &vk_data_size,
+        r_cast<std::byte *>(out_data) + sizeof(PipelineCacheDataHeader)));
+    if (result != DAXA_RESULT_SUCCESS && result != DAXA_RESULT_INCOMPLETE)
+    {
+        _DAXA_RETURN_IF_ERROR(result, result)
+    }
+    auto const header = make_pipeline_cache_data_header(self->properties, vk_data_size);
+    std::memcpy(out_data, &header, sizeof(PipelineCacheDataHeader));
+    *out_size = sizeof(PipelineCacheDataHeader) + vk_data_size;
+    return result;
+}
+
+auto daxa_dvc_load_pipeline_cache(daxa_Device self, void const * data, size_t size) -> daxa_Result
+{
+    if (data == nullptr && size != 0)
+    {
+        _DAXA_RETURN_IF_ERROR(DAXA_RESULT_ERROR_INVALID_POINTER_PARAMETER, DAXA_RESULT_ERROR_INVALID_POINTER_PARAMETER);
+    }
+
+    // Stale or foreign cache data is an expected condition (driver updates, different gpus), so this does not debug break.
+    if (size < sizeof(PipelineCacheDataHeader))
+    {
+        return DAXA_RESULT_ERROR_INCOMPATIBLE_PIPELINE_CACHE_DATA;
+    }
+    PipelineCacheDataHeader header = {};
+    std::memcpy(&header, data, sizeof(PipelineCacheDataHeader));
+    auto const expected = make_pipeline_cache_data_header(self->properties, size - sizeof(PipelineCacheDataHeader));
+    bool const compatible =
+        header.magic == expected.magic &&
+        header.header_version == expected.header_version &&
+        header.vendor_id == expected.vendor_id &&
+        header.device_id == expected.device_id &&
+        header.driver_version == expected.driver_version &&
+        header.vk_data_offset == expected.vk_data_offset &&
+        header.vk_data_size == expected.vk_data_size &&
+        header.pipeline_cache_uuid == expected.pipeline_cache_uuid;
+    if (!compatible)
+    {
+        return DAXA_RESULT_ERROR_INCOMPATIBLE_PIPELINE_CACHE_DATA;
+    }
+    if (header.vk_data_size == 0)
+    {
+        return DAXA_RESULT_SUCCESS;
+    }
+
+    VkPipelineCacheCreateInfo const vk_pipeline_cache_create_info{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = {},
+        .initialDataSize = static_cast<size_t>(header.vk_data_size),
+        .pInitialData = r_cast<std::byte const *>(data) + header.vk_data_offset,
+    };
+    VkPipelineCache loaded_cache = {};
+    auto result = static_cast<daxa_Result>(vkCreatePipelineCache(self->vk_device, &vk_pipeline_cache_create_info, nullptr, &loaded_cache));
+    _DAXA_RETURN_IF_ERROR(result, result)
+    {
+        std::unique_lock lock{self->pipeline_cache_mtx};
+        result = static_cast<daxa_Result>(vkMergePipelineCaches(self->vk_device, self->vk_pipeline_cache, 1u, &loaded_cache));
+    }
+    vkDestroyPipelineCache(self->vk_device, loaded_cache, nullptr);
+    _DAXA_RETURN_IF_ERROR(result, result)
+    return DAXA_RESULT_SUCCESS;
+}
+
 auto daxa_dvc_properties(daxa_Device device) -> daxa_DeviceProperties const *
 {
     return &device->properties;
@@ -2176,6 +2489,12 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
             self->vkCopyMemoryToImageEXT = r_cast<PFN_vkCopyMemoryToImageEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCopyMemoryToImageEXT"));
             self->vkCopyImageToMemoryEXT = r_cast<PFN_vkCopyImageToMemoryEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCopyImageToMemoryEXT"));
         }
+
+        if (properties.implicit_features & DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW)
+        {
+            self->vkCmdDrawMultiEXT = r_cast<PFN_vkCmdDrawMultiEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdDrawMultiEXT"));
+            self->vkCmdDrawMultiIndexedEXT = r_cast<PFN_vkCmdDrawMultiIndexedEXT>(vkGetDeviceProcAddr(self->vk_device, "vkCmdDrawMultiIndexedEXT"));
+        }
     }
 
     VkCommandPool init_cmd_pool = {};
@@ -2301,9 +2620,26 @@ auto daxa_ImplDevice::create_2(daxa_Instance instance, daxa_DeviceInfo2 const &
             {
                 vmaDestroyBuffer(self->vma_allocator, self->buffer_device_address_buffer, self->buffer_device_address_buffer_allocation);
             }
+            if (self->vk_pipeline_cache)
+            {
+                vkDestroyPipelineCache(self->vk_device, self->vk_pipeline_cache, nullptr);
+            }
         }
     };
 
+    // Create the device wide pipeline cache. It starts out empty, daxa_dvc_load_pipeline_cache merges previously saved data into it.
+    {
+        VkPipelineCacheCreateInfo const vk_pipeline_cache_create_info{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = {},
+            .initialDataSize = 0,
+            .pInitialData = nullptr,
+        };
+        result = static_cast<daxa_Result>(vkCreatePipelineCache(self->vk_device, &vk_pipeline_cache_create_info, nullptr, &self->vk_pipeline_cache));
+        _DAXA_RETURN_IF_ERROR(result, result)
+    }
+
     // Create null resources:
     {
         auto buffer_data = std::array<u8, 4>{0xff, 0x00, 0xff, 0xff};
@@ -2934,6 +3270,11 @@ void daxa_ImplDevice::zero_ref_callback(ImplHandle const * handle)
     vmaDestroyAllocator(self->vma_allocator);
     vkDestroySampler(self->vk_device, self->vk_null_sampler, nullptr);
     vkDestroyImageView(self->vk_device, self->vk_null_image_view, nullptr);
+    for (auto const & [key, entry] : self->shader_module_cache)
+    {
+        vkDestroyShaderModule(self->vk_device, entry.vk_shader_module, nullptr);
+    }
+    vkDestroyPipelineCache(self->vk_device, self->vk_pipeline_cache, nullptr);
     for (auto & queue : self->queues)
     {
         queue.cleanup(self->vk_device);
@@ -2946,7 +3287,7 @@ void daxa_ImplDevice::zero_ref_callback(ImplHandle const * handle)
 }
 
 template <typename T>
-void zombiefy(daxa_Device self, T id, auto & slots, auto & zombies)
+void zombiefy_release_dependencies(daxa_Device self, T id, auto & slots)
 {
     [[maybe_unused]] auto & slot = slots.unsafe_get(std::bit_cast<GPUResourceId>(id));
     if constexpr (std::is_same_v<T, BufferId> || std::is_same_v<T, ImageId>)
@@ -2966,41 +3307,77 @@ void zombiefy(daxa_Device self, T id, auto & slots, auto & zombies)
             DAXA_DBG_ASSERT_TRUE_M(result == DAXA_RESULT_SUCCESS, "Tlas owned buffer could not be destroyed.");
         }
     }
+}
+
+auto zombie_shard_index() -> u32
+{
+    static std::atomic_uint32_t next_zombie_shard = {};
+    thread_local u32 const shard_index = next_zombie_shard.fetch_add(1, std::memory_order_relaxed) % ZOMBIE_SHARD_COUNT;
+    return shard_index;
+}
+
+template <typename T, typename ZombiesT>
+void zombiefy(daxa_Device self, T id, auto & slots, ZombiesT ZombieShard::* shard_zombies)
+{
+    zombiefy_release_dependencies(self, id, slots);
+    u64 const submit_timeline_value = self->global_submit_timeline.load(std::memory_order::relaxed);
+    auto & shard = self->zombie_shards[zombie_shard_index()];
+    {
+        std::unique_lock const lock{shard.mtx};
+        (shard.*shard_zombies).push_back(std::pair{submit_timeline_value, id});
+    }
+}
+
+template <typename T, typename ZombiesT>
+void zombiefy_batch(daxa_Device self, std::span<T const> ids, auto & slots, ZombiesT ZombieShard::* shard_zombies)
+{
+    if (ids.empty())
+    {
+        return;
+    }
+    for (T id : ids)
+    {
+        zombiefy_release_dependencies(self, id, slots);
+    }
     u64 const submit_timeline_value = self->global_submit_timeline.load(std::memory_order::relaxed);
+    auto & shard = self->zombie_shards[zombie_shard_index()];
     {
-        std::unique_lock const lock{self->zombies_mtx};
-        zombies.push_front(std::pair{submit_timeline_value, id});
+        std::unique_lock const lock{shard.mtx};
+        for (T id : ids)
+        {
+            (shard.*shard_zombies).push_back(std::pair{submit_timeline_value, id});
+        }
     }
 }
 
 void daxa_ImplDevice::zombify_buffer(BufferId id)
 {
-    zombiefy(this, id, gpu_sro_table.buffer_slots, this->buffer_zombies);
+    zombiefy(this, id, gpu_sro_table.buffer_slots, &ZombieShard::buffer_zombies);
 }
 
 void daxa_ImplDevice::zombify_image(ImageId id)
 {
-    zombiefy(this, id, gpu_sro_table.image_slots, this->image_zombies);
+    zombiefy(this, id, gpu_sro_table.image_slots, &ZombieShard::image_zombies);
 }
 
 void daxa_ImplDevice::zombify_image_view(ImageViewId id)
 {
-    zombiefy(this, id, gpu_sro_table.image_slots, this->image_view_zombies);
+    zombiefy(this, id, gpu_sro_table.image_slots, &ZombieShard::image_view_zombies);
 }
 
 void daxa_ImplDevice::zombify_sampler(SamplerId id)
 {
-    zombiefy(this, id, gpu_sro_table.sampler_slots, this->sampler_zombies);
+    zombiefy(this, id, gpu_sro_table.sampler_slots, &ZombieShard::sampler_zombies);
 }
 
 void daxa_ImplDevice::zombify_tlas(TlasId id)
 {
-    zombiefy(this, id, gpu_sro_table.tlas_slots, this->tlas_zombies);
+    zombiefy(this, id, gpu_sro_table.tlas_slots, &ZombieShard::tlas_zombies);
 }
 
 void daxa_ImplDevice::zombify_blas(BlasId id)
 {
-    zombiefy(this, id, gpu_sro_table.blas_slots, this->blas_zombies);
+    zombiefy(this, id, gpu_sro_table.blas_slots, &ZombieShard::blas_zombies);
 }
 
 auto daxa_dvc_copy_memory_to_image(daxa_Device self, daxa_MemoryToImageCopyInfo const * info) -> daxa_Result
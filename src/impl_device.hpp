@@ -13,6 +13,7 @@
 
 #include <atomic>
 #include <mutex>
+#include <shared_mutex>
 
 using namespace daxa;
 
@@ -22,6 +23,26 @@ struct SubmitZombie
     std::vector<daxa_TimelineSemaphore> timeline_semaphores = {};
 };
 
+// Destroyed gpu resources and command arenas are first pushed into one of several shards, each with its own lock.
+// Threads are assigned to shards round robin, so concurrent destruction rarely contends on a lock.
+// Garbage collection merges all shards into the per type zombie queues of the device.
+static inline constexpr u32 ZOMBIE_SHARD_COUNT = 16;
+
+struct ZombieShard
+{
+    std::mutex mtx = {};
+    std::vector<std::pair<u64, BufferId>> buffer_zombies = {};
+    std::vector<std::pair<u64, ImageId>> image_zombies = {};
+    std::vector<std::pair<u64, ImageViewId>> image_view_zombies = {};
+    std::vector<std::pair<u64, SamplerId>> sampler_zombies = {};
+    std::vector<std::pair<u64, TlasId>> tlas_zombies = {};
+    std::vector<std::pair<u64, BlasId>> blas_zombies = {};
+    std::vector<std::pair<u64, ImplTransientCommandArena *>> command_zombies = {};
+};
+
+// Shard of the calling thread, assigned round robin on first use.
+auto zombie_shard_index() -> u32;
+
 static inline constexpr u64 MAX_PENDING_SUBMISSIONS_PER_QUEUE = 64;
 static inline constexpr u64 MAIN_QUEUE_INDEX = 0;
 static inline constexpr u64 FIRST_COMPUTE_QUEUE_IDX = 1;
@@ -68,6 +89,30 @@ struct daxa_ImplDevice final : public ImplHandle
     PFN_vkCopyMemoryToImageEXT vkCopyMemoryToImageEXT = {};
     PFN_vkCopyImageToMemoryEXT vkCopyImageToMemoryEXT = {};
 
+    // Multi draw:
+    PFN_vkCmdDrawMultiEXT vkCmdDrawMultiEXT = {};
+    PFN_vkCmdDrawMultiIndexedEXT vkCmdDrawMultiIndexedEXT = {};
+
+    // Device wide pipeline cache, passed to every pipeline creation.
+    // Pipeline creation only reads the cache handle and holds the lock shared, vulkan synchronizes cache insertion internally.
+    // Merging loaded data into the cache requires external synchronization and holds the lock exclusively.
+    VkPipelineCache vk_pipeline_cache = {};
+    std::shared_mutex pipeline_cache_mtx = {};
+
+    // Shader modules by SPIR-V content, shared by all pipelines created on this device.
+    // A module is only needed while pipelines are created from it. Modules stay cached afterwards,
+    // so identical stages of later pipelines skip vkCreateShaderModule. Unused modules are destroyed once the cache grows too large.
+    struct ShaderModuleCacheEntry
+    {
+        VkShaderModule vk_shader_module = {};
+        u64 byte_code_size = {};
+        u32 use_count = {};
+    };
+    std::mutex shader_module_cache_mtx = {};
+    std::unordered_map<u64, ShaderModuleCacheEntry> shader_module_cache = {};
+    // Cache key of every cached module, so releasing a module does not have to search the cache.
+    std::unordered_map<VkShaderModule, u64> shader_module_cache_keys = {};
+
     VkBuffer buffer_device_address_buffer = {};
     u64 * buffer_device_address_buffer_host_ptr = {};
     VmaAllocation buffer_device_address_buffer_allocation = {};
@@ -97,6 +142,8 @@ struct daxa_ImplDevice final : public ImplHandle
     // When collect garbage is called, the zombies timeline values are compared against submits running in all queues.
     // If the zombies global submit index is smaller then global index of all submits currently in flight (on all queues), we can safely clean the resource up.
     std::atomic_uint64_t global_submit_timeline = {};
+    // Gpu resource and command zombies are pushed into the shards and only moved into the queues below during garbage collection.
+    std::array<ZombieShard, ZOMBIE_SHARD_COUNT> zombie_shards = {};
     std::recursive_mutex zombies_mtx = {};
     std::deque<std::pair<u64, ImplTransientCommandArena*>> command_zombies = {};
     std::deque<std::pair<u64, BufferId>> buffer_zombies = {};
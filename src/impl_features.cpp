@@ -181,6 +181,13 @@ namespace daxa
             chain = static_cast<void *>(&physical_device_line_rasterization_features_khr);
         }
 
+        if (extensions.extensions_present[extensions.physical_device_multi_draw_ext])
+        {
+            physical_device_multi_draw_features_ext.pNext = chain;
+            physical_device_multi_draw_features_ext.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT;
+            chain = static_cast<void *>(&physical_device_multi_draw_features_ext);
+        }
+
         if (extensions.extensions_present[extensions.physical_device_pipeline_library_group_handles_ext])
         {
             physical_device_pipeline_library_group_handles_ext.pNext = chain;
@@ -356,6 +363,10 @@ namespace daxa
         offsetof(PhysicalDeviceFeaturesStruct, physical_device_line_rasterization_features_khr.stippledSmoothLines),
     };
 
+    constexpr static std::array DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW_VK_FEATURES = std::array{
+        offsetof(PhysicalDeviceFeaturesStruct, physical_device_multi_draw_features_ext.multiDraw),
+    };
+
     constexpr static std::array IMPLICIT_FEATURES = std::array{
         ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_MESH_SHADER_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_MESH_SHADER},
         ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_BASIC_RAY_TRACING},
@@ -375,6 +386,7 @@ namespace daxa
         ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_SHADER_CLOCK_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_SHADER_CLOCK},
         ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_HOST_IMAGE_COPY_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_HOST_IMAGE_COPY},
         ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_LINE_RASTERIZATION_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_LINE_RASTERIZATION},
+        ImplicitFeature{DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW_VK_FEATURES, DAXA_IMPLICIT_FEATURE_FLAG_MULTI_DRAW},
     };
 
     // === Explicit Features ===
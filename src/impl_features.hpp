@@ -62,6 +62,7 @@ namespace daxa
             physical_device_shader_clock_khr,
             physical_device_host_image_copy_ext,
             physical_device_line_rasterization_khr,
+            physical_device_multi_draw_ext,
             COUNT
         };
         constexpr static std::array<char const *, COUNT> extension_names = {
@@ -84,6 +85,7 @@ namespace daxa
             VK_KHR_SHADER_CLOCK_EXTENSION_NAME,
             VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME,
             VK_KHR_LINE_RASTERIZATION_EXTENSION_NAME,
+            VK_EXT_MULTI_DRAW_EXTENSION_NAME,
         };
         char const * extension_name_list[COUNT] = {};
         u32 extension_name_list_size = {};
@@ -122,6 +124,7 @@ namespace daxa
         VkPhysicalDeviceShaderClockFeaturesKHR physical_device_shader_clock_features_khr = {};
         VkPhysicalDeviceHostImageCopyFeaturesEXT physical_device_host_image_copy_features_ext = {};
         VkPhysicalDeviceLineRasterizationFeaturesKHR physical_device_line_rasterization_features_khr = {};
+        VkPhysicalDeviceMultiDrawFeaturesEXT physical_device_multi_draw_features_ext = {};
         VkPhysicalDevicePipelineLibraryGroupHandlesFeaturesEXT physical_device_pipeline_library_group_handles_ext = {};
         VkPhysicalDeviceShaderDemoteToHelperInvocationFeatures physical_device_shader_demote_to_helper_invocation_features = {};
         VkPhysicalDeviceFeatures2 physical_device_features_2 = {};
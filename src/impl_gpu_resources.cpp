@@ -104,6 +104,15 @@ namespace daxa
             blas_slots.hot_data = decltype(blas_slots.hot_data)(blas_slots.max_resources);
         }
 
+        buffer_slots.free_index_links = decltype(buffer_slots.free_index_links)(buffer_slots.max_resources);
+        image_slots.free_index_links = decltype(image_slots.free_index_links)(image_slots.max_resources);
+        sampler_slots.free_index_links = decltype(sampler_slots.free_index_links)(sampler_slots.max_resources);
+        if (ray_tracing_enabled)
+        {
+            tlas_slots.free_index_links = decltype(tlas_slots.free_index_links)(tlas_slots.max_resources);
+            blas_slots.free_index_links = decltype(blas_slots.free_index_links)(blas_slots.max_resources);
+        }
+
         VkDescriptorPoolSize const buffer_descriptor_pool_size{
             .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
             .descriptorCount = buffer_slots.max_resources + 1,
@@ -413,9 +422,9 @@ namespace daxa
             }
             return ret;
         };
-        DAXA_DBG_ASSERT_TRUE_M(buffer_slots.free_index_stack.size() == buffer_slots.next_index, print_remaining("Detected leaked buffers; not all buffers have been destroyed before destroying the device;", buffer_slots));
-        DAXA_DBG_ASSERT_TRUE_M(image_slots.free_index_stack.size() == image_slots.next_index, print_remaining("Detected leaked images; not all images have been destroyed before destroying the device;", image_slots));
-        DAXA_DBG_ASSERT_TRUE_M(sampler_slots.free_index_stack.size() == sampler_slots.next_index, print_remaining("Detected leaked samplers; not all samplers have been destroyed before destroying the device;", sampler_slots));
+        DAXA_DBG_ASSERT_TRUE_M(buffer_slots.free_index_count.load() == buffer_slots.next_index.load(), print_remaining("Detected leaked buffers; not all buffers have been destroyed before destroying the device;", buffer_slots));
+        DAXA_DBG_ASSERT_TRUE_M(image_slots.free_index_count.load() == image_slots.next_index.load(), print_remaining("Detected leaked images; not all images have been destroyed before destroying the device;", image_slots));
+        DAXA_DBG_ASSERT_TRUE_M(sampler_slots.free_index_count.load() == sampler_slots.next_index.load(), print_remaining("Detected leaked samplers; not all samplers have been destroyed before destroying the device;", sampler_slots));
         for (usize i = 0; i < DAXA_PIPELINE_LAYOUT_COUNT; ++i)
         {
             vkDestroyPipelineLayout(device, pipeline_layouts.at(i), nullptr);
@@ -449,15 +458,9 @@ namespace daxa
         vkUpdateDescriptorSets(vk_device, 1, &vk_write_descriptor_set_storage, 0, nullptr);
     }
 
-    void write_descriptor_set_buffer(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkBuffer vk_buffer, VkDeviceSize offset, VkDeviceSize range, u32 index)
+    auto descriptor_set_buffer_write(VkDescriptorSet vk_descriptor_set, VkDescriptorBufferInfo const & vk_descriptor_buffer_info, u32 index) -> VkWriteDescriptorSet
     {
-        VkDescriptorBufferInfo const vk_descriptor_image_info{
-            .buffer = vk_buffer,
-            .offset = offset,
-            .range = range,
-        };
-
-        VkWriteDescriptorSet const vk_write_descriptor_set{
+        return VkWriteDescriptorSet{
             .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
             .pNext = nullptr,
             .dstSet = vk_descriptor_set,
@@ -466,23 +469,27 @@ namespace daxa
             .descriptorCount = 1,
             .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
             .pImageInfo = nullptr,
-            .pBufferInfo = &vk_descriptor_image_info,
+            .pBufferInfo = &vk_descriptor_buffer_info,
             .pTexelBufferView = nullptr,
         };
+    }
+
+    void write_descriptor_set_buffer(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkBuffer vk_buffer, VkDeviceSize offset, VkDeviceSize range, u32 index)
+    {
+        VkDescriptorBufferInfo const vk_descriptor_buffer_info{
+            .buffer = vk_buffer,
+            .offset = offset,
+            .range = range,
+        };
+
+        VkWriteDescriptorSet const vk_write_descriptor_set = descriptor_set_buffer_write(vk_descriptor_set, vk_descriptor_buffer_info, index);
 
         vkUpdateDescriptorSets(vk_device, 1, &vk_write_descriptor_set, 0, nullptr);
     }
 
-    void write_descriptor_set_image(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkImageView vk_image_view, ImageUsageFlags usage, u32 index)
+    auto descriptor_set_image_writes(VkDescriptorSet vk_descriptor_set, VkDescriptorImageInfo const & vk_descriptor_image_info, ImageUsageFlags usage, u32 index, std::span<VkWriteDescriptorSet, 2> out_writes) -> u32
     {
         u32 descriptor_set_write_count = 0;
-        std::array<VkWriteDescriptorSet, 2> descriptor_set_writes = {};
-
-        VkDescriptorImageInfo const vk_descriptor_image_info{
-            .sampler = VK_NULL_HANDLE,
-            .imageView = vk_image_view,
-            .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
-        };
 
         VkWriteDescriptorSet const vk_write_descriptor_set{
             .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
@@ -499,15 +506,9 @@ namespace daxa
 
         if ((usage & ImageUsageFlagBits::SHADER_STORAGE) != ImageUsageFlagBits::NONE)
         {
-            descriptor_set_writes.at(descriptor_set_write_count++) = vk_write_descriptor_set;
+            out_writes[descriptor_set_write_count++] = vk_write_descriptor_set;
         }
 
-        VkDescriptorImageInfo const vk_descriptor_image_info_sampled{
-            .sampler = VK_NULL_HANDLE,
-            .imageView = vk_image_view,
-            .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
-        };
-
         VkWriteDescriptorSet const vk_write_descriptor_set_sampled{
             .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
             .pNext = nullptr,
@@ -516,16 +517,31 @@ namespace daxa
             .dstArrayElement = index,
             .descriptorCount = 1,
             .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-            .pImageInfo = &vk_descriptor_image_info_sampled,
+            .pImageInfo = &vk_descriptor_image_info,
             .pBufferInfo = nullptr,
             .pTexelBufferView = nullptr,
         };
 
         if ((usage & ImageUsageFlagBits::SHADER_SAMPLED) != ImageUsageFlagBits::NONE)
         {
-            descriptor_set_writes.at(descriptor_set_write_count++) = vk_write_descriptor_set_sampled;
+            out_writes[descriptor_set_write_count++] = vk_write_descriptor_set_sampled;
         }
 
+        return descriptor_set_write_count;
+    }
+
+    void write_descriptor_set_image(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkImageView vk_image_view, ImageUsageFlags usage, u32 index)
+    {
+        std::array<VkWriteDescriptorSet, 2> descriptor_set_writes = {};
+
+        VkDescriptorImageInfo const vk_descriptor_image_info{
+            .sampler = VK_NULL_HANDLE,
+            .imageView = vk_image_view,
+            .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+        };
+
+        u32 const descriptor_set_write_count = descriptor_set_image_writes(vk_descriptor_set, vk_descriptor_image_info, usage, index, descriptor_set_writes);
+
         vkUpdateDescriptorSets(vk_device, descriptor_set_write_count, descriptor_set_writes.data(), 0, nullptr);
     }
 
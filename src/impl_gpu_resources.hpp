@@ -121,6 +121,7 @@ namespace daxa
      * * never dereference a deleted resource
      * * never delete a resource twice
      * That means the function dereference_id can be used without synchronization, even calling get_new_slot or return_old_slot in parallel is safe.
+     * Slot creation and destruction are lock free, only the allocation of a new page takes a lock.
      *
      * To check if these assumptions are met at runtime, the debug define DAXA_GPU_ID_VALIDATION can be enabled.
      * The define enables runtime checking to detect use after free and double free at the cost of performance.
@@ -157,12 +158,27 @@ namespace daxa
             return (version & VERSION_COUNT_MASK) | ((refcnt & REF_COUNT_MASK) << REF_COUNT_OFFSET);
         }
 
-        // TODO: replace with lockless queue.
-        std::vector<u32> free_index_stack = {};
-        u32 next_index = {};
+        static constexpr inline u32 FREE_LIST_END = ~0u;
+
+        static auto get_free_list_index(u64 tag_index) -> u32
+        {
+            return static_cast<u32>(tag_index);
+        }
+
+        static auto pack_free_list_tag_index(u64 tag, u32 index) -> u64
+        {
+            return (tag << 32u) | static_cast<u64>(index);
+        }
+
+        // Lock free free list of slot indices (treiber stack).
+        // The head packs a 32 bit tag with the top index. The tag is incremented on every push and pop to prevent ABA.
+        // Each free slot stores the index of the next free slot in free_index_links.
+        std::atomic_uint64_t free_list_head = pack_free_list_tag_index(0ull, FREE_LIST_END);
+        std::vector<std::atomic_uint32_t> free_index_links = {};
+        std::atomic_uint32_t free_index_count = {};
+        std::atomic_uint32_t next_index = {};
         u32 max_resources = {};
 
-        mutable std::mutex mut = {};
         std::mutex page_alloc_mtx = {};
         std::array<std::unique_ptr<PageT>, PAGE_COUNT> paged_data = {};
         using HotDataAndVersion = std::pair<typename ResourceT::HotData, VersionAndRefcntT>;
@@ -191,9 +207,75 @@ namespace daxa
             this->paged_data.at(page)->at(offset) = {};
             if (version != DAXA_ID_VERSION_MASK /* this is the maximum value a version is allowed to reach */)
             {
-                std::unique_lock l{mut};
-                this->free_index_stack.push_back(id.index);
+                push_free_index(static_cast<u32>(id.index));
+            }
+        }
+
+        /**
+         * @brief   Pushes an index onto the free list.
+         *
+         * Always threadsafe, lock free.
+         */
+        void push_free_index(u32 index)
+        {
+            u64 head = this->free_list_head.load(std::memory_order_relaxed);
+            u64 new_head = {};
+            do
+            {
+                this->free_index_links[index].store(get_free_list_index(head), std::memory_order_relaxed);
+                new_head = pack_free_list_tag_index((head >> 32u) + 1u, index);
             }
+            // Release, so that the slot clear and the link write are visible to the thread popping the index.
+            while (!this->free_list_head.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+            this->free_index_count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief   Pops an index from the free list.
+         *
+         * Always threadsafe, lock free.
+         * @returns the popped index or FREE_LIST_END if the free list is empty.
+         */
+        auto try_pop_free_index() -> u32
+        {
+            u64 head = this->free_list_head.load(std::memory_order_acquire);
+            u64 new_head = {};
+            do
+            {
+                u32 const index = get_free_list_index(head);
+                if (index == FREE_LIST_END)
+                {
+                    return FREE_LIST_END;
+                }
+                // The link may be stale when another thread pops and reuses the index concurrently.
+                // In that case the tag in the head changed and the exchange fails.
+                u32 const next = this->free_index_links[index].load(std::memory_order_relaxed);
+                new_head = pack_free_list_tag_index((head >> 32u) + 1u, next);
+            }
+            while (!this->free_list_head.compare_exchange_weak(head, new_head, std::memory_order_acquire, std::memory_order_acquire));
+            this->free_index_count.fetch_sub(1, std::memory_order_relaxed);
+            return get_free_list_index(head);
+        }
+
+        /**
+         * @brief   Claims a never before used index.
+         *
+         * Always threadsafe, lock free.
+         * @returns the new index or FREE_LIST_END if the pool is exhausted.
+         */
+        auto try_claim_new_index() -> u32
+        {
+            u32 const max_index = static_cast<u32>(std::min(static_cast<usize>(this->max_resources), MAX_RESOURCE_COUNT));
+            u32 index = this->next_index.load(std::memory_order_relaxed);
+            do
+            {
+                if (index >= max_index)
+                {
+                    return FREE_LIST_END;
+                }
+            }
+            while (!this->next_index.compare_exchange_weak(index, index + 1, std::memory_order_relaxed, std::memory_order_relaxed));
+            return index;
         }
 
         /**
@@ -207,39 +289,37 @@ namespace daxa
          */
         auto try_create_slot() -> std::optional<std::tuple<GPUResourceId, ResourceT &, typename ResourceT::HotData &>>
         {
-            u32 index;
+            u32 index = try_pop_free_index();
+            if (index == FREE_LIST_END)
             {
-                std::unique_lock l{mut};
-                if (this->free_index_stack.empty())
+                index = try_claim_new_index();
+                if (index == FREE_LIST_END)
                 {
-                    index = this->next_index++;
-                    if (index >= this->max_resources || index >= MAX_RESOURCE_COUNT)
-                    {
-                        return std::nullopt;
-                    }
-                }
-                else
-                {
-                    index = this->free_index_stack.back();
-                    this->free_index_stack.pop_back();
-
-                    [[maybe_unused]] u64 version_refcnt = this->hot_data.at(index).second.load(std::memory_order_relaxed);
-                    DAXA_DBG_ASSERT_TRUE_M(get_refcnt(version_refcnt) == 0, "All reused resources must be zombies! Possibly called zombify instead of destroy within device!");
+                    return std::nullopt;
                 }
             }
+            else
+            {
+                [[maybe_unused]] u64 version_refcnt = this->hot_data.at(index).second.load(std::memory_order_relaxed);
+                DAXA_DBG_ASSERT_TRUE_M(get_refcnt(version_refcnt) == 0, "All reused resources must be zombies! Possibly called zombify instead of destroy within device!");
+            }
 
             auto const page = static_cast<usize>(index) >> PAGE_BITS;
             auto const offset = static_cast<usize>(index) & PAGE_MASK;
 
+            // Only taken once per PAGE_SIZE new indices, the common path never locks.
             if (page >= this->valid_page_count.load(std::memory_order_seq_cst))
             {
                 std::unique_lock l{page_alloc_mtx};
-                if (page >= this->valid_page_count.load(std::memory_order_relaxed))
+                // New indices are claimed concurrently, a thread may need a page before a lower page was allocated by another thread.
+                // Allocate all pages up to the required one, so that valid_page_count always covers a contiguous range of pages.
+                while (page >= this->valid_page_count.load(std::memory_order_relaxed))
                 {
-                    this->paged_data[page] = std::make_unique<PageT>();
+                    usize const new_page = this->valid_page_count.load(std::memory_order_relaxed);
+                    this->paged_data[new_page] = std::make_unique<PageT>();
                     for (u32 i = 0; i < PAGE_SIZE; ++i)
                     {
-                        this->hot_data.at(page * PAGE_SIZE + i).second.store(pack_version_refcnt(1ull, 0ull), std::memory_order_relaxed);
+                        this->hot_data.at(new_page * PAGE_SIZE + i).second.store(pack_version_refcnt(1ull, 0ull), std::memory_order_relaxed);
                     }
                     // Needs to be sequential, so that the 0 writes to the versions are visible before the atomic op.
                     this->valid_page_count.fetch_add(1, std::memory_order_seq_cst);
@@ -433,8 +513,15 @@ namespace daxa
 
     void write_descriptor_set_sampler(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkSampler vk_sampler, u32 index);
 
+    // The returned write points to vk_descriptor_buffer_info, it must stay alive until the write is submitted.
+    auto descriptor_set_buffer_write(VkDescriptorSet vk_descriptor_set, VkDescriptorBufferInfo const & vk_descriptor_buffer_info, u32 index) -> VkWriteDescriptorSet;
+
     void write_descriptor_set_buffer(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkBuffer vk_buffer, VkDeviceSize offset, VkDeviceSize range, u32 index);
 
+    // Writes up to two descriptor writes into out_writes, one per storage and sampled usage, and returns their count.
+    // The writes point to vk_descriptor_image_info, it must stay alive until the writes are submitted.
+    auto descriptor_set_image_writes(VkDescriptorSet vk_descriptor_set, VkDescriptorImageInfo const & vk_descriptor_image_info, ImageUsageFlags usage, u32 index, std::span<VkWriteDescriptorSet, 2> out_writes) -> u32;
+
     void write_descriptor_set_image(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkImageView vk_image_view, ImageUsageFlags usage, u32 index);
 
     void write_descriptor_set_acceleration_structure(VkDevice vk_device, VkDescriptorSet vk_descriptor_set, VkAccelerationStructureKHR vk_acceleration_structure, u32 index);
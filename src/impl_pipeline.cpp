@@ -4,6 +4,95 @@
 #include "impl_pipeline.hpp"
 #include "impl_instance.hpp"
 
+namespace
+{
+    // Unused cached modules are only destroyed once the device wide shader module cache holds more than this many modules.
+    constexpr usize MAX_CACHED_SHADER_MODULES = 256;
+
+    // Returns the cached module for this byte code or creates one. Every acquired module must be released again with release_shader_module.
+    auto acquire_shader_module(daxa_Device device, u32 const * byte_code, u64 byte_code_size, VkShaderModule * out_module) -> daxa_Result
+    {
+        auto const code_bytes = byte_code_size * sizeof(u32);
+        auto const key = static_cast<u64>(std::hash<std::string_view>{}(std::string_view{reinterpret_cast<char const *>(byte_code), code_bytes}));
+        {
+            auto lock = std::lock_guard{device->shader_module_cache_mtx};
+            auto iter = device->shader_module_cache.find(key);
+            if (iter != device->shader_module_cache.end() && iter->second.byte_code_size == code_bytes)
+            {
+                ++iter->second.use_count;
+                *out_module = iter->second.vk_shader_module;
+                return DAXA_RESULT_SUCCESS;
+            }
+        }
+
+        // Created outside of the lock, so that other threads can keep hitting the cache meanwhile.
+        VkShaderModule vk_shader_module = {};
+        VkShaderModuleCreateInfo const vk_shader_module_create_info{
+            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = {},
+            .codeSize = code_bytes,
+            .pCode = byte_code,
+        };
+        auto result = static_cast<daxa_Result>(vkCreateShaderModule(device->vk_device, &vk_shader_module_create_info, nullptr, &vk_shader_module));
+        if (result != DAXA_RESULT_SUCCESS)
+        {
+            return result;
+        }
+
+        auto lock = std::lock_guard{device->shader_module_cache_mtx};
+        if (device->shader_module_cache.size() >= MAX_CACHED_SHADER_MODULES)
+        {
+            std::erase_if(device->shader_module_cache, [&](auto const & pair)
+                          {
+                              if (pair.second.use_count != 0)
+                              {
+                                  return false;
+                              }
+                              device->shader_module_cache_keys.erase(pair.second.vk_shader_module);
+                              vkDestroyShaderModule(device->vk_device, pair.second.vk_shader_module, nullptr);
+                              return true; });
+        }
+        auto [iter, inserted] = device->shader_module_cache.try_emplace(key, daxa_ImplDevice::ShaderModuleCacheEntry{
+                                                                                 .vk_shader_module = vk_shader_module,
+                                                                                 .byte_code_size = code_bytes,
+                                                                             });
+        if (inserted)
+        {
+            device->shader_module_cache_keys.emplace(vk_shader_module, key);
+        }
+        else if (iter->second.byte_code_size == code_bytes)
+        {
+            // Another thread created the same module in the meantime.
+            vkDestroyShaderModule(device->vk_device, vk_shader_module, nullptr);
+            vk_shader_module = iter->second.vk_shader_module;
+        }
+        else
+        {
+            // Hash collision with different byte code. The module is not cached and destroyed again on release.
+            *out_module = vk_shader_module;
+            return DAXA_RESULT_SUCCESS;
+        }
+        ++iter->second.use_count;
+        *out_module = vk_shader_module;
+        return DAXA_RESULT_SUCCESS;
+    }
+
+    void release_shader_module(daxa_Device device, VkShaderModule vk_shader_module)
+    {
+        auto lock = std::lock_guard{device->shader_module_cache_mtx};
+        auto key_iter = device->shader_module_cache_keys.find(vk_shader_module);
+        if (key_iter != device->shader_module_cache_keys.end())
+        {
+            --device->shader_module_cache.at(key_iter->second).use_count;
+        }
+        else
+        {
+            vkDestroyShaderModule(device->vk_device, vk_shader_module, nullptr);
+        }
+    }
+} // namespace
+
 // --- Begin API Functions ---
 
 auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo const * info, daxa_RasterPipeline * out_pipeline) -> daxa_Result
@@ -24,14 +113,7 @@ auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo
     auto create_shader_module = [&](ShaderInfo const & shader_info, VkShaderStageFlagBits shader_stage) -> daxa_Result
     {
         VkShaderModule vk_shader_module = nullptr;
-        VkShaderModuleCreateInfo const vk_shader_module_create_info{
-            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-            .pNext = nullptr,
-            .flags = {},
-            .codeSize = static_cast<u32>(shader_info.byte_code_size * sizeof(u32)),
-            .pCode = shader_info.byte_code,
-        };
-        auto result = static_cast<daxa_Result>(vkCreateShaderModule(ret.device->vk_device, &vk_shader_module_create_info, nullptr, &vk_shader_module));
+        auto result = acquire_shader_module(ret.device, shader_info.byte_code, shader_info.byte_code_size, &vk_shader_module);
         _DAXA_RETURN_IF_ERROR(result, result);
 
         vk_shader_modules.push_back(vk_shader_module);
@@ -76,7 +158,7 @@ auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo
         {                                                                                                                       \
             for (auto module : vk_shader_modules)                                                                               \
             {                                                                                                                   \
-                vkDestroyShaderModule(ret.device->vk_device, module, nullptr);                                                  \
+                release_shader_module(ret.device, module);                                                                      \
             }                                                                                                                   \
             _DAXA_RETURN_IF_ERROR(result, result);                                                                              \
         }                                                                                                                       \
@@ -96,7 +178,7 @@ auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo
         {
             for (auto module : vk_shader_modules)
             {
-                vkDestroyShaderModule(ret.device->vk_device, module, nullptr);
+                release_shader_module(ret.device, module);
             }
             _DAXA_DEBUG_BREAK
             return DAXA_RESULT_MESH_SHADER_NOT_DEVICE_ENABLED;
@@ -310,16 +392,18 @@ auto daxa_dvc_create_raster_pipeline(daxa_Device device, daxa_RasterPipelineInfo
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = 0,
     };
+    std::shared_lock pipeline_cache_lock{ret.device->pipeline_cache_mtx};
     auto result = vkCreateGraphicsPipelines(
         ret.device->vk_device,
-        VK_NULL_HANDLE,
+        ret.device->vk_pipeline_cache,
         1u,
         &vk_graphics_pipeline_create_info,
         nullptr,
         &ret.vk_pipeline);
+    pipeline_cache_lock.unlock();
     for (auto & vk_shader_module : vk_shader_modules)
     {
-        vkDestroyShaderModule(ret.device->vk_device, vk_shader_module, nullptr);
+        release_shader_module(ret.device, vk_shader_module);
     }
     if (result != VK_SUCCESS)
     {
@@ -367,18 +451,11 @@ auto daxa_dvc_create_compute_pipeline(daxa_Device device, daxa_ComputePipelineIn
     ret.device = device;
     ret.info = *reinterpret_cast<ComputePipelineInfo const *>(info);
     VkShaderModule vk_shader_module = {};
-    VkShaderModuleCreateInfo const shader_module_ci{
-        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .pNext = nullptr,
-        .flags = {},
-        .codeSize = ret.info.shader_info.byte_code_size * static_cast<u32>(sizeof(u32)),
-        .pCode = ret.info.shader_info.byte_code,
-    };
-    auto module_result = vkCreateShaderModule(ret.device->vk_device, &shader_module_ci, nullptr, &vk_shader_module);
-    if (module_result != VK_SUCCESS)
+    auto module_result = acquire_shader_module(ret.device, ret.info.shader_info.byte_code, ret.info.shader_info.byte_code_size, &vk_shader_module);
+    if (module_result != DAXA_RESULT_SUCCESS)
     {
         _DAXA_DEBUG_BREAK
-        return std::bit_cast<daxa_Result>(module_result);
+        return module_result;
     }
     ret.vk_pipeline_layout = ret.device->gpu_sro_table.pipeline_layouts.at((ret.info.push_constant_size + 3) / 4);
 
@@ -388,8 +465,9 @@ auto daxa_dvc_create_compute_pipeline(daxa_Device device, daxa_ComputePipelineIn
 
     if (!supports_required_subgroup_size_for_stage)
     {
+        release_shader_module(ret.device, vk_shader_module);
         _DAXA_DEBUG_BREAK
-        return std::bit_cast<daxa_Result>(module_result);
+        return module_result;
     }
 
     VkPipelineShaderStageRequiredSubgroupSizeCreateInfo require_subgroup_size_vkstruct{
@@ -414,14 +492,16 @@ auto daxa_dvc_create_compute_pipeline(daxa_Device device, daxa_ComputePipelineIn
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = 0,
     };
+    std::shared_lock pipeline_cache_lock{ret.device->pipeline_cache_mtx};
     auto pipeline_result = vkCreateComputePipelines(
         ret.device->vk_device,
-        VK_NULL_HANDLE,
+        ret.device->vk_pipeline_cache,
         1u,
         &vk_compute_pipeline_create_info,
         nullptr,
         &ret.vk_pipeline);
-    vkDestroyShaderModule(ret.device->vk_device, vk_shader_module, nullptr);
+    pipeline_cache_lock.unlock();
+    release_shader_module(ret.device, vk_shader_module);
     if (pipeline_result != VK_SUCCESS)
     {
         _DAXA_DEBUG_BREAK
@@ -495,7 +575,7 @@ auto daxa_dvc_create_ray_tracing_pipeline_or_library(daxa_Device device, daxa_Ra
     {
         for (auto & vk_shader_module : vk_shader_modules)
         {
-            vkDestroyShaderModule(ret.device->vk_device, vk_shader_module, nullptr);
+            release_shader_module(ret.device, vk_shader_module);
         }
     };
 
@@ -517,14 +597,7 @@ auto daxa_dvc_create_ray_tracing_pipeline_or_library(daxa_Device device, daxa_Ra
     auto create_shader_module = [&](ShaderInfo const & shader_info, VkShaderStageFlagBits shader_stage) -> daxa_Result
     {
         VkShaderModule vk_shader_module = nullptr;
-        VkShaderModuleCreateInfo const vk_shader_module_create_info{
-            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-            .pNext = nullptr,
-            .flags = {},
-            .codeSize = static_cast<u32>(shader_info.byte_code_size * sizeof(u32)),
-            .pCode = shader_info.byte_code,
-        };
-        auto result = static_cast<daxa_Result>(vkCreateShaderModule(ret.device->vk_device, &vk_shader_module_create_info, nullptr, &vk_shader_module));
+        auto result = acquire_shader_module(ret.device, shader_info.byte_code, shader_info.byte_code_size, &vk_shader_module);
         _DAXA_RETURN_IF_ERROR(result, result);
 
         vk_shader_modules.push_back(vk_shader_module);
@@ -662,14 +735,16 @@ auto daxa_dvc_create_ray_tracing_pipeline_or_library(daxa_Device device, daxa_Ra
         vk_ray_tracing_pipeline_create_info.pLibraryInterface = &library_interface_info;
     }
 
+    std::shared_lock pipeline_cache_lock{ret.device->pipeline_cache_mtx};
     auto pipeline_result = static_cast<daxa_Result>(ret.device->vkCreateRayTracingPipelinesKHR(
         ret.device->vk_device,
         VK_NULL_HANDLE,
-        VK_NULL_HANDLE,
+        ret.device->vk_pipeline_cache,
         1u,
         &vk_ray_tracing_pipeline_create_info,
         nullptr,
         &ret.vk_pipeline));
+    pipeline_cache_lock.unlock();
     _DAXA_RETURN_IF_ERROR(pipeline_result, pipeline_result);
 
     if ((ret.device->instance->info.flags & InstanceFlagBits::DEBUG_UTILS) != InstanceFlagBits::NONE && !ret.info.name.view().empty())
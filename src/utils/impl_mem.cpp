@@ -4,6 +4,10 @@
 
 #include <daxa/utils/mem.hpp>
 #include <utility>
+#include <thread>
+#include <algorithm>
+#include <bit>
+#include <numeric>
 
 namespace daxa
 {
@@ -28,6 +32,13 @@ namespace daxa
         std::swap(this->buffer_host_address, other.buffer_host_address);
         std::swap(this->claimed_start, other.claimed_start);
         std::swap(this->claimed_size, other.claimed_size);
+        std::swap(this->m_allocation_count, other.m_allocation_count);
+        std::swap(this->retired_allocation_count, other.retired_allocation_count);
+        std::swap(this->spill_blocks, other.spill_blocks);
+        std::swap(this->spill_bytes_in_use, other.spill_bytes_in_use);
+        std::swap(this->spilled_since_reuse, other.spilled_since_reuse);
+        std::swap(this->quiet_frames, other.quiet_frames);
+        std::swap(this->m_statistics, other.m_statistics);
     }
 
     auto RingBuffer::operator=(RingBuffer && other) -> RingBuffer &
@@ -36,6 +47,11 @@ namespace daxa
         {
             this->m_info.device.destroy_buffer(this->m_buffer);
         }
+        for (auto & block : this->spill_blocks)
+        {
+            this->m_info.device.destroy_buffer(block.buffer);
+        }
+        this->spill_blocks.clear();
         std::swap(this->m_info, other.m_info);
         std::swap(this->live_allocations, other.live_allocations);
         std::swap(this->m_buffer, other.m_buffer);
@@ -43,6 +59,13 @@ namespace daxa
         std::swap(this->buffer_host_address, other.buffer_host_address);
         std::swap(this->claimed_start, other.claimed_start);
         std::swap(this->claimed_size, other.claimed_size);
+        std::swap(this->m_allocation_count, other.m_allocation_count);
+        std::swap(this->retired_allocation_count, other.retired_allocation_count);
+        std::swap(this->spill_blocks, other.spill_blocks);
+        std::swap(this->spill_bytes_in_use, other.spill_bytes_in_use);
+        std::swap(this->spilled_since_reuse, other.spilled_since_reuse);
+        std::swap(this->quiet_frames, other.quiet_frames);
+        std::swap(this->m_statistics, other.m_statistics);
         return *this;
     }
 
@@ -52,6 +75,10 @@ namespace daxa
         {
             this->m_info.device.destroy_buffer(this->m_buffer);
         }
+        for (auto & block : this->spill_blocks)
+        {
+            this->m_info.device.destroy_buffer(block.buffer);
+        }
     }
 
     auto RingBuffer::allocate_internal(u32 allocation_size, u32 alignment_requirement, bool try_again_on_fail) -> std::optional<Allocation>
@@ -69,7 +96,8 @@ namespace daxa
         auto calc_tail_allocation_possible = [&]()
         {
             u32 const tail = tail_alloc_offset_aligned;
-            bool const wrapped = this->claimed_start + this->claimed_size > this->m_info.capacity;
+            // A completely full ring also counts as wrapped, its tail offset is back at the claimed start.
+            bool const wrapped = this->claimed_start + this->claimed_size >= this->m_info.capacity;
             u32 const end = wrapped ? this->claimed_start : this->m_info.capacity;
             return tail + allocation_size <= end;
         };
@@ -91,7 +119,7 @@ namespace daxa
             }
             else
             {
-                return std::nullopt;
+                return this->allocate_spill(allocation_size, alignment_requirement);
             }
         }
         u64 const current_timeline_value = m_info.device.latest_submit_index();
@@ -103,6 +131,7 @@ namespace daxa
             actual_allocation_size = allocation_size + tail_alloc_align_padding;
             returned_allocation_offset = tail_alloc_offset_aligned;
             actual_allocation_offset = tail_alloc_offset;
+            this->m_statistics.wasted_padding += tail_alloc_align_padding;
         }
         else // Zero offset allocation.
         {
@@ -110,8 +139,11 @@ namespace daxa
             actual_allocation_size = allocation_size + left_tail_space;
             returned_allocation_offset = {};
             actual_allocation_offset = {};
+            this->m_statistics.wasted_padding += left_tail_space;
         }
         this->claimed_size += actual_allocation_size;
+        ++this->m_allocation_count;
+        this->m_statistics.high_water_mark = std::max(this->m_statistics.high_water_mark, this->claimed_size + this->spill_bytes_in_use);
         live_allocations.push_back(TrackedAllocation{
             .submit_index = current_timeline_value,
             .offset = actual_allocation_offset,
@@ -123,6 +155,64 @@ namespace daxa
             .buffer_offset = returned_allocation_offset,
             .size = allocation_size,
             .submit_index = current_timeline_value,
+            .buffer = this->m_buffer,
+        };
+    }
+
+    auto RingBuffer::allocate_spill(u32 allocation_size, u32 alignment_requirement) -> std::optional<Allocation>
+    {
+        auto up_align_offset = [](auto value, auto alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        };
+        SpillBlock * spill_block = {};
+        u32 aligned_head = {};
+        for (auto & block : this->spill_blocks)
+        {
+            aligned_head = up_align_offset(block.head, alignment_requirement);
+            if (!block.retired && aligned_head + allocation_size <= block.size)
+            {
+                spill_block = &block;
+                break;
+            }
+        }
+        if (spill_block == nullptr)
+        {
+            if (this->spill_blocks.size() >= this->m_info.max_spill_blocks)
+            {
+                return std::nullopt;
+            }
+            u32 const block_size = std::max(this->m_info.spill_block_size, allocation_size);
+            BufferId const block_buffer = this->m_info.device.create_buffer({
+                .size = block_size,
+                .memory_flags = this->m_info.prefer_device_memory ? daxa::MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE : daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+                .name = this->m_info.name + " spill block",
+            });
+            this->spill_blocks.push_back(SpillBlock{
+                .buffer = block_buffer,
+                .device_address = this->m_info.device.device_address(block_buffer).value(),
+                .host_address = this->m_info.device.buffer_host_address(block_buffer).value(),
+                .size = block_size,
+            });
+            spill_block = &this->spill_blocks.back();
+            aligned_head = 0;
+            this->m_statistics.spill_block_count = static_cast<u32>(this->spill_blocks.size());
+        }
+        u32 const padding = aligned_head - spill_block->head;
+        spill_block->head = aligned_head + allocation_size;
+        this->spill_bytes_in_use += padding + allocation_size;
+        this->spilled_since_reuse = true;
+        ++this->m_allocation_count;
+        ++this->m_statistics.spill_count;
+        this->m_statistics.wasted_padding += padding;
+        this->m_statistics.high_water_mark = std::max(this->m_statistics.high_water_mark, this->claimed_size + this->spill_bytes_in_use);
+        return Allocation{
+            .device_address = spill_block->device_address + aligned_head,
+            .host_address = reinterpret_cast<void *>(reinterpret_cast<u8 *>(spill_block->host_address) + aligned_head),
+            .buffer_offset = aligned_head,
+            .size = allocation_size,
+            .submit_index = m_info.device.latest_submit_index(),
+            .buffer = spill_block->buffer,
         };
     }
 
@@ -131,17 +221,71 @@ namespace daxa
         return allocate_internal(allocation_size, alignment_requirement, true);
     }
 
+    template <typename T>
+    auto allocate_packed_draw_commands(RingBuffer & ring_buffer, daxa::Span<T const> const & draws, bool is_indexed) -> std::optional<DrawIndirectInfo>
+    {
+        u32 const size = static_cast<u32>(sizeof(T) * draws.size());
+        // Indirect draw commands must be 4 byte aligned.
+        auto allocation_o = ring_buffer.allocate(size, 4);
+        if (!allocation_o.has_value())
+        {
+            return std::nullopt;
+        }
+        std::memcpy(allocation_o->host_address, draws.data(), size);
+        return DrawIndirectInfo{
+            .draw_command_buffer = allocation_o->buffer,
+            .indirect_buffer_offset = allocation_o->buffer_offset,
+            .draw_count = static_cast<u32>(draws.size()),
+            .draw_command_stride = 0,
+            .is_indexed = is_indexed,
+        };
+    }
+
+    auto RingBuffer::allocate_draw_commands(daxa::Span<DrawInfo const> const & draws) -> std::optional<DrawIndirectInfo>
+    {
+        return allocate_packed_draw_commands(*this, draws, false);
+    }
+
+    auto RingBuffer::allocate_draw_commands(daxa::Span<DrawIndexedInfo const> const & draws) -> std::optional<DrawIndirectInfo>
+    {
+        return allocate_packed_draw_commands(*this, draws, true);
+    }
+
     void RingBuffer::reclaim_memory()
     {
         auto const current_gpu_submit_index_value = this->m_info.device.oldest_pending_submit_index();
-        while (!live_allocations.empty() && live_allocations.front().submit_index <= current_gpu_submit_index_value)
+        // Only allocations retired by reuse_memory_after_pending_submits are reclaimed, the others may still be recorded into unsubmitted commands.
+        while (this->retired_allocation_count > 0 && live_allocations.front().submit_index < current_gpu_submit_index_value)
         {
             this->claimed_start = (this->claimed_start + live_allocations.front().size) % this->m_info.capacity;
             this->claimed_size -= live_allocations.front().size;
             live_allocations.pop_front();
+            --this->retired_allocation_count;
+        }
+        for (auto & block : this->spill_blocks)
+        {
+            if (block.retired && block.retire_submit_index < current_gpu_submit_index_value)
+            {
+                this->spill_bytes_in_use -= block.head;
+                block.head = 0;
+                block.retired = false;
+            }
         }
     }
 
+    void RingBuffer::release_spill_blocks()
+    {
+        // Only idle blocks are destroyed, retired blocks may still be read by pending submits.
+        auto const idle_end = std::partition(this->spill_blocks.begin(), this->spill_blocks.end(), [](SpillBlock const & block)
+                                             { return block.retired || block.head != 0; });
+        for (auto iter = idle_end; iter != this->spill_blocks.end(); ++iter)
+        {
+            this->m_info.device.destroy_buffer(iter->buffer);
+        }
+        this->spill_blocks.erase(idle_end, this->spill_blocks.end());
+        this->m_statistics.spill_block_count = static_cast<u32>(this->spill_blocks.size());
+    }
+
     auto RingBuffer::info() const -> RingBufferInfo const &
     {
         return this->m_info;
@@ -151,11 +295,689 @@ namespace daxa
     {
         return this->m_buffer;
     }
+
+    auto RingBuffer::allocation_count() const -> u64
+    {
+        return this->m_allocation_count;
+    }
+
+    auto RingBuffer::statistics() const -> RingBufferStatistics
+    {
+        return this->m_statistics;
+    }
     
     void RingBuffer::reuse_memory_after_pending_submits()
     {
         this->reclaim_submit_index = this->m_info.device.latest_submit_index();
+        for (usize i = this->retired_allocation_count; i < this->live_allocations.size(); ++i)
+        {
+            this->live_allocations[i].submit_index = this->reclaim_submit_index;
+        }
+        this->retired_allocation_count = this->live_allocations.size();
+        for (auto & block : this->spill_blocks)
+        {
+            if (block.head != 0 && !block.retired)
+            {
+                block.retired = true;
+                block.retire_submit_index = this->reclaim_submit_index;
+            }
+        }
         reclaim_memory();
+        this->quiet_frames = this->spilled_since_reuse ? 0 : this->quiet_frames + 1;
+        this->spilled_since_reuse = false;
+        if (this->quiet_frames >= this->m_info.spill_release_frames && !this->spill_blocks.empty())
+        {
+            this->release_spill_blocks();
+        }
+    }
+
+    StagingAllocator::StagingAllocator(StagingAllocatorInfo a_info)
+        : m_info{std::move(a_info)},
+          m_buffer{this->m_info.device.create_buffer({
+              .size = static_cast<usize>(this->m_info.block_size) * this->m_info.block_count,
+              .memory_flags = this->m_info.prefer_device_memory ? daxa::MemoryFlagBits::HOST_ACCESS_SEQUENTIAL_WRITE : daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+              .name = this->m_info.name,
+          })},
+          buffer_device_address{this->m_info.device.device_address(this->m_buffer).value()},
+          buffer_host_address{this->m_info.device.buffer_host_address(this->m_buffer).value()},
+          block_heads{std::make_unique<std::atomic<u32>[]>(this->m_info.block_count)}
+    {
+        DAXA_DBG_ASSERT_TRUE_M(static_cast<u64>(this->m_info.block_size) * this->m_info.block_count <= std::numeric_limits<u32>::max(), "staging allocator size must fit into 32 bit buffer offsets");
+        this->free_blocks.reserve(this->m_info.block_count);
+        for (u32 block = this->m_info.block_count; block > 0; --block)
+        {
+            this->free_blocks.push_back(block - 1);
+        }
+    }
+
+    StagingAllocator::~StagingAllocator()
+    {
+        if (!this->m_buffer.is_empty())
+        {
+            this->m_info.device.destroy_buffer(this->m_buffer);
+        }
+    }
+
+    auto StagingAllocator::allocate(u32 allocation_size, u32 alignment_requirement) -> std::optional<Allocation>
+    {
+        if (allocation_size > this->m_info.block_size)
+        {
+            return std::nullopt;
+        }
+        // An alignment of 0 means no alignment requirement.
+        alignment_requirement = std::max(alignment_requirement, 1u);
+        Shard & shard = this->shards[std::hash<std::thread::id>{}(std::this_thread::get_id()) % SHARD_COUNT];
+        while (true)
+        {
+            u32 const block = shard.block.load(std::memory_order_acquire);
+            if (block != NO_BLOCK)
+            {
+                std::atomic<u32> & head = this->block_heads[block];
+                u64 const block_offset = static_cast<u64>(block) * this->m_info.block_size;
+                u32 block_head = head.load(std::memory_order_relaxed);
+                while (true)
+                {
+                    // Aligns the offset within the whole buffer, the block size does not need to be a multiple of the alignment.
+                    u64 const aligned_offset = (block_offset + block_head + alignment_requirement - 1) / alignment_requirement * alignment_requirement;
+                    u64 const new_block_head = aligned_offset + allocation_size - block_offset;
+                    if (new_block_head > this->m_info.block_size)
+                    {
+                        break;
+                    }
+                    if (head.compare_exchange_weak(block_head, static_cast<u32>(new_block_head), std::memory_order_relaxed))
+                    {
+                        this->m_allocation_count.fetch_add(1, std::memory_order_relaxed);
+                        return Allocation{
+                            .device_address = this->buffer_device_address + aligned_offset,
+                            .host_address = reinterpret_cast<void *>(reinterpret_cast<u8 *>(this->buffer_host_address) + aligned_offset),
+                            .buffer_offset = static_cast<u32>(aligned_offset),
+                            .size = allocation_size,
+                        };
+                    }
+                }
+            }
+            // The current block of the shard is full. Replace it, unless another thread of the shard already did.
+            std::lock_guard const lock{shard.mtx};
+            if (shard.block.load(std::memory_order_relaxed) != block)
+            {
+                continue;
+            }
+            u32 const new_block = this->acquire_block();
+            if (new_block == NO_BLOCK)
+            {
+                return std::nullopt;
+            }
+            this->block_heads[new_block].store(0, std::memory_order_relaxed);
+            shard.block.store(new_block, std::memory_order_release);
+            if (block != NO_BLOCK)
+            {
+                std::lock_guard const block_lock{this->block_mtx};
+                this->filled_blocks.push_back(block);
+            }
+        }
+    }
+
+    auto StagingAllocator::acquire_block() -> u32
+    {
+        std::lock_guard const lock{this->block_mtx};
+        if (this->free_blocks.empty())
+        {
+            this->reclaim_blocks();
+        }
+        if (this->free_blocks.empty())
+        {
+            return NO_BLOCK;
+        }
+        u32 const block = this->free_blocks.back();
+        this->free_blocks.pop_back();
+        return block;
+    }
+
+    void StagingAllocator::reclaim_blocks()
+    {
+        auto const current_gpu_submit_index_value = this->m_info.device.oldest_pending_submit_index();
+        while (!this->retired_blocks.empty() && this->retired_blocks.front().submit_index < current_gpu_submit_index_value)
+        {
+            this->free_blocks.push_back(this->retired_blocks.front().block);
+            this->retired_blocks.pop_front();
+        }
+    }
+
+    auto StagingAllocator::info() const -> StagingAllocatorInfo const &
+    {
+        return this->m_info;
+    }
+
+    auto StagingAllocator::buffer() const -> daxa::BufferId
+    {
+        return this->m_buffer;
+    }
+
+    auto StagingAllocator::allocation_count() const -> u64
+    {
+        return this->m_allocation_count.load(std::memory_order_relaxed);
+    }
+
+    void StagingAllocator::reuse_memory_after_pending_submits()
+    {
+        this->retire_blocks(this->close_blocks());
+    }
+
+    auto StagingAllocator::close_blocks() -> std::vector<u32>
+    {
+        std::lock_guard const lock{this->block_mtx};
+        for (auto & shard : this->shards)
+        {
+            u32 const block = shard.block.exchange(NO_BLOCK, std::memory_order_relaxed);
+            if (block != NO_BLOCK)
+            {
+                this->filled_blocks.push_back(block);
+            }
+        }
+        std::vector<u32> blocks = {};
+        std::swap(blocks, this->filled_blocks);
+        return blocks;
+    }
+
+    void StagingAllocator::retire_blocks(std::vector<u32> const & blocks)
+    {
+        std::lock_guard const lock{this->block_mtx};
+        u64 const submit_index = this->m_info.device.latest_submit_index();
+        for (u32 const block : blocks)
+        {
+            this->retired_blocks.push_back(RetiredBlock{.submit_index = submit_index, .block = block});
+        }
+        this->reclaim_blocks();
+    }
+
+    // Buffer offsets of buffer to image copies must be a multiple of the texel block size and of 4.
+    // Aligning to the optimal copy offset alignment as well keeps copies on the fast path.
+    static auto buffer_image_copy_alignment(Device const & device, Format format) -> u32
+    {
+        u64 const optimal_alignment = std::max<u64>(device.properties().limits.optimal_buffer_copy_offset_alignment, 1);
+        return static_cast<u32>(std::lcm(std::lcm<u64>(texel_block_size(format), 4), optimal_alignment));
+    }
+
+    // Byte size of a tightly packed buffer image copy region.
+    static auto image_region_byte_size(Format format, Extent3D const & extent, u32 layer_count) -> u64
+    {
+        Extent3D const block_extent = texel_block_extent(format);
+        u64 const block_count_x = (static_cast<u64>(extent.x) + block_extent.x - 1) / block_extent.x;
+        u64 const block_count_y = (static_cast<u64>(extent.y) + block_extent.y - 1) / block_extent.y;
+        return block_count_x * block_count_y * extent.z * layer_count * texel_block_size(format);
+    }
+
+    UploadQueue::UploadQueue(UploadQueueInfo a_info)
+        : m_info{std::move(a_info)},
+          staging{StagingAllocatorInfo{
+              .device = this->m_info.device,
+              .block_size = this->m_info.staging_block_size,
+              .block_count = this->m_info.staging_block_count,
+              .name = this->m_info.name + " staging",
+          }},
+          timeline{this->m_info.device.create_timeline_semaphore({
+              .name = this->m_info.name + " timeline",
+          })}
+    {
+    }
+
+    UploadQueue::~UploadQueue() = default;
+
+    auto UploadQueue::upload(BufferUploadInfo const & info) -> bool
+    {
+        std::shared_lock const flush_lock{this->flush_mtx};
+        // Uploads larger than a staging block are split, the pieces are coalesced again in flush when they land in the same block.
+        // The pieces are only queued once all of them got staging memory, a failed upload queues nothing.
+        // Staging memory of the pieces staged before the failure is reclaimed with the next flush.
+        std::vector<PendingBufferCopy> pieces = {};
+        pieces.reserve((info.size + this->m_info.staging_block_size - 1) / this->m_info.staging_block_size);
+        usize uploaded = 0;
+        while (uploaded < info.size)
+        {
+            u32 const piece_size = static_cast<u32>(std::min<usize>(info.size - uploaded, this->m_info.staging_block_size));
+            auto allocation = this->staging.allocate(piece_size, 4);
+            if (!allocation.has_value())
+            {
+                return false;
+            }
+            std::memcpy(allocation->host_address, reinterpret_cast<u8 const *>(info.data) + uploaded, piece_size);
+            pieces.push_back(PendingBufferCopy{
+                .src_offset = allocation->buffer_offset,
+                .dst_buffer = info.dst_buffer,
+                .dst_offset = info.dst_offset + uploaded,
+                .size = piece_size,
+            });
+            uploaded += piece_size;
+        }
+        std::lock_guard const lock{this->pending_mtx};
+        for (auto & piece : pieces)
+        {
+            piece.sequence = this->upload_sequence;
+        }
+        ++this->upload_sequence;
+        this->pending_buffer_copies.insert(this->pending_buffer_copies.end(), pieces.begin(), pieces.end());
+        ++this->m_statistics.upload_count;
+        return true;
+    }
+
+    auto UploadQueue::upload(ImageUploadInfo const & info) -> bool
+    {
+        auto const image_info = this->m_info.device.image_info(info.dst_image);
+        // The copy reads a tightly packed region from the staging memory, any other size would make it read past the uploaded data.
+        if (!image_info.has_value() ||
+            info.size != image_region_byte_size(image_info.value().format, info.image_extent, info.image_slice.layer_count) ||
+            info.size > this->m_info.staging_block_size)
+        {
+            return false;
+        }
+        std::shared_lock const flush_lock{this->flush_mtx};
+        auto allocation = this->staging.allocate(static_cast<u32>(info.size), buffer_image_copy_alignment(this->m_info.device, image_info.value().format));
+        if (!allocation.has_value())
+        {
+            return false;
+        }
+        std::memcpy(allocation->host_address, info.data, info.size);
+        std::lock_guard const lock{this->pending_mtx};
+        this->pending_image_copies.push_back(PendingImageCopy{
+            .src_offset = allocation->buffer_offset,
+            .dst_image = info.dst_image,
+            .image_slice = info.image_slice,
+            .image_offset = info.image_offset,
+            .image_extent = info.image_extent,
+        });
+        ++this->m_statistics.upload_count;
+        return true;
+    }
+
+    auto UploadQueue::flush() -> u64
+    {
+        // Flushes are serialized, so that timeline values are signaled in order.
+        std::lock_guard const submit_lock{this->submit_mtx};
+        std::vector<PendingBufferCopy> buffer_copies = {};
+        std::vector<PendingImageCopy> image_copies = {};
+        std::vector<u32> staging_blocks = {};
+        {
+            // Uploads are only blocked while the queued copies and their staging blocks are taken.
+            // Uploads made after this are staged in new blocks and recorded by the next flush.
+            std::unique_lock const flush_lock{this->flush_mtx};
+            {
+                std::lock_guard const lock{this->pending_mtx};
+                std::swap(buffer_copies, this->pending_buffer_copies);
+                std::swap(image_copies, this->pending_image_copies);
+            }
+            staging_blocks = this->staging.close_blocks();
+        }
+        if (buffer_copies.empty() && image_copies.empty())
+        {
+            // Blocks can still hold staging memory of failed uploads.
+            this->staging.retire_blocks(staging_blocks);
+            return this->timeline_value;
+        }
+
+        // Copies are recorded in waves with a transfer barrier between them, so that overlapping uploads land in the order they were queued.
+        // Copies that overlap no other copy all go into the first wave.
+        std::vector<std::vector<PendingBufferCopy>> buffer_copy_waves(1);
+        std::vector<std::vector<PendingImageCopy>> image_copy_waves(1);
+
+        // Sorting by destination makes uploads that are adjacent or overlapping in the destination neighbours.
+        // The sequence makes the order total, so equal destinations stay in queue order.
+        std::sort(buffer_copies.begin(), buffer_copies.end(), [](PendingBufferCopy const & a, PendingBufferCopy const & b)
+                  {
+                      u64 const a_buffer = std::bit_cast<u64>(a.dst_buffer);
+                      u64 const b_buffer = std::bit_cast<u64>(b.dst_buffer);
+                      if (a_buffer != b_buffer)
+                      {
+                          return a_buffer < b_buffer;
+                      }
+                      return a.dst_offset != b.dst_offset ? a.dst_offset < b.dst_offset : a.sequence < b.sequence; });
+        usize cluster_begin = 0;
+        while (cluster_begin < buffer_copies.size())
+        {
+            // A cluster is a run of copies whose destination ranges overlap each other transitively.
+            usize cluster_end = cluster_begin + 1;
+            usize cluster_dst_end = buffer_copies[cluster_begin].dst_offset + buffer_copies[cluster_begin].size;
+            while (cluster_end < buffer_copies.size() &&
+                   buffer_copies[cluster_end].dst_buffer == buffer_copies[cluster_begin].dst_buffer &&
+                   buffer_copies[cluster_end].dst_offset < cluster_dst_end)
+            {
+                cluster_dst_end = std::max(cluster_dst_end, buffer_copies[cluster_end].dst_offset + buffer_copies[cluster_end].size);
+                ++cluster_end;
+            }
+            if (cluster_end - cluster_begin == 1)
+            {
+                // Non overlapping copies are merged when their staging memory is adjacent as well, which is the case for sequential uploads of one thread.
+                auto const & copy = buffer_copies[cluster_begin];
+                auto & first_wave = buffer_copy_waves[0];
+                if (!first_wave.empty())
+                {
+                    auto & prev = first_wave.back();
+                    if (prev.dst_buffer == copy.dst_buffer && prev.dst_offset + prev.size == copy.dst_offset && prev.src_offset + prev.size == copy.src_offset)
+                    {
+                        prev.size += copy.size;
+                        cluster_begin = cluster_end;
+                        continue;
+                    }
+                }
+                first_wave.push_back(copy);
+            }
+            else
+            {
+                // Copies that a later copy fully overwrites are dropped, the rest is recorded one wave per copy in queue order.
+                std::vector<PendingBufferCopy> cluster = {};
+                for (usize i = cluster_begin; i < cluster_end; ++i)
+                {
+                    auto const & copy = buffer_copies[i];
+                    bool const overwritten = std::any_of(buffer_copies.begin() + static_cast<isize>(cluster_begin), buffer_copies.begin() + static_cast<isize>(cluster_end), [&](PendingBufferCopy const & other)
+                                                         { return other.sequence > copy.sequence && other.dst_offset <= copy.dst_offset && other.dst_offset + other.size >= copy.dst_offset + copy.size; });
+                    if (!overwritten)
+                    {
+                        cluster.push_back(copy);
+                    }
+                }
+                std::sort(cluster.begin(), cluster.end(), [](PendingBufferCopy const & a, PendingBufferCopy const & b)
+                          { return a.sequence < b.sequence; });
+                for (usize wave = 0; wave < cluster.size(); ++wave)
+                {
+                    if (buffer_copy_waves.size() <= wave)
+                    {
+                        buffer_copy_waves.emplace_back();
+                    }
+                    buffer_copy_waves[wave].push_back(cluster[wave]);
+                }
+            }
+            cluster_begin = cluster_end;
+        }
+
+        // Image copies are already in queue order. Each goes one wave after the latest earlier copy it overlaps.
+        auto image_copies_overlap = [](PendingImageCopy const & a, PendingImageCopy const & b)
+        {
+            auto ranges_overlap = [](i64 a_begin, i64 a_size, i64 b_begin, i64 b_size)
+            {
+                return a_begin < b_begin + b_size && b_begin < a_begin + a_size;
+            };
+            return a.dst_image == b.dst_image &&
+                   a.image_slice.mip_level == b.image_slice.mip_level &&
+                   ranges_overlap(a.image_slice.base_array_layer, a.image_slice.layer_count, b.image_slice.base_array_layer, b.image_slice.layer_count) &&
+                   ranges_overlap(a.image_offset.x, a.image_extent.x, b.image_offset.x, b.image_extent.x) &&
+                   ranges_overlap(a.image_offset.y, a.image_extent.y, b.image_offset.y, b.image_extent.y) &&
+                   ranges_overlap(a.image_offset.z, a.image_extent.z, b.image_offset.z, b.image_extent.z);
+        };
+        std::vector<usize> image_copy_wave_indices(image_copies.size());
+        for (usize i = 0; i < image_copies.size(); ++i)
+        {
+            usize wave = 0;
+            for (usize earlier = 0; earlier < i; ++earlier)
+            {
+                if (image_copies_overlap(image_copies[earlier], image_copies[i]))
+                {
+                    wave = std::max(wave, image_copy_wave_indices[earlier] + 1);
+                }
+            }
+            image_copy_wave_indices[i] = wave;
+            if (image_copy_waves.size() <= wave)
+            {
+                image_copy_waves.emplace_back();
+            }
+            image_copy_waves[wave].push_back(image_copies[i]);
+        }
+
+        auto recorder = this->m_info.device.create_command_recorder({
+            .queue_type = this->m_info.queue.type,
+            .name = this->m_info.name,
+        });
+        usize const wave_count = std::max(buffer_copy_waves.size(), image_copy_waves.size());
+        usize copy_command_count = 0;
+        for (usize wave = 0; wave < wave_count; ++wave)
+        {
+            if (wave > 0)
+            {
+                recorder.pipeline_barrier({
+                    .src_access = AccessConsts::TRANSFER_WRITE,
+                    .dst_access = AccessConsts::TRANSFER_WRITE,
+                });
+            }
+            if (wave < buffer_copy_waves.size())
+            {
+                for (auto const & copy : buffer_copy_waves[wave])
+                {
+                    recorder.copy_buffer_to_buffer({
+                        .src_buffer = this->staging.buffer(),
+                        .dst_buffer = copy.dst_buffer,
+                        .src_offset = copy.src_offset,
+                        .dst_offset = copy.dst_offset,
+                        .size = copy.size,
+                    });
+                }
+                copy_command_count += buffer_copy_waves[wave].size();
+            }
+            if (wave < image_copy_waves.size())
+            {
+                for (auto const & copy : image_copy_waves[wave])
+                {
+                    recorder.copy_buffer_to_image({
+                        .src_buffer = this->staging.buffer(),
+                        .buffer_offset = copy.src_offset,
+                        .dst_image = copy.dst_image,
+                        .image_slice = copy.image_slice,
+                        .image_offset = copy.image_offset,
+                        .image_extent = copy.image_extent,
+                    });
+                }
+                copy_command_count += image_copy_waves[wave].size();
+            }
+        }
+        auto executable_commands = recorder.complete_current_commands();
+
+        ++this->timeline_value;
+        this->m_info.device.submit_commands({
+            .queue = this->m_info.queue,
+            .command_lists = std::array{executable_commands},
+            .signal_timeline_semaphores = std::array{std::pair{this->timeline, this->timeline_value}},
+        });
+        this->staging.retire_blocks(staging_blocks);
+
+        std::lock_guard const lock{this->pending_mtx};
+        this->m_statistics.copy_command_count += copy_command_count;
+        ++this->m_statistics.flush_count;
+        return this->timeline_value;
+    }
+
+    auto UploadQueue::timeline_semaphore() const -> TimelineSemaphore const &
+    {
+        return this->timeline;
+    }
+
+    auto UploadQueue::info() const -> UploadQueueInfo const &
+    {
+        return this->m_info;
+    }
+
+    auto UploadQueue::statistics() const -> UploadQueueStatistics
+    {
+        std::lock_guard const lock{this->pending_mtx};
+        return this->m_statistics;
+    }
+
+    TextureStreamer::TextureStreamer(TextureStreamerInfo a_info)
+        : m_info{std::move(a_info)},
+          staging{RingBufferInfo{
+              .device = this->m_info.device,
+              .capacity = this->m_info.staging_capacity,
+              .max_spill_blocks = this->m_info.max_staging_spill_blocks,
+              .name = this->m_info.name + " staging",
+          }},
+          timeline{this->m_info.device.create_timeline_semaphore({
+              .name = this->m_info.name + " timeline",
+          })}
+    {
+    }
+
+    TextureStreamer::~TextureStreamer() = default;
+
+    auto TextureStreamer::uses_host_image_copy(ImageId image) const -> bool
+    {
+        if (!this->m_info.prefer_host_image_copy || !(this->m_info.device.properties().implicit_features & ImplicitFeatureFlagBits::HOST_IMAGE_COPY))
+        {
+            return false;
+        }
+        auto const image_info = this->m_info.device.image_info(image);
+        return image_info.has_value() && (image_info.value().usage & ImageUsageFlagBits::HOST_TRANSFER);
+    }
+
+    auto TextureStreamer::upload(TextureUploadInfo const & info) -> bool
+    {
+        auto const image_info = this->m_info.device.image_info(info.image);
+        if (!image_info.has_value() ||
+            info.base_mip_level + info.mips.size() > image_info.value().mip_level_count ||
+            info.base_array_layer + info.layer_count > image_info.value().array_layer_count)
+        {
+            return false;
+        }
+        auto mip_extent = [&](u32 mip_level)
+        {
+            Extent3D const size = image_info.value().size;
+            return Extent3D{
+                .x = std::max(size.x >> mip_level, 1u),
+                .y = std::max(size.y >> mip_level, 1u),
+                .z = std::max(size.z >> mip_level, 1u),
+            };
+        };
+        usize upload_size = 0;
+        for (u32 i = 0; i < info.mips.size(); ++i)
+        {
+            // Copies read the tightly packed mip, a mip of any other size would make them read past its data.
+            if (info.mips[i].size != image_region_byte_size(image_info.value().format, mip_extent(info.base_mip_level + i), info.layer_count))
+            {
+                return false;
+            }
+            upload_size += info.mips[i].size;
+        }
+
+        if (this->uses_host_image_copy(info.image))
+        {
+            // Host image copies write the image directly, no lock, staging memory or command recording needed.
+            if (info.initialize_layout)
+            {
+                this->m_info.device.image_layout_operation({
+                    .image = info.image,
+                    .layout_operation = ImageLayoutOperation::TO_GENERAL,
+                });
+            }
+            for (u32 i = 0; i < info.mips.size(); ++i)
+            {
+                this->m_info.device.copy_memory_to_image({
+                    .memory_ptr = info.mips[i].data,
+                    .image = info.image,
+                    .image_slice = {
+                        .mip_level = info.base_mip_level + i,
+                        .base_array_layer = info.base_array_layer,
+                        .layer_count = info.layer_count,
+                    },
+                    .image_extent = mip_extent(info.base_mip_level + i),
+                });
+            }
+            std::lock_guard const lock{this->mtx};
+            ++this->m_statistics.host_copy_uploads;
+            this->m_statistics.host_copy_bytes += upload_size;
+            return true;
+        }
+
+        // Mips are only queued once all of them got staging memory, a failed upload queues nothing.
+        // Staging memory of the mips staged before the failure is reclaimed with the next flush.
+        u32 const staging_alignment = buffer_image_copy_alignment(this->m_info.device, image_info.value().format);
+        std::lock_guard const lock{this->mtx};
+        usize const first_staged_copy = this->staged_copies.size();
+        for (u32 i = 0; i < info.mips.size(); ++i)
+        {
+            auto allocation = this->staging.allocate(static_cast<u32>(info.mips[i].size), staging_alignment);
+            if (!allocation.has_value())
+            {
+                this->staged_copies.resize(first_staged_copy);
+                return false;
+            }
+            std::memcpy(allocation->host_address, info.mips[i].data, info.mips[i].size);
+            this->staged_copies.push_back(StagedMipCopy{
+                .src_buffer = allocation->buffer,
+                .src_offset = allocation->buffer_offset,
+                .image = info.image,
+                .image_slice = {
+                    .mip_level = info.base_mip_level + i,
+                    .base_array_layer = info.base_array_layer,
+                    .layer_count = info.layer_count,
+                },
+                .image_extent = mip_extent(info.base_mip_level + i),
+            });
+        }
+        if (info.initialize_layout)
+        {
+            this->staged_layout_initializations.push_back(info.image);
+        }
+        ++this->m_statistics.staged_uploads;
+        this->m_statistics.staged_bytes += upload_size;
+        return true;
+    }
+
+    auto TextureStreamer::flush() -> u64
+    {
+        std::lock_guard const lock{this->mtx};
+        if (this->staged_copies.empty() && this->staged_layout_initializations.empty())
+        {
+            // Releases the staging memory of failed uploads.
+            this->staging.reuse_memory_after_pending_submits();
+            return this->timeline_value;
+        }
+        auto recorder = this->m_info.device.create_command_recorder({
+            .queue_type = this->m_info.queue.type,
+            .name = this->m_info.name,
+        });
+        for (ImageId const image : this->staged_layout_initializations)
+        {
+            // The previous contents are discarded, but earlier accesses to the image must still finish before the transition.
+            recorder.pipeline_image_barrier({
+                .src_access = AccessConsts::READ_WRITE,
+                .dst_access = AccessConsts::TRANSFER_WRITE,
+                .image = image,
+                .layout_operation = ImageLayoutOperation::TO_GENERAL,
+            });
+        }
+        for (auto const & copy : this->staged_copies)
+        {
+            recorder.copy_buffer_to_image({
+                .src_buffer = copy.src_buffer,
+                .buffer_offset = copy.src_offset,
+                .dst_image = copy.image,
+                .image_slice = copy.image_slice,
+                .image_extent = copy.image_extent,
+            });
+        }
+        auto executable_commands = recorder.complete_current_commands();
+
+        ++this->timeline_value;
+        this->m_info.device.submit_commands({
+            .queue = this->m_info.queue,
+            .command_lists = std::array{executable_commands},
+            .signal_timeline_semaphores = std::array{std::pair{this->timeline, this->timeline_value}},
+        });
+        this->staging.reuse_memory_after_pending_submits();
+        this->staged_layout_initializations.clear();
+        this->staged_copies.clear();
+        return this->timeline_value;
+    }
+
+    auto TextureStreamer::timeline_semaphore() const -> TimelineSemaphore const &
+    {
+        return this->timeline;
+    }
+
+    auto TextureStreamer::info() const -> TextureStreamerInfo const &
+    {
+        return this->m_info;
+    }
+
+    auto TextureStreamer::statistics() const -> TextureStreamerStatistics
+    {
+        std::lock_guard const lock{this->mtx};
+        return this->m_statistics;
     }
 } // namespace daxa
 
@@ -7,6 +7,12 @@
 
 #include <tuple>
 
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
 static constexpr TBuiltInResource DAXA_DEFAULT_BUILTIN_RESOURCE = {
     .maxLights = 32,
@@ -235,7 +241,11 @@ namespace daxa
             {
                 return nullptr;
             }
-            impl_pipeline_manager->current_observed_hotload_files->insert({full_path, std::chrono::file_clock::now()});
+            // Hot reload compares the recorded write time of real files exactly, so it must be the one of the file on disk.
+            // Local includes are not canonicalized and may not have been recorded under this path by load_shader_source_from_file.
+            auto error_code = std::error_code{};
+            auto const write_time = std::filesystem::last_write_time(full_path, error_code);
+            impl_pipeline_manager->current_observed_hotload_files->insert({full_path, error_code ? std::chrono::file_clock::now() : write_time});
 
             std::string headerName = {};
             char const * headerData = nullptr;
@@ -423,6 +433,7 @@ namespace daxa
     auto PipelineManager::add_ray_tracing_pipeline2(RayTracingPipelineCompileInfo2 const & info) -> Result<std::shared_ptr<RayTracingPipeline>>
     {
         auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        impl.wait_for_async_reload();
 
         // DAXA_DBG_ASSERT_TRUE_M(!daxa::holds_alternative<daxa::Monostate>(a_info.shader_info.source), "must provide shader source");
         auto modified_info = info;
@@ -462,6 +473,7 @@ namespace daxa
     auto PipelineManager::add_compute_pipeline2(ComputePipelineCompileInfo2 a_info) -> Result<std::shared_ptr<ComputePipeline>>
     {
         auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        impl.wait_for_async_reload();
         DAXA_DBG_ASSERT_TRUE_M(!daxa::holds_alternative<daxa::Monostate>(a_info.source), "must provide shader source");
 
         auto m_info = std::move(a_info);
@@ -491,6 +503,7 @@ namespace daxa
     auto PipelineManager::add_raster_pipeline2(RasterPipelineCompileInfo2 const & info) -> Result<std::shared_ptr<RasterPipeline>>
     {
         auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        impl.wait_for_async_reload();
 
         auto modified_info = info;
         auto const modified_shader_compile_infos = std::array<Optional<ShaderCompileInfo2> *, 6>{
@@ -530,18 +543,21 @@ namespace daxa
     void PipelineManager::remove_compute_pipeline(std::shared_ptr<ComputePipeline> const & pipeline)
     {
         auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        impl.wait_for_async_reload();
         return impl.remove_compute_pipeline(pipeline);
     }
 
     void PipelineManager::remove_ray_tracing_pipeline(std::shared_ptr<RayTracingPipeline> const & pipeline)
     {
         auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        impl.wait_for_async_reload();
         return impl.remove_ray_tracing_pipeline(pipeline);
     }
 
     void PipelineManager::remove_raster_pipeline(std::shared_ptr<RasterPipeline> const & pipeline)
     {
         auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        impl.wait_for_async_reload();
         return impl.remove_raster_pipeline(pipeline);
     }
 
@@ -592,6 +608,7 @@ namespace daxa
         PipelineManagerParallelInfo parallel_info) -> PipelineCompileBatch
     {
         auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        impl.wait_for_async_reload();
 
         // Pre-process all infos on the calling thread (same logic as the individual add_* functions).
         for (auto & info : computes)
@@ -828,6 +845,7 @@ namespace daxa
     void PipelineManager::add_virtual_file(VirtualFileInfo const & virtual_info)
     {
         auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        impl.wait_for_async_reload();
         impl.add_virtual_file(virtual_info);
     }
 
@@ -837,9 +855,115 @@ namespace daxa
         return impl.reload_all();
     }
 
+    ShaderFileWatcher::ShaderFileWatcher()
+    {
+#if defined(__linux__)
+        inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+        failed = inotify_fd < 0;
+    }
+
+    ShaderFileWatcher::~ShaderFileWatcher()
+    {
+#if defined(__linux__)
+        if (inotify_fd >= 0)
+        {
+            close(inotify_fd);
+        }
+#endif
+    }
+
+    auto ShaderFileWatcher::next_sequence() const -> u64
+    {
+        return first_event_sequence + events.size();
+    }
+
+    void ShaderFileWatcher::watch([[maybe_unused]] std::filesystem::path const & file_path)
+    {
+#if defined(__linux__)
+        auto directory = file_path.parent_path();
+        auto directory_string = directory.string();
+        if (failed || watched_directory_strings.contains(directory_string))
+        {
+            return;
+        }
+        // Watching the directory instead of the file also catches editors that save by renaming a new file over the old one.
+        static constexpr u32 WATCH_MASK = IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+        int const watch_descriptor = inotify_add_watch(inotify_fd, directory_string.c_str(), WATCH_MASK);
+        if (watch_descriptor < 0)
+        {
+            // Most likely fs.inotify.max_user_watches was reached. Files in this directory would go unnoticed, so stop trusting events entirely.
+            failed = true;
+            return;
+        }
+        watched_directories[watch_descriptor] = std::move(directory);
+        watched_directory_strings.insert(std::move(directory_string));
+#endif
+    }
+
+    void ShaderFileWatcher::push(std::filesystem::path const & path)
+    {
+        events.push_back(path);
+    }
+
+    void ShaderFileWatcher::poll()
+    {
+#if defined(__linux__)
+        alignas(inotify_event) std::array<char, 4096> buffer = {};
+        while (!failed)
+        {
+            auto const read_size = read(inotify_fd, buffer.data(), buffer.size());
+            if (read_size < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (read_size < 0)
+            {
+                failed = errno != EAGAIN && errno != EWOULDBLOCK;
+                return;
+            }
+            if (read_size == 0)
+            {
+                return;
+            }
+            for (usize offset = 0; offset < static_cast<usize>(read_size);)
+            {
+                auto const * event = reinterpret_cast<inotify_event const *>(buffer.data() + offset);
+                offset += sizeof(inotify_event) + event->len;
+                if ((event->mask & IN_Q_OVERFLOW) != 0)
+                {
+                    push(std::filesystem::path{});
+                    continue;
+                }
+                if ((event->mask & IN_IGNORED) != 0)
+                {
+                    // A watched directory was removed or unmounted, its files can no longer be tracked with events.
+                    failed = true;
+                    return;
+                }
+                auto directory_iter = watched_directories.find(event->wd);
+                if (event->len == 0 || directory_iter == watched_directories.end())
+                {
+                    continue;
+                }
+                push(directory_iter->second / std::filesystem::path{event->name});
+            }
+        }
+#endif
+    }
+
+    void ShaderFileWatcher::trim(u64 oldest_needed_sequence)
+    {
+        while (first_event_sequence < oldest_needed_sequence && !events.empty())
+        {
+            events.pop_front();
+            ++first_event_sequence;
+        }
+    }
+
     using FileWriteTimeLookupTable = std::unordered_map<std::string, std::filesystem::file_time_type>;
 
-    static auto check_if_sources_changed(std::chrono::file_clock::time_point & last_hotload_time, ShaderFileTimeSet & observed_hotload_files, VirtualFileSet & virtual_files, FileWriteTimeLookupTable & lookup_table) -> bool
+    static auto check_if_sources_changed(std::chrono::file_clock::time_point & last_hotload_time, ShaderFileTimeSet & observed_hotload_files, VirtualFileSet & virtual_files, FileWriteTimeLookupTable & lookup_table, ShaderFileWatcher * file_watcher, u64 & watch_sequence) -> bool
     {
         using namespace std::chrono_literals;
         static constexpr auto HOTRELOAD_MIN_TIME = 250ms;
@@ -853,6 +977,8 @@ namespace daxa
         last_hotload_time = now;
         bool reload = false;
 
+        // Like the spirv cache, any change of a file write time counts, not just newer ones, so restoring an older file is caught too.
+        // Virtual files are recorded with the time they were observed at, only a newer timestamp means they were replaced.
         auto get_last_file_write_time = [&](std::filesystem::path const & path)
         {
             auto full_path_str = std::filesystem::absolute(path).string();
@@ -869,6 +995,61 @@ namespace daxa
             }
         };
 
+        if (file_watcher != nullptr && !file_watcher->failed)
+        {
+            if (watch_sequence == ShaderFileWatcher::UNREGISTERED)
+            {
+                // First check of this pipeline. Its files are watched from now on,
+                // the full scan below catches changes made between compilation and this point.
+                for (auto const & [path, recorded_write_time] : observed_hotload_files)
+                {
+                    if (!virtual_files.contains(path.string()))
+                    {
+                        file_watcher->watch(path);
+                    }
+                }
+                watch_sequence = file_watcher->next_sequence();
+            }
+            else
+            {
+                // Only files that produced events since the last check need their write times compared.
+                auto changed_files = std::vector<ShaderFileTimeSet::value_type *>{};
+                bool events_lost = watch_sequence < file_watcher->first_event_sequence;
+                for (u64 sequence = watch_sequence; !events_lost && sequence < file_watcher->next_sequence(); ++sequence)
+                {
+                    auto const & changed_path = file_watcher->events[sequence - file_watcher->first_event_sequence];
+                    events_lost = changed_path.empty();
+                    auto iter = observed_hotload_files.find(changed_path);
+                    if (iter != observed_hotload_files.end())
+                    {
+                        changed_files.push_back(&*iter);
+                    }
+                }
+                watch_sequence = file_watcher->next_sequence();
+                if (!events_lost)
+                {
+                    for (auto * changed_file : changed_files)
+                    {
+                        auto path_str = changed_file->first.string();
+                        auto virtual_file_iter = virtual_files.find(path_str);
+                        bool const is_virtual_file = virtual_file_iter != virtual_files.end();
+                        if (!is_virtual_file && !std::filesystem::exists(changed_file->first))
+                        {
+                            continue;
+                        }
+                        auto latest_write_time = is_virtual_file ? virtual_file_iter->second.timestamp : get_last_file_write_time(changed_file->first);
+                        bool const changed = is_virtual_file ? latest_write_time > changed_file->second : latest_write_time != changed_file->second;
+                        if (changed)
+                        {
+                            changed_file->second = latest_write_time;
+                            reload = true;
+                        }
+                    }
+                    return reload;
+                }
+            }
+        }
+
         for (auto & [path, recorded_write_time] : observed_hotload_files)
         {
             auto path_str = path.string();
@@ -883,7 +1064,7 @@ namespace daxa
             else // if (std::filesystem::exists(path))
             {
                 auto latest_write_time = get_last_file_write_time(path);
-                if (latest_write_time > recorded_write_time)
+                if (latest_write_time != recorded_write_time)
                 {
                     reload = true;
                 }
@@ -911,11 +1092,31 @@ namespace daxa
         return reload;
     };
 
+    // Swaps in a recompiled pipeline together with the files observed while compiling it.
+    // Edits can add or remove includes, so the previously observed files are stale after a reload.
+    // The next check watches the new files and compares all of their write times once, which also catches edits made during the compilation.
+    template <typename StateT>
+    static void apply_reloaded_pipeline(decltype(StateT::pipeline_ptr) const & pipeline, ShaderFileTimeSet & observed_hotload_files, u64 & watch_sequence, StateT & reloaded_state)
+    {
+        *pipeline = std::move(*reloaded_state.pipeline_ptr);
+        observed_hotload_files = std::move(reloaded_state.observed_hotload_files);
+        watch_sequence = ShaderFileWatcher::UNREGISTERED;
+    }
+
     auto PipelineManager::reload_all_parallel(PipelineManagerParallelInfo parallel_info) -> PipelineReloadResult
     {
         auto & impl = *r_cast<ImplPipelineManager *>(this->object);
 
+        // Results of a background reload started by poll_reloads are applied first.
+        auto const pending_result = impl.apply_async_reload();
+        if (daxa::holds_alternative<PipelineReloadError>(pending_result))
+        {
+            return pending_result;
+        }
+
         // Serial pass: collect which pipelines changed (fast filesystem stat checks).
+        impl.poll_file_watcher();
+        auto * file_watcher = impl.file_watcher.has_value() ? &impl.file_watcher.value() : nullptr;
         auto lookup_table = FileWriteTimeLookupTable{};
         struct ReloadItem { enum class Type { Compute, Raster, RayTracing } type; u32 index; };
         auto work = std::vector<ReloadItem>{};
@@ -923,23 +1124,23 @@ namespace daxa
         for (u32 i = 0; i < impl.compute_pipelines.size(); ++i)
         {
             auto & s = impl.compute_pipelines[i];
-            if (check_if_sources_changed(s.last_hotload_time, s.observed_hotload_files, impl.virtual_files, lookup_table))
+            if (check_if_sources_changed(s.last_hotload_time, s.observed_hotload_files, impl.virtual_files, lookup_table, file_watcher, s.watch_sequence))
                 work.push_back({ReloadItem::Type::Compute, i});
         }
         for (u32 i = 0; i < impl.raster_pipelines.size(); ++i)
         {
             auto & s = impl.raster_pipelines[i];
-            if (check_if_sources_changed(s.last_hotload_time, s.observed_hotload_files, impl.virtual_files, lookup_table))
+            if (check_if_sources_changed(s.last_hotload_time, s.observed_hotload_files, impl.virtual_files, lookup_table, file_watcher, s.watch_sequence))
                 work.push_back({ReloadItem::Type::Raster, i});
         }
         for (u32 i = 0; i < impl.ray_tracing_pipelines.size(); ++i)
         {
             auto & s = impl.ray_tracing_pipelines[i];
-            if (check_if_sources_changed(s.last_hotload_time, s.observed_hotload_files, impl.virtual_files, lookup_table))
+            if (check_if_sources_changed(s.last_hotload_time, s.observed_hotload_files, impl.virtual_files, lookup_table, file_watcher, s.watch_sequence))
                 work.push_back({ReloadItem::Type::RayTracing, i});
         }
         if (work.empty())
-            return NoPipelineChanged{};
+            return pending_result;
 
         using ComputeState   = ImplPipelineManager::ComputePipelineState;
         using RasterState    = ImplPipelineManager::RasterPipelineState;
@@ -1086,7 +1287,10 @@ namespace daxa
                     ? (new_pipe.is_ok() && new_pipe.value().pipeline_ptr->is_valid())
                     : new_pipe.is_ok();
                 if (is_valid)
-                    *impl.compute_pipelines[item.index].pipeline_ptr = std::move(*new_pipe.value().pipeline_ptr);
+                {
+                    auto & state = impl.compute_pipelines[item.index];
+                    apply_reloaded_pipeline(state.pipeline_ptr, state.observed_hotload_files, state.watch_sequence, new_pipe.value());
+                }
                 else
                     return PipelineReloadError{new_pipe.m};
             }
@@ -1097,7 +1301,10 @@ namespace daxa
                     ? (new_pipe.is_ok() && new_pipe.value().pipeline_ptr->is_valid())
                     : new_pipe.is_ok();
                 if (is_valid)
-                    *impl.raster_pipelines[item.index].pipeline_ptr = std::move(*new_pipe.value().pipeline_ptr);
+                {
+                    auto & state = impl.raster_pipelines[item.index];
+                    apply_reloaded_pipeline(state.pipeline_ptr, state.observed_hotload_files, state.watch_sequence, new_pipe.value());
+                }
                 else
                     return PipelineReloadError{new_pipe.m};
             }
@@ -1108,7 +1315,10 @@ namespace daxa
                     ? (new_pipe.is_ok() && new_pipe.value().pipeline_ptr->is_valid())
                     : new_pipe.is_ok();
                 if (is_valid)
-                    *impl.ray_tracing_pipelines[item.index].pipeline_ptr = std::move(*new_pipe.value().pipeline_ptr);
+                {
+                    auto & state = impl.ray_tracing_pipelines[item.index];
+                    apply_reloaded_pipeline(state.pipeline_ptr, state.observed_hotload_files, state.watch_sequence, new_pipe.value());
+                }
                 else
                     return PipelineReloadError{new_pipe.m};
             }
@@ -1117,12 +1327,40 @@ namespace daxa
         return PipelineReloadSuccess{};
     }
 
+    auto PipelineManager::poll_reloads(PipelineManagerParallelInfo parallel_info) -> PipelineReloadResult
+    {
+        auto & impl = *r_cast<ImplPipelineManager *>(this->object);
+        return impl.poll_reloads(parallel_info);
+    }
+
+    auto PipelineManager::reload_in_progress() const -> bool
+    {
+        auto const & impl = *r_cast<ImplPipelineManager *>(this->object);
+        return impl.async_reload != nullptr && !impl.async_reload->finished.load(std::memory_order_acquire);
+    }
+
+    auto PipelineManager::stage_cache_stats() const -> PipelineManagerStageCacheStats
+    {
+        auto const & impl = *r_cast<ImplPipelineManager *>(this->object);
+        return PipelineManagerStageCacheStats{
+            .memory_hits = impl.stage_cache.memory_hits.load(),
+            .disk_hits = impl.stage_cache.disk_hits.load(),
+            .compiles = impl.stage_cache.compiles.load(),
+        };
+    }
+
     auto PipelineManager::all_pipelines_valid() const -> bool
     {
         auto const & impl = *r_cast<ImplPipelineManager *>(this->object);
         return impl.all_pipelines_valid();
     }
 
+    void PipelineManager::save_pipeline_cache() const
+    {
+        auto const & impl = *r_cast<ImplPipelineManager *>(this->object);
+        impl.save_pipeline_cache_file();
+    }
+
     static std::mutex glslang_init_mtx;
     static i32 pipeline_manager_count = 0;
 
@@ -1157,10 +1395,22 @@ namespace daxa
             }
             ++pipeline_manager_count;
         }
+
+        load_spirv_cache_index();
+        load_pipeline_cache_file();
+
+        file_watcher.emplace();
+        if (file_watcher->failed)
+        {
+            file_watcher.reset();
+        }
     }
 
     ImplPipelineManager::~ImplPipelineManager()
     {
+        wait_for_async_reload();
+        save_spirv_cache_index();
+        save_pipeline_cache_file();
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
         {
             auto lock = std::lock_guard{glslang_init_mtx};
@@ -1609,20 +1859,62 @@ namespace daxa
             this->info.custom_preprocessor(virtual_file.contents, virtual_info.name);
         }
         shader_preprocess(virtual_file.contents, virtual_info.name);
+        if (file_watcher.has_value())
+        {
+            file_watcher->push(std::filesystem::path{virtual_info.name});
+        }
+    }
+
+    void ImplPipelineManager::poll_file_watcher()
+    {
+        if (!file_watcher.has_value())
+        {
+            return;
+        }
+        // Events every pipeline has already looked at are no longer needed.
+        auto oldest_needed_sequence = file_watcher->next_sequence();
+        auto consider = [&](auto const & states)
+        {
+            for (auto const & state : states)
+            {
+                if (state.watch_sequence != ShaderFileWatcher::UNREGISTERED)
+                {
+                    oldest_needed_sequence = std::min(oldest_needed_sequence, state.watch_sequence);
+                }
+            }
+        };
+        consider(compute_pipelines);
+        consider(raster_pipelines);
+        consider(ray_tracing_pipelines);
+        file_watcher->trim(oldest_needed_sequence);
+        file_watcher->poll();
+        if (file_watcher->failed)
+        {
+            file_watcher.reset();
+        }
     }
 
     auto ImplPipelineManager::reload_all() -> PipelineReloadResult
     {
-        bool reloaded = false;
+        // Results of a background reload started by poll_reloads are applied first.
+        auto const pending_result = apply_async_reload();
+        if (daxa::holds_alternative<PipelineReloadError>(pending_result))
+        {
+            return pending_result;
+        }
+        bool reloaded = daxa::holds_alternative<PipelineReloadSuccess>(pending_result);
         auto const t0 = std::chrono::steady_clock::now();
 
         // Optimization for caching the write times so that multiple pipelines don't check the
         // filesystem for the same file's write-time. Filesystem checks are really slow...
         auto lookup_table = FileWriteTimeLookupTable{};
+        // Even better, with a file watcher only files that reported changes are checked at all.
+        poll_file_watcher();
+        auto * file_watcher_ptr = file_watcher.has_value() ? &file_watcher.value() : nullptr;
 
-        for (auto & [pipeline, compile_info, last_hotload_time, observed_hotload_files] : this->compute_pipelines)
+        for (auto & [pipeline, compile_info, last_hotload_time, observed_hotload_files, watch_sequence] : this->compute_pipelines)
         {
-            if (check_if_sources_changed(last_hotload_time, observed_hotload_files, virtual_files, lookup_table))
+            if (check_if_sources_changed(last_hotload_time, observed_hotload_files, virtual_files, lookup_table, file_watcher_ptr, watch_sequence))
             {
                 reloaded = true;
                 auto new_pipeline = create_compute_pipeline(compile_info);
@@ -1637,7 +1929,7 @@ namespace daxa
                 }
                 if (is_valid)
                 {
-                    *pipeline = std::move(*new_pipeline.value().pipeline_ptr);
+                    apply_reloaded_pipeline(pipeline, observed_hotload_files, watch_sequence, new_pipeline.value());
                 }
                 else
                 {
@@ -1646,9 +1938,9 @@ namespace daxa
             }
         }
 
-        for (auto & [pipeline, compile_info, last_hotload_time, observed_hotload_files] : this->raster_pipelines)
+        for (auto & [pipeline, compile_info, last_hotload_time, observed_hotload_files, watch_sequence] : this->raster_pipelines)
         {
-            if (check_if_sources_changed(last_hotload_time, observed_hotload_files, virtual_files, lookup_table))
+            if (check_if_sources_changed(last_hotload_time, observed_hotload_files, virtual_files, lookup_table, file_watcher_ptr, watch_sequence))
             {
                 reloaded = true;
                 auto new_pipeline = create_raster_pipeline(compile_info);
@@ -1663,7 +1955,7 @@ namespace daxa
                 }
                 if (is_valid)
                 {
-                    *pipeline = std::move(*new_pipeline.value().pipeline_ptr);
+                    apply_reloaded_pipeline(pipeline, observed_hotload_files, watch_sequence, new_pipeline.value());
                 }
                 else
                 {
@@ -1672,9 +1964,9 @@ namespace daxa
             }
         }
 
-        for (auto & [pipeline, compile_info, last_hotload_time, observed_hotload_files] : this->ray_tracing_pipelines)
+        for (auto & [pipeline, compile_info, last_hotload_time, observed_hotload_files, watch_sequence] : this->ray_tracing_pipelines)
         {
-            if (check_if_sources_changed(last_hotload_time, observed_hotload_files, virtual_files, lookup_table))
+            if (check_if_sources_changed(last_hotload_time, observed_hotload_files, virtual_files, lookup_table, file_watcher_ptr, watch_sequence))
             {
                 reloaded = true;
                 auto new_pipeline = create_ray_tracing_pipeline(compile_info);
@@ -1689,7 +1981,7 @@ namespace daxa
                 }
                 if (is_valid)
                 {
-                    *pipeline = std::move(*new_pipeline.value().pipeline_ptr);
+                    apply_reloaded_pipeline(pipeline, observed_hotload_files, watch_sequence, new_pipeline.value());
                 }
                 else
                 {
@@ -1710,6 +2002,191 @@ namespace daxa
         }
     }
 
+    auto ImplPipelineManager::poll_reloads(PipelineManagerParallelInfo const & parallel_info) -> PipelineReloadResult
+    {
+        if (this->async_reload != nullptr)
+        {
+            if (!this->async_reload->finished.load(std::memory_order_acquire))
+            {
+                return NoPipelineChanged{};
+            }
+            return apply_async_reload();
+        }
+
+        auto lookup_table = FileWriteTimeLookupTable{};
+        poll_file_watcher();
+        auto * file_watcher_ptr = file_watcher.has_value() ? &file_watcher.value() : nullptr;
+
+        auto reload = std::make_unique<AsyncReload>();
+        reload->parallel_info = parallel_info;
+        // The jobs copy the compile infos, so the background thread never reads the pipeline state vectors.
+        for (auto & state : this->compute_pipelines)
+        {
+            if (check_if_sources_changed(state.last_hotload_time, state.observed_hotload_files, virtual_files, lookup_table, file_watcher_ptr, state.watch_sequence))
+            {
+                reload->computes.push_back({.target = state.pipeline_ptr, .info = state.info});
+                reload->total_stages += 1;
+            }
+        }
+        for (auto & state : this->raster_pipelines)
+        {
+            if (check_if_sources_changed(state.last_hotload_time, state.observed_hotload_files, virtual_files, lookup_table, file_watcher_ptr, state.watch_sequence))
+            {
+                reload->rasters.push_back({.target = state.pipeline_ptr, .info = state.info});
+                reload->total_stages += count_raster_stages(state.info);
+            }
+        }
+        for (auto & state : this->ray_tracing_pipelines)
+        {
+            if (check_if_sources_changed(state.last_hotload_time, state.observed_hotload_files, virtual_files, lookup_table, file_watcher_ptr, state.watch_sequence))
+            {
+                reload->ray_tracings.push_back({.target = state.pipeline_ptr, .info = state.info});
+                reload->total_stages += count_rt_stages(state.info);
+            }
+        }
+        if (reload->computes.empty() && reload->rasters.empty() && reload->ray_tracings.empty())
+        {
+            return NoPipelineChanged{};
+        }
+
+        this->async_reload = std::move(reload);
+        this->async_reload->thread = std::thread{[this, reload_ptr = this->async_reload.get()]()
+                                                 { run_async_reload(*reload_ptr); }};
+        return NoPipelineChanged{};
+    }
+
+    void ImplPipelineManager::run_async_reload(AsyncReload & reload)
+    {
+        // Same per-batch state as reload_all_parallel. Every other call waits for this thread, so nothing races on it.
+        this->parallel_file_cache.emplace();
+        this->current_parallel_info = reload.parallel_info.blocking_parallel_for != nullptr ? &reload.parallel_info : nullptr;
+        this->current_print_mtx = &reload.print_mtx;
+        this->current_completed_stages = &reload.stage_completed;
+        this->current_stage_cache_hits = &reload.stage_cache_hits;
+        this->current_total_stages = reload.total_stages;
+
+        struct TaskState
+        {
+            ImplPipelineManager * impl;
+            AsyncReload * reload;
+        };
+        auto task_state = TaskState{this, &reload};
+        auto * task_fn = +[](void * ud, u32 idx, u32)
+        {
+            auto & s = *static_cast<TaskState *>(ud);
+            auto const compute_count = static_cast<u32>(s.reload->computes.size());
+            auto const raster_count = static_cast<u32>(s.reload->rasters.size());
+            if (idx < compute_count)
+            {
+                auto & job = s.reload->computes[idx];
+                job.result = s.impl->create_compute_pipeline(job.info);
+                if (ImplPipelineManager::tl_last_spirv_from_cache)
+                {
+                    ++s.reload->stage_cache_hits;
+                }
+            }
+            else if (idx < compute_count + raster_count)
+            {
+                auto & job = s.reload->rasters[idx - compute_count];
+                job.result = s.impl->create_raster_pipeline(job.info);
+            }
+            else
+            {
+                auto & job = s.reload->ray_tracings[idx - compute_count - raster_count];
+                job.result = s.impl->create_ray_tracing_pipeline(job.info);
+            }
+        };
+
+        auto const total = static_cast<u32>(reload.computes.size() + reload.rasters.size() + reload.ray_tracings.size());
+        auto const batch_start = std::chrono::steady_clock::now();
+        if (reload.parallel_info.blocking_parallel_for != nullptr)
+        {
+            reload.parallel_info.blocking_parallel_for(reload.parallel_info.user_data, total, &task_state, task_fn);
+        }
+        else
+        {
+            for (u32 i = 0; i < total; ++i)
+            {
+                task_fn(&task_state, i, 0u);
+            }
+        }
+
+        if (reload.parallel_info.print_fn)
+        {
+            auto const total_ms = static_cast<u32>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - batch_start).count());
+            char buf[128];
+            std::snprintf(buf, sizeof(buf), "[done] %5ums  %u/%u stages cached  %u pipelines reloaded in background",
+                total_ms, reload.stage_cache_hits.load(), reload.total_stages, total);
+            std::lock_guard<std::mutex> lock{reload.print_mtx};
+            reload.parallel_info.print_fn(reload.parallel_info.print_user_data, buf, ~0u, 0u, reload.parallel_info.worker_thread_count);
+        }
+
+        this->current_parallel_info = nullptr;
+        this->current_print_mtx = nullptr;
+        this->current_completed_stages = nullptr;
+        this->current_stage_cache_hits = nullptr;
+        this->current_total_stages = 0;
+        this->parallel_file_cache.reset();
+        reload.finished.store(true, std::memory_order_release);
+    }
+
+    void ImplPipelineManager::wait_for_async_reload()
+    {
+        if (this->async_reload != nullptr && this->async_reload->thread.joinable())
+        {
+            this->async_reload->thread.join();
+        }
+    }
+
+    auto ImplPipelineManager::apply_async_reload() -> PipelineReloadResult
+    {
+        if (this->async_reload == nullptr)
+        {
+            return NoPipelineChanged{};
+        }
+        auto reload = std::move(this->async_reload);
+        if (reload->thread.joinable())
+        {
+            reload->thread.join();
+        }
+
+        // Unlike reload_all, every valid pipeline is swapped in even if another one failed; the first error is reported.
+        auto result = PipelineReloadResult{PipelineReloadSuccess{}};
+        auto apply = [&](auto & jobs, auto & states)
+        {
+            for (auto & job : jobs)
+            {
+                auto state_iter = std::find_if(states.begin(), states.end(), [&](auto const & state)
+                                               { return state.pipeline_ptr == job.target; });
+                if (state_iter == states.end())
+                {
+                    continue;
+                }
+                bool is_valid = true;
+                if (this->info.register_null_pipelines_when_first_compile_fails)
+                {
+                    is_valid = job.result.is_ok() && job.result.value().pipeline_ptr->is_valid();
+                }
+                else
+                {
+                    is_valid = job.result.is_ok();
+                }
+                if (is_valid)
+                {
+                    apply_reloaded_pipeline(state_iter->pipeline_ptr, state_iter->observed_hotload_files, state_iter->watch_sequence, job.result.value());
+                }
+                else if (!daxa::holds_alternative<PipelineReloadError>(result))
+                {
+                    result = PipelineReloadError{job.result.m};
+                }
+            }
+        };
+        apply(reload->computes, this->compute_pipelines);
+        apply(reload->rasters, this->raster_pipelines);
+        apply(reload->ray_tracings, this->ray_tracing_pipelines);
+        return result;
+    }
+
     auto ImplPipelineManager::all_pipelines_valid() const -> bool
     {
         for (RasterPipelineState const & raster_pipeline_state : this->raster_pipelines)
@@ -1738,171 +2215,570 @@ namespace daxa
         return true;
     }
 
-    auto ImplPipelineManager::hash_shader_info(std::string const & source_string, ShaderCompileInfo2 const & compile_options, ImplPipelineManager::ShaderStage shader_stage) -> uint64_t
+    auto ImplPipelineManager::shader_cache_options_key(ShaderCompileInfo2 const & compile_options, ImplPipelineManager::ShaderStage shader_stage) const -> std::string
     {
-        auto result = uint64_t{};
+        // Canonical description of everything besides the source that influences the generated spirv.
+        // Every field is length prefixed, so that no two different option sets can produce the same key.
+        auto key = std::string{};
+        auto append = [&key](std::string_view field)
+        {
+            key += std::to_string(field.size());
+            key += ':';
+            key += field;
+        };
+        append(compile_options.entry_point.value_or(std::string{}));
+        append(compile_options.language.has_value() ? std::to_string(static_cast<u32>(compile_options.language.value())) : std::string{});
+        for (auto const & define : compile_options.defines)
+        {
+            append(define.name);
+            append(define.value);
+        }
+        append(compile_options.enable_debug_info.has_value() ? std::to_string(static_cast<u32>(compile_options.enable_debug_info.value())) : std::string{});
+        for (auto const & path : this->info.root_paths)
+        {
+            append(path.string());
+        }
+        append(std::to_string(static_cast<u32>(shader_stage)));
+        return key;
+    }
+
+    auto ImplPipelineManager::hash_shader_info(std::string const & source_string, std::string const & options_key) -> uint64_t
+    {
+        auto result = static_cast<uint64_t>(std::hash<std::string>{}(source_string));
+        result ^= static_cast<uint64_t>(std::hash<std::string>{}(options_key)) + 0x9e3779b97f4a7c15ull + (result << 6) + (result >> 2);
+        return result;
+    }
+
+    static constexpr auto CACHE_FILE_MAGIC_NUMBER = std::bit_cast<uint64_t>(std::to_array("daxpipe"));
+    static constexpr auto CACHE_FILE_VERSION = uint64_t{3};
+    static constexpr auto CACHE_INDEX_MAGIC_NUMBER = std::bit_cast<uint64_t>(std::to_array("daxaidx"));
+    static constexpr auto CACHE_INDEX_VERSION = uint64_t{1};
+    static constexpr auto CACHE_INDEX_FILE_NAME = std::string_view{"index"};
+    // Guards against allocating absurd amounts of memory when reading corrupted cache files.
+    static constexpr auto CACHE_MAX_STRING_SIZE = uint64_t{1} << 20;
 
-        auto hash_combine = [](uint64_t h1, uint64_t h2) -> uint64_t
+    struct ShaderCacheFileHeader
+    {
+        uint64_t magic_number;
+        uint64_t version;
+        uint64_t dependency_n;
+        uint64_t spirv_offset;
+        uint64_t spirv_size;
+    };
+
+    template <typename T>
+    static void write_cache_value(std::string & out, T const & value)
+    {
+        out.append(reinterpret_cast<char const *>(&value), sizeof(T));
+    }
+
+    static void write_cache_string(std::string & out, std::string_view str)
+    {
+        write_cache_value(out, uint64_t{str.size()});
+        out.append(str);
+    }
+
+    template <typename T>
+    static auto read_cache_value(std::istream & in, T & value) -> bool
+    {
+        in.read(reinterpret_cast<char *>(&value), sizeof(T));
+        return in.good();
+    }
+
+    static auto read_cache_string(std::istream & in, std::string & str) -> bool
+    {
+        auto size = uint64_t{};
+        if (!read_cache_value(in, size) || size > CACHE_MAX_STRING_SIZE)
         {
-            return h1 ^ (h2 << 1);
-        };
+            return false;
+        }
+        str.resize(size);
+        in.read(str.data(), static_cast<std::streamsize>(size));
+        return in.good();
+    }
+
+    // Shared by the per entry cache files and the index:
+    // u64 options key size, options key, u64 dependency count, then per dependency u64 flags, u64 path size, path, i64 stamp.
+    static void write_cache_index_entry(std::string & out, ImplPipelineManager::SpirvCacheIndexEntry const & entry)
+    {
+        write_cache_string(out, entry.options_key);
+        write_cache_value(out, uint64_t{entry.dependencies.size()});
+        for (auto const & dependency : entry.dependencies)
+        {
+            auto const flags = static_cast<uint64_t>(dependency.is_virtual) << 0ull;
+            write_cache_value(out, flags);
+            write_cache_string(out, dependency.path.string());
+            write_cache_value(out, dependency.stamp);
+        }
+    }
 
-        auto hash_shader_compile_options = [this, &hash_combine](ShaderCompileInfo2 const & options) -> uint64_t
+    static auto read_cache_index_entry(std::istream & in, ImplPipelineManager::SpirvCacheIndexEntry & entry) -> bool
+    {
+        auto dependency_n = uint64_t{};
+        if (!read_cache_string(in, entry.options_key) || !read_cache_value(in, dependency_n) || dependency_n > CACHE_MAX_STRING_SIZE)
+        {
+            return false;
+        }
+        entry.dependencies.resize(dependency_n);
+        for (auto & dependency : entry.dependencies)
         {
-            auto result = uint64_t{};
-            if (options.entry_point.has_value())
+            auto flags = uint64_t{};
+            auto path_string = std::string{};
+            if (!read_cache_value(in, flags) || !read_cache_string(in, path_string) || !read_cache_value(in, dependency.stamp))
             {
-                result = hash_combine(result, std::hash<std::string>{}(options.entry_point.value()));
+                return false;
             }
-            for (auto const & path : this->info.root_paths)
+            dependency.is_virtual = ((flags >> 0) & 1) != 0;
+            dependency.path = path_string;
+        }
+        return true;
+    }
+
+    static auto virtual_file_stamp(std::string const & contents) -> i64
+    {
+        return std::bit_cast<i64>(static_cast<uint64_t>(std::hash<std::string>{}(contents)));
+    }
+
+    void ImplPipelineManager::load_pipeline_cache_file()
+    {
+        if (!this->info.pipeline_cache_file.has_value())
+        {
+            return;
+        }
+        auto in_file = std::ifstream{this->info.pipeline_cache_file.value(), std::ios::binary | std::ios::ate};
+        if (!in_file.good())
+        {
+            return;
+        }
+        auto const file_size = static_cast<usize>(in_file.tellg());
+        auto data = std::vector<std::byte>(file_size);
+        in_file.seekg(0);
+        in_file.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(file_size));
+        if (!in_file.good())
+        {
+            return;
+        }
+        // A stale cache (e.g. after a driver update) is not an error, it gets replaced with fresh data on the next save.
+        [[maybe_unused]] bool const loaded = this->info.device.load_pipeline_cache(data);
+    }
+
+    void ImplPipelineManager::save_pipeline_cache_file() const
+    {
+        // Also called from the destructor, so nothing in here may throw.
+        // Failures are ignored, the next run merely starts with a colder pipeline cache.
+        if (!this->info.pipeline_cache_file.has_value())
+        {
+            return;
+        }
+        auto const & path = this->info.pipeline_cache_file.value();
+        auto const device = *reinterpret_cast<daxa_Device const *>(&this->info.device);
+        auto data = std::vector<std::byte>{};
+        // The cache can grow between the size query and the copy when pipelines are created concurrently.
+        auto result = DAXA_RESULT_INCOMPLETE;
+        while (result == DAXA_RESULT_INCOMPLETE)
+        {
+            auto size = usize{};
+            if (daxa_dvc_get_pipeline_cache_data(device, &size, nullptr) != DAXA_RESULT_SUCCESS)
             {
-                result = hash_combine(result, std::hash<std::string>{}(path.string()));
+                return;
             }
-            if (options.language.has_value())
+            data.resize(size);
+            result = daxa_dvc_get_pipeline_cache_data(device, &size, data.data());
+            data.resize(size);
+        }
+        if (result != DAXA_RESULT_SUCCESS)
+        {
+            return;
+        }
+        auto ec = std::error_code{};
+        if (path.has_parent_path())
+        {
+            std::filesystem::create_directories(path.parent_path(), ec);
+            if (ec)
             {
-                result = hash_combine(result, std::hash<uint32_t>{}(static_cast<uint32_t>(options.language.value())));
+                return;
             }
-            for (auto const & define : options.defines)
+        }
+        // Write to a temporary file first so that a crash or a concurrently running process never observes a half written cache.
+        auto tmp_path = path;
+        tmp_path += ".tmp";
+        {
+            auto out_file = std::ofstream{tmp_path, std::ios::binary | std::ios::trunc};
+            out_file.write(reinterpret_cast<char const *>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!out_file.good())
             {
-                result = hash_combine(result, std::hash<std::string>{}(define.name));
-                result = hash_combine(result, std::hash<std::string>{}(define.value));
+                return;
             }
-            if (options.enable_debug_info.has_value())
+        }
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tmp_path, ec);
+        }
+    }
+
+    void ImplPipelineManager::load_spirv_cache_index()
+    {
+        if (!this->info.spirv_cache_folder.has_value())
+        {
+            return;
+        }
+        auto in_file = std::ifstream{this->info.spirv_cache_folder.value() / CACHE_INDEX_FILE_NAME, std::ios::binary};
+        auto magic_number = uint64_t{};
+        auto version = uint64_t{};
+        auto entry_n = uint64_t{};
+        if (!in_file.good() ||
+            !read_cache_value(in_file, magic_number) || magic_number != CACHE_INDEX_MAGIC_NUMBER ||
+            !read_cache_value(in_file, version) || version != CACHE_INDEX_VERSION ||
+            !read_cache_value(in_file, entry_n))
+        {
+            return;
+        }
+        auto lock = std::lock_guard{spirv_cache_index.mtx};
+        for (uint64_t entry_i = 0; entry_i < entry_n; ++entry_i)
+        {
+            auto hash = uint64_t{};
+            auto entry = SpirvCacheIndexEntry{};
+            if (!read_cache_value(in_file, hash) || !read_cache_index_entry(in_file, entry))
             {
-                result = hash_combine(result, std::hash<uint32_t>{}(static_cast<uint32_t>(options.enable_debug_info.value())));
+                // A truncated index only loses the remaining entries, they are read from their cache files again on first use.
+                break;
             }
-            return result;
-        };
+            spirv_cache_index.entries.insert_or_assign(hash, std::move(entry));
+        }
+    }
 
-        result = hash_combine(result, std::hash<std::string>{}(source_string));
-        result = hash_combine(result, hash_shader_compile_options(compile_options));
-        result = hash_combine(result, std::hash<uint32_t>{}(static_cast<uint32_t>(shader_stage)));
+    void ImplPipelineManager::save_spirv_cache_index()
+    {
+        if (!this->info.spirv_cache_folder.has_value())
+        {
+            return;
+        }
+        auto data = std::string{};
+        {
+            auto lock = std::lock_guard{spirv_cache_index.mtx};
+            if (!spirv_cache_index.dirty)
+            {
+                return;
+            }
+            write_cache_value(data, CACHE_INDEX_MAGIC_NUMBER);
+            write_cache_value(data, CACHE_INDEX_VERSION);
+            write_cache_value(data, uint64_t{spirv_cache_index.entries.size()});
+            for (auto const & [hash, entry] : spirv_cache_index.entries)
+            {
+                write_cache_value(data, hash);
+                write_cache_index_entry(data, entry);
+            }
+            spirv_cache_index.dirty = false;
+        }
+        auto ec = std::error_code{};
+        auto const & cache_folder = this->info.spirv_cache_folder.value();
+        std::filesystem::create_directories(cache_folder, ec);
+        // Pipeline managers in other processes may share the folder, never let them observe a half written index.
+        auto const index_path = cache_folder / CACHE_INDEX_FILE_NAME;
+        auto tmp_path = index_path;
+        tmp_path += ".tmp";
+        {
+            auto out_file = std::ofstream{tmp_path, std::ios::binary | std::ios::trunc};
+            out_file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!out_file.good())
+            {
+                return;
+            }
+        }
+        std::filesystem::rename(tmp_path, index_path, ec);
+    }
 
-        return result;
+    auto ImplPipelineManager::cached_last_write_time(std::filesystem::path const & path) -> std::optional<std::filesystem::file_time_type>
+    {
+        auto query = [&path]() -> std::optional<std::filesystem::file_time_type>
+        {
+            auto ec = std::error_code{};
+            auto const write_time = std::filesystem::last_write_time(path, ec);
+            if (ec)
+            {
+                return std::nullopt;
+            }
+            return write_time;
+        };
+        if (!parallel_file_cache.has_value())
+        {
+            return query();
+        }
+        auto const path_str = path.string();
+        {
+            std::shared_lock read_lock{parallel_file_cache->mtx};
+            auto it = parallel_file_cache->write_times.find(path_str);
+            if (it != parallel_file_cache->write_times.end())
+            {
+                return it->second;
+            }
+        }
+        auto const write_time = query();
+        std::unique_lock write_lock{parallel_file_cache->mtx};
+        parallel_file_cache->write_times.emplace(path_str, write_time);
+        return write_time;
     }
 
-    static constexpr auto CACHE_FILE_MAGIC_NUMBER = std::bit_cast<uint64_t>(std::to_array("daxpipe"));
-    static constexpr auto CACHE_FILE_VERSION = uint64_t{2};
+    auto ImplPipelineManager::spirv_cache_dependencies_valid(std::vector<SpirvCacheDependency> const & dependencies) -> bool
+    {
+        for (auto const & dependency : dependencies)
+        {
+            if (dependency.is_virtual)
+            {
+                auto virtual_file_iter = virtual_files.find(dependency.path.string());
+                if (virtual_file_iter == virtual_files.end() || virtual_file_stamp(virtual_file_iter->second.contents) != dependency.stamp)
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                // Any change of the write time invalidates, not just newer ones, so restoring an older file is caught too.
+                auto const write_time = cached_last_write_time(dependency.path);
+                if (!write_time.has_value() || static_cast<i64>(write_time->time_since_epoch().count()) != dependency.stamp)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
 
-    struct ShaderCacheFileHeader
+    auto ImplPipelineManager::current_spirv_dependencies() const -> std::vector<SpirvCacheDependency>
     {
-        uint64_t magic_number;
-        uint64_t version;
-        uint64_t dependency_n;
-        uint64_t spirv_size;
-    };
+        auto dependencies = std::vector<SpirvCacheDependency>{};
+        dependencies.reserve(current_observed_hotload_files->size());
+        for (auto const & [path, time_point] : *current_observed_hotload_files)
+        {
+            auto virtual_file_iter = virtual_files.find(path.string());
+            bool const is_virtual_file = virtual_file_iter != virtual_files.end();
+            dependencies.push_back(SpirvCacheDependency{
+                .path = path,
+                .is_virtual = is_virtual_file,
+                .stamp = is_virtual_file ? virtual_file_stamp(virtual_file_iter->second.contents) : static_cast<i64>(time_point.time_since_epoch().count()),
+            });
+        }
+        return dependencies;
+    }
 
-    void ImplPipelineManager::save_shader_cache(std::filesystem::path const & cache_folder, uint64_t shader_info_hash, std::vector<u32> const & spirv)
+    void ImplPipelineManager::observe_spirv_dependencies(std::vector<SpirvCacheDependency> const & dependencies)
     {
-        std::filesystem::create_directories(cache_folder);
-        auto out_file = std::ofstream{cache_folder / std::filesystem::path{std::to_string(shader_info_hash)}, std::ios::binary};
+        for (auto const & dependency : dependencies)
+        {
+            auto const observed_time = dependency.is_virtual
+                                           ? std::chrono::file_clock::now()
+                                           : std::filesystem::file_time_type{std::filesystem::file_time_type::duration{dependency.stamp}};
+            current_observed_hotload_files->insert({dependency.path, observed_time});
+        }
+    }
+
+    void ImplPipelineManager::save_shader_cache(std::filesystem::path const & cache_folder, uint64_t shader_info_hash, std::string const & options_key, std::vector<u32> const & spirv)
+    {
+        auto entry = SpirvCacheIndexEntry{
+            .options_key = options_key,
+            .dependencies = current_spirv_dependencies(),
+        };
+
+        auto entry_data = std::string{};
+        write_cache_index_entry(entry_data, entry);
         auto header = ShaderCacheFileHeader{};
         header.magic_number = CACHE_FILE_MAGIC_NUMBER;
         header.version = CACHE_FILE_VERSION;
-        header.dependency_n = current_observed_hotload_files->size();
+        header.dependency_n = entry.dependencies.size();
+        header.spirv_offset = sizeof(header) + entry_data.size();
         header.spirv_size = spirv.size() * sizeof(u32);
 
+        std::filesystem::create_directories(cache_folder);
+        auto out_file = std::ofstream{cache_folder / std::filesystem::path{std::to_string(shader_info_hash)}, std::ios::binary};
         out_file.write(reinterpret_cast<char const *>(&header), sizeof(header));
-        // TODO: Save more granular dependency info
-        for (auto const & [path, time_point] : *current_observed_hotload_files)
+        out_file.write(entry_data.data(), static_cast<std::streamsize>(entry_data.size()));
+        out_file.write(reinterpret_cast<char const *>(spirv.data()), static_cast<std::streamsize>(header.spirv_size));
+
+        auto lock = std::lock_guard{spirv_cache_index.mtx};
+        spirv_cache_index.entries.insert_or_assign(shader_info_hash, std::move(entry));
+        spirv_cache_index.dirty = true;
+    }
+
+    auto ImplPipelineManager::try_load_shader_cache(std::filesystem::path const & cache_folder, uint64_t shader_info_hash, std::string const & options_key) -> Result<std::vector<u32>>
+    {
+        auto forget_entry = [&]()
         {
-            auto flags = uint64_t{};
-            auto path_string = path.string();
-            auto path_string_size = uint64_t{path_string.size()};
-            auto virtual_file_iter = virtual_files.find(path_string);
-            bool is_virtual_file = virtual_file_iter != virtual_files.end();
-            flags |= (static_cast<uint64_t>(is_virtual_file) << 0ull);
-            auto time_since_epoch = time_point.time_since_epoch().count();
-            out_file.write(reinterpret_cast<char const *>(&flags), sizeof(flags));
-            out_file.write(reinterpret_cast<char const *>(&path_string_size), sizeof(path_string_size));
-            out_file.write(path_string.data(), static_cast<std::streamsize>(path_string.size()));
-            if (is_virtual_file)
-            {
-                auto const & virtual_file_contents = virtual_file_iter->second.contents;
-                auto virtual_file_size = uint64_t{virtual_file_contents.size()};
-                out_file.write(reinterpret_cast<char const *>(&virtual_file_size), sizeof(virtual_file_size));
-                out_file.write(virtual_file_contents.data(), static_cast<std::streamsize>(virtual_file_contents.size()));
+            auto lock = std::lock_guard{spirv_cache_index.mtx};
+            if (spirv_cache_index.entries.erase(shader_info_hash) != 0)
+            {
+                spirv_cache_index.dirty = true;
             }
-            else
+        };
+
+        auto entry = std::optional<SpirvCacheIndexEntry>{};
+        {
+            auto lock = std::lock_guard{spirv_cache_index.mtx};
+            auto iter = spirv_cache_index.entries.find(shader_info_hash);
+            if (iter != spirv_cache_index.entries.end())
             {
-                out_file.write(reinterpret_cast<char const *>(&time_since_epoch), sizeof(time_since_epoch));
+                entry = iter->second;
             }
         }
-        out_file.write(reinterpret_cast<char const *>(spirv.data()), static_cast<std::streamsize>(header.spirv_size));
-    }
+        // Indexed entries are validated before their cache file is even opened.
+        if (entry.has_value() && (entry->options_key != options_key || !spirv_cache_dependencies_valid(entry->dependencies)))
+        {
+            forget_entry();
+            return Result<std::vector<u32>>(std::string_view{"needs update"});
+        }
 
-    auto ImplPipelineManager::try_load_shader_cache(std::filesystem::path const & cache_folder, uint64_t shader_info_hash) -> Result<std::vector<u32>>
-    {
         auto in_file = std::ifstream{cache_folder / std::filesystem::path{std::to_string(shader_info_hash)}, std::ios::binary};
-        if (in_file.good())
+        if (!in_file.good())
+        {
+            forget_entry();
+            return Result<std::vector<u32>>(std::string_view{"no cache found"});
+        }
+        auto header = ShaderCacheFileHeader{};
+        if (!read_cache_value(in_file, header) || header.magic_number != CACHE_FILE_MAGIC_NUMBER)
         {
-            auto header = ShaderCacheFileHeader{};
-            in_file.read(reinterpret_cast<char *>(&header), sizeof(header));
-            if (header.magic_number != CACHE_FILE_MAGIC_NUMBER)
+            forget_entry();
+            return Result<std::vector<u32>>(std::string_view{"bad cache file"});
+        }
+        if (header.version != CACHE_FILE_VERSION)
+        {
+            forget_entry();
+            return Result<std::vector<u32>>(std::string_view{"needs update"});
+        }
+
+        bool const was_indexed = entry.has_value();
+        if (!was_indexed)
+        {
+            // Written by a pipeline manager whose index was not saved (e.g. another process), fall back to the entry file.
+            entry.emplace();
+            if (!read_cache_index_entry(in_file, entry.value()))
             {
                 return Result<std::vector<u32>>(std::string_view{"bad cache file"});
             }
-            if (header.version != CACHE_FILE_VERSION)
+            if (entry->options_key != options_key || !spirv_cache_dependencies_valid(entry->dependencies))
             {
                 return Result<std::vector<u32>>(std::string_view{"needs update"});
             }
+        }
 
-            for (uint64_t dep_i = 0; dep_i < header.dependency_n; ++dep_i)
-            {
-                auto flags = uint64_t{};
-                auto path = std::filesystem::path{};
-                auto time_since_epoch = std::chrono::system_clock::rep{};
-                auto path_string = std::string{};
-                auto path_string_size = uint64_t{};
-                in_file.read(reinterpret_cast<char *>(&flags), sizeof(flags));
-                auto is_virtual_file = ((flags >> 0) & 1) != 0;
-                in_file.read(reinterpret_cast<char *>(&path_string_size), sizeof(path_string_size));
-                path_string.resize(path_string_size);
-                in_file.read(path_string.data(), static_cast<std::streamsize>(path_string_size));
-                path = path_string;
-                if (is_virtual_file)
-                {
-                    auto virtual_file_contents = std::string{};
-                    auto virtual_file_size = uint64_t{};
+        auto spirv = std::vector<u32>{};
+        spirv.resize(header.spirv_size / sizeof(u32));
+        in_file.seekg(static_cast<std::streamoff>(header.spirv_offset));
+        in_file.read(reinterpret_cast<char *>(spirv.data()), static_cast<std::streamsize>(header.spirv_size));
+        if (!in_file.good())
+        {
+            forget_entry();
+            return Result<std::vector<u32>>(std::string_view{"bad cache file"});
+        }
 
-                    in_file.read(reinterpret_cast<char *>(&virtual_file_size), sizeof(virtual_file_size));
-                    virtual_file_contents.resize(virtual_file_size);
-                    in_file.read(virtual_file_contents.data(), static_cast<std::streamsize>(virtual_file_size));
+        observe_spirv_dependencies(entry->dependencies);
+        if (!was_indexed)
+        {
+            auto lock = std::lock_guard{spirv_cache_index.mtx};
+            spirv_cache_index.entries.insert_or_assign(shader_info_hash, std::move(entry.value()));
+            spirv_cache_index.dirty = true;
+        }
+        return Result<std::vector<u32>>{spirv};
+    }
 
-                    auto virtual_file_iter = virtual_files.find(path_string);
-                    if (virtual_file_iter == virtual_files.end())
-                    {
-                        return Result<std::vector<u32>>(std::string_view{"needs update"});
-                    }
-                    if (virtual_file_iter->second.contents != virtual_file_contents)
-                    {
-                        return Result<std::vector<u32>>(std::string_view{"needs update"});
-                    }
-                }
-                else
+    auto ImplPipelineManager::compile_spirv(ShaderCompileInfo2 const & shader_info, std::string const & debug_name_opt, ShaderStage shader_stage, ShaderCode const & code, uint64_t shader_info_hash, std::string const & options_key) -> Result<std::vector<u32>>
+    {
+        if (this->info.spirv_cache_folder.has_value())
+        {
+            auto cache_ret = try_load_shader_cache(this->info.spirv_cache_folder.value(), shader_info_hash, options_key);
+            if (cache_ret.is_ok())
+            {
+                tl_last_spirv_from_cache = true;
+                return cache_ret;
+            }
+        }
+        tl_last_spirv_from_cache = false;
+
+        Result<std::vector<u32>> ret = Result<std::vector<u32>>("No shader was compiled");
+
+        DAXA_DBG_ASSERT_TRUE_M(shader_info.language.has_value(), "How did this happen? You mustn't provide a nullopt for the language");
+
+        DAXA_DBG_ASSERT_TRUE_M(shader_info.language.has_value(), "You must have a shader language set when compiling GLSL");
+        switch (shader_info.language.value())
+        {
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
+        case ShaderLanguage::GLSL:
+            ret = get_spirv_glslang(shader_info, debug_name_opt, shader_stage, code);
+            break;
+#endif
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
+        case ShaderLanguage::SLANG:
+            ret = get_spirv_slang(shader_info, shader_stage, code);
+            break;
+#endif
+        default: break;
+        }
+
+        if (ret.is_err())
+        {
+            return ret;
+        }
+
+        auto spirv = std::move(ret.value());
+
+#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
+        // Patch slang Spirv
+        // There is a bug in slang that it does not annotate per primitive attributes for fragment shaders.
+        // This leads to amd gpus not beeing able to properly read per primitive attributes.
+        // We work around this by adding a daxa name for per primitive inputs (daxa_prim_in).
+        // When the pipeline compiler sees this name, it automatically adds the per primitive attribute to all the fields inside the daxa_prim_in parameter.
+        if (shader_info.language.value() == ShaderLanguage::SLANG) 
+        {
+            char const * patching_prefix = "daxa_prim_in.";
+
+            std::unordered_map<std::string, u32> ids_to_patch = {};
+
+            static const uint32_t SpvOpName      = 5;
+            static const uint32_t SpvOpDecorate  = 71;
+            static const uint32_t SpvDecorationPerPrimitiveEXT = 5271; // from SPIR-V spec
+
+            // Skip header (5 words)
+            size_t i = 5;
+
+            // Pass 1: find the ID of the variable with OpName "prim.visibility_id"
+            while (i < spirv.size())
+            {
+                uint32_t word0 = spirv[i];
+                uint16_t wordCount = word0 >> 16;
+                uint16_t opcode    = word0 & 0xFFFF;
+
+                if (opcode == SpvOpName)
                 {
-                    in_file.read(reinterpret_cast<char *>(&time_since_epoch), sizeof(time_since_epoch));
-                    if (!std::filesystem::exists(path))
-                    {
-                        return Result<std::vector<u32>>(std::string_view{"needs update"});
-                    }
-                    auto write_time = std::filesystem::last_write_time(path);
-                    if (write_time.time_since_epoch().count() > time_since_epoch)
+                    uint32_t id = spirv[i + 1];
+                    const char* name = reinterpret_cast<const char*>(&spirv[i + 2]);
+
+                    if (std::strncmp(patching_prefix, name, std::strlen(patching_prefix)) == 0)
                     {
-                        return Result<std::vector<u32>>(std::string_view{"needs update"});
+                        ids_to_patch[std::string(name)] = id;
                     }
                 }
-                // NOTE(grundlett): Setting the time to now is fine, as we successfully handle
-                // any temporal changes above. This is a bus sus tho.
-                current_observed_hotload_files->insert({path, std::chrono::file_clock::now()});
+
+                i += wordCount;
             }
 
-            auto spirv = std::vector<u32>{};
-            spirv.resize(header.spirv_size / sizeof(u32));
-            in_file.read(reinterpret_cast<char *>(spirv.data()), static_cast<std::streamsize>(header.spirv_size));
-            return Result<std::vector<u32>>{spirv};
+            for (auto [name, target_id] : ids_to_patch)
+            {
+                // Build the OpDecorate instruction
+                uint32_t inst[3];
+                inst[0] = (3u << 16) | SpvOpDecorate;
+                inst[1] = target_id;
+                inst[2] = SpvDecorationPerPrimitiveEXT;
+
+                // Insert after header (word index 5)
+                spirv.insert(spirv.end(), inst, inst + 3);
+            }
         }
-        return Result<std::vector<u32>>(std::string_view{"no cache found"});
+#endif
+
+        if (this->info.spirv_cache_folder.has_value())
+        {
+            save_shader_cache(this->info.spirv_cache_folder.value(), shader_info_hash, options_key, spirv);
+        }
+        return Result<std::vector<u32>>(std::move(spirv));
     }
 
     auto ImplPipelineManager::get_spirv(ShaderCompileInfo2 const & shader_info, std::string const & debug_name_opt, ShaderStage shader_stage) -> Result<std::vector<u32>>
@@ -1949,106 +2825,80 @@ namespace daxa
                 code = daxa::get<ShaderCode>(shader_info.source);
             }
 
-            // TODO: Test if this is slow, as it's not needed if there's no shader cache.
             tl_last_spirv_from_cache = false;
-            auto shader_info_hash = hash_shader_info(code.string, shader_info, shader_stage);
-            if (this->info.spirv_cache_folder.has_value())
+            auto const options_key = shader_cache_options_key(shader_info, shader_stage);
+            auto shader_info_hash = hash_shader_info(code.string, options_key);
+
+            // Identical stages requested by other pipelines reuse the spirv compiled first, even while it is still being compiled.
+            auto claimed_slot_promise = std::optional<std::promise<Result<std::vector<u32>>>>{};
+            auto stage_slot = std::shared_ptr<StageCacheSlot>{};
+            {
+                auto lock = std::lock_guard{stage_cache.mtx};
+                auto & slot = stage_cache.slots[shader_info_hash];
+                // Finished slots are validated like spirv cache entries. Pending ones are compiled from the current files anyway.
+                bool const reusable = slot != nullptr &&
+                                      slot->options_key == options_key &&
+                                      (slot->spirv.wait_for(std::chrono::seconds(0)) != std::future_status::ready || spirv_cache_dependencies_valid(slot->dependencies));
+                if (!reusable)
+                {
+                    claimed_slot_promise.emplace();
+                    slot = std::make_shared<StageCacheSlot>(StageCacheSlot{
+                        .options_key = options_key,
+                        .spirv = claimed_slot_promise->get_future().share(),
+                    });
+                }
+                stage_slot = slot;
+            }
+            if (!claimed_slot_promise.has_value())
             {
-                auto cache_ret = try_load_shader_cache(this->info.spirv_cache_folder.value(), shader_info_hash);
-                if (cache_ret.is_ok())
+                auto const & cached_spirv = stage_slot->spirv.get();
+                current_shader_info = nullptr;
+                if (cached_spirv.is_err())
                 {
-                    tl_last_spirv_from_cache = true;
-                    return cache_ret;
+                    return Result<std::vector<u32>>(cached_spirv.message());
                 }
+                observe_spirv_dependencies(stage_slot->dependencies);
+                ++stage_cache.memory_hits;
+                tl_last_spirv_from_cache = true;
+                return Result<std::vector<u32>>(cached_spirv.value());
             }
-            tl_last_spirv_from_cache = false;
-
-            Result<std::vector<u32>> ret = Result<std::vector<u32>>("No shader was compiled");
 
-            DAXA_DBG_ASSERT_TRUE_M(shader_info.language.has_value(), "How did this happen? You mustn't provide a nullopt for the language");
-
-            DAXA_DBG_ASSERT_TRUE_M(shader_info.language.has_value(), "You must have a shader language set when compiling GLSL");
-            switch (shader_info.language.value())
+            auto ret = compile_spirv(shader_info, debug_name_opt, shader_stage, code, shader_info_hash, options_key);
+            bool const from_disk = tl_last_spirv_from_cache;
+            if (from_disk)
             {
-#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
-            case ShaderLanguage::GLSL:
-                ret = get_spirv_glslang(shader_info, debug_name_opt, shader_stage, code);
-                break;
-#endif
-#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
-            case ShaderLanguage::SLANG:
-                ret = get_spirv_slang(shader_info, shader_stage, code);
-                break;
-#endif
-            default: break;
+                ++stage_cache.disk_hits;
             }
-
-            if (ret.is_err())
+            else
             {
-                current_shader_info = nullptr;
-                return Result<std::vector<u32>>(ret.message());
+                ++stage_cache.compiles;
             }
-
-            spirv = ret.value();
-
-#if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_SLANG
-            // Patch slang Spirv
-            // There is a bug in slang that it does not annotate per primitive attributes for fragment shaders.
-            // This leads to amd gpus not beeing able to properly read per primitive attributes.
-            // We work around this by adding a daxa name for per primitive inputs (daxa_prim_in).
-            // When the pipeline compiler sees this name, it automatically adds the per primitive attribute to all the fields inside the daxa_prim_in parameter.
-            if (shader_info.language.value() == ShaderLanguage::SLANG) 
+            if (ret.is_ok())
             {
-                char const * patching_prefix = "daxa_prim_in.";
-
-                std::unordered_map<std::string, u32> ids_to_patch = {};
-
-                static const uint32_t SpvOpName      = 5;
-                static const uint32_t SpvOpDecorate  = 71;
-                static const uint32_t SpvDecorationPerPrimitiveEXT = 5271; // from SPIR-V spec
-
-                // Skip header (5 words)
-                size_t i = 5;
-
-                // Pass 1: find the ID of the variable with OpName "prim.visibility_id"
-                while (i < spirv.size())
-                {
-                    uint32_t word0 = spirv[i];
-                    uint16_t wordCount = word0 >> 16;
-                    uint16_t opcode    = word0 & 0xFFFF;
-
-                    if (opcode == SpvOpName)
-                    {
-                        uint32_t id = spirv[i + 1];
-                        const char* name = reinterpret_cast<const char*>(&spirv[i + 2]);
-
-                        if (std::strncmp(patching_prefix, name, std::strlen(patching_prefix)) == 0)
-                        {
-                            ids_to_patch[std::string(name)] = id;
-                        }
-                    }
-
-                    i += wordCount;
-                }
-
-                for (auto [name, target_id] : ids_to_patch)
+                stage_slot->dependencies = current_spirv_dependencies();
+            }
+            else
+            {
+                // Failed stages are not cached, the next request tries again.
+                auto lock = std::lock_guard{stage_cache.mtx};
+                auto iter = stage_cache.slots.find(shader_info_hash);
+                if (iter != stage_cache.slots.end() && iter->second == stage_slot)
                 {
-                    // Build the OpDecorate instruction
-                    uint32_t inst[3];
-                    inst[0] = (3u << 16) | SpvOpDecorate;
-                    inst[1] = target_id;
-                    inst[2] = SpvDecorationPerPrimitiveEXT;
-
-                    // Insert after header (word index 5)
-                    spirv.insert(spirv.end(), inst, inst + 3);
+                    stage_cache.slots.erase(iter);
                 }
             }
-#endif
+            claimed_slot_promise->set_value(ret);
 
-            if (this->info.spirv_cache_folder.has_value())
+            if (ret.is_err())
+            {
+                current_shader_info = nullptr;
+                return Result<std::vector<u32>>(ret.message());
+            }
+            if (from_disk)
             {
-                save_shader_cache(this->info.spirv_cache_folder.value(), shader_info_hash, spirv);
+                return ret;
             }
+            spirv = std::move(ret.value());
         }
         current_shader_info = nullptr;
 
@@ -2495,7 +3345,10 @@ namespace daxa
             auto const * const dep_path = slangRequest->getDependencyFilePath(dependency_i);
             if (std::strcmp(dep_path, "_daxa_slang_main") != 0)
             {
-                current_observed_hotload_files->insert({dep_path, std::chrono::file_clock::now()});
+                // Recording the write time like the glslang includer does lets the stage caches validate slang stages too.
+                auto error_code = std::error_code{};
+                auto const write_time = std::filesystem::last_write_time(dep_path, error_code);
+                current_observed_hotload_files->insert({dep_path, error_code ? std::chrono::file_clock::now() : write_time});
             }
         }
 
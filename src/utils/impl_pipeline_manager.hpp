@@ -23,7 +23,11 @@
 
 #include <shared_mutex>
 #include <unordered_map>
+#include <unordered_set>
+#include <deque>
 #include <optional>
+#include <thread>
+#include <future>
 
 namespace daxa
 {
@@ -39,6 +43,36 @@ namespace daxa
 
     using VirtualFileSet = std::map<std::string, VirtualFileState>;
 
+    // Event driven change tracking for observed shader files, so that reload_all only looks at files that actually changed.
+    // Built on inotify and therefore linux only. Elsewhere, or once events can no longer be trusted
+    // (watch limit reached, watched directory removed), the pipeline manager polls write times instead.
+    struct ShaderFileWatcher
+    {
+        static constexpr u64 UNREGISTERED = ~u64{0};
+
+        int inotify_fd = -1;
+        std::unordered_map<int, std::filesystem::path> watched_directories = {};
+        std::unordered_set<std::string> watched_directory_strings = {};
+        // Log of changed paths, the event with sequence number i is stored at events[i - first_event_sequence].
+        // An empty path means events were lost and every observed file has to be checked.
+        std::deque<std::filesystem::path> events = {};
+        u64 first_event_sequence = {};
+        bool failed = {};
+
+        ShaderFileWatcher();
+        ~ShaderFileWatcher();
+        ShaderFileWatcher(ShaderFileWatcher const &) = delete;
+        ShaderFileWatcher(ShaderFileWatcher &&) = delete;
+        auto operator=(ShaderFileWatcher const &) -> ShaderFileWatcher & = delete;
+        auto operator=(ShaderFileWatcher &&) -> ShaderFileWatcher & = delete;
+
+        auto next_sequence() const -> u64;
+        void watch(std::filesystem::path const & file_path);
+        void push(std::filesystem::path const & path);
+        void poll();
+        void trim(u64 oldest_needed_sequence);
+    };
+
     struct ImplPipelineManager final : ImplHandle
     {
         enum class ShaderStage
@@ -80,14 +114,62 @@ namespace daxa
         {
             std::shared_mutex mtx = {};
             std::unordered_map<std::string, FileCacheEntry> files = {};
+            // Write times of spirv cache dependencies, so that each include is only stat'ed once per batch.
+            std::unordered_map<std::string, std::optional<std::filesystem::file_time_type>> write_times = {};
         };
         std::optional<FileCache> parallel_file_cache = {};
+
+        // In memory index over spirv_cache_folder. Loaded once on creation and written back on destruction.
+        // Records the include set and compile options of every cache entry,
+        // so that warm startup validates entries from file metadata alone, without reading every entry file up front.
+        struct SpirvCacheDependency
+        {
+            std::filesystem::path path = {};
+            bool is_virtual = {};
+            // Write time for files on disk, content hash for virtual files.
+            i64 stamp = {};
+        };
+        struct SpirvCacheIndexEntry
+        {
+            std::string options_key = {};
+            std::vector<SpirvCacheDependency> dependencies = {};
+        };
+        struct SpirvCacheIndex
+        {
+            std::mutex mtx = {};
+            std::unordered_map<u64, SpirvCacheIndexEntry> entries = {};
+            bool dirty = false;
+        };
+        SpirvCacheIndex spirv_cache_index = {};
+
+        // In memory stage cache, keyed like the spirv cache, but independent of spirv_cache_folder.
+        // Identical stages shared by several pipelines compile once per run.
+        // A stage still being compiled is already in the cache, so parallel compiles of the same stage wait for it instead of compiling again.
+        struct StageCacheSlot
+        {
+            std::string options_key = {};
+            // Written before spirv is fulfilled, only read after waiting for it.
+            std::vector<SpirvCacheDependency> dependencies = {};
+            std::shared_future<Result<std::vector<u32>>> spirv = {};
+        };
+        struct StageCache
+        {
+            std::mutex mtx = {};
+            std::unordered_map<u64, std::shared_ptr<StageCacheSlot>> slots = {};
+            std::atomic<u32> memory_hits = {};
+            std::atomic<u32> disk_hits = {};
+            std::atomic<u32> compiles = {};
+        };
+        StageCache stage_cache = {};
+
+        std::optional<ShaderFileWatcher> file_watcher = {};
         // Set for the duration of compile_pipelines_parallel / reload_all_parallel.
         // Allows create_raster/rt_pipeline to fan out their per-stage get_spirv calls
         // and to share the outer ParallelState's print mutex for interleave-free output.
         PipelineManagerParallelInfo const * current_parallel_info = nullptr;
         std::mutex * current_print_mtx = nullptr;
         std::atomic<u32> * current_completed_stages = nullptr;
+        // Counts stages served from stage_cache or the spirv_cache_folder.
         std::atomic<u32> * current_stage_cache_hits = nullptr;
         u32 current_total_stages = 0;
 
@@ -98,6 +180,8 @@ namespace daxa
             InfoT info = {};
             std::chrono::file_clock::time_point last_hotload_time = {};
             ShaderFileTimeSet observed_hotload_files = {};
+            // Next file watcher event this pipeline has not looked at yet.
+            u64 watch_sequence = ShaderFileWatcher::UNREGISTERED;
         };
 
         using ComputePipelineState = PipelineState<ComputePipeline, ComputePipelineCompileInfo2>;
@@ -108,6 +192,30 @@ namespace daxa
         std::vector<RasterPipelineState> raster_pipelines;
         std::vector<RayTracingPipelineState> ray_tracing_pipelines;
 
+        // Background reload started by poll_reloads. At most one is in flight, its results are only applied by poll_reloads.
+        template <typename StateT>
+        struct AsyncReloadJob
+        {
+            // Pipelines are identified by their shared_ptr, so pipelines removed while the reload runs are simply skipped.
+            decltype(StateT::pipeline_ptr) target = {};
+            decltype(StateT::info) info = {};
+            Result<StateT> result = Result<StateT>(std::string_view{"pending"});
+        };
+        struct AsyncReload
+        {
+            std::vector<AsyncReloadJob<ComputePipelineState>> computes = {};
+            std::vector<AsyncReloadJob<RasterPipelineState>> rasters = {};
+            std::vector<AsyncReloadJob<RayTracingPipelineState>> ray_tracings = {};
+            PipelineManagerParallelInfo parallel_info = {};
+            u32 total_stages = {};
+            std::mutex print_mtx = {};
+            std::atomic<u32> stage_completed = {};
+            std::atomic<u32> stage_cache_hits = {};
+            std::atomic<bool> finished = {};
+            std::thread thread = {};
+        };
+        std::unique_ptr<AsyncReload> async_reload = {};
+
 #if DAXA_BUILT_WITH_UTILS_PIPELINE_MANAGER_GLSLANG
         struct GlslangBackend
         {
@@ -141,15 +249,30 @@ namespace daxa
         void add_virtual_file(VirtualFileInfo const & virtual_info);
         auto reload_all() -> PipelineReloadResult;
         auto all_pipelines_valid() const -> bool;
+        void poll_file_watcher();
+        auto poll_reloads(PipelineManagerParallelInfo const & parallel_info) -> PipelineReloadResult;
+        void run_async_reload(AsyncReload & reload);
+        void wait_for_async_reload();
+        auto apply_async_reload() -> PipelineReloadResult;
 
-        auto try_load_shader_cache(std::filesystem::path const & cache_folder, uint64_t shader_info_hash) -> Result<std::vector<u32>>;
-        void save_shader_cache(std::filesystem::path const & out_folder, uint64_t shader_info_hash, std::vector<u32> const & spirv);
+        void load_pipeline_cache_file();
+        void save_pipeline_cache_file() const;
+        void load_spirv_cache_index();
+        void save_spirv_cache_index();
+        auto cached_last_write_time(std::filesystem::path const & path) -> std::optional<std::filesystem::file_time_type>;
+        auto spirv_cache_dependencies_valid(std::vector<SpirvCacheDependency> const & dependencies) -> bool;
+        auto current_spirv_dependencies() const -> std::vector<SpirvCacheDependency>;
+        void observe_spirv_dependencies(std::vector<SpirvCacheDependency> const & dependencies);
+        auto try_load_shader_cache(std::filesystem::path const & cache_folder, uint64_t shader_info_hash, std::string const & options_key) -> Result<std::vector<u32>>;
+        void save_shader_cache(std::filesystem::path const & out_folder, uint64_t shader_info_hash, std::string const & options_key, std::vector<u32> const & spirv);
         auto full_path_to_file(std::filesystem::path const & path) -> Result<std::filesystem::path>;
         auto load_shader_source_from_file(std::filesystem::path const & path) -> Result<ShaderCode>;
 
 
-        auto hash_shader_info(std::string const & source_string, ShaderCompileInfo2 const & compile_options, ImplPipelineManager::ShaderStage shader_stage) -> uint64_t;
+        auto shader_cache_options_key(ShaderCompileInfo2 const & compile_options, ImplPipelineManager::ShaderStage shader_stage) const -> std::string;
+        static auto hash_shader_info(std::string const & source_string, std::string const & options_key) -> uint64_t;
         auto get_spirv(ShaderCompileInfo2 const & shader_info, std::string const & debug_name_opt, ShaderStage shader_stage) -> Result<std::vector<u32>>;
+        auto compile_spirv(ShaderCompileInfo2 const & shader_info, std::string const & debug_name_opt, ShaderStage shader_stage, ShaderCode const & code, uint64_t shader_info_hash, std::string const & options_key) -> Result<std::vector<u32>>;
         auto get_spirv_glslang(ShaderCompileInfo2 const & shader_info, std::string const & debug_name_opt, ShaderStage shader_stage, ShaderCode const & code) -> Result<std::vector<u32>>;
         auto get_spirv_slang(ShaderCompileInfo2 const & shader_info, ShaderStage shader_stage, ShaderCode const & code) -> Result<std::vector<u32>>;
 
@@ -3,6 +3,7 @@
 #include "../impl_core.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <iostream>
 #include <set>
 
@@ -125,6 +126,16 @@ namespace daxa
         }
     }
 
+    auto to_string(TaskResourceAliasingStrategy strategy) -> std::string_view
+    {
+        switch (strategy)
+        {
+            case TaskResourceAliasingStrategy::FIRST_FIT: return "FIRST_FIT";
+            case TaskResourceAliasingStrategy::BEST_FIT: return "BEST_FIT";
+            default: return "UNKNOWN";
+        }
+    }
+
     auto to_string(TaskStages tstage) -> std::string
     {
         std::string ret = {};
@@ -1214,15 +1225,8 @@ namespace daxa
                     }));
     }
 
-    void TaskGraph::request_persistent_buffer_clear(TaskBufferView const & task_buffer)
+    void add_resource_clear_request(ImplTaskGraph & impl, ImplTaskResource & resource, u32 resource_index)
     {
-        ImplTaskGraph & impl = *reinterpret_cast<ImplTaskGraph *>(this->object);
-
-        DAXA_DBG_ASSERT_TRUE_M(impl.compiled, "ERROR: Persistent resource clear requests can ONLY be done outside of graph recording. Hint: all persistent resources are automatically cleared before the first execution.");
-
-        u32 const resource_index = validate_and_translate_view(impl, task_buffer).index;
-        ImplTaskResource & resource = impl.resources[resource_index];
-
         if (resource.clear_request_index == ~0u)
         {
             u32 const clear_request_index = impl.resource_clear_request_count;
@@ -1235,6 +1239,16 @@ namespace daxa
         }
     }
 
+    void TaskGraph::request_persistent_buffer_clear(TaskBufferView const & task_buffer)
+    {
+        ImplTaskGraph & impl = *reinterpret_cast<ImplTaskGraph *>(this->object);
+
+        DAXA_DBG_ASSERT_TRUE_M(impl.compiled, "ERROR: Persistent resource clear requests can ONLY be done outside of graph recording. Hint: all persistent resources are automatically cleared before the first execution.");
+
+        u32 const resource_index = validate_and_translate_view(impl, task_buffer).index;
+        add_resource_clear_request(impl, impl.resources[resource_index], resource_index);
+    }
+
     void TaskGraph::request_persistent_image_clear(TaskImageView const & task_image)
     {
         ImplTaskGraph & impl = *reinterpret_cast<ImplTaskGraph *>(this->object);
@@ -1242,17 +1256,57 @@ namespace daxa
         DAXA_DBG_ASSERT_TRUE_M(impl.compiled, "ERROR: Persistent resource clear requests can ONLY be done outside of graph recording. Hint: all persistent resources are automatically cleared before the first execution.");
 
         u32 const resource_index = validate_and_translate_view(impl, task_image).index;
+        add_resource_clear_request(impl, impl.resources[resource_index], resource_index);
+    }
+
+    void TaskGraph::resize_task_buffer(TaskBufferView const & task_buffer, u64 size)
+    {
+        ImplTaskGraph & impl = *reinterpret_cast<ImplTaskGraph *>(this->object);
+
+        u32 const resource_index = validate_and_translate_view(impl, task_buffer).index;
         ImplTaskResource & resource = impl.resources[resource_index];
 
-        if (resource.clear_request_index == ~0u)
+        DAXA_DBG_ASSERT_TRUE_M(resource.external == nullptr, std::format("ERROR: Only graph owned resources can be resized! Detected resize of external resource \"{}\".", resource.name).c_str());
+        DAXA_DBG_ASSERT_TRUE_M(size > 0, std::format("ERROR: Detected resize of buffer \"{}\" to size 0!", resource.name).c_str());
+
+        // Both buffers of a double buffer resource must always match.
+        for (ImplTaskResource * r : {&resource, resource.double_buffer_pair_resource.first})
         {
-            u32 const clear_request_index = impl.resource_clear_request_count;
-            DAXA_DBG_ASSERT_TRUE_M(clear_request_index < impl.resource_clear_requests.size(), "IMPOSSIBLE CASE! THE CODE SHOULD BE SET UP IN A WAY THAT THE CLEAR REQUEST SPAN SIZE CAN NEVER BE EXCEEDED!");
+            if (r != nullptr && r->info.buffer.size != size)
+            {
+                r->info.buffer.size = size;
+                r->resized = true;
+                impl.pending_resource_resizes = true;
+            }
+        }
+    }
 
-            impl.resource_clear_requests[clear_request_index] = { &resource, resource_index };
-            resource.clear_request_index = clear_request_index;
+    void TaskGraph::resize_task_image(TaskImageView const & task_image, Extent3D const & size)
+    {
+        ImplTaskGraph & impl = *reinterpret_cast<ImplTaskGraph *>(this->object);
 
-            impl.resource_clear_request_count += 1;
+        u32 const resource_index = validate_and_translate_view(impl, task_image).index;
+        ImplTaskResource & resource = impl.resources[resource_index];
+
+        DAXA_DBG_ASSERT_TRUE_M(resource.external == nullptr, std::format("ERROR: Only graph owned resources can be resized! Detected resize of external resource \"{}\".", resource.name).c_str());
+        DAXA_DBG_ASSERT_TRUE_M(size.x > 0 && size.y > 0 && size.z > 0, std::format("ERROR: Detected resize of image \"{}\" to an empty extent!", resource.name).c_str());
+        u32 const max_extent = std::max({size.x, size.y, size.z});
+        u32 const max_mip_level_count = static_cast<u32>(std::bit_width(max_extent));
+        DAXA_DBG_ASSERT_TRUE_M(
+            resource.info.image.mip_level_count <= max_mip_level_count,
+            std::format("ERROR: Detected resize of image \"{}\" to extent ({},{},{}) which only supports {} mip levels, but the image has {} mip levels!",
+                        resource.name, size.x, size.y, size.z, max_mip_level_count, resource.info.image.mip_level_count)
+                .c_str());
+
+        // Both images of a double buffer resource must always match.
+        for (ImplTaskResource * r : {&resource, resource.double_buffer_pair_resource.first})
+        {
+            if (r != nullptr && r->info.image.size != size)
+            {
+                r->info.image.size = size;
+                r->resized = true;
+                impl.pending_resource_resizes = true;
+            }
         }
     }
 
@@ -1509,7 +1563,7 @@ namespace daxa
         TaskAttachmentInfo & attachment_info = task.attachments[attach_i];
 
         DAXA_DBG_ASSERT_TRUE_M(!attachment_info.value.image.translated_view.is_null(), "IMPOSSIBLE CASE, WE SHOULD NEVER TRY TO PATCH NULL ATTACHMENTS!");
-        DAXA_DBG_ASSERT_TRUE_M(resource.external != nullptr || resource.lifetime_type == TaskResourceLifetimeType::PERSISTENT_DOUBLE_BUFFER, "IMPOSSIBLE CASE, WE SHOULD NEVER TRY TO PATCH NON EXTERNAL, NON DOUBLE BUFFER RESOURCE ATTACHMENTS!");
+        DAXA_DBG_ASSERT_TRUE_M(resource.external != nullptr || resource.lifetime_type == TaskResourceLifetimeType::PERSISTENT_DOUBLE_BUFFER || resource.resized, "IMPOSSIBLE CASE, WE SHOULD NEVER TRY TO PATCH NON EXTERNAL, NON DOUBLE BUFFER, NON RESIZED RESOURCE ATTACHMENTS!");
 
         switch (attachment_info.type)
         {
@@ -1548,7 +1602,7 @@ namespace daxa
         }
 
         DAXA_DBG_ASSERT_TRUE_M(!attachment_info.value.image.translated_view.is_null(), "IMPOSSIBLE CASE, WE SHOULD NEVER TRY TO PATCH NULL ATTACHMENTS!");
-        DAXA_DBG_ASSERT_TRUE_M(resource.external != nullptr || resource.lifetime_type == TaskResourceLifetimeType::PERSISTENT_DOUBLE_BUFFER, "IMPOSSIBLE CASE, WE SHOULD NEVER TRY TO PATCH NON EXTERNAL, NON DOUBLE BUFFER RESOURCE ATTACHMENTS!");
+        DAXA_DBG_ASSERT_TRUE_M(resource.external != nullptr || resource.lifetime_type == TaskResourceLifetimeType::PERSISTENT_DOUBLE_BUFFER || resource.resized, "IMPOSSIBLE CASE, WE SHOULD NEVER TRY TO PATCH NON EXTERNAL, NON DOUBLE BUFFER, NON RESIZED RESOURCE ATTACHMENTS!");
 
         if (attachment_info.value.image.is_mip_array)
         {
@@ -1627,7 +1681,7 @@ namespace daxa
         auto asb_section = task.attachment_shader_blob_sections[attach_i];
 
         DAXA_DBG_ASSERT_TRUE_M(!attachment_info.value.image.translated_view.is_null(), "IMPOSSIBLE CASE, WE SHOULD NEVER TRY TO PATCH NULL ATTACHMENTS!");
-        DAXA_DBG_ASSERT_TRUE_M(resource.external != nullptr || resource.lifetime_type == TaskResourceLifetimeType::PERSISTENT_DOUBLE_BUFFER, "IMPOSSIBLE CASE, WE SHOULD NEVER TRY TO PATCH NON EXTERNAL, NON DOUBLE BUFFER RESOURCE ATTACHMENTS!");
+        DAXA_DBG_ASSERT_TRUE_M(resource.external != nullptr || resource.lifetime_type == TaskResourceLifetimeType::PERSISTENT_DOUBLE_BUFFER || resource.resized, "IMPOSSIBLE CASE, WE SHOULD NEVER TRY TO PATCH NON EXTERNAL, NON DOUBLE BUFFER, NON RESIZED RESOURCE ATTACHMENTS!");
 
         switch (attachment_info.type)
         {
@@ -1935,138 +1989,739 @@ namespace daxa
         };
     }
 
-    void TaskGraph::complete(TaskCompleteInfo const & /*unused*/)
+    struct NonExternalResourceAllocation
     {
-        ImplTaskGraph & impl = *r_cast<ImplTaskGraph *>(this->object);
-        u32 required_tmp_size = 1u << 23u; /* 8MB */
-        MemoryArena tmp_memory = MemoryArena{"TaskGraph::complete tmp memory", required_tmp_size};
+        ImplTaskResource * resource = {};
+        u32 resource_index = {};
+        u64 offset = {};
+        u64 size = {};
+    };
 
-        /// ================================
-        /// ==== EARLY INPUT VALIDATION ====
-        /// ================================
+    struct NonExternalResourceAllocations
+    {
+        std::span<NonExternalResourceAllocation> allocations = {};
+        u64 heap_size = {};
+        u64 heap_alignment = {};
+        u32 heap_memory_type_bits = {};
+    };
+
+    // Queries the memory requirements of all non external resources.
+    void determine_resource_allocation_sizes(ImplTaskGraph & impl)
+    {
+        for (u32 r = 0; r < impl.resources.size(); ++r)
+        {
+            ImplTaskResource & resource = impl.resources[r];
+            if (resource.external)
+            {
+                continue;
+            }
 
-        DAXA_DBG_ASSERT_TRUE_M(impl.submits.size() > 0, "ERROR: All task graphs must have at least one submission!");
-        DAXA_DBG_ASSERT_TRUE_M(!impl.compiled, "ERROR: TaskGraph was already completed!");
-        if (impl.present.has_value())
+            MemoryRequirements new_allocation_memory_requirements = {};
+            if (resource.kind != TaskResourceKind::IMAGE)
+            {
+                new_allocation_memory_requirements = impl.info.device.buffer_memory_requirements(BufferInfo{
+                    .size = resource.info.buffer.size,
+                });
+            }
+            else
+            {
+                new_allocation_memory_requirements = impl.info.device.image_memory_requirements(ImageInfo{
+                    .flags = resource.info.image.flags,
+                    .dimensions = resource.info.image.dimensions,
+                    .format = resource.info.image.format,
+                    .size = resource.info.image.size,
+                    .mip_level_count = resource.info.image.mip_level_count,
+                    .array_layer_count = resource.info.image.array_layer_count,
+                    .sample_count = resource.info.image.sample_count,
+                    .usage = resource.info.image.usage,
+                });
+            }
+            impl.resources[r].allocation_size = new_allocation_memory_requirements.size;
+            impl.resources[r].allocation_alignment = new_allocation_memory_requirements.alignment;
+            impl.resources[r].allocation_allowed_memory_type_bits = new_allocation_memory_requirements.memory_type_bits;
+        }
+    }
+
+    // When considering a single queue, the batches imply a strong ordering between tasks and resource lifetimes.
+    // But execution ordering of batches is not guaranteed across queues within a submit!
+    // Across queues the only ordering guarantees are given by the submits.
+    // Thus, when aliasing resources used across queues, we have to use the submit lifetimes.
+    // For resource aliasing between resources used on the same queue, we can use the batch lifetimes.
+    auto resource_lifetimes_collide(ImplTaskResource const & a, ImplTaskResource const & b) -> bool
+    {
+        auto const resource_queue_access_identical = a.queue_bits == b.queue_bits;
+        auto const resources_used_across_multiple_queues = std::popcount(a.queue_bits) > 1u || std::popcount(b.queue_bits) > 1u;
+        bool const use_submit_lifetime_granularity = !resource_queue_access_identical || resources_used_across_multiple_queues;
+
+        if (use_submit_lifetime_granularity)
         {
-            DAXA_DBG_ASSERT_TRUE_M(impl.swapchain_image != nullptr, "ERROR: No swapchain image registered but a present was recorded!");
+            bool const a_is_before_b = a.final_schedule_last_submit < b.final_schedule_first_submit;
+            bool const a_is_after_b = a.final_schedule_first_submit > b.final_schedule_last_submit;
+            return !a_is_before_b && !a_is_after_b;
+        }
+        else // batch lifetime granularity
+        {
+            bool const a_is_before_b = a.final_schedule_last_batch < b.final_schedule_first_batch;
+            bool const a_is_after_b = a.final_schedule_first_batch > b.final_schedule_last_batch;
+            return !a_is_before_b && !a_is_after_b;
         }
+    }
 
-        // Validate that all attachments of each task refer to unique resources.
-        // Validate that all image attachment mips and layers are within bounds the transient image.
-        for (u32 task_i = 0; task_i < impl.tasks.size(); ++task_i)
+    auto resource_lifetime_length(ImplTaskResource const & resource) -> u32
+    {
+        return resource.final_schedule_last_batch - resource.final_schedule_first_batch + 1u;
+    }
+
+    // Places the allocations sorted by lifetime length.
+    // Each allocation is placed at the lowest offset that does not collide with any previous allocation.
+    // The placed allocations are written into out_allocations, sorted by their memory offset.
+    void place_resource_allocations_first_fit(std::span<NonExternalResourceAllocation const> sorted_allocations, std::span<NonExternalResourceAllocation> out_allocations)
+    {
+        for (u32 tr = 0; tr < sorted_allocations.size(); ++tr)
         {
-            ImplTask & task = impl.tasks.at(task_i);
-            for (u32 attach_i = 0; attach_i < task.attachments.size(); ++attach_i)
+            u32 const allocation_count = tr;
+            auto new_allocation = sorted_allocations[tr];
+            u64 const new_allocation_alignment = new_allocation.resource->allocation_alignment;
+
+            // Walk over all allocations made so far.
+            // Allocations are always sorted by their memory offset.
+            // This ensures that when we push back the offset of the new allocation on a collision,
+            // we do not have to go back to check all previous allocations we already checked,
+            // as they are guaranteedd to all the previous allocations we checked have a smaller offset + size than our current offset,
+            // so they could never collide if we bump the new allocations offset.
+            u32 last_colliding_allocation = 0u;
+            for (u32 alloc_i = 0; alloc_i < allocation_count; ++alloc_i)
             {
-                TaskAttachmentInfo const & attachment = task.attachments[attach_i];
-
-                if (attachment.type == TaskAttachmentType::IMAGE)
+                auto const & other_allocation = out_allocations[alloc_i];
+                if (resource_lifetimes_collide(*new_allocation.resource, *other_allocation.resource))
                 {
-                    u32 const resource_index = attachment.value.image.translated_view.index;
-
-                    if (resource_index != ~0u)
+                    bool const new_is_below_other = (new_allocation.offset + new_allocation.size) < other_allocation.offset;
+                    bool const new_is_above_other = new_allocation.offset > (other_allocation.offset + other_allocation.size);
+                    bool const allocation_memory_ranges_collide = !new_is_below_other && !new_is_above_other;
+                    if (allocation_memory_ranges_collide)
                     {
-                        ImplTaskResource const & resource = impl.resources[resource_index];
-                        if (resource.external == nullptr)
-                        {
-                            bool const mips_in_bounds = attachment.value.image.translated_view.slice.base_mip_level + attachment.value.image.translated_view.slice.level_count <= resource.info.image.mip_level_count;
-                            bool const layers_in_bounds = attachment.value.image.translated_view.slice.base_array_layer + attachment.value.image.translated_view.slice.layer_count <= resource.info.image.array_layer_count;
-                            DAXA_DBG_ASSERT_TRUE_M(
-                                mips_in_bounds && layers_in_bounds,
-                                std::format(
-                                    "ERROR: Attachment \"{}\" of task \"{}\" is assigned a image view for resource \"{}\" exceeding the images mips/layers!\n"
-                                    "\"{}\" mip levels: {}, array layers: {}. Attachment view mips: [{},{}], layers: [{},{}].",
-                                    attachment.value.common.name, task.name, resource.name,
-                                    resource.name, resource.info.image.mip_level_count, resource.info.image.array_layer_count,
-                                    attachment.value.image.translated_view.slice.base_mip_level, attachment.value.image.translated_view.slice.base_mip_level + attachment.value.image.translated_view.slice.level_count - 1,
-                                    attachment.value.image.translated_view.slice.base_array_layer, attachment.value.image.translated_view.slice.base_array_layer + attachment.value.image.translated_view.slice.layer_count - 1)
-                                    .c_str());
-                        }
+                        new_allocation.offset = align_up(other_allocation.offset + other_allocation.size, new_allocation_alignment);
+                        last_colliding_allocation = alloc_i;
                     }
                 }
+            }
 
-                // Validate that all attachments of each task refer to unique resources.
-                for (u32 other_i = attach_i + 1; other_i < task.attachments.size(); ++other_i)
+            // Insert the new allocation so that we keep the allocations sorted by offset.
+            // We can already skip all allocations before the last colliding allocation,
+            // as they are guaranteed to have a smaller offset than the new allocation.
+            // Search in relevant present allocations for a spot to insert the new allocation.
+            bool inserted = false;
+            for (u32 alloc_i = last_colliding_allocation; alloc_i < allocation_count; ++alloc_i)
+            {
+                bool const insert = new_allocation.offset < out_allocations[alloc_i].offset;
+                if (insert)
                 {
-                    TaskAttachmentInfo const & other_attachment = task.attachments[other_i];
-
-                    if (attachment.type == other_attachment.type)
+                    // Insert new allocation at alloc_i
+                    // Move back all other allocations at and after alloc_i
+                    // last_new_allocation_index is correct, as we are adding a new element here.
+                    u32 const last_new_allocation_index = allocation_count;
+                    for (u32 i = last_new_allocation_index; i >= (alloc_i + 1); --i)
                     {
-                        u32 resource_index = {};
-                        u32 other_resource_index = {};
-                        char const * attachment_name = {};
-                        char const * other_attachment_name = {};
-                        if (attachment.type != TaskAttachmentType::IMAGE)
-                        {
-                            // buffer, blas, tlas attach infos are identical memory layout :)
-                            resource_index = attachment.value.buffer.translated_view.index;
-                            other_resource_index = other_attachment.value.buffer.translated_view.index;
-                            attachment_name = attachment.value.buffer.name;
-                            other_attachment_name = other_attachment.value.buffer.name;
-                        }
-                        else
-                        {
-                            resource_index = attachment.value.image.translated_view.index;
-                            other_resource_index = other_attachment.value.image.translated_view.index;
-                            attachment_name = attachment.value.image.name;
-                            other_attachment_name = other_attachment.value.image.name;
-                        }
-
-                        bool const either_resource_null = resource_index == ~0u || other_resource_index == ~0u;
-                        DAXA_DBG_ASSERT_TRUE_M(
-                            resource_index != other_resource_index || either_resource_null,
-                            std::format(
-                                "ERROR: All attachments must have different task resources assigned to them! "
-                                "Detected error in task \"{}\" (index: {}), attachment \"{}\" (index: {}) and attachment \"{}\" (index: {}) refer to the same resource \"{}\" (index: {}).",
-                                task.name, task_i, attachment_name, attach_i, other_attachment_name, other_i, impl.resources[resource_index].name, resource_index)
-                                .c_str());
+                        out_allocations[i] = out_allocations[i - 1];
                     }
+                    out_allocations[alloc_i] = new_allocation;
+                    inserted = true;
+                    break;
                 }
             }
+            if (!inserted)
+            {
+                // append to end
+                out_allocations[allocation_count] = new_allocation;
+            }
+
+            // SANITY CHECK, CAN BE REMOVED
+            for (u32 a = 1; a < allocation_count + 1; ++a)
+            {
+                DAXA_DBG_ASSERT_TRUE_M(out_allocations[a - 1].offset <= out_allocations[a].offset, "IMPOSSIBLE CASE!");
+            }
         }
+    }
 
-        /// =========================================
-        /// ==== BUILD RESOURCE ACCESS TIMELINES ====
-        /// =========================================
+    // Places the allocations sorted by size, largest first.
+    // For each allocation, only the previous allocations with colliding lifetimes are considered.
+    // Sorted by offset, they leave gaps in memory. The allocation is placed into the smallest gap it fits in.
+    // When no gap fits, the allocation is placed above all colliding allocations.
+    // Large allocations tend to claim the bottom of the heap while small short lived allocations fill the holes between them.
+    // Placed allocations are kept sorted by offset, so each placement is a single walk over them and an insertion, O(n) instead of a sort per placement.
+    void place_resource_allocations_best_fit(std::span<NonExternalResourceAllocation> allocations, MemoryArena & tmp_memory)
+    {
+        auto placed_allocations = tmp_memory.allocate_trivial_span<NonExternalResourceAllocation const *>(allocations.size());
+        for (u32 tr = 0; tr < allocations.size(); ++tr)
+        {
+            NonExternalResourceAllocation & new_allocation = allocations[tr];
+            u64 const new_allocation_alignment = new_allocation.resource->allocation_alignment;
 
-        struct TmpAccessGroup
+            u64 best_offset = ~0ull;
+            u64 best_gap_size = ~0ull;
+            u64 gap_begin = 0u;
+            for (u32 alloc_i = 0; alloc_i < tr; ++alloc_i)
+            {
+                NonExternalResourceAllocation const & other_allocation = *placed_allocations[alloc_i];
+                if (!resource_lifetimes_collide(*new_allocation.resource, *other_allocation.resource))
+                {
+                    continue;
+                }
+                u64 const candidate_offset = align_up(gap_begin, new_allocation_alignment);
+                bool const fits_into_gap = other_allocation.offset >= gap_begin && candidate_offset + new_allocation.size <= other_allocation.offset;
+                if (fits_into_gap && (other_allocation.offset - gap_begin) < best_gap_size)
+                {
+                    best_gap_size = other_allocation.offset - gap_begin;
+                    best_offset = candidate_offset;
+                }
+                gap_begin = std::max(gap_begin, other_allocation.offset + other_allocation.size);
+            }
+            if (best_offset == ~0ull)
+            {
+                best_offset = align_up(gap_begin, new_allocation_alignment);
+            }
+            new_allocation.offset = best_offset;
+
+            auto const placed_end = placed_allocations.begin() + tr;
+            auto const insert_at = std::upper_bound(placed_allocations.begin(), placed_end, best_offset, [](u64 offset, NonExternalResourceAllocation const * allocation)
+                                                    { return offset < allocation->offset; });
+            std::copy_backward(insert_at, placed_end, placed_end + 1);
+            *insert_at = &new_allocation;
+        }
+    }
+
+    // Places all non external resources within a single resource heap.
+    // Requires the resource batch lifetimes and allocation sizes to be determined.
+    // Without aliasing, all allocations are placed next to each other.
+    auto determine_resource_allocations(ImplTaskGraph & impl, MemoryArena & tmp_memory, bool alias, TaskResourceAliasingStrategy strategy) -> NonExternalResourceAllocations
+    {
+        auto non_external_resource_allocations = tmp_memory.allocate_trivial_span<NonExternalResourceAllocation>(impl.resources.size());
+        auto non_external_resources_count = 0u;
+        for (u32 r = 0; r < impl.resources.size(); ++r)
         {
-            TaskStages stages = {};
-            TaskAccessType type = {};
-            u32 queue_bits = {};
-            ArenaDynamicArray8k<TaskAttachmentAccess> tasks = {};
+            ImplTaskResource & resource = impl.resources[r];
+            if (resource.external == nullptr)
+            {
+                u32 const size_factor = resource.lifetime_type == TaskResourceLifetimeType::PERSISTENT_DOUBLE_BUFFER ? 2u : 1u;
+                non_external_resource_allocations[non_external_resources_count++] = NonExternalResourceAllocation{
+                    .resource = &resource,
+                    .resource_index = r,
+                    .offset = 0u,
+                    .size = resource.allocation_size * size_factor,
+                };
+            }
+        }
+        non_external_resource_allocations = std::span{non_external_resource_allocations.data(), static_cast<usize>(non_external_resources_count)};
+
+        auto const sort_by_lifetime = [](NonExternalResourceAllocation const & a0, NonExternalResourceAllocation const & a1)
+        {
+            return resource_lifetime_length(*a0.resource) > resource_lifetime_length(*a1.resource);
+        };
+        auto const sort_by_size = [](NonExternalResourceAllocation const & a0, NonExternalResourceAllocation const & a1)
+        {
+            if (a0.size != a1.size)
+            {
+                return a0.size > a1.size;
+            }
+            return resource_lifetime_length(*a0.resource) > resource_lifetime_length(*a1.resource);
         };
-        auto tmp_resource_access_timelines = tmp_memory.allocate_trivial_span_fill<ArenaDynamicArray8k<TmpAccessGroup>>(impl.resources.size(), ArenaDynamicArray8k<TmpAccessGroup>(&tmp_memory));
-        auto tmp_resource_latest_submit_access = tmp_memory.allocate_trivial_span_fill(impl.resources.size(), 0u);
 
-        // Build access timelines in tmp allocations
-        for (u32 task_i = 0; task_i < impl.tasks.size(); ++task_i)
+        if (!alias)
         {
-            ImplTask & task = impl.tasks.at(task_i);
-            for (u32 attach_i = 0; attach_i < task.attachments.size(); ++attach_i)
+            std::sort(non_external_resource_allocations.begin(), non_external_resource_allocations.end(), sort_by_lifetime);
+            u64 offset = 0u;
+            for (auto & allocation : non_external_resource_allocations)
             {
-                TaskAttachmentInfo const & attachment = task.attachments[attach_i];
+                allocation.offset = align_up(offset, allocation.resource->allocation_alignment);
+                offset = allocation.offset + allocation.size;
+            }
+        }
+        else if (strategy == TaskResourceAliasingStrategy::FIRST_FIT)
+        {
+            auto sorted_allocations = tmp_memory.allocate_trivial_span<NonExternalResourceAllocation>(non_external_resources_count);
+            std::copy(non_external_resource_allocations.begin(), non_external_resource_allocations.end(), sorted_allocations.begin());
+            std::sort(sorted_allocations.begin(), sorted_allocations.end(), sort_by_lifetime);
+            place_resource_allocations_first_fit(sorted_allocations, non_external_resource_allocations);
+        }
+        else
+        {
+            std::sort(non_external_resource_allocations.begin(), non_external_resource_allocations.end(), sort_by_size);
+            place_resource_allocations_best_fit(non_external_resource_allocations, tmp_memory);
+        }
 
-                task.attachment_access_groups[attach_i] = {nullptr, ~0u}; // Zero init attachment_access_groups. Only non-null attachments are assigned access groups later.
-                task.attachment_resources[attach_i] = {nullptr, ~0u};
+        // Calculate transient heap size.
+        u64 resource_heap_size = {};
+        u64 resource_heap_alignment = {};
+        auto resource_heap_memory_bits = ~0u;
+        for (auto const & allocation : non_external_resource_allocations)
+        {
+            resource_heap_size = std::max(resource_heap_size, allocation.offset + allocation.size);
+            resource_heap_alignment = std::max(resource_heap_alignment, allocation.resource->allocation_alignment);
+            resource_heap_memory_bits &= allocation.resource->allocation_allowed_memory_type_bits;
+        }
 
-                TaskAccessType access_type = {};
-                ArenaDynamicArray8k<TmpAccessGroup> * access_timeline = nullptr;
-                u32 * latest_access_submit_index = nullptr;
-                TaskStages attachment_stages = {};
-                ImplTaskResource * resource = nullptr;
-                u32 resource_index = ~0u;
-                if (attachment.type != TaskAttachmentType::IMAGE)
+        // SANITY CHECK, CAN BE REMOVED
+        for (u32 a = 0; a < non_external_resources_count; ++a)
+        {
+            for (u32 b = 0; b < non_external_resources_count; ++b)
+            {
+                if (a == b)
                 {
-                    // buffer, blas, tlas attach infos are identical memory layout :)
-                    access_type = attachment.value.buffer.task_access.type;
-                    if (!attachment.value.buffer.translated_view.is_null())
-                    {
-                        resource_index = attachment.value.buffer.translated_view.index;
-                        access_timeline = &tmp_resource_access_timelines[resource_index];
-                        latest_access_submit_index = &tmp_resource_latest_submit_access[resource_index];
-                        attachment_stages = attachment.value.buffer.task_access.stage;
+                    continue;
+                }
+
+                NonExternalResourceAllocation & allocation_a = non_external_resource_allocations[a];
+                NonExternalResourceAllocation & allocation_b = non_external_resource_allocations[b];
+
+                bool const lifetime_exclusive = !resource_lifetimes_collide(*allocation_a.resource, *allocation_b.resource);
+                bool const memory_exclusive = allocation_a.offset >= (allocation_b.offset + allocation_b.size) || (allocation_a.offset + allocation_a.size) <= allocation_b.offset;
+                bool const exclusive = lifetime_exclusive || memory_exclusive;
+                DAXA_DBG_ASSERT_TRUE_M(exclusive, "IMPOSSIBLE CASE!");
+            }
+        }
+
+        return NonExternalResourceAllocations{
+            .allocations = non_external_resource_allocations,
+            .heap_size = resource_heap_size,
+            .heap_alignment = resource_heap_alignment,
+            .heap_memory_type_bits = resource_heap_memory_bits,
+        };
+    }
+
+    auto determine_resource_allocations(ImplTaskGraph & impl, MemoryArena & tmp_memory) -> NonExternalResourceAllocations
+    {
+        return determine_resource_allocations(impl, tmp_memory, impl.info.alias_transients, impl.info.aliasing_strategy);
+    }
+
+    // Re-runs the resource allocation with every aliasing strategy to report their heap sizes.
+    void update_resource_memory_report(ImplTaskGraph & impl, NonExternalResourceAllocations const & allocations, MemoryArena & tmp_memory)
+    {
+        impl.memory_report = {};
+        impl.memory_report.aliasing_enabled = impl.info.alias_transients;
+        impl.memory_report.aliasing_strategy = impl.info.aliasing_strategy;
+        impl.memory_report.resource_memory_block_size = allocations.heap_size;
+        impl.memory_report.non_aliased_size = determine_resource_allocations(impl, tmp_memory, false, {}).heap_size;
+        for (u32 s = 0; s < static_cast<u32>(TaskResourceAliasingStrategy::MAX_ENUM); ++s)
+        {
+            auto const strategy = static_cast<TaskResourceAliasingStrategy>(s);
+            impl.memory_report.aliasing_strategy_sizes[s] = determine_resource_allocations(impl, tmp_memory, true, strategy).heap_size;
+        }
+    }
+
+    // Creates the resource for the allocation within the resource memory block.
+    void create_non_external_resource(ImplTaskGraph & impl, NonExternalResourceAllocation & allocation)
+    {
+        allocation.resource->allocation_offset = allocation.offset;
+        allocation.resource->allocation_size = allocation.size;
+
+        switch (allocation.resource->kind)
+        {
+        case TaskResourceKind::BUFFER:
+        {
+            auto info = BufferInfo{
+                .size = allocation.resource->info.buffer.size,
+                .name = allocation.resource->name,
+            };
+            allocation.resource->id.buffer = impl.info.device.create_buffer_from_memory_block(MemoryBlockBufferInfo{
+                .buffer_info = info,
+                .memory_block = impl.resource_memory_block,
+                .offset = allocation.offset,
+            });
+        }
+        break;
+        case TaskResourceKind::TLAS:
+        {
+            auto info = TlasInfo{
+                .size = allocation.resource->info.buffer.size,
+                .name = allocation.resource->name,
+            };
+            allocation.resource->id.tlas = impl.info.device.create_tlas_from_memory_block(MemoryBlockTlasInfo{
+                .tlas_info = info,
+                .memory_block = impl.resource_memory_block,
+                .offset = allocation.offset,
+            });
+        }
+        break;
+        case TaskResourceKind::BLAS:
+            DAXA_DBG_ASSERT_TRUE_M(false, "IMPOSSIBLE CASE! THERE IS NO SUPPORT FOR GRAPH OWNED TASK BLAS!");
+            break;
+        case TaskResourceKind::IMAGE:
+        {
+            auto info = ImageInfo{
+                .flags = allocation.resource->info.image.flags,
+                .dimensions = allocation.resource->info.image.dimensions,
+                .format = allocation.resource->info.image.format,
+                .size = allocation.resource->info.image.size,
+                .mip_level_count = allocation.resource->info.image.mip_level_count,
+                .array_layer_count = allocation.resource->info.image.array_layer_count,
+                .sample_count = allocation.resource->info.image.sample_count,
+                .usage = allocation.resource->info.image.usage | impl.info.additional_image_usage_flags,
+                .name = allocation.resource->name,
+            };
+            allocation.resource->id.image = impl.info.device.create_image_from_memory_block(MemoryBlockImageInfo{
+                .image_info = info,
+                .memory_block = impl.resource_memory_block,
+                .offset = allocation.offset,
+            });
+        }
+        break;
+        }
+    }
+
+    // Determines which earlier submits each queue of each submit has to wait on.
+    // A submit queue depends on an earlier submit queue when:
+    // * one of its accesses directly follows an access of the earlier submit queue in a resources access timeline
+    // * one of its resources is aliased in memory with a resource that was last accessed in the earlier submit queue
+    // Only the latest dependency per queue is stored, waiting on it implies waiting on all earlier submits of that queue.
+    // Requires the resource allocations to be created.
+    void determine_submit_queue_dependencies(ImplTaskGraph & impl)
+    {
+        for (u32 s = 0; s < impl.submits.size(); ++s)
+        {
+            for (u32 q = 0; q < DAXA_QUEUE_COUNT; ++q)
+            {
+                impl.submits[s].queue_wait_submits[q].fill(~0u);
+            }
+        }
+
+        auto add_access_group_dependencies = [&](AccessGroup const & dst_access_group, AccessGroup const & src_access_group)
+        {
+            for (u32 dst_t = 0; dst_t < dst_access_group.tasks.size(); ++dst_t)
+            {
+                ImplTask const & dst_task = *dst_access_group.tasks[dst_t].task;
+                for (u32 src_t = 0; src_t < src_access_group.tasks.size(); ++src_t)
+                {
+                    ImplTask const & src_task = *src_access_group.tasks[src_t].task;
+                    // Accesses within the same submit are synchronized with barriers.
+                    if (src_task.submit_index >= dst_task.submit_index)
+                    {
+                        continue;
+                    }
+                    u32 & wait_submit = impl.submits[dst_task.submit_index].queue_wait_submits[queue_to_queue_index(dst_task.queue)][queue_to_queue_index(src_task.queue)];
+                    wait_submit = wait_submit == ~0u ? src_task.submit_index : std::max(wait_submit, src_task.submit_index);
+                }
+            }
+        };
+
+        for (u32 r = 0; r < impl.resources.size(); ++r)
+        {
+            ImplTaskResource const & resource = impl.resources[r];
+            for (u32 ag = 1u; ag < resource.access_timeline.size(); ++ag)
+            {
+                add_access_group_dependencies(resource.access_timeline[ag], resource.access_timeline[ag - 1]);
+            }
+        }
+
+        // Resources aliased in memory never have colliding lifetimes, so one is always accessed entirely before the other.
+        for (u32 r0 = 0; r0 < impl.resources.size(); ++r0)
+        {
+            ImplTaskResource const & resource0 = impl.resources[r0];
+            if (resource0.external != nullptr || resource0.access_timeline.size() == 0)
+            {
+                continue;
+            }
+            for (u32 r1 = 0; r1 < impl.resources.size(); ++r1)
+            {
+                ImplTaskResource const & resource1 = impl.resources[r1];
+                if (r0 == r1 || resource1.external != nullptr || resource1.access_timeline.size() == 0)
+                {
+                    continue;
+                }
+
+                bool const memory_exclusive =
+                    resource0.allocation_offset >= (resource1.allocation_offset + resource1.allocation_size) ||
+                    (resource0.allocation_offset + resource0.allocation_size) <= resource1.allocation_offset;
+                bool const resource0_before_resource1 = resource0.final_schedule_last_batch < resource1.final_schedule_first_batch;
+                if (!memory_exclusive && resource0_before_resource1)
+                {
+                    add_access_group_dependencies(resource1.access_timeline[0], resource0.access_timeline.back());
+                }
+            }
+        }
+    }
+
+    void destroy_non_external_resource_id(Device & device, TaskResourceKind kind, ImplTaskResource::IdUnion const & id)
+    {
+        switch (kind)
+        {
+        case TaskResourceKind::BUFFER: device.destroy_buffer(id.buffer); break;
+        case TaskResourceKind::TLAS: device.destroy_tlas(id.tlas); break;
+        case TaskResourceKind::BLAS: DAXA_DBG_ASSERT_TRUE_M(false, "IMPOSSIBLE CASE! THERE IS NO SUPPORT FOR GRAPH OWNED TASK BLAS!"); break;
+        case TaskResourceKind::IMAGE: device.destroy_image(id.image); break;
+        }
+    }
+
+    // Persistent buffers and images that are moved without being resized keep their contents.
+    auto resource_preserves_contents_on_relocation(ImplTaskResource const & resource) -> bool
+    {
+        return resource.lifetime_type != TaskResourceLifetimeType::TRANSIENT &&
+               !resource.resized &&
+               (resource.kind == TaskResourceKind::BUFFER || resource.kind == TaskResourceKind::IMAGE) &&
+               resource.access_timeline.size() > 0;
+    }
+
+    // Applies resource resizes to an already completed graph.
+    // Resource sizes do not influence the schedule, the barriers or the layout of attachment shader blobs.
+    // So only the resource allocation and creation is re-run.
+    // The resource memory block is kept when the new allocations fit into it.
+    // Only resources that were resized or moved within the memory block are re-created and all attachments referencing them are patched.
+    // Resized persistent resources are cleared, moved persistent resources are copied from their old resource in the next execution.
+    void complete_resource_resizes(ImplTaskGraph & impl)
+    {
+        MemoryArena tmp_memory = MemoryArena{"TaskGraph::complete resource resizes tmp memory", 1u << 16u};
+
+        determine_resource_allocation_sizes(impl);
+        auto const resource_allocations = determine_resource_allocations(impl, tmp_memory);
+        update_resource_memory_report(impl, resource_allocations, tmp_memory);
+
+        bool keep_memory_block = false;
+        if (impl.resource_memory_block.is_valid())
+        {
+            MemoryRequirements const & current_requirements = impl.resource_memory_block.info().requirements;
+            keep_memory_block =
+                current_requirements.size >= resource_allocations.heap_size &&
+                current_requirements.alignment >= resource_allocations.heap_alignment &&
+                (current_requirements.memory_type_bits & ~resource_allocations.heap_memory_type_bits) == 0u;
+        }
+        // Moving a persistent resource within the current memory block could overwrite other old resources before their contents are copied.
+        // Their old memory must stay intact until the next execution, so the moved resources are placed in a new memory block instead.
+        for (u32 alloc_i = 0; alloc_i < resource_allocations.allocations.size() && keep_memory_block; ++alloc_i)
+        {
+            NonExternalResourceAllocation const & allocation = resource_allocations.allocations[alloc_i];
+            keep_memory_block = !resource_preserves_contents_on_relocation(*allocation.resource) || allocation.offset == allocation.resource->allocation_offset;
+        }
+        if (!keep_memory_block && resource_allocations.heap_size > 0)
+        {
+            // Resources created from the previous memory block keep it alive until they are destroyed.
+            impl.resource_memory_block = impl.info.device.create_memory({
+                .requirements = {
+                    .size = resource_allocations.heap_size,
+                    .alignment = resource_allocations.heap_alignment,
+                    .memory_type_bits = resource_allocations.heap_memory_type_bits,
+                },
+                .flags = {},
+            });
+        }
+
+        for (u32 r = 0; r < impl.resources.size(); ++r)
+        {
+            ImplTaskResource & resource = impl.resources[r];
+            if (resource.external != nullptr)
+            {
+                continue;
+            }
+
+            NonExternalResourceAllocation * allocation = nullptr;
+            for (u32 alloc_i = 0; alloc_i < resource_allocations.allocations.size(); ++alloc_i)
+            {
+                if (resource_allocations.allocations[alloc_i].resource == &resource)
+                {
+                    allocation = &resource_allocations.allocations[alloc_i];
+                    break;
+                }
+            }
+            DAXA_DBG_ASSERT_TRUE_M(allocation != nullptr, "IMPOSSIBLE CASE! ALL NON EXTERNAL RESOURCES MUST HAVE AN ALLOCATION!");
+
+            bool const recreate = !keep_memory_block || resource.resized || allocation->offset != resource.allocation_offset;
+            if (!recreate)
+            {
+                resource.allocation_size = allocation->size;
+                continue;
+            }
+
+            bool const preserve_contents = resource_preserves_contents_on_relocation(resource);
+
+            // Patching requires the resource to be marked as resized.
+            resource.resized = true;
+            ImplTaskResource::IdUnion const old_id = resource.id;
+            create_non_external_resource(impl, *allocation);
+
+            for (u32 access_group_i = 0; access_group_i < resource.access_timeline.size(); ++access_group_i)
+            {
+                AccessGroup const & access_group = resource.access_timeline[access_group_i];
+                for (u32 t = 0; t < access_group.tasks.size(); ++t)
+                {
+                    TaskAttachmentAccess const & task_attachment_access = access_group.tasks[t];
+                    patch_attachment_id(impl, *task_attachment_access.task, task_attachment_access.attachment_index, resource);
+                    if (resource.kind == TaskResourceKind::IMAGE)
+                    {
+                        patch_attachment_image_views(impl, *task_attachment_access.task, task_attachment_access.attachment_index, resource);
+                    }
+                    patch_attachment_shader_blob(impl, *task_attachment_access.task, task_attachment_access.attachment_index, resource);
+                }
+            }
+
+            // A resource moved twice before an execution is still copied from its first resource, the intermediate one was never written.
+            if (preserve_contents && resource.relocated_from.buffer.is_empty())
+            {
+                resource.relocated_from = old_id;
+            }
+            else
+            {
+                destroy_non_external_resource_id(impl.info.device, resource.kind, old_id);
+            }
+            if (!preserve_contents && !resource.relocated_from.buffer.is_empty())
+            {
+                destroy_non_external_resource_id(impl.info.device, resource.kind, resource.relocated_from);
+                resource.relocated_from = {.buffer = {}};
+            }
+
+            // Re-created persistent resources must be re-initialized, either by a clear or by a copy from the old resource.
+            if (resource.lifetime_type != TaskResourceLifetimeType::TRANSIENT && resource.access_timeline.size() > 0)
+            {
+                add_resource_clear_request(impl, resource, r);
+            }
+            resource.resized = false;
+        }
+
+        // Moved resources can alias with different resources.
+        determine_submit_queue_dependencies(impl);
+
+        // Recordings reference the previous resources.
+        impl.recording_cache.clear();
+        impl.pending_resource_resizes = false;
+    }
+
+    void TaskGraph::complete(TaskCompleteInfo const & /*unused*/)
+    {
+        ImplTaskGraph & impl = *r_cast<ImplTaskGraph *>(this->object);
+
+        if (impl.compiled)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(impl.pending_resource_resizes, "ERROR: TaskGraph was already completed! Completed graphs can only be completed again after resizing resources.");
+            complete_resource_resizes(impl);
+            return;
+        }
+
+        u32 required_tmp_size = 1u << 23u; /* 8MB */
+        MemoryArena tmp_memory = MemoryArena{"TaskGraph::complete tmp memory", required_tmp_size};
+
+        /// ================================
+        /// ==== EARLY INPUT VALIDATION ====
+        /// ================================
+
+        DAXA_DBG_ASSERT_TRUE_M(impl.submits.size() > 0, "ERROR: All task graphs must have at least one submission!");
+        DAXA_DBG_ASSERT_TRUE_M(!impl.compiled, "ERROR: TaskGraph was already completed!");
+        if (impl.present.has_value())
+        {
+            DAXA_DBG_ASSERT_TRUE_M(impl.swapchain_image != nullptr, "ERROR: No swapchain image registered but a present was recorded!");
+        }
+
+        // Validate that all attachments of each task refer to unique resources.
+        // Validate that all image attachment mips and layers are within bounds the transient image.
+        for (u32 task_i = 0; task_i < impl.tasks.size(); ++task_i)
+        {
+            ImplTask & task = impl.tasks.at(task_i);
+            for (u32 attach_i = 0; attach_i < task.attachments.size(); ++attach_i)
+            {
+                TaskAttachmentInfo const & attachment = task.attachments[attach_i];
+
+                if (attachment.type == TaskAttachmentType::IMAGE)
+                {
+                    u32 const resource_index = attachment.value.image.translated_view.index;
+
+                    if (resource_index != ~0u)
+                    {
+                        ImplTaskResource const & resource = impl.resources[resource_index];
+                        if (resource.external == nullptr)
+                        {
+                            bool const mips_in_bounds = attachment.value.image.translated_view.slice.base_mip_level + attachment.value.image.translated_view.slice.level_count <= resource.info.image.mip_level_count;
+                            bool const layers_in_bounds = attachment.value.image.translated_view.slice.base_array_layer + attachment.value.image.translated_view.slice.layer_count <= resource.info.image.array_layer_count;
+                            DAXA_DBG_ASSERT_TRUE_M(
+                                mips_in_bounds && layers_in_bounds,
+                                std::format(
+                                    "ERROR: Attachment \"{}\" of task \"{}\" is assigned a image view for resource \"{}\" exceeding the images mips/layers!\n"
+                                    "\"{}\" mip levels: {}, array layers: {}. Attachment view mips: [{},{}], layers: [{},{}].",
+                                    attachment.value.common.name, task.name, resource.name,
+                                    resource.name, resource.info.image.mip_level_count, resource.info.image.array_layer_count,
+                                    attachment.value.image.translated_view.slice.base_mip_level, attachment.value.image.translated_view.slice.base_mip_level + attachment.value.image.translated_view.slice.level_count - 1,
+                                    attachment.value.image.translated_view.slice.base_array_layer, attachment.value.image.translated_view.slice.base_array_layer + attachment.value.image.translated_view.slice.layer_count - 1)
+                                    .c_str());
+                        }
+                    }
+                }
+
+                // Validate that all attachments of each task refer to unique resources.
+                for (u32 other_i = attach_i + 1; other_i < task.attachments.size(); ++other_i)
+                {
+                    TaskAttachmentInfo const & other_attachment = task.attachments[other_i];
+
+                    if (attachment.type == other_attachment.type)
+                    {
+                        u32 resource_index = {};
+                        u32 other_resource_index = {};
+                        char const * attachment_name = {};
+                        char const * other_attachment_name = {};
+                        if (attachment.type != TaskAttachmentType::IMAGE)
+                        {
+                            // buffer, blas, tlas attach infos are identical memory layout :)
+                            resource_index = attachment.value.buffer.translated_view.index;
+                            other_resource_index = other_attachment.value.buffer.translated_view.index;
+                            attachment_name = attachment.value.buffer.name;
+                            other_attachment_name = other_attachment.value.buffer.name;
+                        }
+                        else
+                        {
+                            resource_index = attachment.value.image.translated_view.index;
+                            other_resource_index = other_attachment.value.image.translated_view.index;
+                            attachment_name = attachment.value.image.name;
+                            other_attachment_name = other_attachment.value.image.name;
+                        }
+
+                        bool const either_resource_null = resource_index == ~0u || other_resource_index == ~0u;
+                        DAXA_DBG_ASSERT_TRUE_M(
+                            resource_index != other_resource_index || either_resource_null,
+                            std::format(
+                                "ERROR: All attachments must have different task resources assigned to them! "
+                                "Detected error in task \"{}\" (index: {}), attachment \"{}\" (index: {}) and attachment \"{}\" (index: {}) refer to the same resource \"{}\" (index: {}).",
+                                task.name, task_i, attachment_name, attach_i, other_attachment_name, other_i, impl.resources[resource_index].name, resource_index)
+                                .c_str());
+                    }
+                }
+            }
+        }
+
+        /// =========================================
+        /// ==== BUILD RESOURCE ACCESS TIMELINES ====
+        /// =========================================
+
+        struct TmpAccessGroup
+        {
+            TaskStages stages = {};
+            TaskAccessType type = {};
+            u32 queue_bits = {};
+            ArenaDynamicArray8k<TaskAttachmentAccess> tasks = {};
+        };
+        auto tmp_resource_access_timelines = tmp_memory.allocate_trivial_span_fill<ArenaDynamicArray8k<TmpAccessGroup>>(impl.resources.size(), ArenaDynamicArray8k<TmpAccessGroup>(&tmp_memory));
+        auto tmp_resource_latest_submit_access = tmp_memory.allocate_trivial_span_fill(impl.resources.size(), 0u);
+
+        // Build access timelines in tmp allocations
+        for (u32 task_i = 0; task_i < impl.tasks.size(); ++task_i)
+        {
+            ImplTask & task = impl.tasks.at(task_i);
+            for (u32 attach_i = 0; attach_i < task.attachments.size(); ++attach_i)
+            {
+                TaskAttachmentInfo const & attachment = task.attachments[attach_i];
+
+                task.attachment_access_groups[attach_i] = {nullptr, ~0u}; // Zero init attachment_access_groups. Only non-null attachments are assigned access groups later.
+                task.attachment_resources[attach_i] = {nullptr, ~0u};
+
+                TaskAccessType access_type = {};
+                ArenaDynamicArray8k<TmpAccessGroup> * access_timeline = nullptr;
+                u32 * latest_access_submit_index = nullptr;
+                TaskStages attachment_stages = {};
+                ImplTaskResource * resource = nullptr;
+                u32 resource_index = ~0u;
+                if (attachment.type != TaskAttachmentType::IMAGE)
+                {
+                    // buffer, blas, tlas attach infos are identical memory layout :)
+                    access_type = attachment.value.buffer.task_access.type;
+                    if (!attachment.value.buffer.translated_view.is_null())
+                    {
+                        resource_index = attachment.value.buffer.translated_view.index;
+                        access_timeline = &tmp_resource_access_timelines[resource_index];
+                        latest_access_submit_index = &tmp_resource_latest_submit_access[resource_index];
+                        attachment_stages = attachment.value.buffer.task_access.stage;
                         resource = &impl.resources[resource_index];
                     }
                 }
@@ -2463,38 +3118,7 @@ namespace daxa
 
         // We need the memory allocation requirements for optimizing the task shedule heuristically.
 
-        for (u32 r = 0; r < impl.resources.size(); ++r)
-        {
-            ImplTaskResource & resource = impl.resources[r];
-            if (resource.external)
-            {
-                continue;
-            }
-
-            MemoryRequirements new_allocation_memory_requirements = {};
-            if (resource.kind != TaskResourceKind::IMAGE)
-            {
-                new_allocation_memory_requirements = impl.info.device.buffer_memory_requirements(BufferInfo{
-                    .size = resource.info.buffer.size,
-                });
-            }
-            else
-            {
-                new_allocation_memory_requirements = impl.info.device.image_memory_requirements(ImageInfo{
-                    .flags = resource.info.image.flags,
-                    .dimensions = resource.info.image.dimensions,
-                    .format = resource.info.image.format,
-                    .size = resource.info.image.size,
-                    .mip_level_count = resource.info.image.mip_level_count,
-                    .array_layer_count = resource.info.image.array_layer_count,
-                    .sample_count = resource.info.image.sample_count,
-                    .usage = resource.info.image.usage,
-                });
-            }
-            impl.resources[r].allocation_size = new_allocation_memory_requirements.size;
-            impl.resources[r].allocation_alignment = new_allocation_memory_requirements.alignment;
-            impl.resources[r].allocation_allowed_memory_type_bits = new_allocation_memory_requirements.memory_type_bits;
-        }
+        determine_resource_allocation_sizes(impl);
 
         /// ===============================
         /// ==== COMPACT TASKS FORWARD ====
@@ -2726,210 +3350,34 @@ namespace daxa
         /// ==== DETERMINE RESOURCE ALLOCATIONS ====
         /// ========================================
 
-        // By detault, TaskGraph will attempt to alias as many transient resource allocations as possible.
+        // When aliasing is enabled, TaskGraph will attempt to alias as many transient resource allocations as possible.
         // To find possible aliasing opportunities, for each transient resourcce,
         // it scans all existing allocations, placing the new allocation into a memory hole left by other allocations that are already past their lifetime.
-        // When finding memory locations for allocations like this, a strong heuristic is to sort all resources by lifetime before starting to allocate.
-        // This way, all allocations with longer lifetimes will be done early and short lives allocations will be made later.
-        // This works out good in most cases as the short lived allocations will then "sit on top" of many long lived allocations, leaving larger holes for aliasing overlapping.
-
-        // Filter and sort transient resources by lifetime
-        auto non_external_resources_sorted_by_lifetime = tmp_memory.allocate_trivial_span<ImplTaskResource *>(impl.resources.size());
-        auto non_external_resources_count = 0u;
+        // The order in which resources are placed and the choice of the hole are determined by the TaskResourceAliasingStrategy:
+        // * FIRST_FIT sorts by lifetime, so short lived allocations "sit on top" of many long lived allocations, and takes the lowest hole.
+        // * BEST_FIT sorts by size, so large allocations claim the bottom of the heap, and takes the smallest hole that fits.
+        // The heap sizes of all strategies are recorded in the memory report to make them comparable for a given graph.
+
+        auto const resource_allocations = determine_resource_allocations(impl, tmp_memory);
+        update_resource_memory_report(impl, resource_allocations, tmp_memory);
+        auto const non_external_resources_count = static_cast<u32>(resource_allocations.allocations.size());
         auto primary_double_buffer_resources = 0u;
         for (u32 r = 0; r < impl.resources.size(); ++r)
         {
-            ImplTaskResource & resource = impl.resources[r];
-            if (resource.external == nullptr)
-            {
-                non_external_resources_sorted_by_lifetime[non_external_resources_count++] = &resource;
-            }
-            if (resource.lifetime_type == TaskResourceLifetimeType::PERSISTENT_DOUBLE_BUFFER && resource.double_buffer_index == 0)
+            if (impl.resources[r].lifetime_type == TaskResourceLifetimeType::PERSISTENT_DOUBLE_BUFFER && impl.resources[r].double_buffer_index == 0)
             {
                 primary_double_buffer_resources += 1u;
             }
         }
-        non_external_resources_sorted_by_lifetime = std::span{non_external_resources_sorted_by_lifetime.data(), static_cast<usize>(non_external_resources_count)};
-        std::sort(non_external_resources_sorted_by_lifetime.begin(), non_external_resources_sorted_by_lifetime.end(), [&](ImplTaskResource const * r0, ImplTaskResource const * r1)
-                  {
-            u32 const r0_lifetime = r0->final_schedule_last_batch - r0->final_schedule_first_batch + 1u;
-            u32 const r1_lifetime = r1->final_schedule_last_batch - r1->final_schedule_first_batch + 1u;
-            return r0_lifetime > r1_lifetime; });
-
-        // Calculate transient heap size and allocation offsets.
-        u64 resource_heap_size = {};
-        u64 resource_heap_alignment = {};
-        auto resource_heap_memory_bits = ~0u;
-        struct NonExternalResourceAllocation
-        {
-            ImplTaskResource * resource = {};
-            u32 resource_index = {};
-            u64 offset = {};
-            u64 size = {};
-        };
-        auto non_external_resource_allocations = tmp_memory.allocate_trivial_span<NonExternalResourceAllocation>(non_external_resources_count);
-        for (u32 tr = 0; tr < non_external_resources_count; ++tr)
-        {
-            u32 const allocation_count = tr;
-            ImplTaskResource & resource = *non_external_resources_sorted_by_lifetime[tr];
-            MemoryRequirements new_allocation_memory_requirements = {
-                .size = resource.allocation_size,
-                .alignment = resource.allocation_alignment,
-                .memory_type_bits = resource.allocation_allowed_memory_type_bits,
-            };
-
-            u32 const size_factor = resource.lifetime_type == TaskResourceLifetimeType::PERSISTENT_DOUBLE_BUFFER ? 2u : 1u;
-            auto new_allocation = NonExternalResourceAllocation{
-                .resource = &resource,
-                .resource_index = tr,
-                .offset = 0u,
-                .size = new_allocation_memory_requirements.size * size_factor,
-            };
-            auto new_allocation_first_batch = non_external_resources_sorted_by_lifetime[tr]->final_schedule_first_batch;
-            auto new_allocation_last_batch = non_external_resources_sorted_by_lifetime[tr]->final_schedule_last_batch;
-            auto new_allocation_first_submit = non_external_resources_sorted_by_lifetime[tr]->final_schedule_first_submit;
-            auto new_allocation_last_submit = non_external_resources_sorted_by_lifetime[tr]->final_schedule_last_submit;
-
-            if (impl.info.alias_transients)
-            {
-                // Walk over all allocations made so far.
-                // Allocations are always sorted by their memory offset.
-                // This ensures that when we push back the offset of the new allocation on a collision,
-                // we do not have to go back to check all previous allocations we already checked,
-                // as they are guaranteedd to all the previous allocations we checked have a smaller offset + size than our current offset,
-                // so they could never collide if we bump the new allocations offset.
-                u32 last_colliding_allocation = 0u;
-                for (u32 alloc_i = 0; alloc_i < allocation_count; ++alloc_i)
-                {
-                    auto const & other_allocation = non_external_resource_allocations[alloc_i];
-
-                    auto other_allocation_first_batch = other_allocation.resource->final_schedule_first_batch;
-                    auto other_allocation_last_batch = other_allocation.resource->final_schedule_last_batch;
-                    auto other_allocation_first_submit = other_allocation.resource->final_schedule_first_submit;
-                    auto other_allocation_last_submit = other_allocation.resource->final_schedule_last_submit;
-
-                    // When considering a single queue, the batches imply a strong ordering between tasks and resource lifetimes.
-                    // But execution ordering of batches is not guaranteed across queues within a submit!
-                    // Across queues the only ordering guarantees are given by the submits.
-                    // Thus, when aliasing resources used across queues, we have to use the submit lifetimes.
-                    // For resource aliasing between resources used on the same queue, we can use the batch lifetimes.
-                    auto allocation_resource_queue_access_identical = new_allocation.resource->queue_bits == other_allocation.resource->queue_bits;
-                    auto allocations_used_across_multiple_queues = std::popcount(new_allocation.resource->queue_bits) > 1u || std::popcount(other_allocation.resource->queue_bits) > 1u;
-                    bool use_submit_lifetime_granularity = !allocation_resource_queue_access_identical || allocations_used_across_multiple_queues;
-
-                    auto allocation_lifetimes_collide = false;
-                    if (use_submit_lifetime_granularity)
-                    {
-                        bool const new_is_before_other = new_allocation_last_submit < other_allocation_first_submit;
-                        bool const new_is_after_other = new_allocation_first_submit > other_allocation_last_submit;
-                        allocation_lifetimes_collide = !new_is_before_other && !new_is_after_other;
-                    }
-                    else // batch lifetime granularity
-                    {
-                        bool const new_is_before_other = new_allocation_last_batch < other_allocation_first_batch;
-                        bool const new_is_after_other = new_allocation_first_batch > other_allocation_last_batch;
-                        allocation_lifetimes_collide = !new_is_before_other && !new_is_after_other;
-                    }
-
-                    if (allocation_lifetimes_collide)
-                    {
-                        bool const new_is_below_other = (new_allocation.offset + new_allocation.size) < other_allocation.offset;
-                        bool const new_is_above_other = new_allocation.offset > (other_allocation.offset + other_allocation.size);
-                        bool const allocation_memory_ranges_collide = !new_is_below_other && !new_is_above_other;
-                        if (allocation_memory_ranges_collide)
-                        {
-                            new_allocation.offset = align_up(other_allocation.offset + other_allocation.size, new_allocation_memory_requirements.alignment);
-                            last_colliding_allocation = alloc_i;
-                        }
-                    }
-                }
-
-                // Insert the new allocation so that we keep the allocations sorted by offset.
-                // We can already skip all allocations before the last colliding allocation,
-                // as they are guaranteed to have a smaller offset than the new allocation.
-                // Search in relevant present allocations for a spot to insert the new allocation.
-                bool inserted = false;
-                for (u32 alloc_i = last_colliding_allocation; alloc_i < allocation_count; ++alloc_i)
-                {
-                    bool const insert = new_allocation.offset < non_external_resource_allocations[alloc_i].offset;
-                    if (insert)
-                    {
-                        // Insert new allocation at alloc_i
-                        // Move back all other allocations at and after alloc_i
-                        // last_new_allocation_index is correct, as we are adding a new element here.
-                        u32 const last_new_allocation_index = allocation_count;
-                        for (u32 i = last_new_allocation_index; i >= (alloc_i + 1); --i)
-                        {
-                            non_external_resource_allocations[i] = non_external_resource_allocations[i - 1];
-                        }
-                        non_external_resource_allocations[alloc_i] = new_allocation;
-                        inserted = true;
-                        break;
-                    }
-                }
-                if (!inserted)
-                {
-                    // append to end
-                    non_external_resource_allocations[allocation_count] = new_allocation;
-                }
-                if (tr == 0)
-                {
-                    non_external_resource_allocations[0] = new_allocation;
-                }
-
-                // SANITY CHECK, CAN BE REMOVED
-                for (u32 a = 1; a < allocation_count + 1; ++a)
-                {
-                    NonExternalResourceAllocation & allocation_a = non_external_resource_allocations[a - 1];
-                    NonExternalResourceAllocation & allocation_b = non_external_resource_allocations[a];
-                    DAXA_DBG_ASSERT_TRUE_M(allocation_a.offset <= allocation_b.offset, "IMPOSSIBLE CASE!");
-                }
-            }
-            else
-            {
-                new_allocation.offset = align_up(resource_heap_size, new_allocation_memory_requirements.alignment);
-                non_external_resource_allocations[tr] = new_allocation;
-            }
-
-            resource_heap_size = std::max(resource_heap_size, new_allocation.offset + new_allocation.size);
-            resource_heap_alignment = std::max(resource_heap_alignment, new_allocation_memory_requirements.alignment);
-            resource_heap_memory_bits &= new_allocation_memory_requirements.memory_type_bits;
-        }
-
-        // SANITY CHECK, CAN BE REMOVED
-        for (u32 a = 0; a < non_external_resources_count; ++a)
-        {
-            for (u32 b = 0; b < non_external_resources_count; ++b)
-            {
-                if (a == b)
-                {
-                    continue;
-                }
-
-                NonExternalResourceAllocation & allocation_a = non_external_resource_allocations[a];
-                NonExternalResourceAllocation & allocation_b = non_external_resource_allocations[b];
-
-                auto a_first_batch = non_external_resources_sorted_by_lifetime[allocation_a.resource_index]->final_schedule_first_batch;
-                auto a_last_batch = non_external_resources_sorted_by_lifetime[allocation_a.resource_index]->final_schedule_last_batch;
-
-                auto b_first_batch = non_external_resources_sorted_by_lifetime[allocation_b.resource_index]->final_schedule_first_batch;
-                auto b_last_batch = non_external_resources_sorted_by_lifetime[allocation_b.resource_index]->final_schedule_last_batch;
-
-                bool const lifetime_exclusive = a_first_batch > b_last_batch || a_last_batch < b_first_batch;
-                bool const memory_exclusive = allocation_a.offset >= (allocation_b.offset + allocation_b.size) || (allocation_a.offset + allocation_a.size) <= allocation_b.offset;
-                bool const exclusive = lifetime_exclusive || memory_exclusive;
-                DAXA_DBG_ASSERT_TRUE_M(exclusive, "IMPOSSIBLE CASE!");
-            }
-        }
 
         // Allocate resource heap
-        if (resource_heap_size > 0)
+        if (resource_allocations.heap_size > 0)
         {
             impl.resource_memory_block = impl.info.device.create_memory({
                 .requirements = {
-                    .size = resource_heap_size,
-                    .alignment = resource_heap_alignment,
-                    .memory_type_bits = resource_heap_memory_bits,
+                    .size = resource_allocations.heap_size,
+                    .alignment = resource_allocations.heap_alignment,
+                    .memory_type_bits = resource_allocations.heap_memory_type_bits,
                 },
                 .flags = {},
             });
@@ -2939,65 +3387,18 @@ namespace daxa
         /// ==== CREATE RESOURCES ====
         /// ==========================
 
-        for (u32 alloc_i = 0; alloc_i < non_external_resource_allocations.size(); ++alloc_i)
+        for (u32 alloc_i = 0; alloc_i < resource_allocations.allocations.size(); ++alloc_i)
         {
-            NonExternalResourceAllocation & allocation = non_external_resource_allocations[alloc_i];
-            allocation.resource->allocation_offset = allocation.offset;
-            allocation.resource->allocation_size = allocation.size;
-
-            switch (allocation.resource->kind)
-            {
-            case TaskResourceKind::BUFFER:
-            {
-                auto info = BufferInfo{
-                    .size = allocation.resource->info.buffer.size,
-                    .name = allocation.resource->name,
-                };
-                allocation.resource->id.buffer = impl.info.device.create_buffer_from_memory_block(MemoryBlockBufferInfo{
-                    .buffer_info = info,
-                    .memory_block = impl.resource_memory_block,
-                    .offset = allocation.offset,
-                });
-            }
-            break;
-            case TaskResourceKind::TLAS:
-            {
-                auto info = TlasInfo{
-                    .size = allocation.resource->info.buffer.size,
-                    .name = allocation.resource->name,
-                };
-                allocation.resource->id.tlas = impl.info.device.create_tlas_from_memory_block(MemoryBlockTlasInfo{
-                    .tlas_info = info,
-                    .memory_block = impl.resource_memory_block,
-                    .offset = allocation.offset,
-                });
-            }
-            break;
-            case TaskResourceKind::BLAS:
-                DAXA_DBG_ASSERT_TRUE_M(false, "IMPOSSIBLE CASE! THERE IS NO SUPPORT FOR GRAPH OWNED TASK BLAS!");
-                break;
-            case TaskResourceKind::IMAGE:
-            {
-                auto info = ImageInfo{
-                    .flags = allocation.resource->info.image.flags,
-                    .dimensions = allocation.resource->info.image.dimensions,
-                    .format = allocation.resource->info.image.format,
-                    .size = allocation.resource->info.image.size,
-                    .mip_level_count = allocation.resource->info.image.mip_level_count,
-                    .array_layer_count = allocation.resource->info.image.array_layer_count,
-                    .sample_count = allocation.resource->info.image.sample_count,
-                    .usage = allocation.resource->info.image.usage | impl.info.additional_image_usage_flags,
-                    .name = allocation.resource->name,
-                };
-                allocation.resource->id.image = impl.info.device.create_image_from_memory_block(MemoryBlockImageInfo{
-                    .image_info = info,
-                    .memory_block = impl.resource_memory_block,
-                    .offset = allocation.offset,
-                });
-            }
-            break;
-            }
+            create_non_external_resource(impl, resource_allocations.allocations[alloc_i]);
+            resource_allocations.allocations[alloc_i].resource->resized = false;
         }
+        impl.pending_resource_resizes = false;
+
+        /// ============================================
+        /// ==== DETERMINE SUBMIT QUEUE DEPENDENCIES ====
+        /// ============================================
+
+        determine_submit_queue_dependencies(impl);
 
         /// =============================================
         /// ==== STORE SUBMIT TASK BATCHES PER QUEUE ====
@@ -3067,6 +3468,8 @@ namespace daxa
                     submit.queue_batches[q][queue_batch_i].tasks = tmp_queue_batch_tasks[q][queue_batch_i].clone_to_contiguous(&impl.task_memory);
                     submit.queue_batches[q][queue_batch_i].pre_batch_barriers = {};
                     submit.queue_batches[q][queue_batch_i].pre_batch_image_barriers = {};
+                    submit.queue_batches[q][queue_batch_i].pre_batch_split_barrier_waits = {};
+                    submit.queue_batches[q][queue_batch_i].post_batch_split_barrier_signals = {};
                 }
             }
 
@@ -3091,8 +3494,10 @@ namespace daxa
         // Within each AccessGroup, all tasks MUST have the same (concurrent) access to the resource.
         // Between each AccessGroup within an access timeline, the access will be different.
         // This means between all the access groups within a access timeline, there must be a pipeline barrier.
-        // In many cases, there will be multiple batches between access groups, in these cases we could use split barriers to hide potential cache flushes.
-        // Currently, taskgraph does a very simple strategy, placing a normal barrier just before each access groups first batch.
+        // In many cases, there will be multiple batches between access groups, in these cases we use split barriers to hide potential cache flushes.
+        // The split barrier is signaled right after the first access groups last batch and waited on right before the second access groups first batch.
+        // All split barriers with the same signal and wait batch share one event.
+        // Transfer queues do not support events, they always get a normal barrier placed just before the second access groups first batch.
 
         // While we need barriers between batches on a single queue, we do NOT need barriers between resource access of different queues, that are synchronized via semaphores.
         // Quote for semaphore signal operation:
@@ -3104,10 +3509,17 @@ namespace daxa
         // Also, we mark all images used across queues as concurrent AND we perform very few if at all layout transitions, removing the need for inter queue image barriers as well.
 
         // Build temp barrier data structure.
+        struct TmpSplitBarrier
+        {
+            u32 wait_batch = {};
+            ArenaDynamicArray8k<TaskBarrier> barriers = {};
+            ArenaDynamicArray8k<TaskBarrier> image_barriers = {};
+        };
         struct TmpBatchBarriers
         {
             ArenaDynamicArray8k<TaskBarrier> barriers = {};
             ArenaDynamicArray8k<TaskBarrier> image_barriers = {};
+            ArenaDynamicArray8k<TmpSplitBarrier> split_barriers = {};
         };
         struct TmpSubmitBarriers
         {
@@ -3125,14 +3537,15 @@ namespace daxa
                 {
                     tmp_submit_queue_batch_barriers[submit_index].per_queue_batch_barriers[queue_index][queue_batch_i].barriers = ArenaDynamicArray8k<TaskBarrier>(&tmp_memory);
                     tmp_submit_queue_batch_barriers[submit_index].per_queue_batch_barriers[queue_index][queue_batch_i].image_barriers = ArenaDynamicArray8k<TaskBarrier>(&tmp_memory);
+                    tmp_submit_queue_batch_barriers[submit_index].per_queue_batch_barriers[queue_index][queue_batch_i].split_barriers = ArenaDynamicArray8k<TmpSplitBarrier>(&tmp_memory);
                 }
             }
         }
 
         // All transient images have to be transformed from UNDEFINED to GENERAL layout before their first usage
-        for (u32 tr = 0u; tr < non_external_resources_sorted_by_lifetime.size(); ++tr)
+        for (u32 tr = 0u; tr < resource_allocations.allocations.size(); ++tr)
         {
-            ImplTaskResource & resource = *non_external_resources_sorted_by_lifetime[tr];
+            ImplTaskResource & resource = *resource_allocations.allocations[tr].resource;
 
             if (resource.access_timeline.size() == 0 || resource.kind != TaskResourceKind::IMAGE)
             {
@@ -3193,29 +3606,60 @@ namespace daxa
                 DAXA_DBG_ASSERT_TRUE_M(impl.submits[submit_index].final_schedule_first_batch <= second_ag.final_schedule_first_batch, "IMPOSSIBLE CASE! COULD INDICATE ERROR IN SUBMIT CONSTRUCTION PHASE!");
                 auto const second_ag_submit_local_batch_index = second_ag.final_schedule_first_batch - impl.submits[submit_index].final_schedule_first_batch;
 
-                // Add support for split barriers in the future.
+                auto const first_ag_submit_local_last_batch_index = first_ag.final_schedule_last_batch - impl.submits[submit_index].final_schedule_first_batch;
+
                 // Investigate smarter barrier insertion tactics.
                 u32 submit_local_barrier_insertion_index = second_ag_submit_local_batch_index;
 
-                if (impl.info.amd_rdna3_4_image_barrier_fix && resource.kind == TaskResourceKind::IMAGE)
+                auto const barrier = TaskBarrier{
+                    .src_access_group = &first_ag,
+                    .dst_access_group = &second_ag,
+                    .src_access = first_ag_access,
+                    .dst_access = second_ag_access,
+                    .resource = &resource,
+                };
+                bool const use_image_barrier = impl.info.amd_rdna3_4_image_barrier_fix && resource.kind == TaskResourceKind::IMAGE;
+                bool const queue_supports_events = queue_index_to_queue(queue_index).type != QueueType::TRANSFER;
+                bool const batches_between_access_groups = second_ag_submit_local_batch_index > first_ag_submit_local_last_batch_index + 1u;
+
+                if (impl.info.use_split_barriers && queue_supports_events && batches_between_access_groups)
                 {
-                    tmp_submit_queue_batch_barriers[submit_index].per_queue_batch_barriers[queue_index][submit_local_barrier_insertion_index].image_barriers.push_back(TaskBarrier{
-                        .src_access_group = &first_ag,
-                        .dst_access_group = &second_ag,
-                        .src_access = first_ag_access,
-                        .dst_access = second_ag_access,
-                        .resource = &resource,
-                    });
+                    auto & split_barriers = tmp_submit_queue_batch_barriers[submit_index].per_queue_batch_barriers[queue_index][first_ag_submit_local_last_batch_index].split_barriers;
+                    TmpSplitBarrier * split_barrier = nullptr;
+                    for (u32 split_i = 0; split_i < split_barriers.size(); ++split_i)
+                    {
+                        if (split_barriers[split_i].wait_batch == second_ag_submit_local_batch_index)
+                        {
+                            split_barrier = &split_barriers[split_i];
+                            break;
+                        }
+                    }
+                    if (split_barrier == nullptr)
+                    {
+                        split_barriers.push_back(TmpSplitBarrier{
+                            .wait_batch = second_ag_submit_local_batch_index,
+                            .barriers = ArenaDynamicArray8k<TaskBarrier>(&tmp_memory),
+                            .image_barriers = ArenaDynamicArray8k<TaskBarrier>(&tmp_memory),
+                        });
+                        split_barrier = &split_barriers.back();
+                    }
+
+                    if (use_image_barrier)
+                    {
+                        split_barrier->image_barriers.push_back(barrier);
+                    }
+                    else
+                    {
+                        split_barrier->barriers.push_back(barrier);
+                    }
+                }
+                else if (use_image_barrier)
+                {
+                    tmp_submit_queue_batch_barriers[submit_index].per_queue_batch_barriers[queue_index][submit_local_barrier_insertion_index].image_barriers.push_back(barrier);
                 }
                 else
                 {
-                    tmp_submit_queue_batch_barriers[submit_index].per_queue_batch_barriers[queue_index][submit_local_barrier_insertion_index].barriers.push_back(TaskBarrier{
-                        .src_access_group = &first_ag,
-                        .dst_access_group = &second_ag,
-                        .src_access = first_ag_access,
-                        .dst_access = second_ag_access,
-                        .resource = &resource,
-                    });
+                    tmp_submit_queue_batch_barriers[submit_index].per_queue_batch_barriers[queue_index][submit_local_barrier_insertion_index].barriers.push_back(barrier);
                 }
             }
         }
@@ -3225,18 +3669,22 @@ namespace daxa
         /// ===============================================
 
         // This also initializes the access groups pointers to their respective barriers.
+        // Each split barrier is assigned its own event.
 
+        u32 split_barrier_event_count = 0u;
         for (u32 submit_index = 0; submit_index < impl.submits.size(); ++submit_index)
         {
             TasksSubmit & submit = impl.submits[submit_index];
             for (u32 queue_index = 0; queue_index < DAXA_QUEUE_COUNT; ++queue_index)
             {
-                for (u32 queue_batch_i = 0; queue_batch_i < submit.queue_batches[queue_index].size(); ++queue_batch_i)
+                std::span<TasksBatch> batches = submit.queue_batches[queue_index];
+                std::span<TmpBatchBarriers> tmp_batches = tmp_submit_queue_batch_barriers[submit_index].per_queue_batch_barriers[queue_index];
+                for (u32 queue_batch_i = 0; queue_batch_i < batches.size(); ++queue_batch_i)
                 {
-                    auto & pre_batch_barriers = submit.queue_batches[queue_index][queue_batch_i].pre_batch_barriers;
-                    auto & pre_batch_image_barriers = submit.queue_batches[queue_index][queue_batch_i].pre_batch_image_barriers;
-                    pre_batch_barriers = tmp_submit_queue_batch_barriers[submit_index].per_queue_batch_barriers[queue_index][queue_batch_i].barriers.clone_to_contiguous(&impl.task_memory);
-                    pre_batch_image_barriers = tmp_submit_queue_batch_barriers[submit_index].per_queue_batch_barriers[queue_index][queue_batch_i].image_barriers.clone_to_contiguous(&impl.task_memory);
+                    auto & pre_batch_barriers = batches[queue_batch_i].pre_batch_barriers;
+                    auto & pre_batch_image_barriers = batches[queue_batch_i].pre_batch_image_barriers;
+                    pre_batch_barriers = tmp_batches[queue_batch_i].barriers.clone_to_contiguous(&impl.task_memory);
+                    pre_batch_image_barriers = tmp_batches[queue_batch_i].image_barriers.clone_to_contiguous(&impl.task_memory);
 
                     for (u32 b = 0; b < pre_batch_barriers.size(); ++b)
                     {
@@ -3246,10 +3694,63 @@ namespace daxa
                     {
                         pre_batch_image_barriers[b].dst_access_group->final_schedule_pre_barrier = &pre_batch_image_barriers[b];
                     }
+
+                    auto & post_batch_split_barrier_signals = batches[queue_batch_i].post_batch_split_barrier_signals;
+                    post_batch_split_barrier_signals = impl.task_memory.allocate_trivial_span<TaskSplitBarrier>(tmp_batches[queue_batch_i].split_barriers.size());
+                    for (u32 split_i = 0; split_i < post_batch_split_barrier_signals.size(); ++split_i)
+                    {
+                        TmpSplitBarrier const & tmp_split_barrier = tmp_batches[queue_batch_i].split_barriers[split_i];
+                        TaskSplitBarrier & split_barrier = post_batch_split_barrier_signals[split_i];
+                        split_barrier = TaskSplitBarrier{
+                            .event_index = split_barrier_event_count++,
+                            .barriers = tmp_split_barrier.barriers.clone_to_contiguous(&impl.task_memory),
+                            .image_barriers = tmp_split_barrier.image_barriers.clone_to_contiguous(&impl.task_memory),
+                        };
+
+                        for (u32 b = 0; b < split_barrier.barriers.size(); ++b)
+                        {
+                            split_barrier.barriers[b].dst_access_group->final_schedule_pre_barrier = &split_barrier.barriers[b];
+                        }
+                        for (u32 b = 0; b < split_barrier.image_barriers.size(); ++b)
+                        {
+                            split_barrier.image_barriers[b].dst_access_group->final_schedule_pre_barrier = &split_barrier.image_barriers[b];
+                        }
+                    }
+                }
+
+                // Split barriers are always signaled in an earlier batch than they are waited on.
+                // So all signals of the queue are stored before the waits are gathered.
+                for (u32 wait_batch_i = 0; wait_batch_i < batches.size(); ++wait_batch_i)
+                {
+                    u32 wait_count = 0u;
+                    for (u32 signal_batch_i = 0; signal_batch_i < wait_batch_i; ++signal_batch_i)
+                    {
+                        for (u32 split_i = 0; split_i < tmp_batches[signal_batch_i].split_barriers.size(); ++split_i)
+                        {
+                            wait_count += tmp_batches[signal_batch_i].split_barriers[split_i].wait_batch == wait_batch_i ? 1u : 0u;
+                        }
+                    }
+
+                    auto & pre_batch_split_barrier_waits = batches[wait_batch_i].pre_batch_split_barrier_waits;
+                    pre_batch_split_barrier_waits = impl.task_memory.allocate_trivial_span<TaskSplitBarrier const *>(wait_count);
+                    u32 wait_i = 0u;
+                    for (u32 signal_batch_i = 0; signal_batch_i < wait_batch_i; ++signal_batch_i)
+                    {
+                        for (u32 split_i = 0; split_i < tmp_batches[signal_batch_i].split_barriers.size(); ++split_i)
+                        {
+                            if (tmp_batches[signal_batch_i].split_barriers[split_i].wait_batch == wait_batch_i)
+                            {
+                                pre_batch_split_barrier_waits[wait_i++] = &batches[signal_batch_i].post_batch_split_barrier_signals[split_i];
+                            }
+                        }
+                    }
                 }
             }
         }
 
+        // Event sets are created on demand in execute, one per execution in flight.
+        impl.split_barrier_event_count = split_barrier_event_count;
+
         /// ================================================
         /// ==== PREPARE TIGHT SUBMIT QUEUE INDEX LISTS ====
         /// ================================================
@@ -3330,12 +3831,62 @@ namespace daxa
         impl.compiled = true;
     }
 
+    thread_local std::vector<ImageBarrierInfo> tl_split_barrier_image_barriers = {};
+
+    // The signal and wait of a split barrier must use identical barriers.
+    // Image ids are resolved at recording, as external and double buffered resources change their ids between executions.
+    // After the wait, the event is reset so that it can be signaled again in the next execution.
+    void record_split_barrier(CommandRecorder & cr, Event & event, TaskSplitBarrier const & split_barrier, bool signal)
+    {
+        BarrierInfo merged_barrier = {};
+        for (u32 b = 0; b < split_barrier.barriers.size(); ++b)
+        {
+            merged_barrier.src_access = merged_barrier.src_access | split_barrier.barriers[b].src_access;
+            merged_barrier.dst_access = merged_barrier.dst_access | split_barrier.barriers[b].dst_access;
+        }
+        PipelineStageFlags wait_stages = merged_barrier.dst_access.stages;
+        tl_split_barrier_image_barriers.clear();
+        for (u32 b = 0; b < split_barrier.image_barriers.size(); ++b)
+        {
+            TaskBarrier const & task_image_barrier = split_barrier.image_barriers[b];
+            tl_split_barrier_image_barriers.push_back(ImageBarrierInfo{
+                .src_access = task_image_barrier.src_access,
+                .dst_access = task_image_barrier.dst_access,
+                .image = task_image_barrier.resource->id.image,
+                .layout_operation = task_image_barrier.layout_operation,
+            });
+            wait_stages |= task_image_barrier.dst_access.stages;
+        }
+
+        auto const info = EventSignalInfo{
+            .barriers = split_barrier.barriers.size() > 0 ? daxa::Span<BarrierInfo const>{&merged_barrier, 1} : daxa::Span<BarrierInfo const>{},
+            .image_barriers = tl_split_barrier_image_barriers,
+            .event = event,
+        };
+        if (signal)
+        {
+            cr.signal_event(info);
+        }
+        else
+        {
+            cr.wait_event(info);
+            cr.reset_event({.event = event, .stage = wait_stages});
+        }
+    }
+
     auto TaskGraph::get_resource_memory_block_size() -> daxa::usize
     {
         auto & impl = *r_cast<ImplTaskGraph *>(this->object);
         return impl.resource_memory_block.info().requirements.size;
     }
 
+    auto TaskGraph::get_resource_memory_report() -> TaskResourceMemoryReport
+    {
+        auto & impl = *r_cast<ImplTaskGraph *>(this->object);
+        DAXA_DBG_ASSERT_TRUE_M(impl.compiled, "ERROR: TaskGraph must be completed before querying the resource memory report!");
+        return impl.memory_report;
+    }
+
     void TaskGraph::execute([[maybe_unused]] ExecutionInfo const & info)
     {
         auto & impl = *r_cast<ImplTaskGraph *>(this->object);
@@ -3344,6 +3895,8 @@ namespace daxa
         std::array<u8, 1u << 16u> tmp_stack_mem;
         MemoryArena tmp_memory = MemoryArena{"TaskGraph::execute tmp memory", tmp_stack_mem};
 
+        impl.execution_index += 1;
+
         /// =============================================================================
         /// ==== VALIDATE, PATCH AND GENERATE CONNECTING SYNC FOR EXTERNAL RESOURCES ====
         /// =============================================================================
@@ -3368,11 +3921,13 @@ namespace daxa
             }
         }
 
-        // Taskgraph performs a full barrier between all queues it uses at every submit.
+        // Without fine grained queue sync, taskgraph performs a full barrier between all queues it uses at every submit.
         // Task graph finds all queues exterbal resources were used on prior to its exection.
         // It then constructs a dependency which synchronizes all queues found in the previous step with all queues used by this taskgraph.
         // This synchronization waits on all previously recorded commands to finish before any commands from this taskgraph are executed.
+        // With fine grained queue sync, only the submit queues performing the first access to an external resource wait on the queues that used it prior to the graph.
         u32 external_resource_queue_bits = {};
+        auto external_resource_submit_queue_wait_bits = tmp_memory.allocate_trivial_span_fill<std::array<u32, DAXA_QUEUE_COUNT>>(impl.submits.size(), {});
 
         // Validate the swapchain image we use was not yet presented to
         if (impl.swapchain_image)
@@ -3469,6 +4024,12 @@ namespace daxa
             }
 
             // Determine synchronization needs
+            AccessGroup const & first_access_group = resource->access_timeline[0];
+            for (u32 t = 0; t < first_access_group.tasks.size(); ++t)
+            {
+                ImplTask const & task = *first_access_group.tasks[t].task;
+                external_resource_submit_queue_wait_bits[task.submit_index][queue_to_queue_index(task.queue)] |= external->pre_graph_queue_bits;
+            }
             if (resource->kind != TaskResourceKind::IMAGE)
             {
                 external_resource_queue_bits |= external->pre_graph_queue_bits;
@@ -3523,6 +4084,7 @@ namespace daxa
             // swap current and prevous double buffer
             ImplTaskResource* back_buffer_resource = resource->double_buffer_pair_resource.first;
             std::swap(resource->id, back_buffer_resource->id);
+            std::swap(resource->relocated_from, back_buffer_resource->relocated_from);
             
             // As the ids changed, all datastructures must be patched.
             for (u32 access_group_i = 0; access_group_i < resource->access_timeline.size(); ++access_group_i)
@@ -3605,7 +4167,7 @@ namespace daxa
                     .src_access_group = {},
                     .dst_access_group = {},
                     .src_access = {},
-                    .dst_access = AccessConsts::CLEAR_WRITE,
+                    .dst_access = resource->relocated_from.image.is_empty() ? AccessConsts::CLEAR_WRITE : AccessConsts::TRANSFER_WRITE,
                     .resource = resource,
                     .layout_operation = ImageLayoutOperation::TO_GENERAL,
                 });
@@ -3613,65 +4175,232 @@ namespace daxa
 
             resource_clears[first_access_submit_index][first_access_queue_index].push_back({ resource, resource_index });
 
-            // Reset clear reqest index within resource
-            resource->clear_request_index = ~0u;
-        }
+            // Reset clear reqest index within resource
+            resource->clear_request_index = ~0u;
+        }
+
+        // Reset clear requests
+        impl.resource_clear_request_count = {};
+
+#if DAXA_BUILT_WITH_UTILS_IMGUI
+        /// =======================
+        /// ==== DEBUG UI HOOK ====
+        /// =======================
+
+        ImplTaskGraphDebugUi * debug_ui_context = info.debug_ui ? info.debug_ui->get() : nullptr;
+        if (debug_ui_context && debug_ui_context->resource_viewer_states.size() == 0)
+        {
+            debug_ui_context = nullptr; // We only care about the debug ui when there are active attachment viewers.
+        }
+#endif
+
+        /// ========================================
+        /// ==== SELECT SPLIT BARRIER EVENT SET ====
+        /// ========================================
+
+        // Reuse the first event set no pending execution uses anymore, otherwise create a new one.
+        // Graphs without split barriers always use the same empty set.
+        u32 split_barrier_event_set_index = 0u;
+        u64 const oldest_pending_submit_index = impl.info.device.oldest_pending_submit_index();
+        while (impl.split_barrier_event_count > 0 &&
+               split_barrier_event_set_index < impl.split_barrier_event_sets.size() &&
+               impl.split_barrier_event_sets[split_barrier_event_set_index].last_submit_index >= oldest_pending_submit_index)
+        {
+            ++split_barrier_event_set_index;
+        }
+        if (split_barrier_event_set_index == impl.split_barrier_event_sets.size())
+        {
+            SplitBarrierEventSet new_event_set = {};
+            new_event_set.events.reserve(impl.split_barrier_event_count);
+            for (u32 event_i = 0; event_i < impl.split_barrier_event_count; ++event_i)
+            {
+                new_event_set.events.push_back(impl.info.device.create_event({.name = "TaskGraph split barrier"}));
+            }
+            impl.split_barrier_event_sets.push_back(std::move(new_event_set));
+        }
+        SplitBarrierEventSet & split_barrier_event_set = impl.split_barrier_event_sets[split_barrier_event_set_index];
+
+        /// =======================================
+        /// ==== FINGERPRINT SUBMIT RECORDINGS ====
+        /// =======================================
+
+        // The recording of a submit only depends on the ids of the external and double buffer resources it accesses,
+        // its image initializations and clears and the inputs of the task callbacks the user folds into the recording fingerprint.
+        // All other resources and all barriers are fixed after completion.
+        // Submits with image initializations or clears are one-off recordings, they are never cached.
+
+#if DAXA_BUILT_WITH_UTILS_IMGUI
+        bool const use_recording_cache = impl.info.enable_recording_cache && debug_ui_context == nullptr;
+#else
+        bool const use_recording_cache = impl.info.enable_recording_cache;
+#endif
+
+        auto submit_fingerprints = tmp_memory.allocate_trivial_span<u64>(impl.submits.size());
+        auto submit_cacheable = tmp_memory.allocate_trivial_span<bool>(impl.submits.size());
+        if (use_recording_cache)
+        {
+            if (impl.recording_cache.size() != impl.submits.size())
+            {
+                impl.recording_cache.clear();
+                impl.recording_cache.resize(impl.submits.size());
+                impl.recording_used_staging_memory.assign(impl.submits.size(), false);
+            }
+
+            auto hash_combine = [](u64 seed, u64 value) -> u64
+            {
+                return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+            };
+
+            u64 global_fingerprint = hash_combine(0, info.recording_fingerprint);
+            // Recordings reference the events of the set they were recorded with.
+            global_fingerprint = hash_combine(global_fingerprint, split_barrier_event_set_index);
+            for (bool const condition : info.permutation_condition_values)
+            {
+                global_fingerprint = hash_combine(global_fingerprint, static_cast<u64>(condition));
+            }
 
-        // Reset clear requests
-        impl.resource_clear_request_count = {};
+            for (u32 s = 0; s < impl.submits.size(); ++s)
+            {
+                submit_fingerprints[s] = global_fingerprint;
+                submit_cacheable[s] = true;
+                for (u32 q = 0; q < DAXA_QUEUE_COUNT; ++q)
+                {
+                    submit_cacheable[s] = submit_cacheable[s] && image_initializations[s][q].size() == 0 && resource_clears[s][q].size() == 0;
+                }
+            }
 
-#if DAXA_BUILT_WITH_UTILS_IMGUI
-        /// =======================
-        /// ==== DEBUG UI HOOK ====
-        /// =======================
+            auto fingerprint_resource = [&](ImplTaskResource const & resource)
+            {
+                // All id types share the same 64 bit layout.
+                u64 const id = std::bit_cast<u64>(resource.id.buffer);
+                for (u32 access_group_i = 0; access_group_i < resource.access_timeline.size(); ++access_group_i)
+                {
+                    AccessGroup const & access_group = resource.access_timeline[access_group_i];
+                    for (u32 t = 0; t < access_group.tasks.size(); ++t)
+                    {
+                        u32 const submit_index = access_group.tasks[t].task->submit_index;
+                        submit_fingerprints[submit_index] = hash_combine(submit_fingerprints[submit_index], id);
+                    }
+                }
+            };
+            for (u32 er = 0; er < impl.external_resources.size(); ++er)
+            {
+                fingerprint_resource(*impl.external_resources[er].first);
+            }
+            for (u32 dbr_i = 0u; dbr_i < impl.primary_double_buffer_resources.size(); ++dbr_i)
+            {
+                ImplTaskResource const & resource = *impl.primary_double_buffer_resources[dbr_i].first;
+                fingerprint_resource(resource);
+                fingerprint_resource(*resource.double_buffer_pair_resource.first);
+            }
 
-        ImplTaskGraphDebugUi * debug_ui_context = info.debug_ui ? info.debug_ui->get() : nullptr;
-        if (debug_ui_context && debug_ui_context->resource_viewer_states.size() == 0)
-        {
-            debug_ui_context = nullptr; // We only care about the debug ui when there are active attachment viewers.
+            // Non default attachment views are recreated whenever external or double buffered images change.
+            // Cached command lists and attachment shader blobs contain these view ids, so they must be part of the fingerprint.
+            for (u32 task_i = 0; task_i < impl.tasks.size(); ++task_i)
+            {
+                ImplTask const & task = impl.tasks[task_i];
+                if (task.submit_index >= impl.submits.size())
+                {
+                    continue;
+                }
+                u64 & fingerprint = submit_fingerprints[task.submit_index];
+                for (u32 attach_i = 0; attach_i < task.attachments.size(); ++attach_i)
+                {
+                    if (task.attachments[attach_i].type != TaskAttachmentType::IMAGE)
+                    {
+                        continue;
+                    }
+                    for (ImageViewId const view : task.attachment_image_views[attach_i])
+                    {
+                        fingerprint = hash_combine(fingerprint, std::bit_cast<u64>(view));
+                    }
+                }
+            }
         }
-#endif
 
         /// ====================================
         /// ==== RECORD AND SUBMIT COMMANDS ====
         /// ====================================
 
         daxa::Device & device = impl.info.device;
+
+        // Queue submit indices of the queues used on external resources prior to the graph.
+        // Used by fine grained queue sync as the wait values for the first accesses to external resources.
+        std::array<u64, DAXA_QUEUE_COUNT> pre_graph_queue_submit_indices = {};
+        for (u32 q = 0; q < DAXA_QUEUE_COUNT; ++q)
+        {
+            if ((external_resource_queue_bits & queue_index_to_queue_bit(q)) != 0u)
+            {
+                pre_graph_queue_submit_indices[q] = device.latest_queue_submit_index(queue_index_to_queue(q));
+            }
+        }
+        // Queue submit indices of each submit queue of this execution, written after each submit.
+        auto submit_queue_submit_indices = tmp_memory.allocate_trivial_span_fill<std::array<u64, DAXA_QUEUE_COUNT>>(impl.submits.size(), {});
+
+        // Graph owned resources persist across executions or alias within the resource memory block.
+        // The dependencies computed at completion only cover a single execution, so with fine grained queue sync,
+        // every submit queue accessing graph owned resources also waits on the queues of the previous execution.
+        auto graph_memory_submit_queue_bits = tmp_memory.allocate_trivial_span_fill<u32>(impl.submits.size(), 0u);
+        if (impl.info.fine_grained_queue_sync)
+        {
+            for (u32 task_i = 0; task_i < impl.tasks.size(); ++task_i)
+            {
+                ImplTask const & task = impl.tasks[task_i];
+                if (task.submit_index >= impl.submits.size())
+                {
+                    continue;
+                }
+                for (u32 attach_i = 0; attach_i < task.attachment_resources.size(); ++attach_i)
+                {
+                    ImplTaskResource const * resource = task.attachment_resources[attach_i].first;
+                    if (resource != nullptr && resource->external == nullptr)
+                    {
+                        graph_memory_submit_queue_bits[task.submit_index] |= queue_index_to_queue_bit(queue_to_queue_index(task.queue));
+                        break;
+                    }
+                }
+            }
+        }
+
         for (u32 submit_index = 0; submit_index < impl.submits.size(); ++submit_index)
         {
             TasksSubmit & submit = impl.submits[submit_index];
 
             // Inter Queue Sync
             // Build list of queue submit indices to wait on for the current submit.
+            // Fine grained queue sync builds its wait lists per submit queue below.
             std::span<std::pair<Queue, u64>> wait_queue_submit_indices = {};
-            if (submit_index == 0)
-            {
-                // In the first submission, we wait on all queues that touched external resource prior to this graph.
-                u32 initial_wait_queue_bits = external_resource_queue_bits;
-                wait_queue_submit_indices = tmp_memory.allocate_trivial_span<std::pair<Queue, u64>>(std::popcount(initial_wait_queue_bits));
-                u32 queue_iter = initial_wait_queue_bits;
-                u32 i = 0;
-                while (queue_iter)
+            if (!impl.info.fine_grained_queue_sync)
+            {
+                if (submit_index == 0)
                 {
-                    u32 queue_index = queue_bits_to_first_queue_index(queue_iter);
-                    Queue queue = queue_index_to_queue(queue_index);
-                    queue_iter &= ~queue_index_to_queue_bit(queue_index);
-                    wait_queue_submit_indices[i] = std::pair{queue, device.latest_queue_submit_index(queue)};
-                    ++i;
+                    // In the first submission, we wait on all queues that touched external resource prior to this graph.
+                    u32 initial_wait_queue_bits = external_resource_queue_bits;
+                    wait_queue_submit_indices = tmp_memory.allocate_trivial_span<std::pair<Queue, u64>>(std::popcount(initial_wait_queue_bits));
+                    u32 queue_iter = initial_wait_queue_bits;
+                    u32 i = 0;
+                    while (queue_iter)
+                    {
+                        u32 queue_index = queue_bits_to_first_queue_index(queue_iter);
+                        Queue queue = queue_index_to_queue(queue_index);
+                        queue_iter &= ~queue_index_to_queue_bit(queue_index);
+                        wait_queue_submit_indices[i] = std::pair{queue, device.latest_queue_submit_index(queue)};
+                        ++i;
+                    }
                 }
-            }
-            else
-            {
-                // For every following submission we wait on all queues used in the prior submission.
-                TasksSubmit & previous_submit = impl.submits[submit_index - 1];
-
-                // Add a wait on every queue used in the previous submit:
-                wait_queue_submit_indices = tmp_memory.allocate_trivial_span<std::pair<Queue, u64>>(previous_submit.queue_indices.size());
-                for (u32 qi = 0; qi < previous_submit.queue_indices.size(); ++qi)
+                else
                 {
-                    u32 queue_index = previous_submit.queue_indices[qi];
-                    Queue queue = queue_index_to_queue(queue_index);
-                    wait_queue_submit_indices[qi] = std::pair{queue, device.latest_queue_submit_index(queue)};
+                    // For every following submission we wait on all queues used in the prior submission.
+                    TasksSubmit & previous_submit = impl.submits[submit_index - 1];
+
+                    // Add a wait on every queue used in the previous submit:
+                    wait_queue_submit_indices = tmp_memory.allocate_trivial_span<std::pair<Queue, u64>>(previous_submit.queue_indices.size());
+                    for (u32 qi = 0; qi < previous_submit.queue_indices.size(); ++qi)
+                    {
+                        u32 queue_index = previous_submit.queue_indices[qi];
+                        Queue queue = queue_index_to_queue(queue_index);
+                        wait_queue_submit_indices[qi] = std::pair{queue, device.latest_queue_submit_index(queue)};
+                    }
                 }
             }
 
@@ -3700,90 +4429,219 @@ namespace daxa
             u64 signal_semaphore_count = {};
             std::array<std::pair<TimelineSemaphore, u64>, MAX_SYNC_PRIMITIVES> signal_timeline_semaphores = {};
             u64 signal_timeline_semaphore_count = {};
-            std::array<ExecutableCommandList, DAXA_QUEUE_COUNT> executable_command_lists = {};
 
             auto submit_infos = tmp_memory.allocate_trivial_span<CommandSubmitInfo>(submit.queue_indices.size());
 
-            for (u32 qi = 0; qi < submit.queue_indices.size(); ++qi)
+            bool const swapchain_image_used_in_graph = impl.swapchain_image != nullptr && impl.swapchain_image->access_timeline.size() > 0;
+
+            // When the submit has a cached recording, no jobs are recorded and the cached command lists are submitted instead.
+            RecordingCacheEntry * cached_recording = nullptr;
+            if (use_recording_cache && submit_cacheable[submit_index])
+            {
+                for (RecordingCacheEntry & entry : impl.recording_cache[submit_index])
+                {
+                    if (!entry.command_lists.empty() && entry.fingerprint == submit_fingerprints[submit_index])
+                    {
+                        cached_recording = &entry;
+                        break;
+                    }
+                }
+            }
+
+            // Only recordings that are stored in the cache are recorded reusable, all others stay one time submit.
+            // Whether a recording uses staging memory is only known afterwards, it is assumed to do so again when the previous recording did.
+            bool const cache_recording = use_recording_cache && submit_cacheable[submit_index] && cached_recording == nullptr && !impl.recording_used_staging_memory[submit_index];
+
+            // Recording is split into jobs.
+            // Each job records a consecutive range of batches of a single queue into its own command list.
+            // With serial recording, there is exactly one job per queue covering all its batches.
+            // With parallel recording, there is one job per queue batch, all jobs of a submit are recorded concurrently.
+            // The jobs of each queue are stored consecutively, so that their command lists can be submitted in batch order.
+            struct RecordJob
+            {
+                u32 queue_index = {};
+                u32 first_batch = {};
+                u32 batch_count = {};
+            };
+
+#if DAXA_BUILT_WITH_UTILS_IMGUI
+            bool const record_in_parallel = impl.info.parallel_recording.blocking_parallel_for != nullptr && debug_ui_context == nullptr;
+#else
+            bool const record_in_parallel = impl.info.parallel_recording.blocking_parallel_for != nullptr;
+#endif
+
+            u32 record_job_count = {};
+            auto queue_first_record_job = tmp_memory.allocate_trivial_span<u32>(submit.queue_indices.size());
+            for (u32 qi = 0; qi < submit.queue_indices.size() && cached_recording == nullptr; ++qi)
+            {
+                queue_first_record_job[qi] = record_job_count;
+                record_job_count += record_in_parallel ? static_cast<u32>(submit.queue_batches[submit.queue_indices[qi]].size()) : 1u;
+            }
+            auto record_jobs = tmp_memory.allocate_trivial_span<RecordJob>(record_job_count);
+            for (u32 qi = 0; qi < submit.queue_indices.size() && cached_recording == nullptr; ++qi)
+            {
+                u32 const queue_index = submit.queue_indices[qi];
+                u32 const queue_batch_count = static_cast<u32>(submit.queue_batches[queue_index].size());
+                if (record_in_parallel)
+                {
+                    for (u32 batch_i = 0; batch_i < queue_batch_count; ++batch_i)
+                    {
+                        record_jobs[queue_first_record_job[qi] + batch_i] = RecordJob{queue_index, batch_i, 1u};
+                    }
+                }
+                else
+                {
+                    record_jobs[queue_first_record_job[qi]] = RecordJob{queue_index, 0u, queue_batch_count};
+                }
+            }
+            // The command lists are destroyed at the end of the submit, after they were submitted or copied into the recording cache.
+            auto executable_command_lists = std::span{
+                r_cast<ExecutableCommandList *>(tmp_memory.allocate(sizeof(ExecutableCommandList), alignof(ExecutableCommandList), record_job_count)),
+                record_job_count};
+            std::uninitialized_default_construct(executable_command_lists.begin(), executable_command_lists.end());
+            defer
+            {
+                std::destroy(executable_command_lists.begin(), executable_command_lists.end());
+            };
+
+            // Jobs handed an out of range thread_index by blocking_parallel_for are not recorded by the worker.
+            // They are recorded on this thread after blocking_parallel_for returned, instead of indexing past the per worker staging memory.
+            std::span<bool> job_needs_serial_recording = tmp_memory.allocate_trivial_span_fill<bool>(record_job_count, false);
+            auto record_job = [&](RecordJob const & job, u32 job_index, u32 thread_index)
             {
+                if (record_in_parallel && thread_index >= impl.info.parallel_recording.worker_thread_count)
+                {
+                    job_needs_serial_recording[job_index] = true;
+                    return;
+                }
+
                 /// =========================================
                 /// ==== PREPARE QUEUE COMMAND RECORDING ====
                 /// =========================================
 
-                u32 queue_index = submit.queue_indices[qi];
-                Queue queue = queue_index_to_queue(queue_index);
+                u32 const queue_index = job.queue_index;
+                Queue const queue = queue_index_to_queue(queue_index);
+                std::span<TasksBatch> const batches = submit.queue_batches[queue_index];
+                bool const is_first_queue_job = job.first_batch == 0;
+                bool const is_last_queue_job = job.first_batch + job.batch_count == batches.size();
 
                 auto cr = device.create_command_recorder({
                     .queue_type = queue.type,
                     .name = submit.queue_batch_cmd_recorder_labels[queue_index],
+                    .reusable = cache_recording,
                 });
 
                 ImplTaskRuntimeInterface impl_runtime{.task_graph = impl, .recorder = cr};
-
-                // All queues allocate their spans of semaphores into the same stack array.
-                // Safe offset into the queue shared arrays for later use.
-                u64 const queue_wait_semaphores_first = wait_semaphore_count;
-                u64 const queue_signal_semaphores_first = signal_semaphore_count;
-                u64 const queue_signal_timeline_semaphores_first = signal_timeline_semaphore_count;
-
-                // Add image initialization barriers.
-                auto const & initialization_barriers = image_initializations[submit_index][queue_index];
-                for (u32 ib = 0; ib < initialization_barriers.size(); ++ib)
+                TransferMemoryPool * job_allocator = impl.staging_memory.has_value() ? &impl.staging_memory.value() : nullptr;
+                if (record_in_parallel)
                 {
-                    TaskBarrier const & task_image_barrier = initialization_barriers[ib];
-                    cr.pipeline_image_barrier(ImageBarrierInfo{
-                        .src_access = task_image_barrier.src_access,
-                        .dst_access = task_image_barrier.dst_access,
-                        .image = task_image_barrier.resource->id.image,
-                        .layout_operation = task_image_barrier.layout_operation,
-                    });
+                    job_allocator = impl.worker_staging_memory.empty() ? nullptr : &impl.worker_staging_memory[thread_index];
                 }
 
-                // Insert requested resource clears
-                Access post_clear_first_access_merged = {};
-                for (u32 clear_i = 0u; clear_i < resource_clears[submit_index][queue_index].size(); ++clear_i)
+                if (is_first_queue_job)
                 {
-                    TmpResourceClear const & resource_clear = resource_clears[submit_index][queue_index][clear_i];
-                    if (resource_clear.resource->kind == TaskResourceKind::BUFFER)
+                    // Add image initialization barriers.
+                    auto const & initialization_barriers = image_initializations[submit_index][queue_index];
+                    for (u32 ib = 0; ib < initialization_barriers.size(); ++ib)
                     {
-                        cr.clear_buffer({
-                            .buffer = resource_clear.resource->id.buffer,
-                            .offset = {},
-                            .size = resource_clear.resource->info.buffer.size,
-                            .clear_value = 0u,
+                        TaskBarrier const & task_image_barrier = initialization_barriers[ib];
+                        cr.pipeline_image_barrier(ImageBarrierInfo{
+                            .src_access = task_image_barrier.src_access,
+                            .dst_access = task_image_barrier.dst_access,
+                            .image = task_image_barrier.resource->id.image,
+                            .layout_operation = task_image_barrier.layout_operation,
                         });
                     }
-                    else if (resource_clear.resource->kind == TaskResourceKind::IMAGE)
+
+                    // Moved persistent resources are copied from their old resource, which was last accessed in the previous execution.
+                    bool has_relocation_copies = false;
+                    for (u32 clear_i = 0u; clear_i < resource_clears[submit_index][queue_index].size(); ++clear_i)
                     {
-                        cr.clear_image(ImageClearInfo{
-                            .image = resource_clear.resource->id.image,
-                            .slice = device.image_view_info(resource_clear.resource->id.image.default_view()).value().slice,
-                            .clear_value = ClearValue{std::array{0u, 0u, 0u, 0u}},
-                        });
+                        has_relocation_copies = has_relocation_copies || !resource_clears[submit_index][queue_index][clear_i].resource->relocated_from.buffer.is_empty();
                     }
-                    else
+                    if (has_relocation_copies)
                     {
-                        DAXA_DBG_ASSERT_TRUE_M(false, "IMPOSSIBLE CASE! ONLY IMAGES AND BUFFERS CAN HAVE CLEAR REQUESTS!");
+                        cr.pipeline_barrier({
+                            .src_access = AccessConsts::READ_WRITE,
+                            .dst_access = AccessConsts::TRANSFER_READ,
+                        });
                     }
 
-                    // Merge first accesses
-                    auto const & first_access_group = resource_clear.resource->access_timeline[0];
-                    auto first_access = Access{task_stage_to_pipeline_stage(first_access_group.stages), to_access_type(first_access_group.type)};
-                    post_clear_first_access_merged = post_clear_first_access_merged | first_access;
-                }
+                    // Insert requested resource clears
+                    Access post_clear_first_access_merged = {};
+                    for (u32 clear_i = 0u; clear_i < resource_clears[submit_index][queue_index].size(); ++clear_i)
+                    {
+                        TmpResourceClear const & resource_clear = resource_clears[submit_index][queue_index][clear_i];
+                        if (!resource_clear.resource->relocated_from.buffer.is_empty())
+                        {
+                            if (resource_clear.resource->kind == TaskResourceKind::BUFFER)
+                            {
+                                cr.copy_buffer_to_buffer({
+                                    .src_buffer = resource_clear.resource->relocated_from.buffer,
+                                    .dst_buffer = resource_clear.resource->id.buffer,
+                                    .size = resource_clear.resource->info.buffer.size,
+                                });
+                            }
+                            else
+                            {
+                                auto const & image_info = resource_clear.resource->info.image;
+                                for (u32 mip = 0; mip < image_info.mip_level_count; ++mip)
+                                {
+                                    auto const slice = ImageArraySlice{.mip_level = mip, .base_array_layer = 0, .layer_count = image_info.array_layer_count};
+                                    cr.copy_image_to_image({
+                                        .src_image = resource_clear.resource->relocated_from.image,
+                                        .dst_image = resource_clear.resource->id.image,
+                                        .src_slice = slice,
+                                        .dst_slice = slice,
+                                        .extent = {
+                                            std::max(1u, image_info.size.x >> mip),
+                                            std::max(1u, image_info.size.y >> mip),
+                                            std::max(1u, image_info.size.z >> mip),
+                                        },
+                                    });
+                                }
+                            }
+                        }
+                        else if (resource_clear.resource->kind == TaskResourceKind::BUFFER)
+                        {
+                            cr.clear_buffer({
+                                .buffer = resource_clear.resource->id.buffer,
+                                .offset = {},
+                                .size = resource_clear.resource->info.buffer.size,
+                                .clear_value = 0u,
+                            });
+                        }
+                        else if (resource_clear.resource->kind == TaskResourceKind::IMAGE)
+                        {
+                            cr.clear_image(ImageClearInfo{
+                                .image = resource_clear.resource->id.image,
+                                .slice = device.image_view_info(resource_clear.resource->id.image.default_view()).value().slice,
+                                .clear_value = ClearValue{std::array{0u, 0u, 0u, 0u}},
+                            });
+                        }
+                        else
+                        {
+                            DAXA_DBG_ASSERT_TRUE_M(false, "IMPOSSIBLE CASE! ONLY IMAGES AND BUFFERS CAN HAVE CLEAR REQUESTS!");
+                        }
 
-                // Insert resource clear to first access barrier
-                if (resource_clears[submit_index][queue_index].size() > 0)
-                {
-                    cr.pipeline_barrier({
-                        .src_access = AccessConsts::CLEAR_WRITE,
-                        .dst_access = post_clear_first_access_merged,
-                    });
+                        // Merge first accesses
+                        auto const & first_access_group = resource_clear.resource->access_timeline[0];
+                        auto first_access = Access{task_stage_to_pipeline_stage(first_access_group.stages), to_access_type(first_access_group.type)};
+                        post_clear_first_access_merged = post_clear_first_access_merged | first_access;
+                    }
+
+                    // Insert resource clear to first access barrier
+                    if (resource_clears[submit_index][queue_index].size() > 0)
+                    {
+                        cr.pipeline_barrier({
+                            .src_access = has_relocation_copies ? AccessConsts::CLEAR_WRITE | AccessConsts::TRANSFER_WRITE : AccessConsts::CLEAR_WRITE,
+                            .dst_access = post_clear_first_access_merged,
+                        });
+                    }
                 }
 
                 // Record task batches and inter batch barriers:
-                std::span<TasksBatch> batches = submit.queue_batches[queue_index];
-                for (u32 batch_i = 0; batch_i < batches.size(); ++batch_i)
+                for (u32 batch_i = job.first_batch; batch_i < job.first_batch + job.batch_count; ++batch_i)
                 {
                     TasksBatch const & batch = batches[batch_i];
 
@@ -3791,6 +4649,11 @@ namespace daxa
                     /// ==== RECORD PRE BATCH BARRIERS ====
                     /// ===================================
 
+                    for (u32 wait_i = 0; wait_i < batch.pre_batch_split_barrier_waits.size(); ++wait_i)
+                    {
+                        TaskSplitBarrier const & split_barrier = *batch.pre_batch_split_barrier_waits[wait_i];
+                        record_split_barrier(cr, split_barrier_event_set.events[split_barrier.event_index], split_barrier, false);
+                    }
                     for (u32 b = 0; b < batch.pre_batch_barriers.size(); ++b)
                     {
                         cr.pipeline_barrier(BarrierInfo{
@@ -3882,7 +4745,7 @@ namespace daxa
                             .device = impl.info.device,
                             .recorder = impl_runtime.recorder,
                             .attachment_infos = task.attachments,
-                            .allocator = impl.staging_memory.has_value() ? &impl.staging_memory.value() : nullptr,
+                            .allocator = job_allocator,
                             .attachment_shader_blob = task.attachment_shader_blob,
                             .task_name = task.name,
                             .task_index = task_i,
@@ -3921,14 +4784,134 @@ namespace daxa
                             impl_runtime.recorder.end_label();
                         }
                     }
+
+                    /// ==========================================
+                    /// ==== RECORD POST BATCH SPLIT BARRIERS ====
+                    /// ==========================================
+
+                    for (u32 signal_i = 0; signal_i < batch.post_batch_split_barrier_signals.size(); ++signal_i)
+                    {
+                        TaskSplitBarrier const & split_barrier = batch.post_batch_split_barrier_signals[signal_i];
+                        record_split_barrier(cr, split_barrier_event_set.events[split_barrier.event_index], split_barrier, true);
+                    }
+                }
+
+                /// =============================================
+                /// ==== PRESENT SWAPCHAIN LAYOUT TRANSITION ====
+                /// =============================================
+
+                if (impl.present.has_value() && is_last_queue_job)
+                {
+                    AccessGroup const & last_access = impl.swapchain_image->access_timeline.back();
+                    bool const is_last_access_queue_submit = last_access.tasks[0].task->queue == queue && last_access.tasks[0].task->submit_index == submit_index;
+                    if (is_last_access_queue_submit)
+                    {
+                        cr.pipeline_image_barrier(ImageBarrierInfo{
+                            .src_access = Access{task_stage_to_pipeline_stage(last_access.stages), to_access_type(last_access.type)},
+                            .image = impl.swapchain_image->id.image,
+                            .layout_operation = ImageLayoutOperation::TO_PRESENT_SRC,
+                        });
+                    }
+                }
+
+                executable_command_lists[job_index] = cr.complete_current_commands();
+            };
+
+            auto staging_allocation_count = [&]() -> u64
+            {
+                u64 count = impl.staging_memory.has_value() ? impl.staging_memory->allocation_count() : 0;
+                for (auto const & worker_staging_memory : impl.worker_staging_memory)
+                {
+                    count += worker_staging_memory.allocation_count();
+                }
+                return count;
+            };
+            u64 const staging_allocations_before_recording = staging_allocation_count();
+            if (record_in_parallel)
+            {
+                struct ParallelRecordState
+                {
+                    decltype(record_job) * record = {};
+                    std::span<RecordJob> jobs = {};
+                };
+                ParallelRecordState parallel_record_state{&record_job, record_jobs};
+                impl.info.parallel_recording.blocking_parallel_for(
+                    impl.info.parallel_recording.user_data,
+                    record_job_count,
+                    &parallel_record_state,
+                    +[](void * ud, u32 job_index, u32 thread_index)
+                    {
+                        auto & s = *static_cast<ParallelRecordState *>(ud);
+                        (*s.record)(s.jobs[job_index], job_index, thread_index);
+                    });
+                for (u32 job_i = 0; job_i < record_job_count; ++job_i)
+                {
+                    if (job_needs_serial_recording[job_i])
+                    {
+                        DAXA_DBG_ASSERT_TRUE_M(false, "thread_index passed by blocking_parallel_for must be smaller than worker_thread_count");
+                        record_job(record_jobs[job_i], job_i, 0u);
+                    }
+                }
+            }
+            else
+            {
+                for (u32 job_i = 0; job_i < record_job_count; ++job_i)
+                {
+                    record_job(record_jobs[job_i], job_i, 0u);
+                }
+            }
+
+            /// ================================
+            /// ==== UPDATE RECORDING CACHE ====
+            /// ================================
+
+            std::span<ExecutableCommandList> submit_command_lists = executable_command_lists;
+            std::span<u32> submit_queue_first_command_list = queue_first_record_job;
+            if (cached_recording != nullptr)
+            {
+                cached_recording->last_used_execution = impl.execution_index;
+                submit_command_lists = cached_recording->command_lists;
+                submit_queue_first_command_list = std::span{cached_recording->queue_first_command_list.data(), submit.queue_indices.size()};
+            }
+            else if (use_recording_cache && submit_cacheable[submit_index])
+            {
+                // Staging memory allocations are reclaimed after the submit completed, recordings referencing them can not be reused.
+                bool const used_staging_memory = staging_allocation_count() != staging_allocations_before_recording;
+                impl.recording_used_staging_memory[submit_index] = used_staging_memory;
+                if (cache_recording && !used_staging_memory)
+                {
+                    // Replace the least recently used entry.
+                    RecordingCacheEntry * replaced_entry = &impl.recording_cache[submit_index][0];
+                    for (RecordingCacheEntry & entry : impl.recording_cache[submit_index])
+                    {
+                        if (entry.last_used_execution < replaced_entry->last_used_execution)
+                        {
+                            replaced_entry = &entry;
+                        }
+                    }
+                    replaced_entry->fingerprint = submit_fingerprints[submit_index];
+                    replaced_entry->last_used_execution = impl.execution_index;
+                    replaced_entry->command_lists.assign(executable_command_lists.begin(), executable_command_lists.end());
+                    std::copy(queue_first_record_job.begin(), queue_first_record_job.end(), replaced_entry->queue_first_command_list.begin());
                 }
+            }
+
+            for (u32 qi = 0; qi < submit.queue_indices.size(); ++qi)
+            {
+                u32 const queue_index = submit.queue_indices[qi];
+                Queue const queue = queue_index_to_queue(queue_index);
 
-                /// =====================================================================
-                /// ==== ACQUIRE, PRESENT AND LAYOUT TRANSITION SWAPCHAIN IMAGE SYNC ====
-                /// =====================================================================
+                // All queues allocate their spans of semaphores into the same stack array.
+                // Safe offset into the queue shared arrays for later use.
+                u64 const queue_wait_semaphores_first = wait_semaphore_count;
+                u64 const queue_signal_semaphores_first = signal_semaphore_count;
+                u64 const queue_signal_timeline_semaphores_first = signal_timeline_semaphore_count;
+
+                /// ==================================================
+                /// ==== ACQUIRE AND PRESENT SWAPCHAIN IMAGE SYNC ====
+                /// ==================================================
 
                 // Swapchain acquire sync:
-                bool const swapchain_image_used_in_graph = impl.swapchain_image != nullptr && impl.swapchain_image->access_timeline.size() > 0;
                 if (swapchain_image_used_in_graph)
                 {
                     Queue const first_swapchain_use_queue = impl.swapchain_image->access_timeline[0].tasks[0].task->queue;
@@ -3959,11 +4942,6 @@ namespace daxa
                     {
                         push_back_static(signal_semaphores, signal_semaphore_count, impl.info.swapchain->current_present_semaphore());
                         push_back_static(signal_timeline_semaphores, signal_timeline_semaphore_count, impl.info.swapchain->current_timeline_pair());
-                        cr.pipeline_image_barrier(ImageBarrierInfo{
-                            .src_access = Access{task_stage_to_pipeline_stage(last_access.stages), to_access_type(last_access.type)},
-                            .image = impl.swapchain_image->id.image,
-                            .layout_operation = ImageLayoutOperation::TO_PRESENT_SRC,
-                        });
                     }
                 }
 
@@ -3971,14 +4949,51 @@ namespace daxa
                 /// ==== WRITE SUBMIT INFO ====
                 /// ===========================
 
-                executable_command_lists[qi] = cr.complete_current_commands();
+                u32 const queue_command_list_count = (qi + 1 < submit.queue_indices.size() ? submit_queue_first_command_list[qi + 1] : static_cast<u32>(submit_command_lists.size())) - submit_queue_first_command_list[qi];
                 submit_infos[qi] = {};
-                submit_infos[qi].command_lists = std::span{&executable_command_lists[qi], 1}; // THIS IS KINDA DANGEROUS CODE. MAKE SURE THAT THIS POINTER STAYS VALID IN THE FUTURE!
+                submit_infos[qi].command_lists = submit_command_lists.subspan(submit_queue_first_command_list[qi], queue_command_list_count); // THIS IS KINDA DANGEROUS CODE. MAKE SURE THAT THIS POINTER STAYS VALID IN THE FUTURE!
                 submit_infos[qi].queue = queue;
                 submit_infos[qi].signal_binary_semaphores = {signal_semaphores.data() + queue_signal_semaphores_first, signal_semaphore_count - queue_signal_semaphores_first};
                 submit_infos[qi].signal_timeline_semaphores = {signal_timeline_semaphores.data() + queue_signal_timeline_semaphores_first, signal_timeline_semaphore_count - queue_signal_timeline_semaphores_first};
                 submit_infos[qi].wait_binary_semaphores = {wait_semaphores.data() + queue_wait_semaphores_first, wait_semaphore_count - queue_wait_semaphores_first};
                 submit_infos[qi].wait_queue_submit_indices = wait_queue_submit_indices;
+
+                if (impl.info.fine_grained_queue_sync)
+                {
+                    std::array<u64, DAXA_QUEUE_COUNT> queue_wait_values = {};
+                    u32 queue_wait_bits = {};
+                    for (u32 wait_queue_index = 0; wait_queue_index < DAXA_QUEUE_COUNT; ++wait_queue_index)
+                    {
+                        u32 const wait_submit = submit.queue_wait_submits[queue_index][wait_queue_index];
+                        if (wait_submit != ~0u)
+                        {
+                            queue_wait_values[wait_queue_index] = submit_queue_submit_indices[wait_submit][wait_queue_index];
+                            queue_wait_bits |= queue_index_to_queue_bit(wait_queue_index);
+                        }
+                        if ((external_resource_submit_queue_wait_bits[submit_index][queue_index] & queue_index_to_queue_bit(wait_queue_index)) != 0u)
+                        {
+                            queue_wait_values[wait_queue_index] = std::max(queue_wait_values[wait_queue_index], pre_graph_queue_submit_indices[wait_queue_index]);
+                            queue_wait_bits |= queue_index_to_queue_bit(wait_queue_index);
+                        }
+                        bool const accesses_graph_memory = (graph_memory_submit_queue_bits[submit_index] & queue_index_to_queue_bit(queue_index)) != 0u;
+                        if (accesses_graph_memory && impl.previous_execution_queue_submit_indices[wait_queue_index] != 0u)
+                        {
+                            queue_wait_values[wait_queue_index] = std::max(queue_wait_values[wait_queue_index], impl.previous_execution_queue_submit_indices[wait_queue_index]);
+                            queue_wait_bits |= queue_index_to_queue_bit(wait_queue_index);
+                        }
+                    }
+
+                    auto queue_wait_queue_submit_indices = tmp_memory.allocate_trivial_span<std::pair<Queue, u64>>(std::popcount(queue_wait_bits));
+                    u32 wait_i = 0;
+                    u32 queue_iter = queue_wait_bits;
+                    while (queue_iter)
+                    {
+                        u32 const wait_queue_index = queue_bits_to_first_queue_index(queue_iter);
+                        queue_iter &= ~queue_index_to_queue_bit(wait_queue_index);
+                        queue_wait_queue_submit_indices[wait_i++] = std::pair{queue_index_to_queue(wait_queue_index), queue_wait_values[wait_queue_index]};
+                    }
+                    submit_infos[qi].wait_queue_submit_indices = queue_wait_queue_submit_indices;
+                }
             }
 
             /// =====================================
@@ -3988,6 +5003,8 @@ namespace daxa
             for (u32 qi = 0; qi < submit.queue_indices.size(); ++qi)
             {
                 impl.info.device.submit_commands(submit_infos[qi]);
+                Queue const queue = queue_index_to_queue(submit.queue_indices[qi]);
+                submit_queue_submit_indices[submit_index][submit.queue_indices[qi]] = device.latest_queue_submit_index(queue);
             }
 
             /// =================
@@ -4005,10 +5022,35 @@ namespace daxa
             }
         }
 
+        split_barrier_event_set.last_submit_index = device.latest_submit_index();
+
+        for (u32 s = 0; s < impl.submits.size(); ++s)
+        {
+            for (u32 q = 0; q < DAXA_QUEUE_COUNT; ++q)
+            {
+                impl.previous_execution_queue_submit_indices[q] = std::max(impl.previous_execution_queue_submit_indices[q], submit_queue_submit_indices[s][q]);
+            }
+        }
+
+        // The old resources of moved persistent resources were copied by the submits above.
+        for (u32 r = 0; r < impl.resources.size(); ++r)
+        {
+            ImplTaskResource & resource = impl.resources[r];
+            if (!resource.relocated_from.buffer.is_empty())
+            {
+                destroy_non_external_resource_id(device, resource.kind, resource.relocated_from);
+                resource.relocated_from = {.buffer = {}};
+            }
+        }
+
         if (impl.staging_memory.has_value())
         {
             impl.staging_memory->reuse_memory_after_pending_submits();
         }
+        for (auto & worker_staging_memory : impl.worker_staging_memory)
+        {
+            worker_staging_memory.reuse_memory_after_pending_submits();
+        }
 
         /// =================================================
         /// ==== UPDATE PRE GRAPH EXTERNAL RESOURCE INFO ====
@@ -4050,6 +5092,15 @@ namespace daxa
         if (a_info.staging_memory_pool_size != 0)
         {
             this->staging_memory = TransferMemoryPool{TransferMemoryPoolInfo{.device = info.device, .capacity = info.staging_memory_pool_size, .name = "Transfer Memory Pool"}};
+            if (a_info.parallel_recording.blocking_parallel_for != nullptr)
+            {
+                DAXA_DBG_ASSERT_TRUE_M(a_info.parallel_recording.worker_thread_count > 0, "parallel_recording requires worker_thread_count to be set");
+                this->worker_staging_memory.reserve(a_info.parallel_recording.worker_thread_count);
+                for (u32 worker_i = 0; worker_i < a_info.parallel_recording.worker_thread_count; ++worker_i)
+                {
+                    this->worker_staging_memory.push_back(TransferMemoryPool{TransferMemoryPoolInfo{.device = info.device, .capacity = info.staging_memory_pool_size, .name = "Transfer Memory Pool (recording worker)"}});
+                }
+            }
         }
     }
 
@@ -4108,6 +5159,10 @@ namespace daxa
                 }
                 continue;
             }
+            if (!resource.relocated_from.buffer.is_empty())
+            {
+                destroy_non_external_resource_id(this->info.device, resource.kind, resource.relocated_from);
+            }
             switch (resource.kind)
             {
             case TaskResourceKind::BUFFER:
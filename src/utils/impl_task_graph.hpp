@@ -158,6 +158,7 @@ namespace daxa
         u32 clear_request_index = ~0u;
         std::pair<ImplTaskResource*, u32> double_buffer_pair_resource = {};
         u32 double_buffer_index = {};
+        bool resized = {}; // Set when the info changed after completion, the resource must be re-created.
 
         using IdUnion = union {
             BufferId buffer;
@@ -166,6 +167,9 @@ namespace daxa
             ImageId image;
         };
         IdUnion id;
+        // Set when a persistent resource was moved by a resize completion.
+        // The next execution copies the contents of this old resource into the new one, then destroys it.
+        IdUnion relocated_from = {.buffer = {}};
 
         union {
             struct
@@ -276,11 +280,32 @@ namespace daxa
         ImageLayoutOperation layout_operation = {};
     };
 
+    // Barriers between access groups that are separated by at least one batch on the same queue.
+    // The event is signaled after the last batch of the source access groups and waited on before the first batch of the destination access groups.
+    // Events are indexed into the SplitBarrierEventSet of the execution.
+    struct TaskSplitBarrier
+    {
+        u32 event_index = {};
+        std::span<TaskBarrier> barriers = {};
+        std::span<TaskBarrier> image_barriers = {};
+    };
+
+    // The next execution may be recorded while the previous ones are still pending on the gpu.
+    // Signaling or resetting an event that a pending execution still waits on is a race, so each execution in flight uses its own set of events.
+    // A set is reused once the gpu completed the last execution that used it.
+    struct SplitBarrierEventSet
+    {
+        std::vector<Event> events = {};
+        u64 last_submit_index = {};
+    };
+
     struct TasksBatch
     {
         std::span<std::pair<ImplTask*, u32>> tasks = {};
         std::span<TaskBarrier> pre_batch_barriers = {};
         std::span<TaskBarrier> pre_batch_image_barriers = {};
+        std::span<TaskSplitBarrier const *> pre_batch_split_barrier_waits = {};
+        std::span<TaskSplitBarrier> post_batch_split_barrier_signals = {};
     };
 
     struct TasksSubmit
@@ -292,6 +317,8 @@ namespace daxa
         std::array<std::span<TasksBatch>, DAXA_QUEUE_COUNT> queue_batches = {};
         std::array<std::string_view, DAXA_QUEUE_COUNT> queue_batch_cmd_recorder_labels = {};
         std::span<u32> queue_indices = {};
+        // Indexed with [queue_index][wait_queue_index]: the latest earlier submit the queue has to wait on for each other queue, ~0u when there is no dependency.
+        std::array<std::array<u32, DAXA_QUEUE_COUNT>, DAXA_QUEUE_COUNT> queue_wait_submits = {};
     };
 
     struct TaskGraphPresent
@@ -300,6 +327,18 @@ namespace daxa
         Queue queue = QUEUE_MAIN;
     };
 
+    static inline constexpr u32 RECORDING_CACHE_ENTRIES_PER_SUBMIT = 4;
+
+    // Command lists of a single submit, recorded with reusable command recorders.
+    // Several entries are kept per submit, as inputs like the swapchain image or double buffer resources alternate between executions.
+    struct RecordingCacheEntry
+    {
+        u64 fingerprint = {};
+        u64 last_used_execution = {};
+        std::vector<ExecutableCommandList> command_lists = {};
+        std::array<u32, DAXA_QUEUE_COUNT> queue_first_command_list = {}; // Indexed by position in TasksSubmit::queue_indices.
+    };
+
     struct ImplTaskGraph final : ImplHandle
     {
         ImplTaskGraph(TaskGraphInfo a_info); 
@@ -324,9 +363,21 @@ namespace daxa
         u32 flat_batch_count = {};                                                                              // total batch count ignoring async compute;
         u32 queue_bits = {};
         daxa::MemoryBlock resource_memory_block = {};
+        u32 split_barrier_event_count = {};
+        std::vector<SplitBarrierEventSet> split_barrier_event_sets = {};
+        TaskResourceMemoryReport memory_report = {};
         std::optional<daxa::TransferMemoryPool> staging_memory = {};
+        // One per parallel recording worker thread, as the pools are not thread safe.
+        std::vector<daxa::TransferMemoryPool> worker_staging_memory = {};
         std::optional<TaskGraphPresent> present = {};
         ImplTaskResource* swapchain_image = nullptr;
+        bool pending_resource_resizes = {};
+        std::vector<std::array<RecordingCacheEntry, RECORDING_CACHE_ENTRIES_PER_SUBMIT>> recording_cache = {};
+        // Whether the last recording of each submit used staging memory. Such submits are recorded one time submit, as their recordings are not cached.
+        std::vector<bool> recording_used_staging_memory = {};
+        u64 execution_index = {};
+        // Latest queue submit index of each queue used by the previous executions, waited on by fine grained queue sync.
+        std::array<u64, DAXA_QUEUE_COUNT> previous_execution_queue_submit_indices = {};
         
         static void zero_ref_callback(ImplHandle const * handle);
     };
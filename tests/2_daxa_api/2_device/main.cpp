@@ -1,5 +1,8 @@
 #include <daxa/daxa.hpp>
 #include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
 
 namespace tests
 {
@@ -93,6 +96,60 @@ namespace tests
         device.destroy_image(test_image);
         device.destroy_buffer(test_buffer);
     }
+    void sro_batched_creation(daxa::Instance & instance)
+    {
+        auto device = instance.create_device_2(instance.choose_device({}, {}));
+        std::array<daxa::BufferInfo, 64> buffer_infos = {};
+        std::array<daxa::ImageInfo, 64> image_infos = {};
+        buffer_infos.fill(test_buffer_info);
+        image_infos.fill(test_image_info);
+        std::array<daxa::BufferId, 64> buffers = {};
+        std::array<daxa::ImageId, 64> images = {};
+        device.create_buffers(buffer_infos, buffers);
+        device.create_images(image_infos, images);
+        for (u32 i = 0; i < buffers.size(); ++i)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(device.is_buffer_id_valid(buffers[i]), "batched buffer creation returned invalid id");
+            DAXA_DBG_ASSERT_TRUE_M(device.is_image_id_valid(images[i]), "batched image creation returned invalid id");
+        }
+        device.destroy_images(images);
+        device.destroy_buffers(buffers);
+        for (u32 i = 0; i < buffers.size(); ++i)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(!device.is_buffer_id_valid(buffers[i]), "batched buffer destruction left valid id");
+            DAXA_DBG_ASSERT_TRUE_M(!device.is_image_id_valid(images[i]), "batched image destruction left valid id");
+        }
+    }
+    void budgeted_garbage_collection(daxa::Instance & instance)
+    {
+        constexpr u64 ZOMBIE_COUNT = 32;
+        constexpr u64 BUDGET = 7;
+        auto device = instance.create_device_2(instance.choose_device({}, {}));
+        std::array<daxa::BufferInfo, ZOMBIE_COUNT> buffer_infos = {};
+        buffer_infos.fill(test_buffer_info);
+        std::array<daxa::BufferId, ZOMBIE_COUNT> buffers = {};
+        device.create_buffers(buffer_infos, buffers);
+        device.destroy_buffers(buffers);
+        device.wait_idle();
+        // Each call destroys at most BUDGET zombies, so the zombies take exactly ceil(ZOMBIE_COUNT / BUDGET) calls to collect.
+        constexpr u64 EXPECTED_CALLS = (ZOMBIE_COUNT + BUDGET - 1) / BUDGET;
+        u64 calls = 0;
+        u64 collected_objects = 0;
+        daxa::GarbageCollectionResult result = {};
+        while (!result.all_collected && calls <= EXPECTED_CALLS)
+        {
+            result = device.collect_garbage({.max_objects = BUDGET});
+            ++calls;
+            collected_objects += result.collected_objects;
+            DAXA_DBG_ASSERT_TRUE_M(result.collected_objects <= BUDGET, "budgeted garbage collection destroyed more zombies than allowed");
+            DAXA_DBG_ASSERT_TRUE_M(result.all_collected == (calls == EXPECTED_CALLS), "all_collected must only be reported by the last call");
+        }
+        DAXA_DBG_ASSERT_TRUE_M(calls == EXPECTED_CALLS, "budgeted garbage collection took the wrong number of calls");
+        DAXA_DBG_ASSERT_TRUE_M(collected_objects == ZOMBIE_COUNT, "budgeted garbage collection did not destroy all zombies");
+        // Nothing is left, an unbudgeted call reports everything collected without destroying anything.
+        result = device.collect_garbage({});
+        DAXA_DBG_ASSERT_TRUE_M(result.all_collected && result.collected_objects == 0, "zombies remained after budgeted garbage collection");
+    }
     void sro_aliased_suballocation(daxa::Instance & instance)
     {
         auto device = instance.create_device_2(instance.choose_device({}, {}));
@@ -150,6 +207,84 @@ namespace tests
         device.destroy_blas(test_blas);
         device.destroy_tlas(test_tlas);
     }
+    void sro_creation_throughput(daxa::Instance & instance)
+    {
+        // Measures end to end buffer creation and destruction throughput when many threads create and destroy resources concurrently.
+        // The time is dominated by the driver and memory allocator, resource slot allocation is only a small part of it.
+        // This does not benchmark the slot allocator itself, it only shows whether slot allocation stops creation from scaling with threads.
+        // Each thread collects garbage after every round, so all rounds after the first recycle slots from the free list.
+        auto device = instance.create_device_2(instance.choose_device({}, {}));
+        constexpr u32 BUFFERS_PER_THREAD = 256;
+        constexpr u32 ROUNDS = 4;
+        for (u32 thread_count = 1; thread_count <= 32; thread_count *= 2)
+        {
+            auto const start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads = {};
+            for (u32 t = 0; t < thread_count; ++t)
+            {
+                threads.push_back(std::thread([&]()
+                {
+                    std::vector<daxa::BufferId> buffers = {};
+                    buffers.reserve(BUFFERS_PER_THREAD);
+                    for (u32 round = 0; round < ROUNDS; ++round)
+                    {
+                        for (u32 i = 0; i < BUFFERS_PER_THREAD; ++i)
+                        {
+                            buffers.push_back(device.create_buffer(test_buffer_info));
+                        }
+                        for (auto buffer : buffers)
+                        {
+                            device.destroy_buffer(buffer);
+                        }
+                        buffers.clear();
+                        device.collect_garbage();
+                    }
+                }));
+            }
+            for (auto & thread : threads)
+            {
+                thread.join();
+            }
+            auto const end = std::chrono::steady_clock::now();
+            f64 const seconds = std::chrono::duration<f64>(end - start).count();
+            u64 const created = static_cast<u64>(thread_count) * BUFFERS_PER_THREAD * ROUNDS;
+            std::cout << "threads: " << thread_count << ", created buffers: " << created << ", buffers/s: " << static_cast<u64>(static_cast<f64>(created) / seconds) << std::endl;
+        }
+    }
+    void sro_destruction_throughput(daxa::Instance & instance)
+    {
+        // Measures buffer destruction throughput when many threads destroy resources concurrently.
+        // The buffers are created up front, so only the destruction is timed.
+        auto device = instance.create_device_2(instance.choose_device({}, {}));
+        constexpr u32 BUFFERS_PER_THREAD = 256;
+        for (u32 thread_count = 1; thread_count <= 32; thread_count *= 2)
+        {
+            std::vector<daxa::BufferInfo> buffer_infos(thread_count * BUFFERS_PER_THREAD, test_buffer_info);
+            std::vector<daxa::BufferId> buffers(buffer_infos.size());
+            device.create_buffers(buffer_infos, buffers);
+            auto const start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads = {};
+            for (u32 t = 0; t < thread_count; ++t)
+            {
+                threads.push_back(std::thread([&, t]()
+                {
+                    for (u32 i = 0; i < BUFFERS_PER_THREAD; ++i)
+                    {
+                        device.destroy_buffer(buffers[t * BUFFERS_PER_THREAD + i]);
+                    }
+                }));
+            }
+            for (auto & thread : threads)
+            {
+                thread.join();
+            }
+            auto const end = std::chrono::steady_clock::now();
+            device.collect_garbage();
+            f64 const seconds = std::chrono::duration<f64>(end - start).count();
+            u64 const destroyed = static_cast<u64>(thread_count) * BUFFERS_PER_THREAD;
+            std::cout << "threads: " << thread_count << ", destroyed buffers: " << destroyed << ", buffers/s: " << static_cast<u64>(static_cast<f64>(destroyed) / seconds) << std::endl;
+        }
+    }
 } // namespace tests
 
 auto main() -> int
@@ -158,8 +293,12 @@ auto main() -> int
     tests::simplest(instance);
     tests::device_selection(instance);
     tests::sro_creation(instance);
+    tests::sro_batched_creation(instance);
+    tests::budgeted_garbage_collection(instance);
     tests::sro_aliased_suballocation(instance);
     tests::sro_aliased_suballocation_host_memory(instance);
     tests::acceleration_structure_creation(instance);
+    tests::sro_creation_throughput(instance);
+    tests::sro_destruction_throughput(instance);
     std::cout << "completed all tests successfully!" << std::endl;
 }
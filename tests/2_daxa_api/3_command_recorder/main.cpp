@@ -1,7 +1,10 @@
 #include <daxa/daxa.hpp>
+#include <daxa/utils/pipeline_manager.hpp>
 #include <iostream>
 #include <chrono>
 #include <cstring>
+#include <thread>
+#include <vector>
 #include "../../0_common/shared.hpp"
 
 struct App
@@ -14,6 +17,47 @@ namespace tests
 {
     using namespace daxa::types;
 
+    auto create_pipeline_manager(App & app) -> daxa::PipelineManager
+    {
+        return daxa::PipelineManager({
+            .device = app.device,
+            .default_language = daxa::ShaderLanguage::GLSL,
+            .name = "command_recorder pipeline_manager",
+        });
+    }
+
+    // Fills the area covered by the viewport and scissor of an R32_UINT attachment with the pushed value.
+    auto create_fill_pipeline(daxa::PipelineManager & pipeline_manager) -> std::shared_ptr<daxa::RasterPipeline>
+    {
+        auto const source = daxa::ShaderCode{.string = R"glsl(
+            layout(push_constant) uniform Push { uint value; } push;
+            #if DAXA_SHADER_STAGE == 1
+            void main() {
+                vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+                gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+            }
+            #else
+            layout(location = 0) out uint color;
+            void main() {
+                color = push.value;
+            }
+            #endif
+        )glsl"};
+        auto result = pipeline_manager.add_raster_pipeline2({
+            .vertex_shader_info = daxa::ShaderCompileInfo2{.source = source},
+            .fragment_shader_info = daxa::ShaderCompileInfo2{.source = source},
+            .color_attachments = {{.format = daxa::Format::R32_UINT}},
+            .push_constant_size = sizeof(u32),
+            .name = "fill pipeline",
+        });
+        if (result.is_err())
+        {
+            std::cout << "failed to compile the fill pipeline: " << result.message() << std::endl;
+            exit(-1);
+        }
+        return result.value();
+    }
+
     void simplest(App & app)
     {
         auto recorder = app.device.create_command_recorder({});
@@ -596,6 +640,453 @@ namespace tests
             exit(-1);
         }
     }
+    void barrier_batching(App & app)
+    {
+        constexpr u32 SIZE = 16;
+        constexpr u32 BARRIER_COUNT = 64;
+        constexpr u32 CLEAR_VALUE = 0xDA7A;
+        daxa::ImageId const image = app.device.create_image({
+            .format = daxa::Format::R32_UINT,
+            .size = {SIZE, SIZE, 1},
+            .usage = daxa::ImageUsageFlagBits::TRANSFER_DST | daxa::ImageUsageFlagBits::TRANSFER_SRC,
+        });
+        daxa::ImageId const other_image = app.device.create_image({
+            .size = {SIZE, SIZE, 1},
+            .usage = daxa::ImageUsageFlagBits::TRANSFER_DST,
+        });
+        daxa::BufferId const readback_buffer = app.device.create_buffer({
+            .size = SIZE * SIZE * sizeof(u32),
+            .memory_flags = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "barrier_batching readback",
+        });
+
+        auto recorder = app.device.create_command_recorder({.name = "barrier_batching command list"});
+        // More barriers than fit a fixed size batch. State changes in between do not flush the batch.
+        for (u32 i = 0; i < BARRIER_COUNT; ++i)
+        {
+            recorder.pipeline_barrier({
+                .src_access = daxa::AccessConsts::TRANSFER_WRITE,
+                .dst_access = daxa::AccessConsts::TRANSFER_READ_WRITE,
+            });
+            recorder.begin_label({.name = "barrier_batching label"});
+            recorder.end_label();
+        }
+        // Image barriers on the same image are merged into a single layout transition.
+        // Barriers on different images stay separate barriers of the same batch.
+        recorder.pipeline_image_barrier({
+            .dst_access = daxa::AccessConsts::TRANSFER_WRITE,
+            .image = image,
+            .layout_operation = daxa::ImageLayoutOperation::TO_GENERAL,
+        });
+        recorder.pipeline_image_barrier({
+            .dst_access = daxa::AccessConsts::TRANSFER_WRITE,
+            .image = other_image,
+            .layout_operation = daxa::ImageLayoutOperation::TO_GENERAL,
+        });
+        for (u32 i = 0; i < BARRIER_COUNT; ++i)
+        {
+            recorder.pipeline_image_barrier({
+                .src_access = daxa::AccessConsts::TRANSFER_WRITE,
+                .dst_access = daxa::AccessConsts::TRANSFER_WRITE,
+                .image = image,
+            });
+        }
+        DAXA_DBG_ASSERT_TRUE_M(recorder.statistics().barrier_flushes == 0, "barriers were flushed before a command needed them");
+        recorder.clear_image({.image = image, .clear_value = std::array<u32, 4>{CLEAR_VALUE, 0, 0, 0}});
+        recorder.clear_image({.image = other_image, .clear_value = std::array<f32, 4>{1.0f, 0.0f, 0.0f, 1.0f}});
+
+        daxa::CommandRecorderStatistics statistics = recorder.statistics();
+        DAXA_DBG_ASSERT_TRUE_M(statistics.barrier_flushes == 1, "batched barriers were not recorded with a single flush");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.flushed_memory_barriers == BARRIER_COUNT, "wrong flushed memory barrier count");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.merged_image_barriers == BARRIER_COUNT, "barriers on the same image range were not merged");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.flushed_image_barriers == 2, "barriers on different images must not be merged");
+
+        // The cleared value is read back across another batch of merged barriers.
+        for (u32 i = 0; i < BARRIER_COUNT; ++i)
+        {
+            recorder.pipeline_image_barrier({
+                .src_access = daxa::AccessConsts::TRANSFER_WRITE,
+                .dst_access = daxa::AccessConsts::TRANSFER_READ,
+                .image = image,
+            });
+        }
+        recorder.copy_image_to_buffer({
+            .src_image = image,
+            .image_extent = {SIZE, SIZE, 1},
+            .dst_buffer = readback_buffer,
+        });
+        recorder.pipeline_barrier({
+            .src_access = daxa::AccessConsts::TRANSFER_WRITE,
+            .dst_access = daxa::AccessConsts::HOST_READ,
+        });
+
+        auto executable_commands = recorder.complete_current_commands();
+        statistics = recorder.statistics();
+        DAXA_DBG_ASSERT_TRUE_M(statistics.barrier_flushes == 3, "wrong barrier flush count");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.merged_image_barriers == 2 * BARRIER_COUNT - 1, "barriers on the same image range were not merged");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.flushed_image_barriers == 3, "wrong flushed image barrier count");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.flushed_memory_barriers == BARRIER_COUNT + 1, "wrong flushed memory barrier count");
+        app.device.submit_commands({
+            .command_lists = std::array{executable_commands},
+        });
+        app.device.wait_idle();
+
+        u32 const * texels = app.device.buffer_host_address_as<u32>(readback_buffer).value();
+        for (u32 texel = 0; texel < SIZE * SIZE; ++texel)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(texels[texel] == CLEAR_VALUE, "value written before the batched barriers was not read back");
+        }
+        app.device.destroy_buffer(readback_buffer);
+        app.device.destroy_image(other_image);
+        app.device.destroy_image(image);
+    }
+    void secondary_command_lists(App & app)
+    {
+        constexpr u32 SIZE = 64;
+        constexpr u32 SECONDARY_COUNT = 8;
+        constexpr u32 COLUMN_WIDTH = SIZE / SECONDARY_COUNT;
+        constexpr u32 PRIMARY_VALUE = 100;
+        constexpr u32 REUSABLE_VALUE = 200;
+
+        daxa::PipelineManager pipeline_manager = create_pipeline_manager(app);
+        std::shared_ptr<daxa::RasterPipeline> const fill_pipeline = create_fill_pipeline(pipeline_manager);
+
+        daxa::ImageId const image = app.device.create_image({
+            .format = daxa::Format::R32_UINT,
+            .size = {SIZE, SIZE, 1},
+            .usage = daxa::ImageUsageFlagBits::COLOR_ATTACHMENT | daxa::ImageUsageFlagBits::TRANSFER_SRC,
+        });
+        daxa::BufferId const readback_buffer = app.device.create_buffer({
+            .size = SIZE * SIZE * sizeof(u32),
+            .memory_flags = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "secondary_command_lists readback",
+        });
+        daxa::ViewportInfo const full_viewport = {.width = static_cast<f32>(SIZE), .height = static_cast<f32>(SIZE), .max_depth = 1.0f};
+        // The primary recorder draws into the bottom half, the secondaries each draw one column of the top half.
+        daxa::Rect2D const primary_scissor = {.y = SIZE / 2, .width = SIZE, .height = SIZE / 2};
+
+        // Secondary command lists for one render pass are recorded in parallel.
+        std::vector<daxa::ExecutableCommandList> secondary_commands(SECONDARY_COUNT);
+        std::vector<std::thread> threads = {};
+        for (u32 i = 0; i < SECONDARY_COUNT; ++i)
+        {
+            threads.push_back(std::thread([&, i]()
+            {
+                auto secondary = app.device.create_secondary_command_recorder({
+                    .color_attachment_formats = std::array{daxa::Format::R32_UINT},
+                    .name = "secondary_command_lists secondary",
+                });
+                // Pipeline and dynamic state are not inherited from the primary recorder.
+                secondary.set_pipeline(*fill_pipeline);
+                secondary.set_viewport(full_viewport);
+                secondary.set_scissor({.x = static_cast<i32>(i * COLUMN_WIDTH), .width = COLUMN_WIDTH, .height = SIZE / 2});
+                secondary.push_constant(i + 1);
+                secondary.draw({.vertex_count = 3});
+                secondary_commands[i] = secondary.complete_current_commands();
+            }));
+        }
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+
+        auto recorder = app.device.create_command_recorder({.name = "secondary_command_lists primary"});
+        recorder.pipeline_image_barrier({
+            .dst_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_WRITE,
+            .image = image,
+            .layout_operation = daxa::ImageLayoutOperation::TO_GENERAL,
+        });
+        auto render_recorder = std::move(recorder).begin_renderpass({
+            .color_attachments = std::array{daxa::RenderAttachmentInfo{
+                .image_view = image.default_view(),
+                .load_op = daxa::AttachmentLoadOp::CLEAR,
+                .clear_value = std::array<u32, 4>{0, 0, 0, 0},
+            }},
+            .render_area = {.width = SIZE, .height = SIZE},
+        });
+        render_recorder.set_pipeline(*fill_pipeline);
+        render_recorder.set_viewport(full_viewport);
+        render_recorder.set_scissor(primary_scissor);
+        render_recorder.push_constant(PRIMARY_VALUE);
+        render_recorder.draw({.vertex_count = 3});
+        recorder = std::move(render_recorder).end_renderpass();
+        recorder.pipeline_barrier({
+            .src_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_WRITE,
+            .dst_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_READ_WRITE,
+        });
+
+        render_recorder = std::move(recorder).begin_renderpass({
+            .color_attachments = std::array{daxa::RenderAttachmentInfo{.image_view = image.default_view(), .load_op = daxa::AttachmentLoadOp::LOAD}},
+            .render_area = {.width = SIZE, .height = SIZE},
+            .secondary_command_lists = true,
+        });
+        render_recorder.execute_commands(secondary_commands);
+        recorder = std::move(render_recorder).end_renderpass();
+        recorder.pipeline_barrier({
+            .src_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_WRITE,
+            .dst_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_READ_WRITE,
+        });
+
+        // The secondaries leave the command buffer state undefined, so the primary must bind everything again, even identical state.
+        daxa::CommandRecorderStatistics const statistics_before_rebind = recorder.statistics();
+        render_recorder = std::move(recorder).begin_renderpass({
+            .color_attachments = std::array{daxa::RenderAttachmentInfo{.image_view = image.default_view(), .load_op = daxa::AttachmentLoadOp::LOAD}},
+            .render_area = {.width = SIZE, .height = SIZE},
+        });
+        render_recorder.set_pipeline(*fill_pipeline);
+        render_recorder.set_viewport(full_viewport);
+        render_recorder.set_scissor(primary_scissor);
+        render_recorder.push_constant(PRIMARY_VALUE);
+        render_recorder.draw({.vertex_count = 3});
+        recorder = std::move(render_recorder).end_renderpass();
+        daxa::CommandRecorderStatistics const statistics = recorder.statistics();
+        DAXA_DBG_ASSERT_TRUE_M(statistics.elided_pipeline_binds == statistics_before_rebind.elided_pipeline_binds, "pipeline bind after execute_commands was elided");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.elided_descriptor_set_binds == statistics_before_rebind.elided_descriptor_set_binds, "descriptor set bind after execute_commands was elided");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.elided_push_constants == statistics_before_rebind.elided_push_constants, "push constant after execute_commands was elided");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.elided_viewports == statistics_before_rebind.elided_viewports, "viewport after execute_commands was elided");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.elided_scissors == statistics_before_rebind.elided_scissors, "scissor after execute_commands was elided");
+
+        recorder.pipeline_image_barrier({
+            .src_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_WRITE,
+            .dst_access = daxa::AccessConsts::TRANSFER_READ,
+            .image = image,
+        });
+        recorder.copy_image_to_buffer({
+            .src_image = image,
+            .image_extent = {SIZE, SIZE, 1},
+            .dst_buffer = readback_buffer,
+        });
+        recorder.pipeline_barrier({
+            .src_access = daxa::AccessConsts::TRANSFER_WRITE,
+            .dst_access = daxa::AccessConsts::HOST_READ,
+        });
+        auto executable_commands = recorder.complete_current_commands();
+        app.device.submit_commands({
+            .command_lists = std::array{executable_commands},
+        });
+        app.device.wait_idle();
+
+        u32 const * texels = app.device.buffer_host_address_as<u32>(readback_buffer).value();
+        for (u32 y = 0; y < SIZE; ++y)
+        {
+            for (u32 x = 0; x < SIZE; ++x)
+            {
+                u32 const expected = y < SIZE / 2 ? x / COLUMN_WIDTH + 1 : PRIMARY_VALUE;
+                DAXA_DBG_ASSERT_TRUE_M(texels[y * SIZE + x] == expected, "draw recorded in a secondary command list is missing");
+            }
+        }
+
+        // A reusable secondary command list is executed by a reusable primary that is submitted twice.
+        auto reusable_secondary = app.device.create_secondary_command_recorder({
+            .color_attachment_formats = std::array{daxa::Format::R32_UINT},
+            .name = "secondary_command_lists reusable secondary",
+            .reusable = true,
+        });
+        reusable_secondary.set_pipeline(*fill_pipeline);
+        reusable_secondary.set_viewport(full_viewport);
+        reusable_secondary.set_scissor({.width = SIZE, .height = SIZE});
+        reusable_secondary.push_constant(REUSABLE_VALUE);
+        reusable_secondary.draw({.vertex_count = 3});
+        auto reusable_secondary_commands = reusable_secondary.complete_current_commands();
+
+        auto reusable_recorder = app.device.create_command_recorder({.name = "secondary_command_lists reusable primary", .reusable = true});
+        reusable_recorder.pipeline_image_barrier({
+            .src_access = daxa::AccessConsts::TRANSFER_READ,
+            .dst_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_WRITE,
+            .image = image,
+        });
+        auto reusable_render_recorder = std::move(reusable_recorder).begin_renderpass({
+            .color_attachments = std::array{daxa::RenderAttachmentInfo{.image_view = image.default_view()}},
+            .render_area = {.width = SIZE, .height = SIZE},
+            .secondary_command_lists = true,
+        });
+        reusable_render_recorder.execute_commands(std::array{reusable_secondary_commands});
+        reusable_recorder = std::move(reusable_render_recorder).end_renderpass();
+        reusable_recorder.pipeline_image_barrier({
+            .src_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_WRITE,
+            .dst_access = daxa::AccessConsts::TRANSFER_READ,
+            .image = image,
+        });
+        reusable_recorder.copy_image_to_buffer({
+            .src_image = image,
+            .image_extent = {SIZE, SIZE, 1},
+            .dst_buffer = readback_buffer,
+        });
+        reusable_recorder.pipeline_barrier({
+            .src_access = daxa::AccessConsts::TRANSFER_WRITE,
+            .dst_access = daxa::AccessConsts::HOST_READ,
+        });
+        auto reusable_executable_commands = reusable_recorder.complete_current_commands();
+        // The primary keeps the secondary commands alive, the secondary command list handle can be released before submitting.
+        reusable_secondary_commands = {};
+        for (u32 i = 0; i < 2; ++i)
+        {
+            std::memset(app.device.buffer_host_address(readback_buffer).value(), 0, SIZE * SIZE * sizeof(u32));
+            app.device.submit_commands({
+                .command_lists = std::array{reusable_executable_commands},
+            });
+            app.device.wait_idle();
+            for (u32 texel = 0; texel < SIZE * SIZE; ++texel)
+            {
+                DAXA_DBG_ASSERT_TRUE_M(texels[texel] == REUSABLE_VALUE, "reusable secondary command list did not draw");
+            }
+        }
+        app.device.destroy_buffer(readback_buffer);
+        app.device.destroy_image(image);
+    }
+    void recorder_creation_throughput(App & app)
+    {
+        // Measures command recorder creation and retirement throughput when many threads record concurrently.
+        // Each thread collects garbage after every round, so all rounds after the first reuse retired command arenas.
+        constexpr u32 RECORDERS_PER_ROUND = 64;
+        constexpr u32 ROUNDS = 8;
+        for (u32 thread_count = 1; thread_count <= 32; thread_count *= 2)
+        {
+            auto const start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads = {};
+            for (u32 t = 0; t < thread_count; ++t)
+            {
+                threads.push_back(std::thread([&]()
+                {
+                    for (u32 round = 0; round < ROUNDS; ++round)
+                    {
+                        for (u32 i = 0; i < RECORDERS_PER_ROUND; ++i)
+                        {
+                            auto recorder = app.device.create_command_recorder({});
+                            [[maybe_unused]] auto executable_commands = recorder.complete_current_commands();
+                        }
+                        app.device.collect_garbage();
+                    }
+                }));
+            }
+            for (auto & thread : threads)
+            {
+                thread.join();
+            }
+            auto const end = std::chrono::steady_clock::now();
+            f64 const seconds = std::chrono::duration<f64>(end - start).count();
+            u64 const recorders = static_cast<u64>(thread_count) * RECORDERS_PER_ROUND * ROUNDS;
+            std::cout << "threads: " << thread_count << ", recorders: " << recorders << ", recorders/s: " << static_cast<u64>(static_cast<f64>(recorders) / seconds) << std::endl;
+        }
+    }
+    void redundant_state_elision(App & app)
+    {
+        constexpr u32 SIZE = 16;
+        constexpr u32 REPEATS = 16;
+        constexpr u32 PUSH_VALUE = 7;
+
+        daxa::PipelineManager pipeline_manager = create_pipeline_manager(app);
+        std::shared_ptr<daxa::RasterPipeline> const fill_pipeline = create_fill_pipeline(pipeline_manager);
+        // The compute pipeline uses a bigger push constant, so it has a different pipeline layout than the fill pipeline.
+        auto compute_result = pipeline_manager.add_compute_pipeline2({
+            .source = daxa::ShaderCode{.string = R"glsl(
+                layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+                layout(push_constant) uniform Push { uint value; uint padding; } push;
+                void main() {}
+            )glsl"},
+            .push_constant_size = 2 * sizeof(u32),
+            .name = "redundant_state_elision compute pipeline",
+        });
+        if (compute_result.is_err())
+        {
+            std::cout << "failed to compile the compute pipeline: " << compute_result.message() << std::endl;
+            exit(-1);
+        }
+        std::shared_ptr<daxa::ComputePipeline> const compute_pipeline = compute_result.value();
+
+        daxa::ImageId const image = app.device.create_image({
+            .format = daxa::Format::R32_UINT,
+            .size = {SIZE, SIZE, 1},
+            .usage = daxa::ImageUsageFlagBits::COLOR_ATTACHMENT | daxa::ImageUsageFlagBits::TRANSFER_SRC,
+        });
+        daxa::BufferId const readback_buffer = app.device.create_buffer({
+            .size = SIZE * SIZE * sizeof(u32),
+            .memory_flags = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "redundant_state_elision readback",
+        });
+
+        auto recorder = app.device.create_command_recorder({.name = "redundant_state_elision command list"});
+        // Only the first bind of the same pipeline reaches vulkan, the descriptor set is bound together with it.
+        for (u32 i = 0; i < REPEATS; ++i)
+        {
+            recorder.set_pipeline(*compute_pipeline);
+            recorder.push_constant(PUSH_VALUE);
+        }
+        daxa::CommandRecorderStatistics const compute_statistics = recorder.statistics();
+        DAXA_DBG_ASSERT_TRUE_M(compute_statistics.elided_pipeline_binds == REPEATS - 1, "redundant compute pipeline binds were not elided");
+        DAXA_DBG_ASSERT_TRUE_M(compute_statistics.elided_descriptor_set_binds == REPEATS - 1, "redundant compute descriptor set binds were not elided");
+        DAXA_DBG_ASSERT_TRUE_M(compute_statistics.elided_push_constants == REPEATS - 1, "redundant push constants were not elided");
+
+        recorder.pipeline_image_barrier({
+            .dst_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_WRITE,
+            .image = image,
+            .layout_operation = daxa::ImageLayoutOperation::TO_GENERAL,
+        });
+        auto render_recorder = std::move(recorder).begin_renderpass({
+            .color_attachments = std::array{daxa::RenderAttachmentInfo{.image_view = image.default_view()}},
+            .render_area = {.width = SIZE, .height = SIZE},
+        });
+        // Draw heavy passes often set the same state for every draw. Only the first of each call reaches vulkan.
+        // Each bind point tracks its own pipeline, the compute pipeline bound above must not elide the first raster bind.
+        // Binding the fill pipeline changes the pipeline layout, so the first push constant can not be elided even though the bytes are the same.
+        for (u32 i = 0; i < REPEATS; ++i)
+        {
+            render_recorder.set_pipeline(*fill_pipeline);
+            render_recorder.push_constant(PUSH_VALUE);
+            render_recorder.set_viewport({.width = static_cast<f32>(SIZE), .height = static_cast<f32>(SIZE), .max_depth = 1.0f});
+            render_recorder.set_scissor({.width = SIZE, .height = SIZE});
+            render_recorder.set_depth_bias({});
+            render_recorder.draw({.vertex_count = 3});
+        }
+        recorder = std::move(render_recorder).end_renderpass();
+
+        daxa::CommandRecorderStatistics const raster_statistics = recorder.statistics();
+        DAXA_DBG_ASSERT_TRUE_M(raster_statistics.elided_pipeline_binds - compute_statistics.elided_pipeline_binds == REPEATS - 1, "a compute pipeline bind elided a raster pipeline bind");
+        DAXA_DBG_ASSERT_TRUE_M(raster_statistics.elided_descriptor_set_binds - compute_statistics.elided_descriptor_set_binds == REPEATS - 1, "a compute descriptor set bind elided a raster descriptor set bind");
+        DAXA_DBG_ASSERT_TRUE_M(raster_statistics.elided_push_constants - compute_statistics.elided_push_constants == REPEATS - 1, "push constants were elided across a pipeline layout change");
+        DAXA_DBG_ASSERT_TRUE_M(raster_statistics.elided_viewports == REPEATS - 1, "redundant viewports were not elided");
+        DAXA_DBG_ASSERT_TRUE_M(raster_statistics.elided_scissors == REPEATS - 1, "redundant scissors were not elided");
+        DAXA_DBG_ASSERT_TRUE_M(raster_statistics.elided_depth_biases == REPEATS - 1, "redundant depth biases were not elided");
+
+        // The raster binds left the compute bind point untouched, rebinding the compute pipeline is elided.
+        // The push constant layout is the one of the fill pipeline now, so the first push after the bind reaches vulkan again.
+        recorder.set_pipeline(*compute_pipeline);
+        recorder.push_constant(PUSH_VALUE);
+        recorder.push_constant(PUSH_VALUE);
+        daxa::CommandRecorderStatistics const rebind_statistics = recorder.statistics();
+        DAXA_DBG_ASSERT_TRUE_M(rebind_statistics.elided_pipeline_binds - raster_statistics.elided_pipeline_binds == 1, "a raster pipeline bind reset the compute bind point");
+        DAXA_DBG_ASSERT_TRUE_M(rebind_statistics.elided_descriptor_set_binds - raster_statistics.elided_descriptor_set_binds == 1, "a raster descriptor set bind reset the compute bind point");
+        DAXA_DBG_ASSERT_TRUE_M(rebind_statistics.elided_push_constants - raster_statistics.elided_push_constants == 1, "push constant layout was not reset by the pipeline bind");
+
+        // The elided state still applies to every draw.
+        recorder.pipeline_image_barrier({
+            .src_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_WRITE,
+            .dst_access = daxa::AccessConsts::TRANSFER_READ,
+            .image = image,
+        });
+        recorder.copy_image_to_buffer({
+            .src_image = image,
+            .image_extent = {SIZE, SIZE, 1},
+            .dst_buffer = readback_buffer,
+        });
+        recorder.pipeline_barrier({
+            .src_access = daxa::AccessConsts::TRANSFER_WRITE,
+            .dst_access = daxa::AccessConsts::HOST_READ,
+        });
+        auto executable_commands = recorder.complete_current_commands();
+        app.device.submit_commands({
+            .command_lists = std::array{executable_commands},
+        });
+        app.device.wait_idle();
+
+        u32 const * texels = app.device.buffer_host_address_as<u32>(readback_buffer).value();
+        for (u32 texel = 0; texel < SIZE * SIZE; ++texel)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(texels[texel] == PUSH_VALUE, "draw with elided state wrote the wrong value");
+        }
+        app.device.destroy_buffer(readback_buffer);
+        app.device.destroy_image(image);
+    }
 } // namespace tests
 
 auto main() -> int
@@ -620,6 +1111,22 @@ auto main() -> int
         App app = {};
         tests::build_acceleration_structure(app);
     }
+    {
+        App app = {};
+        tests::redundant_state_elision(app);
+    }
+    {
+        App app = {};
+        tests::barrier_batching(app);
+    }
+    {
+        App app = {};
+        tests::secondary_command_lists(app);
+    }
+    {
+        App app = {};
+        tests::recorder_creation_throughput(app);
+    }
     // Tests how long the version in ids can last for a single index.
     // {
     //     App app = {};
@@ -3,6 +3,9 @@
 #include <0_common/window.hpp>
 #include <iostream>
 #include <thread>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
 
 #include <daxa/utils/pipeline_manager.hpp>
 #include <daxa/utils/task_graph.hpp>
@@ -185,6 +185,445 @@ namespace tests
         task_graph.execute({});
     }
 
+    void parallel_recording()
+    {
+        // TEST:
+        //    1) Record many independent batches on a bounded pool of worker threads
+        //    2) Verify every task callback was executed exactly once
+        //    3) Verify concurrently recording workers never share a staging allocator
+        static constexpr u32 WORKER_COUNT = 4;
+        AppContext app = {};
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .parallel_recording = {
+                .user_data = nullptr,
+                .blocking_parallel_for = [](void *, u32 count, void * task_user_data, void (*task_fn)(void *, u32, u32))
+                {
+                    std::atomic_uint32_t next_index = {};
+                    std::array<std::thread, WORKER_COUNT> workers = {};
+                    for (u32 worker_i = 0; worker_i < WORKER_COUNT; ++worker_i)
+                    {
+                        workers[worker_i] = std::thread([&, worker_i]()
+                                                        {
+                                                            for (u32 i = next_index++; i < count; i = next_index++)
+                                                            {
+                                                                task_fn(task_user_data, i, worker_i);
+                                                            } });
+                    }
+                    for (auto & worker : workers)
+                    {
+                        worker.join();
+                    }
+                },
+                .worker_thread_count = WORKER_COUNT,
+            },
+            .name = APPNAME_PREFIX("task_graph (parallel_recording)"),
+        });
+
+        static constexpr u32 TASK_COUNT = 16;
+        static std::atomic_uint32_t executed_tasks = {};
+        executed_tasks = 0;
+        static std::mutex allocator_users_mtx = {};
+        static std::unordered_map<daxa::TransferMemoryPool *, std::thread::id> allocator_users = {};
+        static bool allocator_shared_between_threads = false;
+        allocator_users.clear();
+        allocator_shared_between_threads = false;
+
+        auto buffer = task_graph.create_task_buffer({.size = sizeof(u32), .name = "parallel recording buffer"});
+        for (u32 i = 0; i < TASK_COUNT; ++i)
+        {
+            // Alternating writes and reads force a new batch for every task.
+            auto task = daxa::InlineTask::Transfer("parallel recording task");
+            if (i % 2 == 0)
+            {
+                task.writes(buffer);
+            }
+            else
+            {
+                task.reads(buffer);
+            }
+            task_graph.add_task(task.executes([](daxa::TaskInterface ti)
+                                              {
+                                                  executed_tasks += 1;
+                                                  DAXA_DBG_ASSERT_TRUE_M(ti.allocator != nullptr, "every worker must have a staging allocator");
+                                                  [[maybe_unused]] auto allocation = ti.allocator->allocate(sizeof(u32));
+                                                  std::lock_guard lock{allocator_users_mtx};
+                                                  auto [iter, inserted] = allocator_users.try_emplace(ti.allocator, std::this_thread::get_id());
+                                                  allocator_shared_between_threads = allocator_shared_between_threads || iter->second != std::this_thread::get_id(); }));
+        }
+        task_graph.submit({});
+        task_graph.complete({});
+        task_graph.execute({});
+
+        DAXA_DBG_ASSERT_TRUE_M(executed_tasks == TASK_COUNT, "all tasks must be recorded exactly once");
+        DAXA_DBG_ASSERT_TRUE_M(!allocator_shared_between_threads, "worker threads must not share a staging allocator");
+        app.device.wait_idle();
+        app.device.collect_garbage();
+    }
+
+    void recording_cache()
+    {
+        // TEST:
+        //    1) Execute a static graph multiple times with the recording cache enabled
+        //    2) Verify the task callback is only called when the recording fingerprint changes
+        AppContext app = {};
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .enable_recording_cache = true,
+            .name = APPNAME_PREFIX("task_graph (recording_cache)"),
+        });
+
+        static u32 recorded_tasks = {};
+        recorded_tasks = 0;
+
+        auto buffer = task_graph.create_task_buffer({.size = sizeof(u32), .name = "recording cache buffer"});
+        task_graph.add_task(daxa::InlineTask::Transfer("recording cache task")
+                                .writes(buffer)
+                                .executes([=](daxa::TaskInterface ti)
+                                          {
+                                              ti.recorder.clear_buffer({.buffer = ti.id(buffer), .size = sizeof(u32)});
+                                              recorded_tasks += 1; }));
+        task_graph.submit({});
+        task_graph.complete({});
+
+        task_graph.execute({.recording_fingerprint = 1});
+        task_graph.execute({.recording_fingerprint = 1});
+        task_graph.execute({.recording_fingerprint = 1});
+        DAXA_DBG_ASSERT_TRUE_M(recorded_tasks == 1, "unchanged executions must reuse the cached recording");
+
+        task_graph.execute({.recording_fingerprint = 2});
+        DAXA_DBG_ASSERT_TRUE_M(recorded_tasks == 2, "a changed recording fingerprint must re-record");
+
+        task_graph.execute({.recording_fingerprint = 1});
+        DAXA_DBG_ASSERT_TRUE_M(recorded_tasks == 2, "previous recordings must stay cached");
+
+        app.device.wait_idle();
+        app.device.collect_garbage();
+    }
+
+    void recording_cache_double_buffer_views()
+    {
+        // TEST:
+        //    1) Attach a non default view of a double buffered image to a task with the recording cache enabled
+        //    2) Execute multiple times, swapping the double buffer and recreating the view each time
+        //    3) Verify every execution re-records with a valid view of the current image
+        AppContext app = {};
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .enable_recording_cache = true,
+            .name = APPNAME_PREFIX("task_graph (recording_cache_double_buffer_views)"),
+        });
+
+        static u32 recorded_tasks = {};
+        static daxa::ImageViewId observed_view = {};
+        static daxa::ImageId observed_image = {};
+        recorded_tasks = 0;
+
+        auto image = task_graph.create_task_image({
+            .size = {64, 64, 1},
+            .mip_level_count = 2,
+            .lifetime_type = daxa::TaskResourceLifetimeType::PERSISTENT_DOUBLE_BUFFER,
+            .name = "double buffered image",
+        });
+        task_graph.add_task(daxa::InlineTask::Transfer("double buffered view task")
+                                .writes(daxa::ImageViewType::REGULAR_2D, image.mips(1))
+                                .executes([=](daxa::TaskInterface ti)
+                                          {
+                                              observed_view = ti.view(image);
+                                              observed_image = ti.id(image);
+                                              recorded_tasks += 1; }));
+        task_graph.submit({});
+        task_graph.complete({});
+
+        daxa::ImageViewId previous_view = {};
+        for (u32 i = 0; i < 4; ++i)
+        {
+            task_graph.execute({.recording_fingerprint = 1});
+            DAXA_DBG_ASSERT_TRUE_M(recorded_tasks == i + 1, "recreated attachment views must invalidate the cached recording");
+            DAXA_DBG_ASSERT_TRUE_M(app.device.is_id_valid(observed_view), "task must see a live attachment view");
+            DAXA_DBG_ASSERT_TRUE_M(app.device.image_view_info(observed_view).value().image == observed_image, "attachment view must belong to the current double buffer image");
+            DAXA_DBG_ASSERT_TRUE_M(observed_view != previous_view, "swapping the double buffer must recreate the attachment view");
+            previous_view = observed_view;
+        }
+
+        app.device.wait_idle();
+        app.device.collect_garbage();
+    }
+
+    void resize_transient_image()
+    {
+        // TEST:
+        //    1) Complete and execute a graph with a transient image
+        //    2) Resize the image and complete the graph again
+        //    3) Verify that the task sees the resized image
+        AppContext app = {};
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .name = APPNAME_PREFIX("task_graph (resize_transient_image)"),
+        });
+
+        static daxa::Extent3D observed_size = {};
+
+        auto image = task_graph.create_task_image({.size = {64, 64, 1}, .name = "resized image"});
+        task_graph.add_task(daxa::InlineTask::Transfer("clear resized image")
+                                .writes(image)
+                                .executes([=](daxa::TaskInterface ti)
+                                          {
+                                              ti.recorder.clear_image({.image = ti.id(image)});
+                                              observed_size = ti.info(image).value().size; }));
+        task_graph.submit({});
+        task_graph.complete({});
+        task_graph.execute({});
+        DAXA_DBG_ASSERT_TRUE_M(observed_size == (daxa::Extent3D{64, 64, 1}), "task must see the initial image size");
+
+        task_graph.resize_task_image(image, {128, 128, 1});
+        task_graph.complete({});
+        task_graph.execute({});
+        DAXA_DBG_ASSERT_TRUE_M(observed_size == (daxa::Extent3D{128, 128, 1}), "task must see the resized image");
+        DAXA_DBG_ASSERT_TRUE_M(task_graph.task_image_info(image).size == (daxa::Extent3D{128, 128, 1}), "resize must be reflected in the task image info");
+
+        app.device.wait_idle();
+        app.device.collect_garbage();
+    }
+
+    void resize_keeps_moved_persistent_contents()
+    {
+        // TEST:
+        //    1) Write a persistent buffer once and read it back every execution
+        //    2) Grow another persistent buffer, forcing a new resource memory block and moving the first buffer
+        //    3) Verify the moved buffer kept its contents while only the resized buffer is re-initialized
+        AppContext app = {};
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .name = APPNAME_PREFIX("task_graph (resize_keeps_moved_persistent_contents)"),
+        });
+
+        auto readback_buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32),
+            .memory_flags = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "moved persistent readback buffer",
+        });
+        auto task_readback_buffer = daxa::ExternalTaskBuffer({.buffer = readback_buffer, .name = "moved persistent readback buffer"});
+        task_graph.register_buffer(task_readback_buffer);
+
+        auto kept_buffer = task_graph.create_task_buffer({.size = sizeof(daxa::u32), .lifetime_type = daxa::TaskResourceLifetimeType::PERSISTENT, .name = "kept buffer"});
+        auto grown_buffer = task_graph.create_task_buffer({.size = 256, .lifetime_type = daxa::TaskResourceLifetimeType::PERSISTENT, .name = "grown buffer"});
+
+        static bool write_kept_buffer = {};
+        task_graph.add_task(daxa::InlineTask::Transfer("write kept buffer")
+                                .writes(kept_buffer)
+                                .writes(grown_buffer)
+                                .executes([=](daxa::TaskInterface ti)
+                                          {
+                                              if (write_kept_buffer)
+                                              {
+                                                  ti.recorder.clear_buffer({.buffer = ti.id(kept_buffer), .size = sizeof(daxa::u32), .clear_value = 7u});
+                                              } }));
+        task_graph.add_task(daxa::InlineTask::Transfer("read kept buffer")
+                                .reads(kept_buffer)
+                                .writes(task_readback_buffer)
+                                .executes([=](daxa::TaskInterface ti)
+                                          { ti.recorder.copy_buffer_to_buffer({.src_buffer = ti.id(kept_buffer), .dst_buffer = ti.id(task_readback_buffer), .size = sizeof(daxa::u32)}); }));
+        task_graph.submit({});
+        task_graph.complete({});
+
+        write_kept_buffer = true;
+        task_graph.execute({});
+        app.device.wait_idle();
+        DAXA_DBG_ASSERT_TRUE_M(*app.device.buffer_host_address_as<daxa::u32>(readback_buffer).value() == 7u, "persistent buffer must be written");
+
+        u64 const memory_block_size = task_graph.get_resource_memory_block_size();
+        write_kept_buffer = false;
+        task_graph.resize_task_buffer(grown_buffer, 1u << 20u);
+        task_graph.complete({});
+        DAXA_DBG_ASSERT_TRUE_M(task_graph.get_resource_memory_block_size() > memory_block_size, "growing a buffer must grow the resource memory block");
+        for (u32 i = 0; i < 2; ++i)
+        {
+            task_graph.execute({});
+            app.device.wait_idle();
+            DAXA_DBG_ASSERT_TRUE_M(*app.device.buffer_host_address_as<daxa::u32>(readback_buffer).value() == 7u, "moved persistent buffer must keep its contents");
+        }
+
+        app.device.destroy_buffer(readback_buffer);
+        app.device.collect_garbage();
+    }
+
+    void transient_aliasing_strategies()
+    {
+        // TEST:
+        //    1) Create a chain of transient buffers of different sizes, each only alive for two tasks
+        //    2) Complete the graph with each aliasing strategy
+        //    3) Verify the memory report and that aliasing never increases the resource memory block size
+        AppContext app = {};
+        std::array<u64, 6> const buffer_sizes = {1u << 20u, 1u << 16u, 1u << 18u, 1u << 20u, 1u << 12u, 1u << 19u};
+        for (u32 s = 0; s < static_cast<u32>(daxa::TaskResourceAliasingStrategy::MAX_ENUM); ++s)
+        {
+            auto const strategy = static_cast<daxa::TaskResourceAliasingStrategy>(s);
+            auto task_graph = daxa::TaskGraph({
+                .device = app.device,
+                .alias_transients = true,
+                .aliasing_strategy = strategy,
+                .name = APPNAME_PREFIX("task_graph (transient_aliasing_strategies)"),
+            });
+
+            auto previous_buffer = task_graph.create_task_buffer({.size = buffer_sizes[0], .name = "chain buffer"});
+            task_graph.add_task(daxa::InlineTask::Transfer("chain task")
+                                    .writes(previous_buffer)
+                                    .executes([=](daxa::TaskInterface ti)
+                                              { ti.recorder.clear_buffer({.buffer = ti.id(previous_buffer), .size = buffer_sizes[0]}); }));
+            for (u32 b = 1; b < buffer_sizes.size(); ++b)
+            {
+                auto buffer = task_graph.create_task_buffer({.size = buffer_sizes[b], .name = "chain buffer"});
+                u64 const buffer_size = buffer_sizes[b];
+                task_graph.add_task(daxa::InlineTask::Transfer("chain task")
+                                        .reads(previous_buffer)
+                                        .writes(buffer)
+                                        .executes([=](daxa::TaskInterface ti)
+                                                  { ti.recorder.clear_buffer({.buffer = ti.id(buffer), .size = buffer_size}); }));
+                previous_buffer = buffer;
+            }
+            task_graph.submit({});
+            task_graph.complete({});
+            task_graph.execute({});
+
+            auto const report = task_graph.get_resource_memory_report();
+            std::cout << "aliasing strategy " << daxa::to_string(strategy) << ": " << report.resource_memory_block_size << " bytes, non aliased: " << report.non_aliased_size << " bytes" << std::endl;
+            DAXA_DBG_ASSERT_TRUE_M(report.aliasing_enabled && report.aliasing_strategy == strategy, "report must describe the graphs aliasing settings");
+            DAXA_DBG_ASSERT_TRUE_M(report.resource_memory_block_size == report.aliasing_strategy_sizes[s], "report must contain the selected strategies size");
+            DAXA_DBG_ASSERT_TRUE_M(report.resource_memory_block_size == task_graph.get_resource_memory_block_size(), "report must match the resource memory block");
+            DAXA_DBG_ASSERT_TRUE_M(report.resource_memory_block_size <= report.non_aliased_size, "aliasing must never increase the resource memory block size");
+
+            app.device.wait_idle();
+            app.device.collect_garbage();
+        }
+    }
+
+    void split_barriers()
+    {
+        // TEST:
+        //    1) Write a transient buffer, then write an unrelated buffer twice, then copy the first buffer to a readback buffer
+        //    2) Without reordering each task gets its own batch, so the first buffers barrier is split over two batches
+        //    3) Verify the readback buffer contents after each execution
+        AppContext app = {};
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .reorder_tasks = false,
+            .use_split_barriers = true,
+            .name = APPNAME_PREFIX("task_graph (split_barriers)"),
+        });
+
+        auto readback_buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32),
+            .memory_flags = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "split barrier readback buffer",
+        });
+        auto task_readback_buffer = daxa::ExternalTaskBuffer({.buffer = readback_buffer, .name = "split barrier readback buffer"});
+        task_graph.register_buffer(task_readback_buffer);
+
+        auto split_buffer = task_graph.create_task_buffer({.size = sizeof(daxa::u32), .name = "split buffer"});
+        auto unrelated_buffer = task_graph.create_task_buffer({.size = sizeof(daxa::u32), .name = "unrelated buffer"});
+
+        static daxa::u32 clear_value = {};
+        task_graph.add_task(daxa::InlineTask::Transfer("write split buffer")
+                                .writes(split_buffer)
+                                .executes([=](daxa::TaskInterface ti)
+                                          { ti.recorder.clear_buffer({.buffer = ti.id(split_buffer), .size = sizeof(daxa::u32), .clear_value = clear_value}); }));
+        for (u32 i = 0; i < 2; ++i)
+        {
+            task_graph.add_task(daxa::InlineTask::Transfer("write unrelated buffer")
+                                    .writes(unrelated_buffer)
+                                    .executes([=](daxa::TaskInterface ti)
+                                              { ti.recorder.clear_buffer({.buffer = ti.id(unrelated_buffer), .size = sizeof(daxa::u32)}); }));
+        }
+        task_graph.add_task(daxa::InlineTask::Transfer("read split buffer")
+                                .reads(split_buffer)
+                                .writes(task_readback_buffer)
+                                .executes([=](daxa::TaskInterface ti)
+                                          { ti.recorder.copy_buffer_to_buffer({.src_buffer = ti.id(split_buffer), .dst_buffer = ti.id(task_readback_buffer), .size = sizeof(daxa::u32)}); }));
+        task_graph.submit({});
+        task_graph.complete({});
+
+        for (daxa::u32 execution = 1; execution < 4; ++execution)
+        {
+            clear_value = execution;
+            task_graph.execute({});
+            app.device.wait_idle();
+            DAXA_DBG_ASSERT_TRUE_M(*app.device.buffer_host_address_as<daxa::u32>(readback_buffer).value() == execution, "split barrier must make the write visible to the read");
+        }
+
+        // Executions in flight must not share events.
+        for (daxa::u32 execution = 4; execution < 8; ++execution)
+        {
+            clear_value = execution;
+            task_graph.execute({});
+        }
+        app.device.wait_idle();
+        DAXA_DBG_ASSERT_TRUE_M(*app.device.buffer_host_address_as<daxa::u32>(readback_buffer).value() == 7, "split barriers of executions in flight must not interfere");
+
+        app.device.destroy_buffer(readback_buffer);
+        app.device.collect_garbage();
+    }
+
+    void fine_grained_queue_sync()
+    {
+        // TEST:
+        //    1) Submit 0 writes a buffer on the main queue
+        //    2) Submit 1 writes an unrelated buffer on an async compute queue and reads the first buffer on the main queue
+        //    3) Only the main queue depends on submit 0, the compute queue is free to overlap with it
+        //    4) Verify the readback buffer contents after each execution
+        AppContext app = {};
+        if (app.device.queue_count(daxa::QueueType::COMPUTE) == 0)
+        {
+            return;
+        }
+        auto task_graph = daxa::TaskGraph({
+            .device = app.device,
+            .fine_grained_queue_sync = true,
+            .name = APPNAME_PREFIX("task_graph (fine_grained_queue_sync)"),
+        });
+
+        auto readback_buffer = app.device.create_buffer({
+            .size = sizeof(daxa::u32),
+            .memory_flags = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "queue sync readback buffer",
+        });
+        auto task_readback_buffer = daxa::ExternalTaskBuffer({.buffer = readback_buffer, .name = "queue sync readback buffer"});
+        task_graph.register_buffer(task_readback_buffer);
+
+        auto main_buffer = task_graph.create_task_buffer({.size = sizeof(daxa::u32), .name = "main buffer"});
+        auto compute_buffer = task_graph.create_task_buffer({.size = sizeof(daxa::u32), .name = "compute buffer"});
+
+        static daxa::u32 clear_value = {};
+        task_graph.add_task(daxa::InlineTask::Transfer("write main buffer")
+                                .writes(main_buffer)
+                                .executes([=](daxa::TaskInterface ti)
+                                          { ti.recorder.clear_buffer({.buffer = ti.id(main_buffer), .size = sizeof(daxa::u32), .clear_value = clear_value}); }));
+        task_graph.submit({});
+        task_graph.add_task(daxa::InlineTask::Transfer("write compute buffer")
+                                .uses_queue(daxa::QUEUE_COMPUTE_0)
+                                .writes(compute_buffer)
+                                .executes([=](daxa::TaskInterface ti)
+                                          { ti.recorder.clear_buffer({.buffer = ti.id(compute_buffer), .size = sizeof(daxa::u32)}); }));
+        task_graph.add_task(daxa::InlineTask::Transfer("read main buffer")
+                                .reads(main_buffer)
+                                .writes(task_readback_buffer)
+                                .executes([=](daxa::TaskInterface ti)
+                                          { ti.recorder.copy_buffer_to_buffer({.src_buffer = ti.id(main_buffer), .dst_buffer = ti.id(task_readback_buffer), .size = sizeof(daxa::u32)}); }));
+        task_graph.submit({});
+        task_graph.complete({});
+
+        for (daxa::u32 execution = 1; execution < 4; ++execution)
+        {
+            clear_value = execution;
+            task_graph.execute({});
+            app.device.wait_idle();
+            DAXA_DBG_ASSERT_TRUE_M(*app.device.buffer_host_address_as<daxa::u32>(readback_buffer).value() == execution, "the main queue must wait on the earlier submit that wrote the buffer");
+        }
+
+        app.device.destroy_buffer(readback_buffer);
+        app.device.collect_garbage();
+    }
+
     void write_read_image()
     {
         // TEST:
@@ -961,6 +1400,14 @@ auto main() -> i32
     tests::read_on_readwriteconcurrent();
     tests::simplest();
     tests::execution();
+    tests::parallel_recording();
+    tests::recording_cache();
+    tests::recording_cache_double_buffer_views();
+    tests::resize_transient_image();
+    tests::resize_keeps_moved_persistent_contents();
+    tests::transient_aliasing_strategies();
+    tests::split_barriers();
+    tests::fine_grained_queue_sync();
     tests::write_read_image();
     tests::write_read_image_layer();
     tests::create_transfer_read_buffer();
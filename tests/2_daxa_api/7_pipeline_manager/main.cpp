@@ -6,6 +6,8 @@ using namespace daxa::types;
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <filesystem>
+#include <fstream>
 
 #define APPNAME "Daxa API Sample Pipeline Compiler"
 #define APPNAME_PREFIX(x) ("[" APPNAME "] " x)
@@ -128,6 +130,384 @@ namespace tests
         return 0;
     }
 
+    auto hot_reload_watcher(daxa::Device & device) -> i32
+    {
+        std::filesystem::path const test_folder = "my/hot_reload_watcher_test";
+        std::filesystem::remove_all(test_folder);
+        std::filesystem::create_directories(test_folder / "src");
+        auto write_file = [](std::filesystem::path const & path, std::string_view contents)
+        {
+            auto file = std::ofstream{path, std::ios::trunc};
+            file << contents;
+        };
+        write_file(test_folder / "src/common.glsl", "#define VALUE 1u\n");
+        write_file(test_folder / "src/main.glsl", R"glsl(
+            #include "common.glsl"
+            layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+            layout(push_constant) uniform Push { uint value; } push;
+            shared uint accumulator;
+            void main() {
+                accumulator = push.value + VALUE;
+            }
+        )glsl");
+
+        daxa::PipelineManager pipeline_manager = daxa::PipelineManager({
+            .device = device,
+            .root_paths = {test_folder / "src"},
+            .default_language = daxa::ShaderLanguage::GLSL,
+            .name = APPNAME_PREFIX("pipeline_manager"),
+        });
+        auto compilation_result = pipeline_manager.add_compute_pipeline2({
+            .source = daxa::ShaderFile{"main.glsl"},
+            .push_constant_size = sizeof(u32),
+            .name = APPNAME_PREFIX("hot_reload_watcher_test"),
+        });
+        if (compilation_result.is_err())
+        {
+            std::cerr << compilation_result.message() << std::endl;
+            return -1;
+        }
+
+        // reload_all only checks a pipeline every 250ms.
+        auto reload_after_cooldown = [&]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            return pipeline_manager.reload_all();
+        };
+        if (!daxa::holds_alternative<daxa::NoPipelineChanged>(reload_after_cooldown()))
+        {
+            std::cerr << "Pipeline was reloaded without any source changes!\n";
+            return -1;
+        }
+        write_file(test_folder / "src/unrelated.glsl", "#define UNRELATED\n");
+        if (!daxa::holds_alternative<daxa::NoPipelineChanged>(reload_after_cooldown()))
+        {
+            std::cerr << "Pipeline was reloaded after a change to a file it does not include!\n";
+            return -1;
+        }
+        auto const old_write_time = std::filesystem::last_write_time(test_folder / "src/common.glsl");
+        write_file(test_folder / "src/common.glsl", "#define VALUE 2u\n");
+        std::filesystem::last_write_time(test_folder / "src/common.glsl", old_write_time + std::chrono::seconds(2));
+        if (!daxa::holds_alternative<daxa::PipelineReloadSuccess>(reload_after_cooldown()))
+        {
+            std::cerr << "Pipeline was not reloaded after its include changed!\n";
+            return -1;
+        }
+
+        return 0;
+    }
+
+    auto async_reload(daxa::Device & device) -> i32
+    {
+        std::filesystem::path const test_folder = "my/async_reload_test";
+        std::filesystem::remove_all(test_folder);
+        std::filesystem::create_directories(test_folder / "src");
+        auto write_file = [](std::filesystem::path const & path, std::string_view contents)
+        {
+            auto file = std::ofstream{path, std::ios::trunc};
+            file << contents;
+        };
+        write_file(test_folder / "src/common.glsl", "#define VALUE 1u\n");
+        write_file(test_folder / "src/main.glsl", R"glsl(
+            #include "common.glsl"
+            layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+            layout(push_constant) uniform Push { uint value; } push;
+            shared uint accumulator;
+            void main() {
+                accumulator = push.value + VALUE;
+            }
+        )glsl");
+
+        daxa::PipelineManager pipeline_manager = daxa::PipelineManager({
+            .device = device,
+            .root_paths = {test_folder / "src"},
+            .default_language = daxa::ShaderLanguage::GLSL,
+            .name = APPNAME_PREFIX("pipeline_manager"),
+        });
+        auto compilation_result = pipeline_manager.add_compute_pipeline2({
+            .source = daxa::ShaderFile{"main.glsl"},
+            .push_constant_size = sizeof(u32),
+            .name = APPNAME_PREFIX("async_reload_test"),
+        });
+        if (compilation_result.is_err())
+        {
+            std::cerr << compilation_result.message() << std::endl;
+            return -1;
+        }
+        auto pipeline = compilation_result.value();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        if (!daxa::holds_alternative<daxa::NoPipelineChanged>(pipeline_manager.poll_reloads()) || pipeline_manager.reload_in_progress())
+        {
+            std::cerr << "Background reload started without any source changes!\n";
+            return -1;
+        }
+
+        auto const old_write_time = std::filesystem::last_write_time(test_folder / "src/common.glsl");
+        write_file(test_folder / "src/common.glsl", "#define VALUE 2u\n");
+        std::filesystem::last_write_time(test_folder / "src/common.glsl", old_write_time + std::chrono::seconds(2));
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+        // Simulates a frame loop: the old pipeline stays usable until poll_reloads swaps the new one in.
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        auto reload_result = pipeline_manager.poll_reloads();
+        while (daxa::holds_alternative<daxa::NoPipelineChanged>(reload_result) && std::chrono::steady_clock::now() < deadline)
+        {
+            if (!pipeline->is_valid())
+            {
+                std::cerr << "Pipeline became invalid while the background reload was running!\n";
+                return -1;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            reload_result = pipeline_manager.poll_reloads();
+        }
+        if (auto * reload_err = daxa::get_if<daxa::PipelineReloadError>(&reload_result))
+        {
+            std::cerr << reload_err->message << std::endl;
+            return -1;
+        }
+        if (!daxa::holds_alternative<daxa::PipelineReloadSuccess>(reload_result) || !pipeline->is_valid())
+        {
+            std::cerr << "Background reload did not swap in the changed pipeline!\n";
+            return -1;
+        }
+
+        return 0;
+    }
+
+    auto shared_stage_cache(daxa::Device & device) -> i32
+    {
+        static constexpr u32 PIPELINE_COUNT = 8;
+        daxa::PipelineManager pipeline_manager = daxa::PipelineManager({
+            .device = device,
+            .default_language = daxa::ShaderLanguage::GLSL,
+            .name = APPNAME_PREFIX("pipeline_manager"),
+        });
+        pipeline_manager.add_virtual_file({
+            .name = "shared_stage_common",
+            .contents = "#define VALUE 1u\n",
+        });
+        auto const source = daxa::ShaderCode{.string = R"glsl(
+            #include <shared_stage_common>
+            layout(local_size_x = 1, local_size_y = 1, local_size_z = 1) in;
+            layout(push_constant) uniform Push { uint value; } push;
+            shared uint accumulator;
+            void main() {
+                accumulator = push.value + VALUE + VARIANT;
+            }
+        )glsl"};
+        auto add_pipeline = [&](u32 variant)
+        {
+            return pipeline_manager.add_compute_pipeline2({
+                .source = source,
+                .defines = {{"VARIANT", std::to_string(variant)}},
+                .push_constant_size = sizeof(u32),
+                .name = APPNAME_PREFIX("shared_stage_cache_test"),
+            });
+        };
+
+        // Identical stages compile once, a different define is a different stage.
+        for (u32 i = 0; i < PIPELINE_COUNT; ++i)
+        {
+            if (auto result = add_pipeline(0); result.is_err())
+            {
+                std::cerr << result.message() << std::endl;
+                return -1;
+            }
+        }
+        if (add_pipeline(1).is_err())
+        {
+            std::cerr << "Failed to compile the shared stage cache test pipeline variant!\n";
+            return -1;
+        }
+        auto stats = pipeline_manager.stage_cache_stats();
+        if (stats.compiles != 2 || stats.memory_hits != PIPELINE_COUNT - 1 || stats.disk_hits != 0)
+        {
+            std::cerr << "Unexpected stage cache stats: " << stats.compiles << " compiles, " << stats.memory_hits << " memory hits, " << stats.disk_hits << " disk hits\n";
+            return -1;
+        }
+
+        // Changing an include invalidates the cached stage.
+        pipeline_manager.add_virtual_file({
+            .name = "shared_stage_common",
+            .contents = "#define VALUE 2u\n",
+        });
+        if (add_pipeline(0).is_err() || pipeline_manager.stage_cache_stats().compiles != 3)
+        {
+            std::cerr << "Cached stage was reused after its include changed!\n";
+            return -1;
+        }
+
+        return 0;
+    }
+
+    auto spirv_cache_index(daxa::Device & device) -> i32
+    {
+        static constexpr u32 PIPELINE_COUNT = 32;
+        std::filesystem::path const test_folder = "my/spirv_cache_index_test";
+        std::filesystem::remove_all(test_folder);
+        std::filesystem::create_directories(test_folder / "src");
+        auto write_file = [](std::filesystem::path const & path, std::string_view contents)
+        {
+            auto file = std::ofstream{path, std::ios::trunc};
+            file << contents;
+        };
+        write_file(test_folder / "src/common.glsl", "uint scramble(uint v) { return v * 1664525u + 1013904223u; }\n");
+        write_file(test_folder / "src/main.glsl", R"glsl(
+            #include "common.glsl"
+            layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+            layout(push_constant) uniform Push { uint value; } push;
+            shared uint accumulator[64];
+            void main() {
+                accumulator[gl_LocalInvocationIndex] = scramble(push.value + VARIANT);
+            }
+        )glsl");
+
+        using Clock = std::chrono::high_resolution_clock;
+        auto compile_pipelines = [&](bool & any_failed) -> f32
+        {
+            daxa::PipelineManager pipeline_manager = daxa::PipelineManager({
+                .device = device,
+                .root_paths = {test_folder / "src"},
+                .spirv_cache_folder = test_folder / "cache",
+                .default_language = daxa::ShaderLanguage::GLSL,
+                .name = APPNAME_PREFIX("pipeline_manager"),
+            });
+            any_failed = false;
+            auto t0 = Clock::now();
+            for (u32 i = 0; i < PIPELINE_COUNT; ++i)
+            {
+                auto compilation_result = pipeline_manager.add_compute_pipeline2({
+                    .source = daxa::ShaderFile{"main.glsl"},
+                    .defines = {{"VARIANT", std::to_string(i)}},
+                    .push_constant_size = sizeof(u32),
+                    .name = APPNAME_PREFIX("spirv_cache_index_test"),
+                });
+                any_failed = any_failed || compilation_result.is_err();
+            }
+            return std::chrono::duration<f32, std::milli>(Clock::now() - t0).count();
+        };
+
+        bool any_failed = false;
+        auto const cold_ms = compile_pipelines(any_failed);
+        if (any_failed)
+        {
+            std::cerr << "Failed to compile the spirv cache index test pipelines!\n";
+            return -1;
+        }
+        auto const warm_ms = compile_pipelines(any_failed);
+        if (any_failed || !std::filesystem::exists(test_folder / "cache/index"))
+        {
+            std::cerr << "Failed to load the spirv cache index test pipelines from the cache!\n";
+            return -1;
+        }
+        std::cout << "SPIR-V for " << PIPELINE_COUNT << " pipelines: cold cache " << cold_ms << "ms, warm cache " << warm_ms << "ms" << std::endl;
+
+        // Changing an include must invalidate every cache entry that depends on it, even though the main file is untouched.
+        auto const old_write_time = std::filesystem::last_write_time(test_folder / "src/common.glsl");
+        write_file(test_folder / "src/common.glsl", "#error stale spirv cache entry was used\n");
+        std::filesystem::last_write_time(test_folder / "src/common.glsl", old_write_time + std::chrono::seconds(2));
+        compile_pipelines(any_failed);
+        if (!any_failed)
+        {
+            std::cerr << "Spirv cache entries were not invalidated by a changed include!\n";
+            return -1;
+        }
+
+        return 0;
+    }
+
+    auto pipeline_cache(daxa::Instance & instance) -> i32
+    {
+        // Each phase runs on a fresh device so that pipelines compiled by an earlier phase can only be reused through the cache file.
+        // NOTE: Most drivers keep their own implicit on disk shader cache, which narrows the measured gap between cold and warm startup.
+        static constexpr u32 PIPELINE_COUNT = 32;
+        std::filesystem::path const spirv_cache_folder = "my/shader/cache/folder";
+        std::filesystem::path const pipeline_cache_file = "my/pipeline/cache/pipelines.bin";
+        std::filesystem::remove(pipeline_cache_file);
+
+        using Clock = std::chrono::high_resolution_clock;
+        auto compile_pipelines = [&](daxa::Device & device, std::optional<std::filesystem::path> const & cache_file) -> f32
+        {
+            daxa::PipelineManager pipeline_manager = daxa::PipelineManager({
+                .device = device,
+                .spirv_cache_folder = spirv_cache_folder,
+                .pipeline_cache_file = cache_file,
+                .default_language = daxa::ShaderLanguage::GLSL,
+                .name = APPNAME_PREFIX("pipeline_manager"),
+            });
+            pipeline_manager.add_virtual_file({
+                .name = "pipeline_cache_test",
+                .contents = R"glsl(
+                    layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+                    layout(push_constant) uniform Push { uint value; } push;
+                    shared uint accumulator[64];
+                    void main() {
+                        uint v = push.value;
+                        for (uint i = 0; i < VARIANT + 8; ++i) { v = v * 1664525u + 1013904223u; }
+                        accumulator[gl_LocalInvocationIndex] = v;
+                    }
+                )glsl",
+            });
+            auto t0 = Clock::now();
+            for (u32 i = 0; i < PIPELINE_COUNT; ++i)
+            {
+                auto compilation_result = pipeline_manager.add_compute_pipeline2({
+                    .source = daxa::ShaderFile{"pipeline_cache_test"},
+                    .defines = {{"VARIANT", std::to_string(i)}},
+                    .push_constant_size = sizeof(u32),
+                    .name = APPNAME_PREFIX("pipeline_cache_test"),
+                });
+                if (compilation_result.is_err())
+                {
+                    std::cerr << compilation_result.message() << std::endl;
+                    return -1.0f;
+                }
+            }
+            return std::chrono::duration<f32, std::milli>(Clock::now() - t0).count();
+        };
+
+        // Populate the spirv cache first, so the timings below only measure driver side pipeline creation.
+        {
+            daxa::Device device = instance.create_device_2(instance.choose_device({}, {}));
+            if (compile_pipelines(device, std::nullopt) < 0.0f)
+            {
+                return -1;
+            }
+        }
+        f32 cold_ms = {};
+        {
+            daxa::Device device = instance.create_device_2(instance.choose_device({}, {}));
+            cold_ms = compile_pipelines(device, pipeline_cache_file);
+        }
+        f32 warm_ms = {};
+        {
+            daxa::Device device = instance.create_device_2(instance.choose_device({}, {}));
+            warm_ms = compile_pipelines(device, pipeline_cache_file);
+
+            auto data = device.pipeline_cache_data();
+            if (!device.load_pipeline_cache(data))
+            {
+                std::cerr << "Failed to load pipeline cache data written by the same device!\n";
+                return -1;
+            }
+            // Corrupting the header (here the driver version) must make the device reject the data.
+            data.at(4 * sizeof(u32)) ^= std::byte{0xFF};
+            if (device.load_pipeline_cache(data))
+            {
+                std::cerr << "Pipeline cache data with a mismatching header was not rejected!\n";
+                return -1;
+            }
+        }
+        if (cold_ms < 0.0f || warm_ms < 0.0f)
+        {
+            return -1;
+        }
+        std::cout << "Pipeline creation (" << PIPELINE_COUNT << " pipelines): cold cache " << cold_ms << "ms, warm cache " << warm_ms << "ms" << std::endl;
+
+        return 0;
+    }
+
     auto virtual_files(daxa::Device & device) -> i32
     {
         daxa::PipelineManager pipeline_manager = daxa::PipelineManager({
@@ -281,6 +661,26 @@ auto main() -> int
     {
         return ret;
     }
+    if (ret = tests::hot_reload_watcher(device); ret != 0)
+    {
+        return ret;
+    }
+    if (ret = tests::async_reload(device); ret != 0)
+    {
+        return ret;
+    }
+    if (ret = tests::shared_stage_cache(device); ret != 0)
+    {
+        return ret;
+    }
+    if (ret = tests::spirv_cache_index(device); ret != 0)
+    {
+        return ret;
+    }
+    if (ret = tests::pipeline_cache(daxa_ctx); ret != 0)
+    {
+        return ret;
+    }
 
     std::cout << "Success!" << std::endl;
     return ret;
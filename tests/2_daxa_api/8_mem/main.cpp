@@ -4,10 +4,441 @@ using namespace daxa::types;
 #include <daxa/utils/mem.hpp>
 
 #include <iostream>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cstring>
 
 static inline constexpr usize ITERATION_COUNT = {1000};
 static inline constexpr usize ELEMENT_COUNT = {17};
 
+namespace tests
+{
+    void ring_buffer_spill(daxa::Device & device)
+    {
+        constexpr u32 SPILL_RELEASE_FRAMES = 4;
+        daxa::RingBuffer ring{daxa::RingBufferInfo{
+            .device = device,
+            .capacity = 256,
+            .max_spill_blocks = 2,
+            .spill_block_size = 256,
+            .spill_release_frames = SPILL_RELEASE_FRAMES,
+            .name = "spill ring buffer",
+        }};
+        // The first two allocations fill the ring, the next ones spill into two extra blocks.
+        for (u32 i = 0; i < 6; ++i)
+        {
+            auto allocation = ring.allocate(128);
+            DAXA_DBG_ASSERT_TRUE_M(allocation.has_value(), "spilling allocation failed");
+            DAXA_DBG_ASSERT_TRUE_M((i < 2) == (allocation->buffer == ring.buffer()), "allocation was placed in the wrong buffer");
+        }
+        DAXA_DBG_ASSERT_TRUE_M(!ring.allocate(128).has_value(), "allocation must fail once all spill blocks are full");
+        daxa::RingBufferStatistics statistics = ring.statistics();
+        DAXA_DBG_ASSERT_TRUE_M(statistics.spill_count == 4, "wrong spill count");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.spill_block_count == 2, "wrong spill block count");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.high_water_mark == 256 * 3, "wrong high water mark");
+
+        // No submits are pending, so spill blocks are released after enough quiet frames.
+        for (u32 frame = 0; frame <= SPILL_RELEASE_FRAMES; ++frame)
+        {
+            ring.reuse_memory_after_pending_submits();
+        }
+        statistics = ring.statistics();
+        DAXA_DBG_ASSERT_TRUE_M(statistics.spill_block_count == 0, "spill blocks were not released");
+        device.wait_idle();
+        device.collect_garbage();
+    }
+
+    void upload_queue(daxa::Device & device)
+    {
+        constexpr u32 THREAD_COUNT = 4;
+        constexpr u32 UPLOADS_PER_THREAD = 64;
+        constexpr u32 ELEMENTS_PER_UPLOAD = 4;
+        constexpr u32 ELEMENTS_PER_THREAD = UPLOADS_PER_THREAD * ELEMENTS_PER_UPLOAD;
+        daxa::BufferId result_buffer = device.create_buffer({
+            .size = sizeof(u32) * ELEMENTS_PER_THREAD * THREAD_COUNT,
+            .memory_flags = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "upload queue result",
+        });
+        daxa::UploadQueue uploads{daxa::UploadQueueInfo{
+            .device = device,
+            .name = "upload queue",
+        }};
+
+        // Each thread uploads its part of the buffer in many small pieces.
+        std::vector<std::thread> threads = {};
+        for (u32 t = 0; t < THREAD_COUNT; ++t)
+        {
+            threads.push_back(std::thread([&, t]()
+            {
+                for (u32 upload = 0; upload < UPLOADS_PER_THREAD; ++upload)
+                {
+                    std::array<u32, ELEMENTS_PER_UPLOAD> data = {};
+                    u32 const first_element = t * ELEMENTS_PER_THREAD + upload * ELEMENTS_PER_UPLOAD;
+                    for (u32 i = 0; i < ELEMENTS_PER_UPLOAD; ++i)
+                    {
+                        data[i] = first_element + i;
+                    }
+                    [[maybe_unused]] bool const queued = uploads.upload(daxa::BufferUploadInfo{
+                        .data = data.data(),
+                        .size = sizeof(data),
+                        .dst_buffer = result_buffer,
+                        .dst_offset = sizeof(u32) * first_element,
+                    });
+                    DAXA_DBG_ASSERT_TRUE_M(queued, "upload queue ran out of staging memory");
+                }
+            }));
+        }
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+
+        // Overlapping uploads must land in queue order. The garbage is queued first and partially overwritten by each of the two later uploads.
+        constexpr u32 OVERLAP_ELEMENT_COUNT = 8;
+        std::array<u32, OVERLAP_ELEMENT_COUNT> overlap_data = {};
+        overlap_data.fill(~0u);
+        [[maybe_unused]] bool queued = uploads.upload(daxa::BufferUploadInfo{.data = overlap_data.data(), .size = sizeof(overlap_data), .dst_buffer = result_buffer});
+        for (u32 i = 0; i < OVERLAP_ELEMENT_COUNT; ++i)
+        {
+            overlap_data[i] = i;
+        }
+        queued = queued && uploads.upload(daxa::BufferUploadInfo{.data = overlap_data.data(), .size = sizeof(u32) * 4, .dst_buffer = result_buffer});
+        queued = queued && uploads.upload(daxa::BufferUploadInfo{.data = overlap_data.data() + 2, .size = sizeof(u32) * 6, .dst_buffer = result_buffer, .dst_offset = sizeof(u32) * 2});
+        DAXA_DBG_ASSERT_TRUE_M(queued, "overlapping uploads failed");
+
+        // Image uploads whose size does not match the region are rejected.
+        daxa::ImageId image = device.create_image({
+            .format = daxa::Format::R32_UINT,
+            .size = {4, 4, 1},
+            .usage = daxa::ImageUsageFlagBits::TRANSFER_DST,
+            .name = "upload queue image",
+        });
+        [[maybe_unused]] bool const short_image_upload_queued = uploads.upload(daxa::ImageUploadInfo{
+            .data = overlap_data.data(),
+            .size = sizeof(overlap_data),
+            .dst_image = image,
+            .image_extent = {4, 4, 1},
+        });
+        DAXA_DBG_ASSERT_TRUE_M(!short_image_upload_queued, "image upload smaller than its region was queued");
+
+        u64 const upload_timeline_value = uploads.flush();
+
+        // Makes the uploaded data visible to the host.
+        daxa::CommandRecorder cmd = device.create_command_recorder({});
+        cmd.pipeline_barrier({
+            .src_access = daxa::AccessConsts::TRANSFER_WRITE,
+            .dst_access = daxa::AccessConsts::HOST_READ,
+        });
+        device.submit_commands({
+            .command_lists = std::array{cmd.complete_current_commands()},
+            .wait_timeline_semaphores = std::array{std::pair{uploads.timeline_semaphore(), upload_timeline_value}},
+        });
+        device.wait_idle();
+
+        daxa::UploadQueueStatistics const statistics = uploads.statistics();
+        DAXA_DBG_ASSERT_TRUE_M(statistics.upload_count == THREAD_COUNT * UPLOADS_PER_THREAD + 3, "wrong upload count");
+        DAXA_DBG_ASSERT_TRUE_M(statistics.copy_command_count < statistics.upload_count, "adjacent uploads were not coalesced");
+        std::cout << "uploads: " << statistics.upload_count << ", copy commands: " << statistics.copy_command_count << std::endl;
+
+        u32 const * elements = device.buffer_host_address_as<u32>(result_buffer).value();
+        for (u32 i = 0; i < ELEMENTS_PER_THREAD * THREAD_COUNT; ++i)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(elements[i] == i, "uploaded data is wrong");
+        }
+        device.destroy_buffer(result_buffer);
+        device.destroy_image(image);
+        device.wait_idle();
+        device.collect_garbage();
+    }
+
+    void texture_streaming(daxa::Device & device)
+    {
+        // Compares host image copy with staged uploads for a typical texture set: full mip chains and a layered texture.
+        constexpr u32 TEXTURE_COUNT = 32;
+        constexpr u32 TEXTURE_SIZE = 512;
+        constexpr u32 MIP_COUNT = 10;
+        constexpr u32 LAYER_COUNT = 6;
+        bool const host_image_copy_supported = static_cast<bool>(device.properties().implicit_features & daxa::ImplicitFeatureFlagBits::HOST_IMAGE_COPY);
+
+        // Mip data is shared by all textures, each mip holds all layers of the layered texture.
+        std::vector<std::vector<std::byte>> mip_data = {};
+        std::vector<daxa::TextureMipData> single_layer_mips = {};
+        std::vector<daxa::TextureMipData> layered_mips = {};
+        for (u32 mip = 0; mip < MIP_COUNT; ++mip)
+        {
+            u32 const mip_size = std::max(TEXTURE_SIZE >> mip, 1u);
+            mip_data.push_back(std::vector<std::byte>(mip_size * mip_size * sizeof(u32) * LAYER_COUNT));
+            for (usize i = 0; i < mip_data.back().size(); ++i)
+            {
+                mip_data.back()[i] = static_cast<std::byte>(i * 7 + mip);
+            }
+        }
+        for (u32 mip = 0; mip < MIP_COUNT; ++mip)
+        {
+            single_layer_mips.push_back({.data = mip_data[mip].data(), .size = mip_data[mip].size() / LAYER_COUNT});
+            layered_mips.push_back({.data = mip_data[mip].data(), .size = mip_data[mip].size()});
+        }
+
+        auto stream_texture_set = [&](bool prefer_host_image_copy)
+        {
+            daxa::TextureStreamer streamer{daxa::TextureStreamerInfo{
+                .device = device,
+                .prefer_host_image_copy = prefer_host_image_copy,
+                .name = "texture streamer",
+            }};
+            std::vector<daxa::ImageId> images = {};
+            for (u32 i = 0; i < TEXTURE_COUNT + 1; ++i)
+            {
+                images.push_back(device.create_image({
+                    .size = {TEXTURE_SIZE, TEXTURE_SIZE, 1},
+                    .mip_level_count = MIP_COUNT,
+                    .array_layer_count = i == TEXTURE_COUNT ? LAYER_COUNT : 1,
+                    .usage = daxa::ImageUsageFlagBits::TRANSFER_DST | daxa::ImageUsageFlagBits::TRANSFER_SRC | daxa::ImageUsageFlagBits::SHADER_SAMPLED |
+                             (host_image_copy_supported ? daxa::ImageUsageFlagBits::HOST_TRANSFER : daxa::ImageUsageFlagBits::NONE),
+                    .name = "streamed texture",
+                }));
+            }
+
+            auto const start = std::chrono::steady_clock::now();
+            for (u32 i = 0; i < TEXTURE_COUNT + 1; ++i)
+            {
+                bool const layered = i == TEXTURE_COUNT;
+                [[maybe_unused]] bool const uploaded = streamer.upload({
+                    .image = images[i],
+                    .layer_count = layered ? LAYER_COUNT : 1,
+                    .mips = layered ? layered_mips : single_layer_mips,
+                    .initialize_layout = true,
+                });
+                DAXA_DBG_ASSERT_TRUE_M(uploaded, "texture upload failed");
+            }
+            [[maybe_unused]] auto _timeout = streamer.timeline_semaphore().wait_for_value(streamer.flush());
+            auto const end = std::chrono::steady_clock::now();
+
+            daxa::TextureStreamerStatistics const statistics = streamer.statistics();
+            u64 const bytes = statistics.host_copy_bytes + statistics.staged_bytes;
+            f64 const seconds = std::chrono::duration<f64>(end - start).count();
+            std::cout << (prefer_host_image_copy && host_image_copy_supported ? "host image copy" : "staging")
+                      << ": " << seconds * 1000.0 << "ms, " << static_cast<f64>(bytes) / seconds / (1 << 20) << "MiB/s"
+                      << ", host copied textures: " << statistics.host_copy_uploads << ", staged textures: " << statistics.staged_uploads << std::endl;
+            DAXA_DBG_ASSERT_TRUE_M(statistics.host_copy_uploads + statistics.staged_uploads == TEXTURE_COUNT + 1, "wrong upload count");
+            DAXA_DBG_ASSERT_TRUE_M((statistics.host_copy_uploads > 0) == (prefer_host_image_copy && host_image_copy_supported), "uploads took the wrong path");
+
+            // Reads back one layer of one mip of the layered texture and compares it with the uploaded texels.
+            constexpr u32 CHECKED_MIP = 2;
+            constexpr u32 CHECKED_LAYER = 3;
+            u32 const checked_mip_size = TEXTURE_SIZE >> CHECKED_MIP;
+            usize const checked_layer_bytes = checked_mip_size * checked_mip_size * sizeof(u32);
+            daxa::BufferId readback_buffer = device.create_buffer({
+                .size = checked_layer_bytes,
+                .memory_flags = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+                .name = "texture readback",
+            });
+            daxa::CommandRecorder cmd = device.create_command_recorder({});
+            cmd.pipeline_barrier({
+                .src_access = daxa::AccessConsts::TRANSFER_WRITE | daxa::AccessConsts::HOST_WRITE,
+                .dst_access = daxa::AccessConsts::TRANSFER_READ,
+            });
+            cmd.copy_image_to_buffer({
+                .src_image = images[TEXTURE_COUNT],
+                .image_slice = {.mip_level = CHECKED_MIP, .base_array_layer = CHECKED_LAYER, .layer_count = 1},
+                .image_extent = {checked_mip_size, checked_mip_size, 1},
+                .dst_buffer = readback_buffer,
+            });
+            cmd.pipeline_barrier({
+                .src_access = daxa::AccessConsts::TRANSFER_WRITE,
+                .dst_access = daxa::AccessConsts::HOST_READ,
+            });
+            device.submit_commands({
+                .command_lists = std::array{cmd.complete_current_commands()},
+            });
+            device.wait_idle();
+            std::byte const * texels = device.buffer_host_address_as<std::byte>(readback_buffer).value();
+            DAXA_DBG_ASSERT_TRUE_M(std::memcmp(texels, mip_data[CHECKED_MIP].data() + checked_layer_bytes * CHECKED_LAYER, checked_layer_bytes) == 0, "streamed texels are wrong");
+            device.destroy_buffer(readback_buffer);
+
+            for (auto image : images)
+            {
+                device.destroy_image(image);
+            }
+            device.wait_idle();
+            device.collect_garbage();
+        };
+        stream_texture_set(false);
+        if (host_image_copy_supported)
+        {
+            stream_texture_set(true);
+        }
+    }
+
+    void staging_allocator(daxa::Device & device)
+    {
+        constexpr u32 THREAD_COUNT = 8;
+        constexpr u32 ALLOCATIONS_PER_THREAD = 256;
+        constexpr u32 BLOCK_SIZE = 4096;
+        constexpr u32 BLOCK_COUNT = 64;
+        daxa::StagingAllocator staging{daxa::StagingAllocatorInfo{
+            .device = device,
+            .block_size = BLOCK_SIZE,
+            .block_count = BLOCK_COUNT,
+            // The test reads the memory back on the host.
+            .prefer_device_memory = false,
+            .name = "staging allocator",
+        }};
+
+        // Live allocations from many threads must never overlap and must respect their alignment.
+        struct Range
+        {
+            u32 offset = {};
+            u32 size = {};
+        };
+        std::vector<std::vector<Range>> thread_ranges(THREAD_COUNT);
+        std::vector<std::thread> threads = {};
+        for (u32 t = 0; t < THREAD_COUNT; ++t)
+        {
+            threads.push_back(std::thread([&, t]()
+            {
+                for (u32 i = 0; i < ALLOCATIONS_PER_THREAD; ++i)
+                {
+                    u32 const size = 4 + (i * 7 + t) % 61;
+                    u32 const alignment = i % 5 == 0 ? 0 : 1u << (i % 5);
+                    auto allocation = staging.allocate(size, alignment);
+                    DAXA_DBG_ASSERT_TRUE_M(allocation.has_value(), "staging memory ran out");
+                    DAXA_DBG_ASSERT_TRUE_M(alignment == 0 || allocation->buffer_offset % alignment == 0, "allocation is misaligned");
+                    // Tag the memory, overlapping allocations would overwrite each others tags.
+                    std::memset(allocation->host_address, static_cast<int>(t + 1), size);
+                    thread_ranges[t].push_back(Range{.offset = allocation->buffer_offset, .size = size});
+                }
+            }));
+        }
+        for (auto & thread : threads)
+        {
+            thread.join();
+        }
+        std::vector<Range> ranges = {};
+        u8 const * staging_memory = device.buffer_host_address_as<u8>(staging.buffer()).value();
+        for (u32 t = 0; t < THREAD_COUNT; ++t)
+        {
+            for (Range const & range : thread_ranges[t])
+            {
+                for (u32 i = 0; i < range.size; ++i)
+                {
+                    DAXA_DBG_ASSERT_TRUE_M(staging_memory[range.offset + i] == t + 1, "allocation was overwritten by another thread");
+                }
+                ranges.push_back(range);
+            }
+        }
+        std::sort(ranges.begin(), ranges.end(), [](Range const & a, Range const & b) { return a.offset < b.offset; });
+        for (usize i = 1; i < ranges.size(); ++i)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(ranges[i - 1].offset + ranges[i - 1].size <= ranges[i].offset, "live allocations overlap");
+        }
+
+        // Memory must only be reused once the submits pending at retirement completed.
+        // The submit waits on a semaphore that is signaled from the host, so it stays pending until then.
+        daxa::TimelineSemaphore gate = device.create_timeline_semaphore({
+            .name = "staging allocator gate",
+        });
+        daxa::CommandRecorder cmd = device.create_command_recorder({});
+        auto waits = std::array{
+            std::pair{gate, u64{1}},
+        };
+        device.submit_commands({
+            .command_lists = std::array{cmd.complete_current_commands()},
+            .wait_timeline_semaphores = waits,
+        });
+        staging.reuse_memory_after_pending_submits();
+        u32 retired_allocation_count = 0;
+        while (staging.allocate(BLOCK_SIZE).has_value())
+        {
+            ++retired_allocation_count;
+        }
+        // Every shard held a block, those are retired and may not be handed out again while the submit is pending.
+        DAXA_DBG_ASSERT_TRUE_M(retired_allocation_count < BLOCK_COUNT, "retired memory was reused before its submit completed");
+        gate.set_value(1);
+        device.wait_idle();
+        staging.reuse_memory_after_pending_submits();
+        u32 reclaimed_allocation_count = 0;
+        while (staging.allocate(BLOCK_SIZE).has_value())
+        {
+            ++reclaimed_allocation_count;
+        }
+        DAXA_DBG_ASSERT_TRUE_M(reclaimed_allocation_count == BLOCK_COUNT, "retired memory was not reclaimed after its submit completed");
+        device.wait_idle();
+        device.collect_garbage();
+    }
+
+    void staging_allocator_contention(daxa::Device & device)
+    {
+        // Measures allocation throughput when many threads upload concurrently.
+        // The RingBuffer is single threaded and has to be guarded by a lock, the StagingAllocator is shared as is.
+        constexpr u32 ALLOCATIONS_PER_THREAD = 4096;
+        constexpr u32 ALLOCATION_SIZE = 64;
+        daxa::RingBuffer ring{daxa::RingBufferInfo{
+            .device = device,
+            .capacity = 1 << 25,
+            .name = "contention ring buffer",
+        }};
+        std::mutex ring_mtx = {};
+        daxa::StagingAllocator staging{daxa::StagingAllocatorInfo{
+            .device = device,
+            .block_size = 1 << 16,
+            .block_count = 512,
+            .name = "contention staging allocator",
+        }};
+
+        auto measure = [&](u32 thread_count, auto const & allocate) -> f64
+        {
+            auto const start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads = {};
+            for (u32 t = 0; t < thread_count; ++t)
+            {
+                threads.push_back(std::thread([&, t]()
+                {
+                    for (u32 i = 0; i < ALLOCATIONS_PER_THREAD; ++i)
+                    {
+                        void * host_address = allocate();
+                        DAXA_DBG_ASSERT_TRUE_M(host_address != nullptr, "staging memory ran out");
+                        *reinterpret_cast<u32 *>(host_address) = t * ALLOCATIONS_PER_THREAD + i;
+                    }
+                }));
+            }
+            for (auto & thread : threads)
+            {
+                thread.join();
+            }
+            auto const end = std::chrono::steady_clock::now();
+            f64 const seconds = std::chrono::duration<f64>(end - start).count();
+            return static_cast<f64>(thread_count * ALLOCATIONS_PER_THREAD) / seconds;
+        };
+
+        for (u32 thread_count = 1; thread_count <= 16; thread_count *= 2)
+        {
+            f64 const ring_allocations_per_second = measure(thread_count, [&]() -> void *
+            {
+                std::lock_guard const lock{ring_mtx};
+                auto allocation = ring.allocate(ALLOCATION_SIZE);
+                return allocation.has_value() ? allocation->host_address : nullptr;
+            });
+            f64 const staging_allocations_per_second = measure(thread_count, [&]() -> void *
+            {
+                auto allocation = staging.allocate(ALLOCATION_SIZE);
+                return allocation.has_value() ? allocation->host_address : nullptr;
+            });
+            std::cout << "threads: " << thread_count
+                      << ", ring buffer allocations/s: " << static_cast<u64>(ring_allocations_per_second)
+                      << ", staging allocator allocations/s: " << static_cast<u64>(staging_allocations_per_second) << std::endl;
+
+            // No submits are pending, all memory is reclaimed immediately.
+            ring.reuse_memory_after_pending_submits();
+            staging.reuse_memory_after_pending_submits();
+        }
+    }
+} // namespace tests
+
 auto main() -> int
 {
     daxa::Instance daxa_ctx = daxa::create_instance({});
@@ -94,4 +525,10 @@ auto main() -> int
     device.wait_idle();
     device.collect_garbage();
     std::cout << std::flush;
+
+    tests::ring_buffer_spill(device);
+    tests::upload_queue(device);
+    tests::texture_streaming(device);
+    tests::staging_allocator(device);
+    tests::staging_allocator_contention(device);
 }
@@ -249,6 +249,141 @@ namespace tests
         task_graph.execute({});
         device.destroy_sampler(sampler);
     }
+
+    void multi_draw()
+    {
+        // TEST:
+        //  1) draw_many and draw_indexed_many with more draws than fit one multi draw chunk of 64,
+        //     changing the instance parameters in the middle of a chunk.
+        //  2) draw_indirect with packed commands and a stride of 0, written by TransferMemoryPool::allocate_draw_commands.
+        //  3) every draw marks its own pixel, readback and validate all pixels.
+        daxa::Instance daxa_ctx = daxa::create_instance({});
+        daxa::Device device = daxa_ctx.create_device_2(daxa_ctx.choose_device({}, {}));
+
+        constexpr u32 DIRECT_DRAW_COUNT = 150;
+        constexpr u32 DIRECT_SPLIT = 100;
+        constexpr u32 INDIRECT_DRAW_COUNT = 70;
+        constexpr u32 DIRECT_INDEXED_BASE = DIRECT_DRAW_COUNT;
+        constexpr u32 INDIRECT_BASE = DIRECT_DRAW_COUNT * 2;
+        constexpr u32 INDIRECT_INDEXED_BASE = INDIRECT_BASE + INDIRECT_DRAW_COUNT;
+        constexpr u32 WIDTH = INDIRECT_INDEXED_BASE + INDIRECT_DRAW_COUNT;
+
+        daxa::PipelineManager pipeline_manager = daxa::PipelineManager({
+            .device = device,
+            .root_paths = {
+                DAXA_SHADER_INCLUDE_DIR,
+                "tests/2_daxa_api/9_shader_integration/shaders",
+            },
+            .name = "pipeline manager",
+        });
+        auto const shader_info = daxa::ShaderCompileInfo2{
+            .source = daxa::ShaderFile{"multi_draw_test.glsl"},
+            .defines = {{"MULTI_DRAW_TARGET_WIDTH", std::to_string(WIDTH)}},
+        };
+        auto compile_result = pipeline_manager.add_raster_pipeline2({
+            .vertex_shader_info = shader_info,
+            .fragment_shader_info = shader_info,
+            .color_attachments = {{.format = daxa::Format::R32_UINT}},
+            .raster = {.primitive_topology = daxa::PrimitiveTopology::POINT_LIST},
+            .name = "multi_draw",
+        });
+        auto pipeline = compile_result.value();
+
+        auto image = device.create_image({
+            .format = daxa::Format::R32_UINT,
+            .size = {WIDTH, 1, 1},
+            .usage = daxa::ImageUsageFlagBits::COLOR_ATTACHMENT | daxa::ImageUsageFlagBits::TRANSFER_SRC,
+            .name = "multi_draw target",
+        });
+        auto readback_buffer = device.create_buffer({
+            .size = sizeof(u32) * WIDTH,
+            .memory_flags = daxa::MemoryFlagBits::HOST_ACCESS_RANDOM,
+            .name = "multi_draw readback",
+        });
+        auto transfer_memory = daxa::TransferMemoryPool{{.device = device, .name = "multi_draw transfer memory"}};
+
+        // The instance parameters change at DIRECT_SPLIT, within the second chunk of 64 draws.
+        std::vector<daxa::DrawInfo> draws = {};
+        std::vector<daxa::DrawIndexedInfo> indexed_draws = {};
+        for (u32 i = 0; i < DIRECT_DRAW_COUNT; ++i)
+        {
+            u32 const first_instance = i < DIRECT_SPLIT ? 0 : 1;
+            draws.push_back({.vertex_count = 1, .instance_count = 1, .first_vertex = i, .first_instance = first_instance});
+            indexed_draws.push_back({.index_count = 1, .instance_count = 1, .first_index = i, .vertex_offset = static_cast<i32>(DIRECT_INDEXED_BASE), .first_instance = first_instance});
+        }
+        std::vector<daxa::DrawInfo> indirect_draws = {};
+        std::vector<daxa::DrawIndexedInfo> indirect_indexed_draws = {};
+        for (u32 i = 0; i < INDIRECT_DRAW_COUNT; ++i)
+        {
+            indirect_draws.push_back({.vertex_count = 1, .instance_count = 1, .first_vertex = INDIRECT_BASE + i, .first_instance = 2});
+            indirect_indexed_draws.push_back({.index_count = 1, .instance_count = 1, .first_index = i, .vertex_offset = static_cast<i32>(INDIRECT_INDEXED_BASE), .first_instance = 3});
+        }
+        auto indirect_info = transfer_memory.allocate_draw_commands(indirect_draws).value();
+        auto indirect_indexed_info = transfer_memory.allocate_draw_commands(indirect_indexed_draws).value();
+        DAXA_DBG_ASSERT_TRUE_M(indirect_info.draw_command_stride == 0 && !indirect_info.is_indexed, "packed draw commands must use a stride of 0");
+        DAXA_DBG_ASSERT_TRUE_M(indirect_indexed_info.draw_command_stride == 0 && indirect_indexed_info.is_indexed, "packed indexed draw commands must use a stride of 0");
+
+        // Index i is stored at index i, the draws select their pixel with first_index and vertex_offset.
+        auto indices = transfer_memory.allocate(sizeof(u32) * DIRECT_DRAW_COUNT, sizeof(u32)).value();
+        for (u32 i = 0; i < DIRECT_DRAW_COUNT; ++i)
+        {
+            reinterpret_cast<u32 *>(indices.host_address)[i] = i;
+        }
+
+        auto recorder = device.create_command_recorder({.name = "multi_draw"});
+        recorder.pipeline_image_barrier({
+            .dst_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_WRITE,
+            .image = image,
+            .layout_operation = daxa::ImageLayoutOperation::TO_GENERAL,
+        });
+        auto render_recorder = std::move(recorder).begin_renderpass({
+            .color_attachments = std::array{daxa::RenderAttachmentInfo{
+                .image_view = image.default_view(),
+                .load_op = daxa::AttachmentLoadOp::CLEAR,
+                .clear_value = std::array<u32, 4>{0, 0, 0, 0},
+            }},
+            .render_area = {.width = WIDTH, .height = 1},
+        });
+        render_recorder.set_pipeline(*pipeline);
+        render_recorder.set_index_buffer({.buffer = indices.buffer, .offset = indices.buffer_offset});
+        render_recorder.draw_many(draws);
+        render_recorder.draw_indexed_many(indexed_draws);
+        render_recorder.draw_indirect(indirect_info);
+        render_recorder.draw_indirect(indirect_indexed_info);
+        recorder = std::move(render_recorder).end_renderpass();
+        recorder.pipeline_barrier({
+            .src_access = daxa::AccessConsts::COLOR_ATTACHMENT_OUTPUT_WRITE,
+            .dst_access = daxa::AccessConsts::TRANSFER_READ,
+        });
+        recorder.copy_image_to_buffer({
+            .src_image = image,
+            .image_extent = {WIDTH, 1, 1},
+            .dst_buffer = readback_buffer,
+        });
+        recorder.pipeline_barrier({
+            .src_access = daxa::AccessConsts::TRANSFER_WRITE,
+            .dst_access = daxa::AccessConsts::HOST_READ,
+        });
+        auto executable_commands = recorder.complete_current_commands();
+        device.submit_commands({.command_lists = std::array{executable_commands}});
+        device.wait_idle();
+
+        u32 const * marks = device.buffer_host_address_as<u32>(readback_buffer).value();
+        for (u32 i = 0; i < DIRECT_DRAW_COUNT; ++i)
+        {
+            u32 const expected = i < DIRECT_SPLIT ? 1 : 2;
+            DAXA_DBG_ASSERT_TRUE_M(marks[i] == expected, "draw_many dropped or misplaced a draw");
+            DAXA_DBG_ASSERT_TRUE_M(marks[DIRECT_INDEXED_BASE + i] == expected, "draw_indexed_many dropped or misplaced a draw");
+        }
+        for (u32 i = 0; i < INDIRECT_DRAW_COUNT; ++i)
+        {
+            DAXA_DBG_ASSERT_TRUE_M(marks[INDIRECT_BASE + i] == 3, "packed draw_indirect with stride 0 dropped or misplaced a draw");
+            DAXA_DBG_ASSERT_TRUE_M(marks[INDIRECT_INDEXED_BASE + i] == 4, "packed indexed draw_indirect with stride 0 dropped or misplaced a draw");
+        }
+
+        device.destroy_image(image);
+        device.destroy_buffer(readback_buffer);
+    }
 } // namespace tests
 
 auto main() -> int
@@ -256,4 +391,5 @@ auto main() -> int
     tests::aligned_types_templates();
     tests::alignment();
     tests::bindless_handles();
+    tests::multi_draw();
 }
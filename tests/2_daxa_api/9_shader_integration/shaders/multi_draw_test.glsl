@@ -0,0 +1,20 @@
+#include <daxa/daxa.inl>
+
+// Every draw covers one pixel of a MULTI_DRAW_TARGET_WIDTH x 1 target, selected by its vertex index.
+// The pixel records the instance index of the draw plus one, so missing and misplaced draws are visible in the readback.
+#if DAXA_SHADER_STAGE == DAXA_SHADER_STAGE_VERTEX
+layout(location = 0) flat out daxa_u32 v_mark;
+void main()
+{
+    v_mark = gl_InstanceIndex + 1;
+    gl_PointSize = 1.0;
+    gl_Position = vec4((float(gl_VertexIndex) + 0.5) / float(MULTI_DRAW_TARGET_WIDTH) * 2.0 - 1.0, 0.0, 0.0, 1.0);
+}
+#elif DAXA_SHADER_STAGE == DAXA_SHADER_STAGE_FRAGMENT
+layout(location = 0) flat in daxa_u32 v_mark;
+layout(location = 0) out daxa_u32 f_mark;
+void main()
+{
+    f_mark = v_mark;
+}
+#endif